@@ -1,7 +1,7 @@
 import * as assert from "assert";
 import * as pathLib from "path";
 import * as utils from "../utils";
-import { remote, shell } from "electron";
+import { ipcRenderer, remote, shell } from "electron";
 import { machineId } from "node-machine-id";
 
 const app = remote.app;
@@ -126,6 +126,11 @@ export function openURLInDefaultBrowser(
     });
 }
 
+// hand the renderer's startup trace events to the shell, see startup-trace.ts
+export function reportStartupTrace(events: Array<{}>, isComplete: boolean) {
+    ipcRenderer.send("startup-trace", events, isComplete);
+}
+
 export function quit() {
     // close current window, shell will quit when all windows are closed
     remote.getCurrentWindow().close();
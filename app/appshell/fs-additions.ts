@@ -1,4 +1,5 @@
 import * as fs from "fs-extra";
+import * as pathLib from "path";
 import * as utils from "../utils";
 import { remote } from "electron";
 const { dialog } = remote;
@@ -82,6 +83,83 @@ export function readTextFile(filename: string, encoding: string, callback: (err:
     });
 }
 
+let atomicWriteCounter = 0;
+
+/**
+ * Writes the file next to its destination under a temporary name and then renames it
+ * over the original, so readers never observe a partially written file.
+ *
+ * Symlinks are followed, so the file they point to is replaced and the link is kept. The temporary
+ * file gets the mode and owner of the original; files with several hard links, and files whose
+ * owner can't be kept, are written in place instead, since a rename would detach them.
+ * Temporary files are named ".<name>.<pid>-<n>.tmp~", which the project watchers ignore.
+ */
+export function writeTextFileAtomic(filename: string, data: string, encoding: string, callback: (err?: Error | null) => void) {
+    function writeInPlace(target: string) {
+        fs.writeFile(target, data, encoding, (err) => callback(err));
+    }
+
+    fs.realpath(filename, function (realpathErr, target) {
+        // A file that doesn't exist yet is created under the given name
+        if (realpathErr) {
+            target = filename;
+        }
+        fs.stat(target, function (statErr, stats) {
+            if (statErr && statErr.code !== "ENOENT") {
+                return callback(statErr);
+            }
+            if (stats && stats.nlink > 1) {
+                return writeInPlace(target);
+            }
+
+            const tmpFilename = pathLib.join(
+                pathLib.dirname(target),
+                "." + pathLib.basename(target) + "." + process.pid + "-" + (atomicWriteCounter++) + ".tmp~"
+            );
+
+            function fail(err: Error) {
+                fs.remove(tmpFilename, () => callback(err));
+            }
+
+            function replaceTarget() {
+                // use the native rename which replaces the destination, unlike rename() below
+                fs.rename(tmpFilename, target, function (renameErr) {
+                    if (renameErr) {
+                        return fail(renameErr);
+                    }
+                    callback(null);
+                });
+            }
+
+            fs.writeFile(tmpFilename, data, encoding, function (writeErr) {
+                if (writeErr) {
+                    return fail(writeErr);
+                }
+                if (!stats) {
+                    return replaceTarget();
+                }
+                fs.chmod(tmpFilename, stats.mode, function (chmodErr) {
+                    if (chmodErr) {
+                        return fail(chmodErr);
+                    }
+                    const getuid = process.getuid;
+                    if (!getuid || (stats.uid === getuid() && stats.gid === process.getgid!())) {
+                        return replaceTarget();
+                    }
+                    fs.chown(tmpFilename, stats.uid, stats.gid, function (chownErr) {
+                        if (chownErr) {
+                            // Only the owner of the file may replace it, write into it instead
+                            fs.remove(tmpFilename, () => writeInPlace(target));
+                            return;
+                        }
+                        replaceTarget();
+                    });
+                });
+            });
+        });
+    });
+}
+
 export function remove(path: string, callback: (err?: Error) => void) {
     fs.stat(path, function (err, stats) {
         if (err) {
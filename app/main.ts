@@ -1,3 +1,4 @@
+import * as StartupTrace from "./startup-trace"; // first, so that it sees the other imports load
 import { app, BrowserWindow, BrowserWindowConstructorOptions, ipcMain, LoadURLOptions } from "electron";
 import AutoUpdater from "./auto-updater";
 import * as _ from "lodash";
@@ -13,6 +14,8 @@ import * as SocketServer from "./socket-server"; // Implementation of Brackets'
 
 const appInfo = require("./package.json");
 
+StartupTrace.end("main: load modules");
+
 const log = getLogger("main");
 process.on("uncaughtException", (err: Error) => {
     log.error(`[uncaughtException] ${err.stack}`);
@@ -50,7 +53,9 @@ let windowAllClosed = false;
 
 // Start the socket server used by Brackets'
 const socketServerLog = getLogger("socket-server");
+StartupTrace.begin("main: socket server start");
 SocketServer.start(function (err: Error, port: number) {
+    StartupTrace.end("main: socket server start");
     if (err) {
         shellState.set("socketServer.state", "ERR_NODE_FAILED");
         socketServerLog.error("failed to start: " + errToString(err));
@@ -216,7 +221,9 @@ export function openMainBracketsWindow(query: {} | string = {}): BrowserWindow {
     }
 
     // create the browser window
+    StartupTrace.begin("main: create window");
     const win = new BrowserWindow(winOptions);
+    StartupTrace.end("main: create window");
     if (argv.devtools) {
         win.webContents.openDevTools({ mode: "detach" });
     }
@@ -224,6 +231,8 @@ export function openMainBracketsWindow(query: {} | string = {}): BrowserWindow {
 
     // load the index.html of the app
     log.info(`loading brackets window at ${indexUrl}`);
+    StartupTrace.begin("main: load index.html");
+    win.webContents.once("did-finish-load", () => StartupTrace.end("main: load index.html"));
     win.loadURL(indexUrl);
     if (shellConfig.get("window.maximized")) {
         win.maximize();
@@ -3,6 +3,9 @@ import appshell = require("./appshell/index");
 
 let t: any;
 
+// startup trace of the preload script, see startup-trace.ts
+const preloadStart = Date.now() * 1000;
+
 // define global object extensions
 interface BracketsWindowGlobal {
     // TODO: better define appshell (brackets) global object
@@ -51,4 +54,14 @@ process.once("loaded", function () {
     (g.process.versions as any)["node-webkit"] = true;
     // inject appshell implementation into the browser window
     g.appshell = g.brackets = t.appshell;
+
+    electron.ipcRenderer.send("startup-trace", [{
+        name: "preload",
+        cat: "startup",
+        ph: "X",
+        ts: preloadStart,
+        dur: Date.now() * 1000 - preloadStart,
+        pid: process.pid,
+        tid: 0
+    }], false);
 });
@@ -1,8 +1,11 @@
 import DomainManager from "./domain-manager";
 import * as WebSocket from "ws";
 import { errToMessage, errToString, getLogger } from "../utils";
+import * as Framing from "./framing";
 
 export interface ConnectionMessage {
+    type?: string;
+    framing?: Array<string>;
     id: number;
     domain: string;
     command?: string;
@@ -19,6 +22,10 @@ export interface CommandResponse {
     response: any;
 }
 
+export interface Capabilities {
+    framing: string | null;
+}
+
 export interface CommandError {
     id: number;
     message: string;
@@ -50,6 +57,13 @@ export class Connection {
      */
     private _connected: boolean = false;
 
+    /**
+     * @private
+     * @type {boolean}
+     * Whether the client negotiated binary framing, see framing.ts
+     */
+    private _binaryFraming: boolean = false;
+
     /**
      * @private
      * @constructor
@@ -68,13 +82,20 @@ export class Connection {
     /**
      * @private
      * Sends a message over the WebSocket. Called by public sendX commands.
+     * Messages with large strings or Buffers are sent as binary frames if the
+     * client negotiated binary framing.
      * @param {string} type Message type. Currently supported types are
-     *                 "event", "commandResponse", "commandError", "error"
+     *                 "event", "commandResponse", "commandError", "error", "capabilities"
      * @param {object} message Message body, must be JSON.stringify-able
      */
-    private _send(type: string, message: ConnectionMessage | ConnectionErrorMessage | CommandResponse | CommandError) {
+    private _send(type: string, message: ConnectionMessage | ConnectionErrorMessage | CommandResponse | CommandError | Capabilities) {
         if (this._ws && this._connected) {
             try {
+                const frame = this._binaryFraming ? Framing.encodeFrame(type, message) : null;
+                if (frame) {
+                    this._sendBinary(frame);
+                    return;
+                }
                 this._ws.send(JSON.stringify({ type, message }));
             } catch (e) {
                 console.error("[Connection] Unable to stringify message: " + e.message);
@@ -115,6 +136,11 @@ export class Connection {
             }
         }
 
+        if (m.type === "capabilities") {
+            this._negotiate(m.framing || []);
+            return;
+        }
+
         const validId = m.id !== null && m.id !== undefined;
         const hasDomain = !!m.domain;
         const hasCommand = typeof m.command === "string";
@@ -137,6 +163,17 @@ export class Connection {
         }
     }
 
+    /**
+     * @private
+     * Picks the framing for the rest of the connection from the ones the client
+     * supports and tells the client, which receives the answer before any binary frame.
+     * @param {Array.<string>} framing Framing versions the client supports
+     */
+    private _negotiate(framing: Array<string>) {
+        this._binaryFraming = framing.indexOf(Framing.FRAMING_VERSION) !== -1;
+        this._send("capabilities", { framing: this._binaryFraming ? Framing.FRAMING_VERSION : null });
+    }
+
     /**
      * Closes the connection and does necessary cleanup
      */
@@ -169,7 +206,7 @@ export class Connection {
      *    the result will be sent as a binary response.
      */
     public sendCommandResponse(id: number, response: Object | Buffer) {
-        if (Buffer.isBuffer(response)) {
+        if (Buffer.isBuffer(response) && !this._binaryFraming) {
             // Assume the id is an unsigned 32-bit integer, which is encoded
             // as a four-byte header
             const header = new Buffer(4);
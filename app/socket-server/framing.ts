@@ -0,0 +1,141 @@
+/**
+ * Binary framing of the messages sent to clients that negotiated it.
+ *
+ * Messages with large strings or Buffers are sent as one binary WebSocket frame instead of JSON
+ * text, so that those values are neither escaped nor scanned by the JSON parser of the client:
+ *
+ *     uint32 LE   byte length of the header
+ *     header      UTF-8 JSON {type, message, refs}, where the extracted values are null
+ *     payload     the extracted values, one after the other
+ *
+ * Each entry of refs is [path, kind, offset, length]: the keys leading from message to the
+ * extracted value, whether it's a UTF-8 string or raw bytes, and where it is in the payload.
+ * Clients turn raw bytes into ArrayBuffers, which they can transfer to workers without copying.
+ */
+
+/** Version of the framing, clients send it when they connect */
+export const FRAMING_VERSION = "binary-1";
+
+export const REF_STRING = 0;
+export const REF_BINARY = 1;
+
+/** Strings shorter than this are left in the JSON header */
+export const STRING_THRESHOLD = 4096;
+
+/** Objects nested deeper than this are left in the JSON header */
+const MAX_DEPTH = 32;
+
+type Ref = [Array<string | number>, number, number, number];
+
+/** The keys leading to a value, innermost first, so walking down doesn't allocate arrays */
+interface Path {
+    key: string | number;
+    parent: Path | null;
+}
+
+interface Extracted {
+    refs: Array<Ref>;
+    chunks: Array<Buffer>;
+    size: number;
+}
+
+function toArray(path: Path | null) {
+    const keys: Array<string | number> = [];
+    for (; path; path = path.parent) {
+        keys.unshift(path.key);
+    }
+    return keys;
+}
+
+/**
+ * @private
+ * Moves a large string or Buffer to the payload
+ */
+function addChunk(value: any, path: Path, result: Extracted) {
+    const binary = Buffer.isBuffer(value);
+    const chunk = binary ? value : Buffer.from(value, "utf8");
+
+    result.refs.push([toArray(path), binary ? REF_BINARY : REF_STRING, result.size, chunk.length]);
+    result.chunks.push(chunk);
+    result.size += chunk.length;
+}
+
+/**
+ * @private
+ * Returns the value to put in the header in place of a child: null for large strings
+ * and Buffers, the child itself or a copy of it for other values.
+ */
+function extractChild(child: any, key: string | number, path: Path | null, depth: number, result: Extracted): any {
+    if (typeof child === "string") {
+        if (child.length < STRING_THRESHOLD) {
+            return child;
+        }
+    } else if (!child || typeof child !== "object") {
+        return child;
+    } else if (!Buffer.isBuffer(child)) {
+        const isPlain = depth < MAX_DEPTH && typeof child.toJSON !== "function";
+        return isPlain ? extract(child, { key, parent: path }, depth + 1, result) : child;
+    }
+
+    addChunk(child, { key, parent: path }, result);
+    return null;
+}
+
+/**
+ * @private
+ * Returns an object or array with its large strings and Buffers replaced by null,
+ * copying only the objects and arrays that contain one.
+ */
+function extract(value: any, path: Path | null, depth: number, result: Extracted): any {
+    let copy: any = null;
+
+    if (Array.isArray(value)) {
+        for (let i = 0; i < value.length; i++) {
+            const child = value[i];
+            // Most arrays hold numbers or short strings, skip those without a call
+            if (typeof child === "object" ? child !== null : typeof child === "string" && child.length >= STRING_THRESHOLD) {
+                const replaced = extractChild(child, i, path, depth, result);
+                if (replaced !== child) {
+                    copy = copy || value.slice();
+                    copy[i] = replaced;
+                }
+            }
+        }
+    } else {
+        for (const key in value) {
+            if (value.hasOwnProperty(key)) {
+                const child = value[key];
+                const replaced = typeof child === "object" || typeof child === "string"
+                    ? extractChild(child, key, path, depth, result)
+                    : child;
+                if (replaced !== child) {
+                    copy = copy || Object.assign({}, value);
+                    copy[key] = replaced;
+                }
+            }
+        }
+    }
+    return copy || value;
+}
+
+/**
+ * Encodes a message as a binary frame
+ * @param {string} type Message type, e.g. "commandResponse" or "event"
+ * @param {object} message Message body, must be JSON.stringify-able apart from Buffers
+ * @return {?Buffer} The frame, or null if the message has no large values and is
+ *     better sent as JSON text
+ */
+export function encodeFrame(type: string, message: any): Buffer | null {
+    const extracted: Extracted = { refs: [], chunks: [], size: 0 };
+    const skeleton = extract(message, null, 0, extracted);
+
+    if (!extracted.refs.length) {
+        return null;
+    }
+
+    const header = Buffer.from(JSON.stringify({ type, message: skeleton, refs: extracted.refs }), "utf8");
+    const length = Buffer.alloc(4);
+    length.writeUInt32LE(header.length, 0);
+
+    return Buffer.concat([length, header].concat(extracted.chunks), 4 + header.length + extracted.size);
+}
@@ -0,0 +1,95 @@
+import { app, ipcMain } from "electron";
+import * as fs from "fs";
+import { performance } from "perf_hooks";
+import * as yargs from "yargs";
+import { getLogger, errToString } from "./utils";
+
+// Collects the startup phases of the main process, the preload script and the renderer
+// into one list of Chrome trace events (chrome://tracing, DevTools performance panel).
+// Timestamps are microseconds since the epoch so that events from all processes line up.
+
+export interface TraceEvent {
+    name: string;
+    cat: string;
+    ph: string;
+    ts: number;
+    dur?: number;
+    pid: number;
+    tid: number;
+    id?: string;
+    args?: {};
+}
+
+const log = getLogger("startup-trace");
+
+const argv = yargs
+    .describe("trace-startup", "Write a Chrome trace of the startup phases to this file.")
+    .string("trace-startup")
+    .describe("quit-after-startup", "Quit once startup is complete, used by the startup benchmark.")
+    .boolean("quit-after-startup")
+    .argv;
+
+const events: Array<TraceEvent> = [];
+const openPhases: { [name: string]: number } = {};
+let finished = false;
+
+export function now(): number {
+    return Math.round((performance.timeOrigin + performance.now()) * 1000);
+}
+
+export function complete(name: string, ts: number, dur: number, args?: {}) {
+    events.push({ name, cat: "startup", ph: "X", ts, dur, pid: process.pid, tid: 0, args });
+}
+
+export function begin(name: string) {
+    openPhases[name] = now();
+}
+
+export function end(name: string, args?: {}) {
+    const start = openPhases[name];
+    if (start === undefined) {
+        return;
+    }
+    delete openPhases[name];
+    complete(name, start, now() - start, args);
+}
+
+export function add(otherEvents: Array<TraceEvent>) {
+    events.push(...otherEvents);
+}
+
+export function getEvents(): Array<TraceEvent> {
+    return events.slice().sort((a, b) => a.ts - b.ts);
+}
+
+export function toJSON(): string {
+    return JSON.stringify({ traceEvents: getEvents(), displayTimeUnit: "ms" });
+}
+
+// From the start of the process until main.ts starts loading its imports
+const processStart = now() - Math.round(process.uptime() * 1000000);
+complete("main: electron init", processStart, now() - processStart);
+begin("main: load modules");
+begin("main: app ready");
+app.once("ready", () => end("main: app ready"));
+
+ipcMain.on("startup-trace", function (event: Event, rendererEvents: Array<TraceEvent>, isComplete: boolean) {
+    add(rendererEvents);
+    if (!isComplete || finished) {
+        return;
+    }
+    finished = true;
+
+    const tracePath = argv["trace-startup"];
+    if (tracePath) {
+        try {
+            fs.writeFileSync(tracePath, toJSON());
+            log.info("wrote startup trace to " + tracePath);
+        } catch (err) {
+            log.error("failed to write startup trace: " + errToString(err));
+        }
+    }
+    if (argv["quit-after-startup"]) {
+        app.quit();
+    }
+});
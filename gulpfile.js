@@ -3,11 +3,14 @@
 const gulp = require("gulp");
 
 [
+    "./tasks/benchmark-startup",
     "./tasks/copy",
     "./tasks/download-default-extensions",
     "./tasks/nls-check",
     "./tasks/eslint",
+    "./tasks/extension-bundles",
     "./tasks/less",
+    "./tasks/node-domains",
     "./tasks/npm-install",
     "./tasks/test",
     "./tasks/watch",
@@ -28,6 +31,7 @@ gulp.task("install", gulp.series(
 gulp.task("build", gulp.series(
     "npm-install-dist",
     "npm-install-extensions-dist",
+    "node-domains-check",
     "less"
 ));
 
@@ -46,7 +50,8 @@ gulp.task("optimize-common", gulp.series(
     // "copy:dist",
     // "cleanempty",
     // "usemin",
-    "build-config"
+    "build-config",
+    "extension-bundles"
     // "clean:node_modules_test_dir"
 ));
 
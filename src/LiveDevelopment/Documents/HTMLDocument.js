@@ -79,8 +79,15 @@ define(function HTMLDocumentModule(require, exports, module) {
      */
     HTMLDocument.prototype.setInstrumentationEnabled = function setInstrumentationEnabled(enabled) {
         if (enabled && !this._instrumentationEnabled && this.editor) {
-            HTMLInstrumentation.scanDocument(this.doc);
-            HTMLInstrumentation._markText(this.editor);
+            var self = this,
+                editor = this.editor;
+
+            // Resolves right away unless the document is large enough to be parsed in a worker
+            HTMLInstrumentation.scanDocumentAsync(this.doc).done(function () {
+                if (self.editor === editor) {
+                    HTMLInstrumentation._markText(editor);
+                }
+            });
         }
 
         this._instrumentationEnabled = enabled;
@@ -306,33 +313,41 @@ define(function HTMLDocumentModule(require, exports, module) {
         // Only handles attribute changes currently.
         // TODO: text changes should be easy to add
         // TODO: if new tags are added, need to instrument them
-        var self                = this,
-            result              = HTMLInstrumentation.getUnappliedEditList(editor, change),
-            applyEditsPromise;
+        var self = this;
 
-        if (result.edits) {
-            applyEditsPromise = RemoteAgent.call("applyDOMEdits", result.edits);
+        // Large documents may be reparsed in a worker. If another change comes in first, this
+        // request is dropped and the later one delivers the edits for both.
+        HTMLInstrumentation.getUnappliedEditListAsync(editor, change).done(function (result) {
+            var applyEditsPromise;
 
-            applyEditsPromise.always(function () {
-                if (!isNestedTimer) {
-                    PerfUtils.addMeasurement(perfTimerName);
-                }
-            });
-        }
+            if (result.edits) {
+                applyEditsPromise = RemoteAgent.call("applyDOMEdits", result.edits);
 
-        this.errors = result.errors || [];
-        this.trigger("statusChanged", this);
-
-        // Debug-only: compare in-memory vs. in-browser DOM
-        // edit this file or set a conditional breakpoint at the top of this function:
-        //     "this._debug = true, false"
-        if (this._debug) {
-            console.log("Edits applied to browser were:");
-            console.log(JSON.stringify(result.edits, null, 2));
-            applyEditsPromise.done(function () {
-                self._compareWithBrowser(change);
-            });
-        }
+                applyEditsPromise.always(function () {
+                    if (!isNestedTimer) {
+                        PerfUtils.addMeasurement(perfTimerName);
+                    }
+                });
+            }
+
+            self.errors = result.errors || [];
+            self.trigger("statusChanged", self);
+
+            // Debug-only: compare in-memory vs. in-browser DOM
+            // edit this file or set a conditional breakpoint at the top of this function:
+            //     "this._debug = true, false"
+            if (self._debug) {
+                console.log("Edits applied to browser were:");
+                console.log(JSON.stringify(result.edits, null, 2));
+                applyEditsPromise.done(function () {
+                    self._compareWithBrowser(change);
+                });
+            }
+        }).fail(function () {
+            if (!isNestedTimer) {
+                PerfUtils.finalizeMeasurement(perfTimerName);
+            }
+        });
 
         // var marker = HTMLInstrumentation._getMarkerAtDocumentPos(
         //     this.editor,
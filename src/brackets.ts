@@ -69,6 +69,7 @@ import * as FileSyncManager from "project/FileSyncManager";
 import * as Commands from "command/Commands";
 import * as CommandManager from "command/CommandManager";
 import * as PerfUtils from "utils/PerfUtils";
+import * as StartupTimeline from "utils/StartupTimeline";
 import * as FileSystem from "filesystem/FileSystem";
 import * as Strings from "strings";
 import * as Dialogs from "widgets/Dialogs";
@@ -106,6 +107,7 @@ import * as Inspector from "LiveDevelopment/Inspector/Inspector";
 import * as InstallExtensionDialog from "extensibility/InstallExtensionDialog";
 import * as JSUtils from "language/JSUtils";
 import * as KeyBindingManager from "command/KeyBindingManager";
+import * as LessCache from "utils/LessCache";
 import * as LiveDevelopment from "LiveDevelopment/LiveDevelopment";
 import * as LiveDevMultiBrowser from "LiveDevelopment/LiveDevMultiBrowser";
 import * as LiveDevServerManager from "LiveDevelopment/LiveDevServerManager";
@@ -202,6 +204,7 @@ import "languageTools/DefaultProviders";
 import "languageTools/DefaultEventHandlers";
 
 PerfUtils.addMeasurement("brackets module dependencies resolved");
+StartupTimeline.addPhase("renderer: load core modules", performance.timing.responseEnd * 1000, StartupTimeline.now());
 
 // Local variables
 const params = new UrlParams();
@@ -249,6 +252,7 @@ function _initTest() {
         JSUtils                 : JSUtils,
         KeyBindingManager       : KeyBindingManager,
         LanguageManager         : LanguageManager,
+        LessCache               : LessCache,
         LiveDevelopment         : LiveDevelopment,
         LiveDevMultiBrowser     : LiveDevMultiBrowser,
         LiveDevServerManager    : LiveDevServerManager,
@@ -268,7 +272,10 @@ function _initTest() {
     };
 
     AppInit.appReady(function () {
-        brackets.test.doneLoading = true;
+        // Also wait for the extensions activated once startup has finished
+        ExtensionLoader._getStartupActivationPromise().always(function () {
+            brackets.test.doneLoading = true;
+        });
     });
 }
 
@@ -321,21 +328,29 @@ function _onReady() {
     }
 
     // Load default languages and preferences
+    StartupTimeline.begin("renderer: load languages and preferences");
     Async.waitForAll([LanguageManager.ready, PreferencesManager.ready]).always(function () {
+        StartupTimeline.end("renderer: load languages and preferences");
+
         // Load all extensions. This promise will complete even if one or more
         // extensions fail to load.
         const extensionPathOverride = params.get("extensions");  // used by unit tests
+        StartupTimeline.begin("renderer: load extensions");
         const extensionLoaderPromise = ExtensionLoader.init(extensionPathOverride ? extensionPathOverride.split(",") : null);
 
         // Load the initial project after extensions have loaded
         extensionLoaderPromise.always(function () {
+            StartupTimeline.end("renderer: load extensions");
+
             // Signal that extensions are loaded
             AppInit._dispatchReady(AppInit.EXTENSIONS_LOADED);
 
             // Finish UI initialization
             ViewCommandHandlers.restoreFontSize();
             const initialProjectPath = ProjectManager.getInitialProjectPath();
+            StartupTimeline.begin("renderer: open project");
             ProjectManager.openProject(initialProjectPath).always(function () {
+                StartupTimeline.end("renderer: open project");
                 _initTest();
 
                 // If this is the first launch, and we have an index.html file in the project folder (which should be
@@ -367,6 +382,14 @@ function _onReady() {
                     AppInit._dispatchReady(AppInit.APP_READY);
 
                     PerfUtils.addMeasurement("Application Startup");
+                    StartupTimeline.mark("app ready");
+
+                    // The trace ends once the extensions waiting for the end of startup are loaded too
+                    StartupTimeline.begin("renderer: activate extensions on startup finished");
+                    ExtensionLoader._getStartupActivationPromise().always(function () {
+                        StartupTimeline.end("renderer: activate extensions on startup finished");
+                        StartupTimeline.finish();
+                    });
 
                     if (PreferencesManager._isUserScopeCorrupt()) {
                         const userPrefFullPath = PreferencesManager.getUserPrefFile();
@@ -537,10 +560,14 @@ function _beforeHTMLReady() {
 
 // Wait for view state to load.
 const viewStateTimer = PerfUtils.markStart("User viewstate loading");
+StartupTimeline.begin("renderer: load view state");
 PreferencesManager._smUserScopeLoading.always(function () {
     PerfUtils.addMeasurement(viewStateTimer);
+    StartupTimeline.end("renderer: load view state");
     // Dispatch htmlReady event
+    StartupTimeline.begin("renderer: html ready");
     _beforeHTMLReady();
     AppInit._dispatchReady(AppInit.HTML_READY);
+    StartupTimeline.end("renderer: html ready");
     $(window.document).ready(_onReady);
 });
@@ -47,6 +47,13 @@ let _commands = {};
  */
 let _commandsOriginal = {};
 
+/**
+ * Commands registered with registerPlaceholder() that haven't been registered for real yet
+ * @type {Object.<commandID: string, Command>}
+ */
+let _placeholders = {};
+let _placeholdersOriginal = {};
+
 /**
  * Events:
  * - enabledStateChange
@@ -193,7 +200,7 @@ EventDispatcher.makeEventDispatcher(Command.prototype);
  * @return {?Command}
  */
 export function register(name, id, commandFn) {
-    if (_commands[id]) {
+    if (_commands[id] && !_placeholders[id]) {
         console.log("Attempting to register an already-registered command: " + id);
         return null;
     }
@@ -204,12 +211,47 @@ export function register(name, id, commandFn) {
 
     const command = new Command(name, id, commandFn);
     _commands[id] = command;
+    delete _placeholders[id];
 
     (exports as EventDispatcher.DispatcherEvents).trigger("commandRegistered", command);
 
     return command;
 }
 
+/**
+ * Registers a placeholder for a command that isn't available yet, e.g. because the
+ * extension providing it is only activated when the command is first used.
+ * Executing the placeholder calls activateFn and then executes the command that
+ * got registered in the meantime, with the same arguments. The placeholder is
+ * replaced by the first register() call for the same id, and it isn't listed by getAll().
+ *
+ * @param {string} id - unique identifier of the command that will be registered
+ * @param {function(): $.Promise} activateFn - makes the real command available, resolved once
+ *      it is registered
+ * @return {?Command}
+ */
+export function registerPlaceholder(id, activateFn) {
+    if (_commands[id]) {
+        console.log("Attempting to register a placeholder for an already-registered command: " + id);
+        return null;
+    }
+
+    const placeholder = new Command(null, id, function (...args) {
+        return activateFn().then(function () {
+            const command = _commands[id];
+            if (command === placeholder) {
+                console.error("Command " + id + " was not registered by the code activated for it");
+                return $.Deferred().reject().promise();
+            }
+            return command.execute.apply(command, args);
+        });
+    });
+    _commands[id] = placeholder;
+    _placeholders[id] = placeholder;
+
+    return placeholder;
+}
+
 /**
  * Registers a global internal only command.
  * @param {string} id - unique identifier for command.
@@ -223,7 +265,7 @@ export function register(name, id, commandFn) {
  * @return {?Command}
  */
 export function registerInternal(id, commandFn) {
-    if (_commands[id]) {
+    if (_commands[id] && !_placeholders[id]) {
         console.log("Attempting to register an already-registered command: " + id);
         return null;
     }
@@ -234,6 +276,7 @@ export function registerInternal(id, commandFn) {
 
     const command = new Command(null, id, commandFn);
     _commands[id] = command;
+    delete _placeholders[id];
 
     (exports as EventDispatcher.DispatcherEvents).trigger("commandRegistered", command);
 
@@ -247,6 +290,8 @@ export function registerInternal(id, commandFn) {
 export function _testReset() {
     _commandsOriginal = _commands;
     _commands = {};
+    _placeholdersOriginal = _placeholders;
+    _placeholders = {};
 }
 
 /**
@@ -255,6 +300,8 @@ export function _testReset() {
 export function _testRestore() {
     _commands = _commandsOriginal;
     _commandsOriginal = {};
+    _placeholders = _placeholdersOriginal;
+    _placeholdersOriginal = {};
 }
 
 /**
@@ -271,7 +318,9 @@ export function get(id) {
  * @return {Array.<string>}
  */
 export function getAll() {
-    return Object.keys(_commands);
+    return Object.keys(_commands).filter(function (id) {
+        return !_placeholders[id];
+    });
 }
 
 /**
@@ -180,6 +180,7 @@ AppInit.htmlReady(function () {
     menu.addMenuItem(Commands.FILE_LIVE_HIGHLIGHT);
     menu.addMenuDivider();
     menu.addMenuItem(Commands.VIEW_TOGGLE_INSPECTION);
+    menu.addMenuItem(Commands.VIEW_TOGGLE_PROJECT_INSPECTION);
 
     /*
      * Navigate menu
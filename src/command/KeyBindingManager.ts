@@ -36,6 +36,7 @@ import * as Commands from "command/Commands";
 import * as CommandManager from "command/CommandManager";
 import * as DefaultDialogs from "widgets/DefaultDialogs";
 import * as EventDispatcher from "utils/EventDispatcher";
+import * as ExtensionMonitor from "utils/ExtensionMonitor";
 import * as FileSystem from "filesystem/FileSystem";
 import FileSystemError = require("filesystem/FileSystemError");
 import * as FileUtils from "file/FileUtils";
@@ -59,6 +60,21 @@ let _keyMap            = {};    // For the actual key bindings including user sp
 // For the default factory key bindings, cloned from _keyMap after all extensions are loaded.
 let _defaultKeyMap     = {};
 
+/**
+ * @private
+ * The bindings of _keyMap by key code (see _encodeKey), used to dispatch keyboard
+ * events without building their key descriptor string.
+ * @type {!Map.<number, {commandID: string, key: string, displayKey: string}>}
+ */
+let _keyCodeMap: Map<number, any> = new Map();
+
+/**
+ * @private
+ * The first default binding of each command in _defaultKeyMap
+ * @type {!Object.<string, {commandID: string, key: string, displayKey: string}>}
+ */
+let _defaultBindingByCommand = {};
+
 interface UserKeyBinding {
     shortcut?: string;
     commandID?: string;
@@ -97,6 +113,13 @@ let _commandMap: CommandMap = {};
  */
 let _allCommands: Array<string> = [];
 
+/**
+ * @private
+ * The command IDs in _allCommands, for constant time lookups
+ * @type {!Object.<string, boolean>}
+ */
+let _allCommandsSet = {};
+
 /**
  * @private
  * Maps key names to the corresponding unicode symols
@@ -276,12 +299,86 @@ function _detectAltGrKeyDown(e) {
     }
 }
 
+/**
+ * Modifiers in key codes, see _encodeKey()
+ */
+const MODIFIER_CTRL         = 1;
+const MODIFIER_CMD          = 2;
+const MODIFIER_ALT          = 4;
+const MODIFIER_SHIFT        = 8;
+const MODIFIER_COMBINATIONS = 16;
+
+/**
+ * @private
+ * Small integer ids of the keys seen so far, by key name
+ * @type {!Map.<string, number>}
+ */
+const _keyIds: Map<string, number> = new Map();
+
+/**
+ * @private
+ * Key codes of the normalized key descriptors seen so far
+ * @type {!Map.<string, number>}
+ */
+const _descriptorCodes: Map<string, number> = new Map();
+
+/**
+ * @private
+ * Encodes a key and its modifiers as an integer. The modifiers are those spelled out in
+ * normalized key descriptors, so two descriptors are equal iff their codes are equal.
+ * @param {boolean} hasCtrl "Ctrl" in the descriptor (the Control key, also on Mac)
+ * @param {boolean} hasCmd "Cmd" in the descriptor (the Command key on Mac)
+ * @param {boolean} hasAlt
+ * @param {boolean} hasShift
+ * @param {string} key The key that's pressed
+ * @return {number}
+ */
+function _encodeKey(hasCtrl, hasCmd, hasAlt, hasShift, key) {
+    let id = _keyIds.get(key);
+    if (id === undefined) {
+        id = _keyIds.size;
+        _keyIds.set(key, id);
+    }
+
+    return id * MODIFIER_COMBINATIONS +
+        (hasCtrl ? MODIFIER_CTRL : 0) +
+        (hasCmd ? MODIFIER_CMD : 0) +
+        (hasAlt ? MODIFIER_ALT : 0) +
+        (hasShift ? MODIFIER_SHIFT : 0);
+}
+
+/**
+ * @private
+ * Returns the key code of a normalized key descriptor
+ * @param {!string} descriptor
+ * @return {number}
+ */
+function _getKeyCode(descriptor) {
+    let code = _descriptorCodes.get(descriptor);
+    if (code === undefined) {
+        // The key is after the last "-" that isn't the last character, e.g. in "Ctrl--"
+        const dash = descriptor.length > 1 ? descriptor.lastIndexOf("-", descriptor.length - 2) : -1;
+        const modifiers = dash === -1 ? [] : descriptor.substr(0, dash).split("-");
+        code = _encodeKey(
+            modifiers.indexOf("Ctrl") !== -1,
+            modifiers.indexOf("Cmd") !== -1,
+            modifiers.indexOf("Alt") !== -1,
+            modifiers.indexOf("Shift") !== -1,
+            descriptor.substr(dash + 1)
+        );
+        _descriptorCodes.set(descriptor, code);
+    }
+    return code;
+}
+
 /**
  * @private
  */
 export function _reset() {
     _keyMap = {};
+    _keyCodeMap = new Map();
     _defaultKeyMap = {};
+    _defaultBindingByCommand = {};
     _customKeyMap = {};
     _customKeyMapCache = {};
     _commandMap = {};
@@ -480,13 +577,9 @@ function _mapKeycodeToKey(keycode, key) {
 }
 
 /**
- * Takes a keyboard event and translates it into a key in a key map
+ * Returns the key of a keyboard event, without its modifiers, as named in key descriptors
  */
-function _translateKeyboardEvent(event) {
-    const hasMacCtrl = (brackets.platform === "mac") ? (event.ctrlKey) : false;
-    const hasCtrl = (brackets.platform !== "mac") ? (event.ctrlKey) : (event.metaKey);
-    const hasAlt = (event.altKey);
-    const hasShift = (event.shiftKey);
+function _getEventKey(event) {
     let key = String.fromCharCode(event.keyCode);
 
     // From the W3C, if we can get the KeyboardEvent.key then look here
@@ -519,7 +612,16 @@ function _translateKeyboardEvent(event) {
         key = _mapKeycodeToKey(event.keyCode, key);
     }
 
-    return _buildKeyDescriptor(hasMacCtrl, hasCtrl, hasAlt, hasShift, key);
+    return key;
+}
+
+/**
+ * Takes a keyboard event and translates it into the code of a key in the key map, see _encodeKey().
+ * The Control key is "Ctrl" on every platform, the Command key is "Cmd" on Mac.
+ */
+function _translateKeyboardEvent(event) {
+    const hasCmd = (brackets.platform === "mac") && event.metaKey;
+    return _encodeKey(event.ctrlKey, hasCmd, event.altKey, event.shiftKey, _getEventKey(event));
 }
 
 /**
@@ -586,6 +688,7 @@ export function removeBinding(key, platform?) {
 
         // delete key binding record
         delete _keyMap[normalizedKey];
+        _keyCodeMap.delete(_getKeyCode(normalizedKey));
 
         if (bindings) {
             // delete mapping from command to key binding
@@ -615,8 +718,11 @@ function _updateCommandAndKeyMaps(newBinding) {
         return;
     }
 
-    if (newBinding && newBinding.commandID && _allCommands.indexOf(newBinding.commandID) === -1) {
+    if (newBinding && newBinding.commandID && !_allCommandsSet[newBinding.commandID]) {
         _defaultKeyMap[newBinding.commandID] = _.cloneDeep(newBinding);
+        if (!_defaultBindingByCommand[newBinding.commandID]) {
+            _defaultBindingByCommand[newBinding.commandID] = _defaultKeyMap[newBinding.commandID];
+        }
 
         // Process user key map again to catch any reassignment to all new key bindings added from extensions.
         _loadUserKeyMap();
@@ -776,6 +882,7 @@ function _addBinding(commandID, keyBinding, platform, userBindings?) {
         displayKey          : normalizedDisplay,
         explicitPlatform    : explicitPlatform
     };
+    _keyCodeMap.set(_getKeyCode(normalized), _keyMap[normalized]);
 
     if (!userBindings) {
         _updateCommandAndKeyMaps(_keyMap[normalized]);
@@ -809,11 +916,21 @@ export function getKeymap(defaults) {
  * @return {boolean} true if the key was processed, false otherwise
  */
 export function _handleKey(key) {
-    if (_enabled && _keyMap[key]) {
+    return _executeBinding(_keyMap[key]);
+}
+
+/**
+ * @private
+ * Executes the command of a key binding
+ * @param {?{commandID: string}} binding
+ * @return {boolean} true if the key was processed, false otherwise
+ */
+function _executeBinding(binding) {
+    if (_enabled && binding) {
         // The execute() function returns a promise because some commands are async.
         // Generally, commands decide whether they can run or not synchronously,
         // and reject immediately, so we can test for that synchronously.
-        const promise = CommandManager.execute(_keyMap[key].commandID);
+        const promise = CommandManager.execute(binding.commandID);
         return (promise.state() !== "rejected");
     }
     return false;
@@ -952,6 +1069,7 @@ function _handleCommandRegistered(event, command) {
  * @param {function(Event): boolean} hook The global hook to add.
  */
 export function addGlobalKeydownHook(hook) {
+    ExtensionMonitor.attribute(hook);
     _globalKeydownHooks.push(hook);
 }
 
@@ -976,13 +1094,14 @@ export function removeGlobalKeydownHook(hook) {
 export function _handleKeyEvent(event) {
     let handled = false;
     for (let i = _globalKeydownHooks.length - 1; i >= 0; i--) {
-        if (_globalKeydownHooks[i](event)) {
+        const hook = _globalKeydownHooks[i];
+        if (ExtensionMonitor.invoke(hook, "keydown hook", hook, null, [event])) {
             handled = true;
             break;
         }
     }
     _detectAltGrKeyDown(event);
-    if (!handled && _handleKey(_translateKeyboardEvent(event))) {
+    if (!handled && _executeBinding(_keyCodeMap.get(_translateKeyboardEvent(event)))) {
         event.stopPropagation();
         event.preventDefault();
     }
@@ -1121,8 +1240,8 @@ export function _getDisplayKey(key) {
  *     - A key binding is referring to a non-existent command ID.
  */
 function _applyUserKeyBindings() {
-    const remappedCommands: Array<string> = [];
-    const remappedKeys: Array<string> = [];
+    const remappedCommands: { [commandID: string]: boolean } = {};
+    const remappedKeys: { [key: string]: boolean } = {};
     const restrictedCommands: Array<string> = [];
     const restrictedKeys: Array<string> = [];
     const invalidKeys: Array<string> = [];
@@ -1156,7 +1275,7 @@ function _applyUserKeyBindings() {
         }
 
         if (_isKeyAssigned(normalizedKey)) {
-            if (remappedKeys.indexOf(normalizedKey) !== -1) {
+            if (remappedKeys[normalizedKey]) {
                 // JSON parser already removed all the duplicates that have the exact
                 // same case or order in their keys. So we're only detecting duplicate
                 // bindings that have different orders or different cases used in the key.
@@ -1167,15 +1286,13 @@ function _applyUserKeyBindings() {
             if (_keyMap[normalizedKey].commandID === commandID) {
                 // Still need to add it to the remappedCommands so that
                 // we can detect any duplicate later on.
-                remappedCommands.push(commandID);
+                remappedCommands[commandID] = true;
                 return;
             }
             removeBinding(normalizedKey);
         }
 
-        if (remappedKeys.indexOf(normalizedKey) === -1) {
-            remappedKeys.push(normalizedKey);
-        }
+        remappedKeys[normalizedKey] = true;
 
         // Remove another key binding if the new key binding is for a command
         // that has a different key binding. e.g. "Ctrl-W": "edit.selectLine"
@@ -1188,13 +1305,13 @@ function _applyUserKeyBindings() {
         }
 
         if (commandID) {
-            if (_allCommands.indexOf(commandID) !== -1) {
-                if (remappedCommands.indexOf(commandID) === -1) {
+            if (_allCommandsSet[commandID]) {
+                if (!remappedCommands[commandID]) {
                     const keybinding: KeyBinding = { key: normalizedKey };
 
                     keybinding.displayKey = _getDisplayKey(normalizedKey);
                     _addBinding(commandID, keybinding.displayKey ? keybinding : normalizedKey, brackets.platform, true);
-                    remappedCommands.push(commandID);
+                    remappedCommands[commandID] = true;
                 } else {
                     multipleKeys.push(commandID);
                 }
@@ -1238,11 +1355,16 @@ function _applyUserKeyBindings() {
  *
  * Restores the default key bindings for all the commands that are modified by each key binding
  * specified in _customKeyMapCache (old version) but no longer specified in _customKeyMap (new version).
+ * User key bindings that are in both versions stay in place.
  */
 function _undoPriorUserKeyBindings() {
     _.forEach(_customKeyMapCache, function (commandID, key: string) {
+        if (_customKeyMap[key] === commandID) {
+            return;
+        }
+
         const normalizedKey  = normalizeKeyDescriptorString(key);
-        const defaults       = _.find(_.toArray(_defaultKeyMap), { "commandID": commandID });
+        const defaults       = _defaultBindingByCommand[commandID];
         const defaultCommand = _defaultKeyMap[normalizedKey!];
 
         // We didn't modified this before, so skip it.
@@ -1355,7 +1477,7 @@ export const _loadUserKeyMap = _.debounce(function () {
             // Some extensions may add a new command without any key binding. So
             // we always have to get all commands again to ensure that we also have
             // those from any extensions installed during the current session.
-            _allCommands = CommandManager.getAll();
+            _updateAllCommands();
 
             _customKeyMapCache = _.cloneDeep(_customKeyMap);
             _customKeyMap = keyMap;
@@ -1411,9 +1533,28 @@ CommandManager.register(Strings.CMD_OPEN_KEYMAP, Commands.FILE_OPEN_KEYMAP, _ope
  * detecting non-existent commands and restoring the original key binding.
  */
 export function _initCommandAndKeyMaps() {
-    _allCommands = CommandManager.getAll();
+    _updateAllCommands();
     // Keep a copy of the default key bindings before loading user key bindings.
     _defaultKeyMap = _.cloneDeep(_keyMap);
+
+    _defaultBindingByCommand = {};
+    _.forEach(_defaultKeyMap, function (binding) {
+        if (!_defaultBindingByCommand[binding.commandID]) {
+            _defaultBindingByCommand[binding.commandID] = binding;
+        }
+    });
+}
+
+/**
+ * @private
+ * Refreshes _allCommands and _allCommandsSet
+ */
+function _updateAllCommands() {
+    _allCommands = CommandManager.getAll();
+    _allCommandsSet = {};
+    _allCommands.forEach(function (commandID) {
+        _allCommandsSet[commandID] = true;
+    });
 }
 
 /**
@@ -26,6 +26,7 @@ import * as EditorManager from "editor/EditorManager";
 import * as EventDispatcher from "utils/EventDispatcher";
 import * as FileUtils from "file/FileUtils";
 import InMemoryFile = require("document/InMemoryFile");
+import { TextSnapshot } from "document/TextSnapshot";
 import * as PerfUtils from "utils/PerfUtils";
 import * as LanguageManager from "language/LanguageManager";
 import * as CodeMirror from "codemirror";
@@ -43,6 +44,25 @@ function oneOrEach(itemOrArr, cb) {
     }
 }
 
+/**
+ * How long a Document has to go without changes before "idleChange" is dispatched, in ms.
+ * @const
+ */
+const IDLE_CHANGE_DELAY = 300;
+
+/**
+ * Summary of one or more consecutive changes to a Document: lines fromLine..toLine (inclusive) of
+ * the text before the changes were replaced by lines fromLine..newToLine of the text after them.
+ * Lines before fromLine are untouched; lines after the span are untouched but may have moved by
+ * newToLine - toLine. If replacesAll is true, the whole text was replaced and toLine is unknown.
+ */
+export interface ChangeSummary {
+    fromLine: number;
+    toLine: number;
+    newToLine: number;
+    replacesAll: boolean;
+}
+
 /**
  * Model for the contents of a single file and its current modification state.
  * See DocumentManager documentation for important usage notes.
@@ -73,6 +93,13 @@ function oneOrEach(itemOrArr, cb) {
  * __deleted__ -- When the file for this document has been deleted. All views onto the document should
  * be closed. The document will no longer be editable or dispatch "change" events.
  *
+ * __idleChange__ -- Once the document has stopped changing for a moment. Passes ({Document}, {ChangeSummary}),
+ * where the summary covers every change since the last "idleChange". Listeners that rescan the text on each
+ * change (and don't need to be exact while the user types) should use this instead of "change": a multi-cursor
+ * edit or a burst of typing is delivered as a single line span instead of one change record per cursor or
+ * keystroke. Like "change", you MUST addRef() the document while listening. The Document module dispatches
+ * the same thing as "documentIdleChange".
+ *
  * __languageChanged__ -- When the value of getLanguage() has changed. 2nd argument is the old value,
  * 3rd argument is the new value.
  *
@@ -162,6 +189,29 @@ export class Document {
      */
     public _lineEndings: FileUtils.LineEndings | null = null;
 
+    /**
+     * Number of changes made to the document since it was created. Incremented before "change"
+     * is dispatched.
+     * @type {number}
+     */
+    private _version = 0;
+
+    /**
+     * Snapshot of the current text, or null if the text changed since the last one was taken.
+     * Lets every consumer of a change share one copy of the text instead of rebuilding it.
+     * @type {?TextSnapshot}
+     */
+    private _snapshot: TextSnapshot | null = null;
+
+    /**
+     * Changes not yet delivered through "idleChange", merged into one summary.
+     * @type {?ChangeSummary}
+     */
+    private _pendingIdleChange: ChangeSummary | null = null;
+
+    /** Timeout used to wait for the document to stop changing (setTimeout() return value) */
+    private _idleChangeTimeout: number | null = null;
+
     constructor(file, initialTimestamp, rawText) {
         this.file = file;
         this.editable = !file.readOnly;
@@ -195,6 +245,7 @@ export class Document {
         }
         if (this._refCount === 0) {
             // console.log("--- removing from open list");
+            this._cancelIdleChange();
             if (exports.trigger("_beforeDocumentDelete", this)) {
                 return;
             }
@@ -308,24 +359,38 @@ export class Document {
      * @return {string}
      */
     public getText(useOriginalLineEndings = false) {
-        if (this._masterEditor) {
-            // CodeMirror.getValue() always returns text with LF line endings; fix up to match line
-            // endings preferred by the document, if necessary
-            const codeMirrorText = this._masterEditor._codeMirror.getValue();
-            if (useOriginalLineEndings) {
-                if (this._lineEndings === FileUtils.LINE_ENDINGS_CRLF) {
-                    return codeMirrorText.replace(/\n/g, "\r\n");
-                }
-            }
-            return codeMirrorText;
-        }
+        return this.getSnapshot().getText(useOriginalLineEndings);
+    }
 
-        // Optimized path that doesn't require creating master editor
-        if (useOriginalLineEndings) {
-            return this._text;
+    /**
+     * Returns an immutable snapshot of the document's current contents. The snapshot is shared
+     * until the next change, so it's cheap to take one per change notification and hand it to
+     * background work; compare `version` to tell whether the document changed since.
+     * @return {!TextSnapshot}
+     */
+    public getSnapshot() {
+        if (!this._snapshot) {
+            if (this._masterEditor) {
+                // CodeMirror.getValue() always returns text with LF line endings; the snapshot fixes
+                // them up to match the line endings preferred by the document when asked to
+                this._snapshot = new TextSnapshot(this._masterEditor._codeMirror.getValue(), this._lineEndings, this._version);
+            } else {
+                // Optimized path that doesn't require creating master editor. _text is the raw text,
+                // so it's kept as the original version of the normalized text.
+                this._snapshot = new TextSnapshot(Document.normalizeText(this._text), this._lineEndings, this._version, this._text);
+            }
         }
+        return this._snapshot;
+    }
 
-        return Document.normalizeText(this._text);
+    /**
+     * Returns the number of changes made to the document so far. This is the `version` a
+     * snapshot taken now would have, and is cheaper than taking one just to check whether
+     * the text changed.
+     * @return {number}
+     */
+    public getVersion() {
+        return this._version;
     }
 
     /** Normalizes line endings the same way CodeMirror would */
@@ -351,8 +416,106 @@ export class Document {
      * @param {Object} changeList Changelist in CodeMirror format
      */
     private _notifyDocumentChange(changeList) {
+        this._version++;
+        this._snapshot = null;
         (this as unknown as EventDispatcher.DispatcherEvents).trigger("change", this, changeList);
         (exports as unknown as EventDispatcher.DispatcherEvents).trigger("documentChange", this, changeList);
+
+        if (EventDispatcher.hasListeners(this, "idleChange") || EventDispatcher.hasListeners(exports, "documentIdleChange")) {
+            this._queueIdleChange(changeList);
+        }
+    }
+
+    /**
+     * @private
+     * Merges a change list into the pending "idleChange" summary and (re)starts the wait for the
+     * document to stop changing.
+     * @param {Object} changeList Changelist in CodeMirror format
+     */
+    private _queueIdleChange(changeList) {
+        const summary = Document.summarizeChangeList(changeList);
+        if (summary.replacesAll) {
+            summary.toLine = summary.newToLine = this.getSnapshot().getLineCount() - 1;
+        }
+        this._pendingIdleChange = this._pendingIdleChange
+            ? Document.mergeChangeSummaries(this._pendingIdleChange, summary)
+            : summary;
+
+        if (this._idleChangeTimeout) {
+            window.clearTimeout(this._idleChangeTimeout);
+        }
+        this._idleChangeTimeout = window.setTimeout(() => {
+            const pending = this._pendingIdleChange;
+            this._idleChangeTimeout = null;
+            this._pendingIdleChange = null;
+            (this as unknown as EventDispatcher.DispatcherEvents).trigger("idleChange", this, pending);
+            (exports as unknown as EventDispatcher.DispatcherEvents).trigger("documentIdleChange", this, pending);
+        }, IDLE_CHANGE_DELAY);
+    }
+
+    /**
+     * Drops the changes waiting for "idleChange", so that a document that was deleted or is no
+     * longer referenced doesn't dispatch it later. ONLY Document and DocumentManager should call this.
+     */
+    public _cancelIdleChange() {
+        if (this._idleChangeTimeout) {
+            window.clearTimeout(this._idleChangeTimeout);
+            this._idleChangeTimeout = null;
+        }
+        this._pendingIdleChange = null;
+    }
+
+    /**
+     * Collapses a change list (as passed with the "change" event) into the single span of lines it
+     * touched. Each change in the list is relative to the text left by the previous one; the result
+     * is relative to the text before the first change and after the last one.
+     * @param {!Array.<{from: {line:number, ch:number}, to: {line:number, ch:number}, text: !Array.<string>}>} changeList
+     * @return {!ChangeSummary}
+     */
+    public static summarizeChangeList(changeList): ChangeSummary {
+        let result: ChangeSummary | null = null;
+        for (const change of changeList) {
+            let summary: ChangeSummary;
+            if (!change.from || !change.to) {
+                // Entire text replaced: keep the line count of the new text as a best guess
+                summary = { fromLine: 0, toLine: change.text.length - 1, newToLine: change.text.length - 1, replacesAll: true };
+            } else {
+                summary = {
+                    fromLine: change.from.line,
+                    toLine: change.to.line,
+                    newToLine: change.from.line + change.text.length - 1,
+                    replacesAll: false
+                };
+            }
+            result = result ? Document.mergeChangeSummaries(result, summary) : summary;
+        }
+        return result || { fromLine: 0, toLine: -1, newToLine: -1, replacesAll: false };
+    }
+
+    /**
+     * Merges two consecutive change summaries, where second is relative to the text left by first.
+     * @param {!ChangeSummary} first
+     * @param {!ChangeSummary} second
+     * @return {!ChangeSummary}
+     */
+    public static mergeChangeSummaries(first: ChangeSummary, second: ChangeSummary): ChangeSummary {
+        if (second.replacesAll) {
+            return {
+                fromLine: 0,
+                toLine: second.toLine - (first.newToLine - first.toLine),
+                newToLine: second.newToLine,
+                replacesAll: true
+            };
+        }
+
+        // Last touched line, in the coordinates of the text between the two changes
+        const lastLine = Math.max(first.newToLine, second.toLine);
+        return {
+            fromLine: Math.min(first.fromLine, second.fromLine),
+            toLine: lastLine - (first.newToLine - first.toLine),
+            newToLine: lastLine + (second.newToLine - second.toLine),
+            replacesAll: first.replacesAll
+        };
     }
 
     /**
@@ -400,6 +563,8 @@ export class Document {
         if (!this._lineEndings) {
             this._lineEndings = FileUtils.getPlatformLineEndings();
         }
+        // A snapshot taken by a change listener above used the old line endings
+        this._snapshot = null;
 
         (exports as unknown as EventDispatcher.DispatcherEvents).trigger("_documentRefreshed", this);
 
@@ -444,7 +609,9 @@ export class Document {
      * @return {!string}
      */
     public getRange(start, end) {
-        this._ensureMasterEditor();
+        if (!this._masterEditor) {
+            return this.getSnapshot().getRange(start, end);
+        }
         return this._masterEditor._codeMirror.getRange(start, end);
     }
 
@@ -454,7 +621,9 @@ export class Document {
      * @return {!string}
      */
     public getLine(lineNum) {
-        this._ensureMasterEditor();
+        if (!this._masterEditor) {
+            return this.getSnapshot().getLine(lineNum);
+        }
         return this._masterEditor._codeMirror.getLine(lineNum);
     }
 
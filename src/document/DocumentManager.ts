@@ -113,6 +113,36 @@ interface DocumentMap {
  */
 const _openDocuments: DocumentMap = {};
 
+/**
+ * Secondary index of _openDocuments by Document.file.fullPath, so that looking up a Document by
+ * path doesn't walk every open Document. Keyed by path rather than by
+ * FileSystem.getFileForPath(fullPath).id since the file it returns won't match an Untitled
+ * document's InMemoryFile. Rebuilt whenever files are renamed.
+ * @private
+ * @type {Map.<string, Document>}
+ */
+const _openDocumentsByPath: Map<string, DocumentModule.Document> = new Map();
+
+/**
+ * Cached result of getAllOpenDocuments(), or null if documents were opened or closed since.
+ * @private
+ * @type {?Array.<Document>}
+ */
+let _openDocumentsList: Array<DocumentModule.Document> | null = null;
+
+/**
+ * @private
+ * Rebuilds _openDocumentsByPath from _openDocuments.
+ */
+function _rebuildPathIndex() {
+    _openDocumentsByPath.clear();
+    for (const id in _openDocuments) {
+        if (_openDocuments.hasOwnProperty(id)) {
+            _openDocumentsByPath.set(_openDocuments[id].file.fullPath, _openDocuments[id]);
+        }
+    }
+}
+
 /**
  * Returns the existing open Document for the given file, or null if the file is not open ('open'
  * means referenced by the UI somewhere). If you will hang onto the Document, you must addRef()
@@ -121,19 +151,13 @@ const _openDocuments: DocumentMap = {};
  * @return {?Document}
  */
 export function getOpenDocumentForPath(fullPath): DocumentModule.Document | null {
-    let id;
-
-    // Need to walk all open documents and check for matching path. We can't
-    // use getFileForPath(fullPath).id since the file it returns won't match
-    // an Untitled document's InMemoryFile.
-    for (id in _openDocuments) {
-        if (_openDocuments.hasOwnProperty(id)) {
-            if (_openDocuments[id].file.fullPath === fullPath) {
-                return _openDocuments[id];
-            }
-        }
+    const doc = _openDocumentsByPath.get(fullPath);
+    if (doc && doc.file.fullPath !== fullPath) {
+        // The file was renamed and we haven't been told yet
+        _rebuildPathIndex();
+        return _openDocumentsByPath.get(fullPath) || null;
     }
-    return null;
+    return doc || null;
 }
 
 /**
@@ -183,13 +207,16 @@ export function findInWorkingSet(fullPath) {
  * @return {Array.<Document>}
  */
 export function getAllOpenDocuments(): Array<DocumentModule.Document> {
-    const result: Array<DocumentModule.Document> = [];
-    for (const id in _openDocuments) {
-        if (_openDocuments.hasOwnProperty(id)) {
-            result.push(_openDocuments[id]);
+    if (!_openDocumentsList) {
+        _openDocumentsList = [];
+        for (const id in _openDocuments) {
+            if (_openDocuments.hasOwnProperty(id)) {
+                _openDocumentsList.push(_openDocuments[id]);
+            }
         }
     }
-    return result;
+    // Callers are free to modify the result, so hand out a copy of the cached list
+    return _openDocumentsList.slice();
 }
 
 
@@ -481,6 +508,7 @@ export function notifyFileDeleted(file) {
     const doc = getOpenDocumentForPath(file.fullPath);
 
     if (doc) {
+        doc._cancelIdleChange();
         (doc as unknown as EventDispatcher.DispatcherEvents).trigger("deleted");
     }
 
@@ -531,6 +559,9 @@ export function notifyPathDeleted(fullPath) {
  * @param {string} newName The new name of the file/folder
  */
 export function notifyPathNameChanged(oldName, newName) {
+    // Renaming a folder changes the path of every Document below it
+    _rebuildPathIndex();
+
     // Notify all open documents
     _.forEach(_openDocuments, function (doc) {
         // TODO: Only notify affected documents? For now _notifyFilePathChange
@@ -582,6 +613,8 @@ function _handleLanguageModified(event, language) {
         }
 
         _openDocuments[doc.file.id] = doc;
+        _openDocumentsByPath.set(doc.file.fullPath, doc);
+        _openDocumentsList = null;
         (exports as unknown as EventDispatcher.DispatcherEvents).trigger("afterDocumentCreate", doc);
     })
     .on("_beforeDocumentDelete", function (event, doc) {
@@ -592,6 +625,12 @@ function _handleLanguageModified(event, language) {
 
         (exports as unknown as EventDispatcher.DispatcherEvents).trigger("beforeDocumentDelete", doc);
         delete _openDocuments[doc.file.id];
+        if (_openDocumentsByPath.get(doc.file.fullPath) === doc) {
+            _openDocumentsByPath.delete(doc.file.fullPath);
+        } else {
+            _rebuildPathIndex();
+        }
+        _openDocumentsList = null;
     })
     .on("_documentRefreshed", function (event, doc) {
         (exports as unknown as EventDispatcher.DispatcherEvents).trigger("documentRefreshed", doc);
@@ -627,6 +666,10 @@ function _handleLanguageModified(event, language) {
         (exports as unknown as EventDispatcher.DispatcherEvents).trigger("documentSaved", doc);
     });
 
+// Keep the path index in sync as soon as the file system reports a rename, even if the renamed
+// entry is outside the project and notifyPathNameChanged() is never called for it
+FileSystem.on("rename", _rebuildPathIndex);
+
 // Set up event dispatch
 EventDispatcher.makeEventDispatcher(exports);
 
@@ -0,0 +1,172 @@
+/*
+ * Copyright (c) 2018 - present The quadre code authors. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ *
+ */
+
+import * as FileUtils from "file/FileUtils";
+import * as CodeMirror from "codemirror";
+
+/**
+ * Immutable view of a Document's text at one point in time, as returned by Document.getSnapshot().
+ *
+ * A snapshot is cheap to create and to hand to background consumers: it shares the underlying
+ * string, and the line index and the original line-ending version of the text are only computed
+ * the first time they are asked for. Lines are looked up through the line index, so getLine() is
+ * O(1) and converting an offset to a position is O(log n) in the number of lines.
+ *
+ * @constructor
+ * @param {!string} text Text with normalized (\n) line endings.
+ * @param {?string} lineEndings The Document's line-ending style.
+ * @param {number} version The Document's change count when the snapshot was taken.
+ * @param {?string=} originalText The text exactly as it was read from disk, if known.
+ */
+export class TextSnapshot {
+    /**
+     * Change count of the Document when this snapshot was taken. Two snapshots of the same
+     * Document with the same version have the same text.
+     * @type {number}
+     */
+    public readonly version: number;
+
+    private _text: string;
+    private _lineEndings: FileUtils.LineEndings | null;
+    private _originalText: string | null;
+
+    /**
+     * Offset of the first character of each line, built on demand.
+     * @type {?Array.<number>}
+     */
+    private _lineStarts: Array<number> | null = null;
+
+    constructor(text: string, lineEndings: FileUtils.LineEndings | null, version: number, originalText?: string | null) {
+        this._text = text;
+        this._lineEndings = lineEndings;
+        this.version = version;
+        this._originalText = originalText || null;
+    }
+
+    /**
+     * Returns the text of the snapshot.
+     * @param {boolean=} useOriginalLineEndings If true, line endings match the Document's line-ending
+     *      style; otherwise they are always \n.
+     * @return {string}
+     */
+    public getText(useOriginalLineEndings = false): string {
+        if (!useOriginalLineEndings) {
+            return this._text;
+        }
+        if (this._originalText === null) {
+            this._originalText = this._lineEndings === FileUtils.LINE_ENDINGS_CRLF
+                ? this._text.replace(/\n/g, "\r\n")
+                : this._text;
+        }
+        return this._originalText;
+    }
+
+    private _getLineStarts(): Array<number> {
+        if (!this._lineStarts) {
+            const lineStarts = [0];
+            const text = this._text;
+            let index = text.indexOf("\n");
+            while (index !== -1) {
+                lineStarts.push(index + 1);
+                index = text.indexOf("\n", index + 1);
+            }
+            this._lineStarts = lineStarts;
+        }
+        return this._lineStarts;
+    }
+
+    /** @return {number} Number of lines in the snapshot */
+    public getLineCount(): number {
+        return this._getLineStarts().length;
+    }
+
+    /**
+     * Returns the text of the given line (excluding any line ending characters)
+     * @param {number} lineNum Zero-based line number
+     * @return {?string} undefined if the line doesn't exist, like CodeMirror's getLine()
+     */
+    public getLine(lineNum: number): string | undefined {
+        const lineStarts = this._getLineStarts();
+        if (lineNum < 0 || lineNum >= lineStarts.length) {
+            return undefined;
+        }
+        const end = lineNum + 1 < lineStarts.length ? lineStarts[lineNum + 1] - 1 : this._text.length;
+        return this._text.slice(lineStarts[lineNum], end);
+    }
+
+    /**
+     * Converts a position to an offset in getText(). Out of range positions are clipped to the
+     * text, the way CodeMirror does.
+     * @param {!{line:number, ch:number}} pos
+     * @return {number}
+     */
+    public indexFromPos(pos: CodeMirror.Position): number {
+        const lineStarts = this._getLineStarts();
+        if (pos.line < 0) {
+            return 0;
+        }
+        if (pos.line >= lineStarts.length) {
+            return this._text.length;
+        }
+        const lineStart = lineStarts[pos.line];
+        const lineEnd = pos.line + 1 < lineStarts.length ? lineStarts[pos.line + 1] - 1 : this._text.length;
+        return lineStart + Math.max(0, Math.min(pos.ch, lineEnd - lineStart));
+    }
+
+    /**
+     * Converts an offset in getText() to a position.
+     * @param {number} index
+     * @return {!{line:number, ch:number}}
+     */
+    public posFromIndex(index: number): CodeMirror.Position {
+        const lineStarts = this._getLineStarts();
+        index = Math.max(0, Math.min(index, this._text.length));
+
+        // Binary search for the last line that starts at or before index
+        let low = 0;
+        let high = lineStarts.length - 1;
+        while (low < high) {
+            const mid = (low + high + 1) >> 1;
+            if (lineStarts[mid] <= index) {
+                low = mid;
+            } else {
+                high = mid - 1;
+            }
+        }
+        return { line: low, ch: index - lineStarts[low] };
+    }
+
+    /**
+     * Returns the characters in the given range. Line endings are normalized to '\n'.
+     * @param {!{line:number, ch:number}} start  Start of range, inclusive
+     * @param {!{line:number, ch:number}} end  End of range, exclusive
+     * @return {!string}
+     */
+    public getRange(start: CodeMirror.Position, end: CodeMirror.Position): string {
+        const startIndex = this.indexFromPos(start);
+        const endIndex = this.indexFromPos(end);
+        return startIndex <= endIndex
+            ? this._text.slice(startIndex, endIndex)
+            : this._text.slice(endIndex, startIndex);
+    }
+}
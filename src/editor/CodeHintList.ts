@@ -156,6 +156,17 @@ export class CodeHintList {
                     .hide())
                 .append("<ul class='dropdown-menu'></ul>");
 
+        // delegate list item events to the top-level ul list element
+        const self = this;
+        this.$hintMenu.find("ul.dropdown-menu").on("click", "li", function (this: HTMLElement, e) {
+            // Don't let the click propagate upward (otherwise it will
+            // hit the close handler in bootstrap-dropdown).
+            e.stopPropagation();
+            if (self.handleSelect) {
+                self.handleSelect($(this).data("hint"));
+            }
+        });
+
         this._keydownHook = this._keydownHook.bind(this);
     }
 
@@ -214,7 +225,8 @@ export class CodeHintList {
     }
 
     /**
-     * Rebuilds the list items for the hint list.
+     * Updates the list items for the hint list. The items that are already in the list are
+     * reused, in order, so typing only changes the content of the items whose hint changed.
      *
      * @private
      */
@@ -222,8 +234,8 @@ export class CodeHintList {
         const self            = this;
         const match           = hintObj.match;
         const selectInitial   = hintObj.selectInitial;
-        const view: ViewHints = { hints: [] };
-        let _addHint;
+        const $ul             = this.$hintMenu.find("ul.dropdown-menu");
+        let _formatHint;
 
         this.hints = hintObj.hints;
         this.hints.handleWideResults = hintObj.handleWideResults;
@@ -232,79 +244,73 @@ export class CodeHintList {
         // if there is no match, assume name is already a formatted jQuery
         // object; otherwise, use match to format name for display.
         if (match) {
-            _addHint = function (name) {
-                const displayName = name.replace(
-                    new RegExp(StringUtils.regexEscape(match), "i"),
-                    "<strong>$&</strong>"
-                );
-
-                view.hints.push({ formattedHint: "<span>" + displayName + "</span>" });
+            const matchRegExp = new RegExp(StringUtils.regexEscape(match), "i");
+            _formatHint = function (name) {
+                return "<span>" + name.replace(matchRegExp, "<strong>$&</strong>") + "</span>";
             };
         } else {
-            _addHint = function (hint) {
-                view.hints.push({ formattedHint: (hint.jquery) ? "" : hint });
+            _formatHint = function (hint) {
+                return hint;
             };
         }
 
-        // clear the list
-        this.$hintMenu.find("li").remove();
-
-        // if there are no hints then close the list; otherwise add them and
+        // if there are no hints then close the list; otherwise update the items and
         // set the selection
         if (this.hints.length === 0) {
+            $ul.children("li").remove();
             if (this.handleClose) {
                 this.handleClose();
             }
         } else {
-            for (let index = 0; index < this.hints.length; index++) {
-                if (index >= self.maxResults) {
-                    break;
+            const count = Math.min(this.hints.length, this.maxResults);
+            let $items = $ul.children("li");
+
+            // the selection is set again below
+            $items.children("a.highlight").removeClass("highlight");
+            this.selectedIndex = -1;
+
+            if ($items.length > count) {
+                $items.slice(count).remove();
+            } else if ($items.length < count) {
+                const view: ViewHints = { hints: [] };
+                for (let index = $items.length; index < count; index++) {
+                    view.hints.push({ formattedHint: "" });
                 }
-
-                const item = this.hints[index];
-                _addHint(item);
+                $ul.append(Mustache.render(CodeHintListHTML, view));
             }
+            $items = $ul.children("li");
 
-            // render code hint list
-            const $ul = this.$hintMenu.find("ul.dropdown-menu");
-            const $parent = $ul.parent();
-
-            // remove list temporarily to save rendering time
-            $ul.remove().append(Mustache.render(CodeHintListHTML, view));
-
-            $ul.children("li").each(function (index, element) {
+            $items.each(function (index, element) {
                 const hint        = self.hints[index];
                 const $element    = $(element);
+                const itemContent = $element.find(".codehint-item")[0];
 
-                // store hint on each list item
-                $element.data("hint", hint);
-
-                // insert jQuery hint objects after the template is rendered
                 if (hint.jquery) {
-                    $element.find(".codehint-item").append(hint as any);
+                    // insert jQuery hint objects, unless the item already shows this one
+                    if (!(hint as any)[0] || (hint as any)[0].parentNode !== itemContent) {
+                        $(itemContent).empty().append(hint as any);
+                    }
+                    $element.removeData("formattedHint");
+                } else {
+                    const formattedHint = _formatHint(hint);
+                    if ($element.data("formattedHint") !== formattedHint) {
+                        $(itemContent).empty();
+                        itemContent.innerHTML = formattedHint;
+                        $element.data("formattedHint", formattedHint);
+                    }
                 }
-            });
 
-            // delegate list item events to the top-level ul list element
-            $ul.on("click", "li", function (this: CodeHintList, e) {
-                // Don't let the click propagate upward (otherwise it will
-                // hit the close handler in bootstrap-dropdown).
-                e.stopPropagation();
-                if (self.handleSelect) {
-                    self.handleSelect($(this).data("hint"));
-                }
+                // store hint on each list item
+                $element.data("hint", hint);
             });
 
             // Lists with wide results require different formatting
-            if (this.hints.handleWideResults) {
-                $ul.find("li a").addClass("wide-result");
-            }
-
-            // attach to DOM
-            $parent.append($ul);
+            $items.children("a").toggleClass("wide-result", !!this.hints.handleWideResults);
 
             // If a a description field requested attach one
             if (this.enableDescription) {
+                const $parent = $ul.parent();
+
                 // Remove the desc element first to ensure DOM order
                 $parent.find("#codehint-desc").remove();
                 $parent.append("<div id='codehint-desc' class='dropdown-menu quiet-scrollbars'></div>");
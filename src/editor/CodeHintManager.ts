@@ -237,6 +237,7 @@ import * as Strings from "strings";
 import * as KeyEvent from "utils/KeyEvent";
 import { CodeHintList, HintObject } from "editor/CodeHintList";
 import * as PreferencesManager from "preferences/PreferencesManager";
+import * as ExtensionMonitor from "utils/ExtensionMonitor";
 import { DispatcherEvents } from "utils/EventDispatcher";
 import { Editor } from "editor/Editor";
 
@@ -308,6 +309,8 @@ export function registerHintProvider(providerInfo: CodeHintProvider, languageIds
         priority: priority || 0
     };
 
+    ExtensionMonitor.attribute(providerInfo);
+
     if (languageIds.indexOf("all") !== -1) {
         // Ignore anything else in languageIds and just register for every language. This includes
         // the special "all" language since its key is in the hintProviders map from the beginning.
@@ -440,7 +443,7 @@ function _updateHintList(callMoveUpEvent?) {
         return hintList!.callMoveUp(callMoveUpEvent);
     }
 
-    const response = sessionProvider!.getHints(lastChar);
+    const response = ExtensionMonitor.invoke(sessionProvider!, "getHints", sessionProvider!.getHints, sessionProvider, [lastChar]);
     lastChar = null;
 
     if (!response) {
@@ -502,7 +505,7 @@ const _beginSession = function (editor) {
     const enabledProviders = _getProvidersForLanguageId(language.getId());
 
     for (const item of enabledProviders) {
-        if (item.provider.hasHints(editor, lastChar)) {
+        if (ExtensionMonitor.invoke(item.provider, "hasHints", item.provider.hasHints, item.provider, [editor, lastChar])) {
             sessionProvider = item.provider;
             break;
         }
@@ -542,7 +545,7 @@ const _beginSession = function (editor) {
             }
         });
         hintList.onSelect(function (hint) {
-            const restart = sessionProvider!.insertHint(hint);
+            const restart = ExtensionMonitor.invoke(sessionProvider!, "insertHint", sessionProvider!.insertHint, sessionProvider, [hint]);
             const previousEditor = sessionEditor;
             _endSession();
             if (restart) {
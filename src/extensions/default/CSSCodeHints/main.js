@@ -39,7 +39,8 @@ define(function (require, exports, module) {
         ColorUtils          = brackets.getModule("utils/ColorUtils"),
         Strings             = brackets.getModule("strings"),
         CSSProperties       = require("text!CSSProperties.json"),
-        properties          = JSON.parse(CSSProperties);
+        properties          = JSON.parse(CSSProperties),
+        propertyNames       = Object.keys(properties);
 
 
     PreferencesManager.definePreference("codehint.CssPropHints", "boolean", true, {
@@ -58,6 +59,9 @@ define(function (require, exports, module) {
         this.primaryTriggerKeys = "abcdefghijklmnopqrstuvwxyzABCDEFGHIJKLMNOPQRSTUVWXYZ-()";
         this.secondaryTriggerKeys = ":";
         this.exclusion = null;
+
+        // Candidates that matched the previous query of this hinting session, see matchCandidates()
+        this.hintCache = null;
     }
 
     /**
@@ -110,6 +114,40 @@ define(function (require, exports, module) {
         return this.namedFlowsCache.flows;
     };
 
+    /**
+     * Match a list of candidates against the query. If the query extends the previous query for
+     * the same list, only the candidates that matched the previous query are matched again, since
+     * StringMatch can't match a longer query where a prefix of it didn't match.
+     *
+     * @param {?string} key Identifies the list of candidates, null if it must not be cached
+     * @param {Array.<string|{text: string, color: string}>} candidates
+     * @param {string} query
+     * @return {Array.<SearchResult>} Unsorted match results, with the color of color candidates
+     */
+    CssPropHints.prototype.matchCandidates = function (key, candidates, query) {
+        var cache = this.hintCache,
+            matched = [],
+            results = [];
+
+        if (key && cache && cache.key === key && query.indexOf(cache.query) === 0) {
+            candidates = cache.candidates;
+        }
+
+        candidates.forEach(function (candidate) {
+            var result = StringMatch.stringMatch(candidate.text || candidate, query, stringMatcherOptions);
+            if (result) {
+                if (candidate.color) {
+                    result.color = candidate.color;
+                }
+                matched.push(candidate);
+                results.push(result);
+            }
+        });
+
+        this.hintCache = key ? { key: key, query: query, candidates: matched } : null;
+        return results;
+    };
+
     /**
      * Check whether the exclusion is still the same as text after the cursor.
      * If not, reset it to null.
@@ -154,6 +192,7 @@ define(function (require, exports, module) {
         var cursor = this.editor.getCursorPos();
 
         lastContext = null;
+        this.hintCache = null;
         this.info = CSSUtils.getInfoAtPos(editor, cursor);
 
         if (this.info.context !== CSSUtils.PROP_NAME && this.info.context !== CSSUtils.PROP_VALUE) {
@@ -313,16 +352,8 @@ define(function (require, exports, module) {
                 valueArray.push("transparent", "currentColor");
             }
 
-            result = $.map(valueArray, function (pvalue) {
-                var result = StringMatch.stringMatch(pvalue.text || pvalue, valueNeedle, stringMatcherOptions);
-                if (result) {
-                    if (pvalue.color) {
-                        result.color = pvalue.color;
-                    }
-
-                    return result;
-                }
-            });
+            // Named flows depend on the document and on what is typed, don't narrow them
+            result = this.matchCandidates(type === "named-flow" ? null : "value:" + needle, valueArray, valueNeedle);
 
             return {
                 hints: formatHints(result, valueNeedle),
@@ -347,12 +378,7 @@ define(function (require, exports, module) {
             lastContext = CSSUtils.PROP_NAME;
             needle = needle.substr(0, this.info.offset);
 
-            result = $.map(properties, function (pvalues, pname) {
-                var result = StringMatch.stringMatch(pname, needle, stringMatcherOptions);
-                if (result) {
-                    return result;
-                }
-            });
+            result = this.matchCandidates("name", propertyNames, needle);
 
             return {
                 hints: formatHints(result, needle),
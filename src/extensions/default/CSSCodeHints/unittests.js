@@ -239,6 +239,33 @@ define(function (require, exports, module) {
                 testEditor.setCursorPos({ line: 0, ch: 1 });
                 expect(CSSCodeHints.cssPropHintProvider.hasHints(testEditor, "m")).toBe(false);
             });
+
+            it("should narrow the prop-name hints of a session while typing", function () {
+                var provider = CSSCodeHints.cssPropHintProvider,
+                    narrowed,
+                    widened;
+
+                testDocument.replaceRange("b", { line: 5, ch: 1 });
+                testEditor.setCursorPos({ line: 5, ch: 2 });
+                expectHints(provider);
+
+                // keep typing in the same session
+                testDocument.replaceRange("or", { line: 5, ch: 2 });
+                testEditor.setCursorPos({ line: 5, ch: 4 });
+                narrowed = extractHintList(provider.getHints().hints);
+
+                // delete a character, which widens the query again
+                testDocument.replaceRange("", { line: 5, ch: 3 }, { line: 5, ch: 4 });
+                testEditor.setCursorPos({ line: 5, ch: 3 });
+                widened = extractHintList(provider.getHints().hints);
+
+                // a new session matches all properties
+                expect(widened).toEqual(expectHints(provider));
+                testDocument.replaceRange("r", { line: 5, ch: 3 });
+                testEditor.setCursorPos({ line: 5, ch: 4 });
+                expect(narrowed).toEqual(expectHints(provider));
+                expect(narrowed.length).toBeLessThan(widened.length);
+            });
         });
 
         describe("CSS property hint insertion", function () {
@@ -6,13 +6,26 @@
 define(function (require, exports, module) {
     "use strict";
     var CodeMirror      = brackets.getModule("thirdparty/CodeMirror/lib/codemirror"),
+        _               = brackets.getModule("thirdparty/lodash"),
         prefs           = require("Prefs");
 
     function State(options) {
         this.options = options;
         this.from = this.to = 0;
+        this.resetRanges();
     }
 
+    /**
+     * Forgets the ranges found by the range finder, e.g. when the whole document or its mode changes
+     */
+    State.prototype.resetRanges = function () {
+        // The ranges of the lines the range finder found one for, by line
+        this.ranges = {};
+        // Handles of the lines the range finder found no range for since the last edit. Most lines
+        // are not foldable, line handles move with edits so these never have to be renumbered.
+        this.noRange = new WeakSet();
+    };
+
     function parseOptions(opts) {
         if (opts === true) { opts = {}; }
         if (!opts.gutter) { opts.gutter = "CodeMirror-foldgutter"; }
@@ -41,6 +54,86 @@ define(function (require, exports, module) {
         return m.__isFold;
     }
 
+    /**
+     * Returns the range the range finder finds at a line. The result is cached until the line or
+     * the lines the range depends on are edited, see invalidateRanges.
+     * @param {!CodeMirror} cm the CodeMirror instance for the active editor
+     * @param {!number} line
+     * @return {?{from: CodeMirror.Pos, to: CodeMirror.Pos}}
+     */
+    function findRange(cm, line) {
+        var state = cm.state.foldGutter,
+            func = state.options.rangeFinder || CodeMirror.fold.auto,
+            handle = cm.getLineHandle(line),
+            range;
+
+        if (!func) {
+            return undefined;
+        }
+        // Selections are foldable too, don't cache the ranges that depend on the selection
+        if (cm.somethingSelected() && cm.getCursor("from").line === line) {
+            return func(cm, CodeMirror.Pos(line, 0));
+        }
+        if (state.noRange.has(handle)) {
+            return undefined;
+        }
+        if (state.ranges.hasOwnProperty(line)) {
+            return state.ranges[line];
+        }
+
+        range = func(cm, CodeMirror.Pos(line, 0));
+        if (range) {
+            state.ranges[line] = range;
+        } else {
+            state.noRange.add(handle);
+        }
+        return range;
+    }
+
+    /**
+     * Builds an index of the folded ranges that answers which range hides a line in O(log n).
+     * Only ranges that end after all ranges starting before them are kept: the first of those
+     * that ends at or after a line is the first range that could hide it.
+     * @param {!Object} lineFolds the folded ranges by line, cm._lineFolds
+     * @return {!Array.<{from: CodeMirror.Pos, to: CodeMirror.Pos}>} sorted by start and end
+     */
+    function indexFolds(lineFolds) {
+        var maxTo = -1;
+
+        return Object.keys(lineFolds).map(function (line) {
+            return lineFolds[line];
+        }).sort(function (a, b) {
+            return a.from.line - b.from.line;
+        }).filter(function (range) {
+            if (range.to.line > maxTo) {
+                maxTo = range.to.line;
+                return true;
+            }
+            return false;
+        });
+    }
+
+    /**
+     * Returns the folded range that hides a line
+     * @param {!Array} index the folded ranges, as returned by indexFolds
+     * @param {!number} line
+     * @return {Object} the range that hides the line or undefined if the line is not hidden
+     */
+    function findFoldHiding(index, line) {
+        var low = 0, high = index.length, mid;
+        while (low < high) {
+            mid = Math.floor((low + high) / 2);
+            if (index[mid].to.line < line) {
+                low = mid + 1;
+            } else {
+                high = mid;
+            }
+        }
+        if (low < index.length && index[low].from.line < line) {
+            return index[low];
+        }
+    }
+
     /**
       * Updates the gutter markers for the specified range
       * @param {!CodeMirror} cm the CodeMirror instance for the active editor
@@ -52,29 +145,13 @@ define(function (require, exports, module) {
         var opts = cm.state.foldGutter.options;
         var fade = prefs.getSetting("hideUntilMouseover");
         var $gutter = $(cm.getGutterElement());
+        var folds = indexFolds(cm._lineFolds);
         var i = from;
 
         function clear(m) {
             return m.clear();
         }
 
-        /**
-          * @private
-          * helper function to check if the given line is in a folded region in the editor.
-          * @param {number} line the
-          * @return {Object} the range that hides the specified line or undefine if the line is not hidden
-          */
-        function _isCurrentlyFolded(line) {
-            var keys = Object.keys(cm._lineFolds), i = 0, range;
-            while (i < keys.length) {
-                range = cm._lineFolds[keys[i]];
-                if (range.from.line < line && range.to.line >= line) {
-                    return range;
-                }
-                i++;
-            }
-        }
-
         /**
             This case is needed when unfolding a region that does not cause the viewport to change.
             For instance in a file with about 15 lines, if some code regions are folded and unfolded, the
@@ -89,16 +166,15 @@ define(function (require, exports, module) {
         }
 
         while (i < to) {
-            var sr = _isCurrentlyFolded(i), // surrounding range for the current line if one exists
+            var sr = findFoldHiding(folds, i), // surrounding range for the current line if one exists
                 range;
             var mark = marker("CodeMirror-foldgutter-blank");
-            var pos = CodeMirror.Pos(i, 0),
-                func = opts.rangeFinder || CodeMirror.fold.auto;
+            var pos = CodeMirror.Pos(i, 0);
             // don't look inside collapsed ranges
             if (sr) {
                 i = sr.to.line + 1;
             } else {
-                range = cm._lineFolds[i] || (func && func(cm, pos));
+                range = cm._lineFolds[i] || findRange(cm, i);
 
                 if (!fade || (fade && $gutter.is(":hover"))) {
                     if (cm.isFolded(i)) {
@@ -252,6 +328,115 @@ define(function (require, exports, module) {
         }
     }
 
+    /**
+     * Returns the state of the mode after the given lines, starting from a copy of the given state
+     * @param {!CodeMirror} cm the CodeMirror instance for the active editor
+     * @param {*} startState the state of the mode before the first line
+     * @param {!Array.<string>} lines
+     * @return {*} the state, or null if the mode failed to tokenize the lines
+     */
+    function stateAfterLines(cm, startState, lines) {
+        var mode = cm.getMode(),
+            tabSize = cm.getOption("tabSize"),
+            state = CodeMirror.copyState(mode, startState);
+
+        try {
+            lines.forEach(function (text) {
+                var stream = new CodeMirror.StringStream(text, tabSize);
+                if (!text && mode.blankLine) {
+                    mode.blankLine(state);
+                }
+                while (!stream.eol()) {
+                    mode.token(stream, state);
+                    if (stream.pos === stream.start) {
+                        stream.next();
+                    }
+                    stream.start = stream.pos;
+                }
+            });
+        } catch (err) {
+            return null;
+        }
+        return state;
+    }
+
+    /**
+     * Checks whether the mode ends the edited lines in the same state as before the edit. The range
+     * finders look at the tokens of the lines below their start, so when the state changed (e.g. an
+     * unclosed comment or template string was typed) the ranges below the edit may have changed too.
+     * @param {!CodeMirror} cm the CodeMirror instance for the active editor
+     * @param {!Object} changeObj the change, as passed to the change event
+     * @return {boolean} true if the lines below the edit are tokenized as before
+     */
+    function isModeStateKept(cm, changeObj) {
+        var mode = cm.getMode(),
+            from = changeObj.from.line,
+            to = from + changeObj.text.length - 1,
+            firstLine = cm.getLine(from),
+            lastLine = cm.getLine(to),
+            endCh,
+            oldLines,
+            startState,
+            oldState;
+
+        if (!mode.startState) {
+            return true;
+        }
+        if (firstLine === undefined || lastLine === undefined) {
+            // Other changes of the same operation moved the lines
+            return false;
+        }
+
+        // The lines as they were: the removed text between what is left of the first and last line
+        endCh = (from === to ? changeObj.from.ch : 0) + changeObj.text[changeObj.text.length - 1].length;
+        oldLines = (firstLine.slice(0, changeObj.from.ch) + changeObj.removed.join("\n") + lastLine.slice(endCh)).split("\n");
+
+        startState = from > cm.firstLine() ? cm.getStateAfter(from - 1, true) : CodeMirror.startState(mode);
+        oldState = stateAfterLines(cm, startState, oldLines);
+        return oldState !== null &&
+            _.isEqual(oldState, stateAfterLines(cm, startState, cm.getRange(CodeMirror.Pos(from, 0), CodeMirror.Pos(to)).split("\n")));
+    }
+
+    /**
+     * Drops the cached ranges that an edit may have changed and renumbers the others.
+     * The ranges of the lines below the edit stay valid as long as the mode ends the edited lines
+     * in the same state as before, see isModeStateKept; otherwise they are all dropped. Ranges above
+     * the edit stay valid unless they reach the edit; since indentation folds end at the last
+     * non-blank line, that means reaching the last non-blank line above the edit. Any line above the
+     * edit that had no range may get one though (e.g. when the closing brace of a block that starts
+     * far above is typed), and handles can't tell where their line is, so all lines without a range
+     * are looked at again.
+     * @param {!CodeMirror} cm the CodeMirror instance for the active editor
+     * @param {!Object} changeObj the change, as passed to the change event
+     */
+    function invalidateRanges(cm, changeObj) {
+        var state = cm.state.foldGutter,
+            from = changeObj.from.line,
+            oldTo = from + changeObj.removed.length,
+            linesDiff = changeObj.text.length - changeObj.removed.length,
+            keepBelow = isModeStateKept(cm, changeObj),
+            lastAbove = from - 1,
+            ranges = {};
+
+        while (lastAbove > 0 && !/\S/.test(cm.getLine(lastAbove))) {
+            lastAbove--;
+        }
+
+        Object.keys(state.ranges).forEach(function (key) {
+            var line = +key,
+                range = state.ranges[key];
+            if (line < from) {
+                if (range.to.line < lastAbove) {
+                    ranges[line] = range;
+                }
+            } else if (line >= oldTo && keepBelow) {
+                ranges[line + linesDiff] = linesDiff ? moveRange(range, linesDiff) : range;
+            }
+        });
+        state.ranges = ranges;
+        state.noRange = new WeakSet();
+    }
+
     /**
       * Triggered when the content of the document changes. When the entire content of the document
       * is changed - e.g., changes made from a different editor, the same lineFolds are kept only if
@@ -261,6 +446,7 @@ define(function (require, exports, module) {
       */
     function onChange(cm, changeObj) {
         if (changeObj.origin === "setValue") { // text content has changed outside of brackets
+            cm.state.foldGutter.resetRanges();
             var folds = cm.getValidFolds(cm._lineFolds);
             cm._lineFolds = folds;
             Object.keys(folds).forEach(function (line) {
@@ -269,6 +455,7 @@ define(function (require, exports, module) {
         } else {
             var state = cm.state.foldGutter;
             var lineChanges = changeObj.text.length - changeObj.removed.length;
+            invalidateRanges(cm, changeObj);
             // for undo actions that add new line(s) to the document first update the folds cache as normal
             // and then update the folds cache with any line folds that exist in the new lines
             if (changeObj.origin === "undo" && lineChanges > 0) {
@@ -360,6 +547,26 @@ define(function (require, exports, module) {
         updateFoldInfo(cm, from.line, to.line || vp.to);
     }
 
+    /**
+      * Triggered when the editor shows another document.
+      * @param {!CodeMirror} cm the CodeMirror instance for the active editor
+      */
+    function onSwapDoc(cm) {
+        cm.state.foldGutter.resetRanges();
+        updateInViewport(cm);
+    }
+
+    /**
+      * Triggered when an option of the editor changes. Range finders depend on the mode.
+      * @param {!CodeMirror} cm the CodeMirror instance for the active editor
+      * @param {!string} option the name of the option
+      */
+    function onOptionChange(cm, option) {
+        if (option === "mode" && cm.state.foldGutter) {
+            cm.state.foldGutter.resetRanges();
+        }
+    }
+
     /**
       * Initialises the fold gutter and registers event handlers for changes to document, viewport
       * and user interactions.
@@ -376,7 +583,8 @@ define(function (require, exports, module) {
 
                 cm.off("fold", onFold);
                 cm.off("unfold", onUnFold);
-                cm.off("swapDoc", updateInViewport);
+                cm.off("swapDoc", onSwapDoc);
+                cm.off("optionChange", onOptionChange);
             }
             if (val) {
                 cm.state.foldGutter = new State(parseOptions(val));
@@ -387,7 +595,8 @@ define(function (require, exports, module) {
                 cm.on("cursorActivity", onCursorActivity);
                 cm.on("fold", onFold);
                 cm.on("unfold", onUnFold);
-                cm.on("swapDoc", updateInViewport);
+                cm.on("swapDoc", onSwapDoc);
+                cm.on("optionChange", onOptionChange);
             }
         });
     }
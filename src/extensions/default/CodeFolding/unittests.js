@@ -542,6 +542,104 @@ define(function (require, exports, module) {
                             expect(marks.length).toEqual(0);
                         });
                     });
+
+                    it("moves the foldable lines in the gutter when a line is added above them", function () {
+                        var updateTimeoutElapsed = false;
+
+                        runs(function () {
+                            cm.replaceRange("\n", {line: 0, ch: 0});
+                            setTimeout(function () {
+                                updateTimeoutElapsed = true;
+                            }, 700);
+                        });
+
+                        waitsFor(function () {
+                            return updateTimeoutElapsed;
+                        }, "waiting for the gutter to be updated after the change", 1000);
+
+                        runs(function () {
+                            var gutterNumbers = getGutterFoldMarks().filter(filterOpen)
+                                .map(getLineNumber);
+                            expect(gutterNumbers).toEqual(foldableLines);
+                        });
+                    });
+
+                    if (file === "js") {
+                        it("shows a fold mark on a line far above an edit that closes its block", function () {
+                            var updateTimeoutElapsed = false,
+                                i,
+                                lines = ["var block = ["];
+
+                            // Long enough that the end of the block is out of the viewport. Not
+                            // indented, so that only the brace range finder can fold the first line.
+                            for (i = 0; i < 200; i++) {
+                                lines.push(i + ",");
+                            }
+
+                            runs(function () {
+                                cm.replaceRange(lines.join("\n") + "\n", {line: 0, ch: 0});
+                                setTimeout(function () {
+                                    updateTimeoutElapsed = true;
+                                }, 700);
+                            });
+
+                            waitsFor(function () {
+                                return updateTimeoutElapsed;
+                            }, "waiting for the gutter to be updated after the change", 1000);
+
+                            runs(function () {
+                                expect(getGutterFoldMarks().filter(filterOpen).map(getLineNumber)).not.toContain(0);
+
+                                updateTimeoutElapsed = false;
+                                cm.replaceRange("];\n", {line: lines.length, ch: 0});
+                                setTimeout(function () {
+                                    updateTimeoutElapsed = true;
+                                }, 700);
+                            });
+
+                            waitsFor(function () {
+                                return updateTimeoutElapsed;
+                            }, "waiting for the gutter to be updated after the change", 1000);
+
+                            runs(function () {
+                                expect(getGutterFoldMarks().filter(filterOpen).map(getLineNumber)).toContain(0);
+                            });
+                        });
+
+                        it("removes the fold marks of the lines below an edit that opens a comment", function () {
+                            var updateTimeoutElapsed = false;
+
+                            runs(function () {
+                                cm.replaceRange("// comment\nfunction opened() {\n    a();\n    b();\n    c();\n}\n", {line: 0, ch: 0});
+                                setTimeout(function () {
+                                    updateTimeoutElapsed = true;
+                                }, 700);
+                            });
+
+                            waitsFor(function () {
+                                return updateTimeoutElapsed;
+                            }, "waiting for the gutter to be updated after the change", 1000);
+
+                            runs(function () {
+                                expect(getGutterFoldMarks().filter(filterOpen).map(getLineNumber)).toContain(1);
+
+                                // The edit is on the line above the block, the block becomes part of the comment
+                                updateTimeoutElapsed = false;
+                                cm.replaceRange("/*", {line: 0, ch: 0}, {line: 0, ch: 2});
+                                setTimeout(function () {
+                                    updateTimeoutElapsed = true;
+                                }, 700);
+                            });
+
+                            waitsFor(function () {
+                                return updateTimeoutElapsed;
+                            }, "waiting for the gutter to be updated after the change", 1000);
+
+                            runs(function () {
+                                expect(getGutterFoldMarks().filter(filterOpen).map(getLineNumber)).not.toContain(1);
+                            });
+                        });
+                    }
                 });
             });
         });
@@ -0,0 +1,108 @@
+/*
+ * Copyright (c) 2018 - present The quadre code authors. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ *
+ */
+
+define(function (require, exports, module) {
+    "use strict";
+
+    var ExtensionMonitor    = brackets.getModule("utils/ExtensionMonitor"),
+        WorkspaceManager    = brackets.getModule("view/WorkspaceManager"),
+        Mustache            = brackets.getModule("thirdparty/mustache/mustache"),
+        PanelTemplate       = require("text!htmlContent/extension-performance-panel.html"),
+        TableTemplate       = require("text!htmlContent/extension-performance-table.html");
+
+    var PANEL_ID = "debug.extension-performance",
+        REFRESH_INTERVAL = 1000;
+
+    var panel = null,
+        refreshTimer = null;
+
+    function round(value) {
+        return Math.round(value * 10) / 10;
+    }
+
+    function render() {
+        var stats = ExtensionMonitor.getStats().map(function (entry) {
+            return {
+                name: entry.name,
+                calls: entry.calls,
+                avg: round(entry.avg),
+                p95: round(entry.p95),
+                max: round(entry.max),
+                allocatedPerCall: round(entry.allocatedPerCall / 1024),
+                slowestCall: entry.slowestCall,
+                skipped: entry.skipped,
+                state: entry.state,
+                suspended: entry.state !== "ok"
+            };
+        });
+
+        panel.$panel.find(".monitor-off").toggle(!ExtensionMonitor.isEnabled());
+        panel.$panel.find(".table-container").html(Mustache.render(TableTemplate, { stats: stats }));
+    }
+
+    function hide() {
+        if (panel) {
+            panel.hide();
+        }
+        window.clearInterval(refreshTimer);
+        refreshTimer = null;
+    }
+
+    function createPanel() {
+        panel = WorkspaceManager.createBottomPanel(PANEL_ID, $(PanelTemplate), 100);
+        panel.$panel
+            .on("click", ".close", function () {
+                hide();
+                return false;
+            })
+            .on("click", ".reset-stats", function () {
+                ExtensionMonitor.reset();
+                render();
+            })
+            .on("click", ".resume", function () {
+                ExtensionMonitor.resume($(this).data("extension"));
+                render();
+                return false;
+            });
+    }
+
+    /**
+     * Shows the panel, or hides it if it is visible. The panel is refreshed every second while visible.
+     */
+    function toggle() {
+        if (panel && panel.isVisible()) {
+            hide();
+            return;
+        }
+
+        if (!panel) {
+            createPanel();
+        }
+        panel.show();
+        render();
+        refreshTimer = window.setInterval(render, REFRESH_INTERVAL);
+    }
+
+    // Public API
+    exports.toggle = toggle;
+});
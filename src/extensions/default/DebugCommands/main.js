@@ -45,6 +45,7 @@ define(function (require, exports, module) {
         ExtensionManager       = brackets.getModule("extensibility/ExtensionManager"),
         Mustache               = brackets.getModule("thirdparty/mustache/mustache"),
         ErrorNotification      = require("ErrorNotification"),
+        ExtensionPerfPanel     = require("ExtensionPerformancePanel"),
         PerfDialogTemplate     = require("text!htmlContent/perf-dialog.html"),
         LanguageDialogTemplate = require("text!htmlContent/language-dialog.html");
 
@@ -71,6 +72,7 @@ define(function (require, exports, module) {
         DEBUG_SHOW_DEVELOPER_TOOLS            = "debug.showDeveloperTools",
         DEBUG_RUN_UNIT_TESTS                  = "debug.runUnitTests",
         DEBUG_SHOW_PERF_DATA                  = "debug.showPerfData",
+        DEBUG_SHOW_EXTENSION_PERF             = "debug.showExtensionPerformance",
         DEBUG_RELOAD_WITHOUT_USER_EXTS        = "debug.reloadWithoutUserExts",
         DEBUG_NEW_BRACKETS_WINDOW             = "debug.newBracketsWindow",
         DEBUG_SWITCH_LANGUAGE                 = "debug.switchLanguage",
@@ -763,6 +765,7 @@ define(function (require, exports, module) {
         .setEnabled(false);
 
     CommandManager.register(Strings.CMD_SHOW_PERF_DATA,            DEBUG_SHOW_PERF_DATA,            handleShowPerfData);
+    CommandManager.register(Strings.CMD_SHOW_EXTENSION_PERF,       DEBUG_SHOW_EXTENSION_PERF,       ExtensionPerfPanel.toggle);
 
     // Open Brackets Source (optionally enabled)
     CommandManager.register(Strings.CMD_OPEN_BRACKETS_SOURCE,      DEBUG_OPEN_BRACKETS_SOURCE,      handleOpenBracketsSource)
@@ -793,6 +796,7 @@ define(function (require, exports, module) {
     menu.addMenuDivider();
     menu.addMenuItem(DEBUG_RUN_UNIT_TESTS);
     menu.addMenuItem(DEBUG_SHOW_PERF_DATA);
+    menu.addMenuItem(DEBUG_SHOW_EXTENSION_PERF);
     menu.addMenuItem(DEBUG_OPEN_BRACKETS_SOURCE);
     menu.addMenuDivider();
     menu.addMenuItem(DEBUG_SHOW_ERRORS_IN_STATUS_BAR);
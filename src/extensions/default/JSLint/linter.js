@@ -0,0 +1,76 @@
+/*
+ * Copyright (c) 2018 - present The quadre code authors. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ *
+ */
+
+/*global JSLINT */
+
+/**
+ * Runs JSLint on a text and turns its errors into code inspection results. Used by the
+ * JSLint provider both in inspection workers (through JSLintWorker) and on the main thread.
+ */
+define(function (require, exports, module) {
+    "use strict";
+
+    // Load JSLint, a non-module lib
+    require("thirdparty/jslint/jslint");
+
+    /**
+     * @param {string} text
+     * @param {!Object} options JSLint options
+     * @param {!Object} Type The CodeInspection.Type constants
+     * @return {?{errors: !Array, aborted: boolean}}
+     */
+    function lint(text, options, Type) {
+        // If a line contains only whitespace (here spaces or tabs), remove the whitespace
+        text = text.replace(/^[ \t]+$/gm, "");
+
+        // eslint-disable-next-line new-cap
+        var jslintResult = JSLINT(text, options);
+
+        if (!jslintResult) {
+            // Remove any trailing null placeholder (early-abort indicator)
+            var errors = JSLINT.errors.filter(function (err) { return err !== null; });
+
+            errors = errors.map(function (jslintError) {
+                return {
+                    // JSLint returns 1-based line/col numbers
+                    pos: { line: jslintError.line - 1, ch: jslintError.character - 1 },
+                    message: jslintError.reason,
+                    type: Type.WARNING
+                };
+            });
+
+            var result = { errors: errors };
+
+            // If array terminated in a null it means there was a stop notice
+            if (errors.length !== JSLINT.errors.length) {
+                result.aborted = true;
+                errors[errors.length - 1].type = Type.META;
+            }
+
+            return result;
+        }
+        return null;
+    }
+
+    exports.lint = lint;
+});
@@ -22,23 +22,20 @@
  *
  */
 
-/*global JSLINT */
-
 /**
  * Provides JSLint results via the core linting extension point
  */
 define(function (require, exports, module) {
     "use strict";
 
-    // Load JSLint, a non-module lib
-    require("thirdparty/jslint/jslint");
-
     // Load dependent modules
     var CodeInspection     = brackets.getModule("language/CodeInspection"),
         Editor             = brackets.getModule("editor/Editor").Editor,
+        ExtensionUtils     = brackets.getModule("utils/ExtensionUtils"),
         PreferencesManager = brackets.getModule("preferences/PreferencesManager"),
         Strings            = brackets.getModule("strings"),
-        _                  = brackets.getModule("thirdparty/lodash");
+        _                  = brackets.getModule("thirdparty/lodash"),
+        linter             = require("linter");
 
     var prefs = PreferencesManager.getExtensionPrefs("jslint");
 
@@ -213,13 +210,10 @@ define(function (require, exports, module) {
     }
 
     /**
-     * Run JSLint on the current document. Reports results to the main UI. Displays
-     * a gold star when no errors are found.
+     * Returns the JSLint options for a file: the user's options, with the editor's indentation
+     * and the browser environment by default.
      */
-    function lintOneFile(text, fullPath) {
-        // If a line contains only whitespace (here spaces or tabs), remove the whitespace
-        text = text.replace(/^[ \t]+$/gm, "");
-
+    function getOptions(fullPath) {
         var options = prefs.get("options");
 
         _lastRunOptions = _.clone(options);
@@ -244,38 +238,22 @@ define(function (require, exports, module) {
             options.browser = true;
         }
 
-        // eslint-disable-next-line new-cap
-        var jslintResult = JSLINT(text, options);
-
-        if (!jslintResult) {
-            // Remove any trailing null placeholder (early-abort indicator)
-            var errors = JSLINT.errors.filter(function (err) { return err !== null; });
-
-            errors = errors.map(function (jslintError) {
-                return {
-                    // JSLint returns 1-based line/col numbers
-                    pos: { line: jslintError.line - 1, ch: jslintError.character - 1 },
-                    message: jslintError.reason,
-                    type: CodeInspection.Type.WARNING
-                };
-            });
-
-            var result = { errors: errors };
-
-            // If array terminated in a null it means there was a stop notice
-            if (errors.length !== JSLINT.errors.length) {
-                result.aborted = true;
-                errors[errors.length - 1].type = CodeInspection.Type.META;
-            }
+        return options;
+    }
 
-            return result;
-        }
-        return null;
+    /**
+     * Run JSLint on the current document on the main thread, when inspection workers
+     * aren't available. Reports results to the main UI.
+     */
+    function lintOneFile(text, fullPath) {
+        return linter.lint(text, getOptions(fullPath), CodeInspection.Type);
     }
 
-    // Register for JS files
+    // Register for JS files. JSLint runs in inspection workers, see JSLintWorker.
     CodeInspection.register("javascript", {
         name: Strings.JSLINT_NAME,
+        workerModule: ExtensionUtils.getModuleUrl(module, "JSLintWorker.js"),
+        getWorkerOptions: getOptions,
         scanFile: lintOneFile
     });
 });
@@ -38,6 +38,13 @@ define(function (require, exports, module) {
             // eslint-disable-next-line no-unused-vars
             EditorManager;
 
+        // JSLint runs in inspection workers, wait until the status icon shows its results
+        function waitsForInspection(style) {
+            waitsFor(function () {
+                return $("#status-inspection").hasClass(style);
+            }, "inspection results", 5000);
+        }
+
         var toggleJSLintResults = function (visible) {
             $("#status-inspection").triggerHandler("click");
             expect($("#problems-panel").is(":visible")).toBe(visible);
@@ -70,16 +77,14 @@ define(function (require, exports, module) {
         });
 
         it("should run JSLint linter when a JavaScript document opens", function () {
-            runs(function () {
-                spyOn(testWindow, "JSLINT").andCallThrough();
-            });
-
             runs(function () {
                 waitsForDone(SpecRunnerUtils.openProjectFiles(["errors.js"]), "open test file");
             });
 
+            waitsForInspection("inspection-errors");
+
             runs(function () {
-                expect(testWindow.JSLINT).toHaveBeenCalled();
+                expect($("#problems-panel .table-container tr").length).toBeGreaterThan(0);
             });
         });
 
@@ -87,6 +92,9 @@ define(function (require, exports, module) {
             runs(function () {
                 waitsForDone(SpecRunnerUtils.openProjectFiles(["errors.js"]), "open test file");
             });
+
+            waitsForInspection("inspection-errors");
+
             runs(function () {
                 toggleJSLintResults(false);
                 toggleJSLintResults(true);
@@ -98,6 +106,8 @@ define(function (require, exports, module) {
                 waitsForDone(SpecRunnerUtils.openProjectFiles(["no-errors.js"]), "open test file");
             });
 
+            waitsForInspection("inspection-valid");
+
             runs(function () {
                 toggleJSLintResults(false);
                 toggleJSLintResults(false);
@@ -109,6 +119,8 @@ define(function (require, exports, module) {
                 waitsForDone(SpecRunnerUtils.openProjectFiles(["different-indent.js"]), "open test file");
             });
 
+            waitsForInspection("inspection-valid");
+
             runs(function () {
                 toggleJSLintResults(false);
                 toggleJSLintResults(false);
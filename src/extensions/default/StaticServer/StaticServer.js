@@ -26,6 +26,8 @@ define(function (require, exports, module) {
     "use strict";
 
     var BaseServer           = brackets.getModule("LiveDevelopment/Servers/BaseServer").BaseServer,
+        DocumentManager      = brackets.getModule("document/DocumentManager"),
+        DocumentModule       = brackets.getModule("document/Document"),
         LiveDevelopmentUtils = brackets.getModule("LiveDevelopment/LiveDevelopmentUtils"),
         PreferencesManager   = brackets.getModule("preferences/PreferencesManager"),
         Strings              = brackets.getModule("strings");
@@ -58,6 +60,21 @@ define(function (require, exports, module) {
     function StaticServer(config) {
         this._nodeDomain = config.nodeDomain;
         this._onRequestFilter = this._onRequestFilter.bind(this);
+        this._onDocumentChange = this._onDocumentChange.bind(this);
+
+        /**
+         * @private
+         * Version of each live document, by path key. Incremented whenever the document changes.
+         * @type {Object.<string, number>}
+         */
+        this._versions = {};
+
+        /**
+         * @private
+         * Path keys whose response the StaticServerDomain may have cached since they last changed
+         * @type {Object.<string, boolean>}
+         */
+        this._cachedPaths = {};
 
         BaseServer.call(this, config);
     }
@@ -97,7 +114,15 @@ define(function (require, exports, module) {
      * @return {jQuery.Promise} Resolved by the StaticServer domain when the message is acknowledged.
      */
     StaticServer.prototype._updateRequestFilterPaths = function () {
-        var paths = Object.keys(this._liveDocuments);
+        var paths = Object.keys(this._liveDocuments),
+            self = this;
+
+        // the domain drops the cached responses of the paths that aren't filtered any more
+        Object.keys(this._cachedPaths).forEach(function (key) {
+            if (!self._liveDocuments[key]) {
+                delete self._cachedPaths[key];
+            }
+        });
 
         return this._nodeDomain.exec("setRequestFilterPaths", this._root, paths);
     };
@@ -166,6 +191,9 @@ define(function (require, exports, module) {
 
         BaseServer.prototype.add.call(this, liveDocument);
 
+        // enabling instrumentation again marks the tags again, so cached responses are out of date
+        this._invalidate(this._documentKey(liveDocument.doc.file.fullPath));
+
         // update the paths to watch
         this._updateRequestFilterPaths();
     };
@@ -188,6 +216,36 @@ define(function (require, exports, module) {
         this._updateRequestFilterPaths();
     };
 
+    /**
+     * @private
+     * Makes the StaticServerDomain drop the cached response for a path, once per change burst:
+     * after the first change, the domain neither serves nor caches older responses anyway.
+     * @param {string} key Path key of the live document
+     */
+    StaticServer.prototype._invalidate = function (key) {
+        this._versions[key] = (this._versions[key] || 0) + 1;
+
+        if (this._cachedPaths[key]) {
+            delete this._cachedPaths[key];
+            this._nodeDomain.exec("invalidateResponse", this._root, key, this._versions[key]);
+        }
+    };
+
+    /**
+     * @private
+     * Event handler for changes, saves and reloads of documents. Saving and reloading give
+     * HTML documents new tag IDs the next time they are instrumented.
+     * @param {jQuery.Event} event
+     * @param {Document} doc
+     */
+    StaticServer.prototype._onDocumentChange = function (event, doc) {
+        var key = this._documentKey(doc.file.fullPath);
+
+        if (this._liveDocuments[key]) {
+            this._invalidate(key);
+        }
+    };
+
     /**
      * @private
      * Send HTTP response data back to the StaticServerSomain
@@ -210,6 +268,10 @@ define(function (require, exports, module) {
         // send instrumented response or null to fallback to static file
         if (liveDocument && liveDocument.getResponseData) {
             response = liveDocument.getResponseData();
+
+            // let the domain serve the response again until the document changes
+            response.version = this._versions[key] || 0;
+            this._cachedPaths[key] = true;
         } else {
             response = {};  // let server fall back on loading file off disk
         }
@@ -223,6 +285,8 @@ define(function (require, exports, module) {
      */
     StaticServer.prototype.start = function () {
         this._nodeDomain.on("requestFilter", this._onRequestFilter);
+        DocumentModule.on("documentChange", this._onDocumentChange);
+        DocumentManager.on("documentSaved documentRefreshed", this._onDocumentChange);
     };
 
     /**
@@ -230,6 +294,8 @@ define(function (require, exports, module) {
      */
     StaticServer.prototype.stop = function () {
         this._nodeDomain.off("requestFilter", this._onRequestFilter);
+        DocumentModule.off("documentChange", this._onDocumentChange);
+        DocumentManager.off("documentSaved documentRefreshed", this._onDocumentChange);
     };
 
     module.exports = StaticServer;
@@ -26,6 +26,7 @@
 "use strict";
 
 var http        = require("http"),
+    crypto      = require("crypto"),
     pathJoin    = require("path").join,
     connect     = require("connect"),
     pauseLib    = require("pause"),
@@ -87,6 +88,22 @@ var _requests = {};
  */
 var _rewritePaths = {};
 
+/**
+ * @private
+ * @type {Object.<string, Object.<string, {version: number, body: string, etag: string}>>}
+ * A map from root paths to the responses of filtered requests, by relative path. A response
+ * is served from here, without a requestFilter event, until its document changes.
+ */
+var _responseCache = {};
+
+/**
+ * @private
+ * @type {Object.<string, Object.<string, number>>}
+ * A map from root paths to the oldest document version that may be served, by relative path.
+ * Raised by invalidateResponse, so that a response for an older version is never cached.
+ */
+var _responseVersions = {};
+
 var PATH_KEY_PREFIX = "LiveDev_";
 
 /**
@@ -109,6 +126,67 @@ function getPathKey(path) {
     return PATH_KEY_PREFIX + normalizeRootPath(path);
 }
 
+/**
+ * @private
+ * Writes the body of a filtered request, or 304 Not Modified if the client has the same body.
+ * @param {http.IncomingMessage} req
+ * @param {http.ServerResponse} res
+ * @param {string} pathname Relative path of the file
+ * @param {string} body
+ * @param {?string} etag Entity tag of the body, if it was cached
+ */
+function writeBody(req, res, pathname, body, etag) {
+    // HTTP headers
+    var type    = mime.getType(pathname);
+    // Assume text types are utf8
+    var charset = (/^text\/|^application\/(javascript|json)/).test(type) ? "UTF-8" : "";
+
+    res.setHeader("Content-Type", type + (charset ? "; charset=" + charset : ""));
+
+    if (etag) {
+        // Always revalidate, the body changes with every edit
+        res.setHeader("Cache-Control", "no-cache");
+        res.setHeader("ETag", etag);
+        if (req.headers["if-none-match"] === etag) {
+            res.statusCode = 304;
+            res.end();
+            return;
+        }
+    }
+
+    // TODO (jasonsanjose): off-by-1 error here, why?
+    // Chrome seems to handle the request without issues when Content-Length is not specified
+    //res.setHeader("Content-Length", Buffer.byteLength(resData.body /* TODO encoding? */));
+
+    // response body
+    res.end(body);
+}
+
+/**
+ * @private
+ * Caches the response to a filtered request, unless its document changed since it was generated
+ * @param {string} pathKey
+ * @param {string} pathname Relative path of the file
+ * @param {{body: string, version: number}} resData
+ * @return {?{version: number, body: string, etag: string}} The cache entry, or null if the
+ *     response is out of date
+ */
+function cacheResponse(pathKey, pathname, resData) {
+    var versions = _responseVersions[pathKey],
+        cache = _responseCache[pathKey];
+
+    if (!cache || resData.version < (versions[pathname] || 0)) {
+        return null;
+    }
+
+    cache[pathname] = {
+        version: resData.version,
+        body: resData.body,
+        etag: "\"" + crypto.createHash("sha1").update(resData.body).digest("base64") + "\""
+    };
+    return cache[pathname];
+}
+
 /**
  * @private
  * Helper function to create a new server.
@@ -125,6 +203,8 @@ function _createServer(path, port, createCompleteCallback) {
 
     // create a new map for this server's requests
     _requests[pathKey] = {};
+    _responseCache[pathKey] = {};
+    _responseVersions[pathKey] = {};
 
     function requestRoot(server, cb) {
         address = server.address();
@@ -155,6 +235,13 @@ function _createServer(path, port, createCompleteCallback) {
             return;
         }
 
+        // serve the response to a previous request if its document didn't change since
+        var cached = _responseCache[pathKey] && _responseCache[pathKey][location.pathname];
+        if (cached) {
+            writeBody(req, res, location.pathname, cached.body, cached.etag);
+            return;
+        }
+
         // pause the request and wait for listeners to possibly respond
         var pause = pauseLib(req);
 
@@ -178,19 +265,11 @@ function _createServer(path, port, createCompleteCallback) {
 
             // response data is optional
             if (resData.body) {
-                // HTTP headers
-                var type    = mime.getType(location.pathname);
-                // Assume text types are utf8
-                var charset = (/^text\/|^application\/(javascript|json)/).test(type) ? "UTF-8" : "";
+                // responses with a document version can be served again until the document changes
+                var entry = typeof resData.version === "number" ?
+                        cacheResponse(pathKey, location.pathname, resData) : null;
 
-                res.setHeader("Content-Type", type + (charset ? "; charset=" + charset : ""));
-
-                // TODO (jasonsanjose): off-by-1 error here, why?
-                // Chrome seems to handle the request without issues when Content-Length is not specified
-                //res.setHeader("Content-Length", Buffer.byteLength(resData.body /* TODO encoding? */));
-
-                // response body
-                res.end(resData.body);
+                writeBody(req, res, location.pathname, resData.body, entry && entry.etag);
             }
 
             // resume the HTTP ServerResponse, pass to next middleware if
@@ -297,6 +376,8 @@ function _cmdCloseServer(path, cba) {
     if (_servers[pathKey]) {
         var serverToClose = _servers[pathKey];
         delete _servers[pathKey];
+        delete _responseCache[pathKey];
+        delete _responseVersions[pathKey];
         serverToClose.close();
         return true;
     }
@@ -321,6 +402,40 @@ function _cmdSetRequestFilterPaths(root, paths) {
     paths.forEach(function (path) {
         rewritePaths[path] = pathJoin(root, path);
     });
+
+    // drop the cached responses of paths that aren't filtered any more
+    var cache = _responseCache[pathKey];
+    if (cache) {
+        Object.keys(cache).forEach(function (path) {
+            if (!rewritePaths.hasOwnProperty(path)) {
+                delete cache[path];
+            }
+        });
+    }
+}
+
+/**
+ * @private
+ * Drops the cached response for a path when its document changed. Responses generated for
+ * an older version of the document are neither served nor cached afterwards.
+ *
+ * @param {string} root The absolute path of the server
+ * @param {string} path The relative path of the file beginning with a forward slash "/"
+ * @param {number} version The new version of the document
+ */
+function _cmdInvalidateResponse(root, path, version) {
+    var pathKey  = getPathKey(root),
+        versions = _responseVersions[pathKey],
+        cache    = _responseCache[pathKey];
+
+    if (!versions) {
+        return;
+    }
+
+    versions[path] = Math.max(versions[path] || 0, version);
+    if (cache[path] && cache[path].version < version) {
+        delete cache[path];
+    }
 }
 
 /**
@@ -458,8 +573,33 @@ function init(domainManager) {
             },
             {
                 name: "resData",
-                type: "{body: string, headers: Array}",
-                description: "TODO"
+                type: "{id: number, body: string, version: number}",
+                description: "id of the filtered request, and the response body. If version is given, the response is served again for later requests of the path until invalidateResponse is called."
+            }
+        ],
+        []
+    );
+    _domainManager.registerCommand(
+        "staticServer",
+        "invalidateResponse",
+        _cmdInvalidateResponse,
+        false,
+        "Drops the cached response for a path when its document changed.",
+        [
+            {
+                name: "root",
+                type: "string",
+                description: "absolute filesystem path for root of server"
+            },
+            {
+                name: "path",
+                type: "string",
+                description: "path whose document changed"
+            },
+            {
+                name: "version",
+                type: "number",
+                description: "new version of the document, responses for older versions are not served"
             }
         ],
         []
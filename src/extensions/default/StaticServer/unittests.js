@@ -408,6 +408,67 @@ define(function (require, exports, module) {
                 });
             });
 
+            (isCI ? xit : it)("should serve a versioned response again until it is invalidated", function () {
+                var serverInfo,
+                    path = testFolder + "/folder1",
+                    requestCount = 0,
+                    texts = [];
+
+                function onRequest(event, request) {
+                    requestCount++;
+                    nodeConnection.domains.staticServer.writeFilteredResponse(request.location.root, request.location.pathname,
+                        {id: request.id, body: "response " + requestCount, version: requestCount});
+                }
+
+                function get() {
+                    var done = false;
+
+                    runs(function () {
+                        getUrl(serverInfo, "/index.txt").done(function (data) {
+                            texts.push(data);
+                            done = true;
+                        });
+                    });
+                    waitsFor(function () { return done; }, "waiting for text from server");
+                }
+
+                runs(function () {
+                    nodeConnection.domains.staticServer.getServer(path, 0)
+                        .done(function (info) {
+                            serverInfo = info;
+                        });
+                });
+
+                waitsFor(function () { return serverInfo; }, "waiting for static server to start");
+
+                runs(function () {
+                    nodeConnection.on("staticServer:requestFilter", onRequest);
+                    waitsForDone(nodeConnection.domains.staticServer.setRequestFilterPaths(path, ["/index.txt"]));
+                });
+
+                get();
+                get();
+
+                runs(function () {
+                    expect(requestCount).toBe(1);
+                    expect(texts).toEqual(["response 1", "response 1"]);
+
+                    waitsForDone(nodeConnection.domains.staticServer.invalidateResponse(path, "/index.txt", 2));
+                });
+
+                get();
+
+                runs(function () {
+                    nodeConnection.off("staticServer:requestFilter", onRequest);
+
+                    expect(requestCount).toBe(2);
+                    expect(texts[2]).toBe("response 2");
+
+                    waitsForDone(nodeConnection.domains.staticServer.closeServer(path),
+                        "waiting for static server to close");
+                });
+            });
+
             (isCI ? xit : it)("should ignore multiple responses for the same request", function () {
                 var serverInfo,
                     path = testFolder + "/folder1",
@@ -202,11 +202,6 @@ AppInit.htmlReady(function () {
                 if (searchModel.hasResults()) {
                     _resultsView.showNextPage();
                 }
-            })
-            .on("getLastPage", function () {
-                if (searchModel.hasResults()) {
-                    _resultsView.showLastPage();
-                }
             });
     }
 });
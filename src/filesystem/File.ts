@@ -144,7 +144,8 @@ class File extends FileSystemEntry {
      * Write a file.
      *
      * @param {string} data Data to write.
-     * @param {object=} options Currently unused.
+     * @param {{blind: boolean=, atomic: boolean=}=} options Set blind to skip the consistency check,
+     *              and atomic to replace the file through a temporary file.
      * @param {function (?string, FileSystemStats=)=} callback Callback that is passed the
      *              FileSystemError string or the file's new stats.
      */
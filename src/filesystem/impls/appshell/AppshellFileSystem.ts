@@ -429,16 +429,18 @@ function readFile(path: string, options: { encoding: string, stat: any }, callba
  * is used to the current state of the file before overwriting it. If a
  * consistency hash is provided but does not match the hash of the file on
  * disk, a FileSystemError.CONTENTS_MODIFIED error is passed to the callback.
+ * If atomic is set, the data is written to a temporary file that then replaces
+ * the original, so a failed write never leaves a truncated file behind.
  *
  * @param {string} path
  * @param {string} data
- * @param {{encoding : string=, mode : number=, expectedHash : object=, expectedContents : string=}} options
+ * @param {{encoding : string=, mode : number=, expectedHash : object=, expectedContents : string=, atomic : boolean=}} options
  * @param {function(?string, FileSystemStats=, boolean)} callback
  */
 function writeFile(
     path: string,
     data: string,
-    options: { encoding: string, preserveBOM: boolean, mode: number, expectedHash: string, expectedContents: string },
+    options: { encoding: string, preserveBOM: boolean, mode: number, expectedHash: string, expectedContents: string, atomic?: boolean },
     callback: Function
 ) {
     // const encoding = options.encoding || "utf8";
@@ -461,7 +463,8 @@ function writeFile(
                 return callback(_mapError(err));
             }
         } else {
-            appshell.fs.writeFile(path, data, encoding/*, preserveBOM*/, function (err: NodeJS.ErrnoException) {
+            const write = options.atomic ? appshell.fs.writeTextFileAtomic : appshell.fs.writeFile;
+            write(path, data, encoding/*, preserveBOM*/, function (err: NodeJS.ErrnoException) {
                 if (err) {
                     callback(_mapError(err));
                 } else {
@@ -0,0 +1,358 @@
+/*
+ * Copyright (c) 2018 - present The quadre code authors. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ *
+ */
+
+/*unittests: Code Inspection*/
+
+/**
+ * BackgroundInspection inspects all files of the project while the app is idle, a few files
+ * at a time, and keeps the results. Files are inspected again when they change on disk or are
+ * saved. See CodeInspection.toggleProjectInspection() for the UI.
+ */
+
+import * as DocumentManager from "document/DocumentManager";
+import Directory = require("filesystem/Directory");
+import File = require("filesystem/File");
+import * as FileSystem from "filesystem/FileSystem";
+import * as ProjectManager from "project/ProjectManager";
+import { DispatcherEvents } from "utils/EventDispatcher";
+
+/** Most files inspected at the same time */
+const MAX_IN_FLIGHT = 2;
+
+/** Idle time left below which no other inspection is started, in ms */
+const MIN_IDLE_TIME = 2;
+
+const EVENT_NAMESPACE = ".backgroundInspection";
+
+interface IdleDeadline {
+    didTimeout: boolean;
+    timeRemaining(): number;
+}
+
+function _requestIdle(callback: (deadline: IdleDeadline) => void) {
+    const win = window as any;
+    if (win.requestIdleCallback) {
+        win.requestIdleCallback(callback);
+    } else {
+        window.setTimeout(function () {
+            callback({ didTimeout: true, timeRemaining: function () { return 0; } });
+        }, 100);
+    }
+}
+
+export class BackgroundInspection {
+    private _inspect: (file: File) => JQueryPromise<any>;
+    private _accepts: (fullPath: string) => boolean;
+    private _onChange: () => void;
+    private _results: { [fullPath: string]: any } = {};
+    private _queue: Array<string> = [];
+    private _queued: { [fullPath: string]: boolean } = {};
+    private _inFlight = 0;
+
+    /** The project files to inspect, by full path */
+    private _files: { [fullPath: string]: boolean } = {};
+    private _scheduled = false;
+    private _running = false;
+
+    /** Incremented by stop(), so that inspections that were running then are ignored */
+    private _generation = 0;
+
+    /**
+     * @param {function(File):$.Promise} inspect Inspects a file, e.g. CodeInspection.inspectFile
+     * @param {function(string):boolean} accepts Whether a file should be inspected
+     * @param {function()} onChange Called when the results or the progress changed
+     */
+    constructor(inspect: (file: File) => JQueryPromise<any>, accepts: (fullPath: string) => boolean, onChange: () => void) {
+        this._inspect = inspect;
+        this._accepts = accepts;
+        this._onChange = onChange;
+    }
+
+    /**
+     * Starts inspecting the project, and keeps inspecting the files that change
+     */
+    public start() {
+        if (this._running) {
+            return;
+        }
+
+        const self = this;
+        this._running = true;
+
+        (FileSystem as unknown as DispatcherEvents).on("change" + EVENT_NAMESPACE, function (event, entry, added, removed) {
+            if (!entry) {
+                // The whole tree changed
+                self.requeueAll();
+            } else if (entry.isFile) {
+                self._enqueue(entry.fullPath);
+            } else if (!added && !removed) {
+                // The contents of the directory are not known
+                self._requeueDirectory(entry);
+            } else {
+                (removed || []).forEach(function (removedEntry) {
+                    self._forget(removedEntry.fullPath);
+                });
+                (added || []).forEach(function (addedEntry) {
+                    if (addedEntry.isFile) {
+                        self._add(addedEntry);
+                    } else {
+                        self._requeueDirectory(addedEntry);
+                    }
+                });
+                self._onChange();
+            }
+        });
+        (DocumentManager as unknown as DispatcherEvents).on("documentSaved" + EVENT_NAMESPACE, function (event, doc) {
+            self._enqueue(doc.file.fullPath);
+        });
+        (ProjectManager as unknown as DispatcherEvents).on("projectOpen" + EVENT_NAMESPACE, function () {
+            self._reset();
+            self.requeueAll();
+        });
+
+        this.requeueAll();
+    }
+
+    /**
+     * Stops inspecting and forgets the results
+     */
+    public stop() {
+        (FileSystem as unknown as DispatcherEvents).off(EVENT_NAMESPACE);
+        (DocumentManager as unknown as DispatcherEvents).off(EVENT_NAMESPACE);
+        (ProjectManager as unknown as DispatcherEvents).off(EVENT_NAMESPACE);
+        this._running = false;
+        this._reset();
+    }
+
+    /**
+     * @return {boolean} true between start() and stop()
+     */
+    public isRunning() {
+        return this._running;
+    }
+
+    /**
+     * Queues all files of the project. Files whose results are cached are cheap to inspect again.
+     */
+    public requeueAll() {
+        const self = this;
+        const generation = this._generation;
+
+        ProjectManager.getAllFiles(function (file) {
+            return self._accepts(file.fullPath);
+        }).done(function (files) {
+            if (generation !== self._generation) {
+                return;
+            }
+
+            const paths = {};
+            files.forEach(function (file) {
+                paths[file.fullPath] = true;
+                self._enqueue(file.fullPath);
+            });
+            Object.keys(self._results).forEach(function (fullPath) {
+                if (!paths[fullPath]) {
+                    delete self._results[fullPath];
+                }
+            });
+            self._files = paths;
+            self._onChange();
+        });
+    }
+
+    /**
+     * Queues the inspected files that pass a filter, e.g. the files of a provider whose options
+     * changed. Files that weren't inspected yet are still queued anyway.
+     * @param {function(string):boolean} filter Called with the full path of each file
+     */
+    public requeue(filter: (fullPath: string) => boolean) {
+        const self = this;
+        Object.keys(this._results).forEach(function (fullPath) {
+            if (filter(fullPath)) {
+                self._enqueue(fullPath);
+            }
+        });
+    }
+
+    /**
+     * @return {Object.<string, Array.<{provider:Object, result:?{errors:!Array, aborted:boolean}}>>}
+     *     Results of the files inspected so far, as resolved by inspect(), by full path
+     */
+    public getResults() {
+        return this._results;
+    }
+
+    /**
+     * Sets the results of a file that was inspected elsewhere, e.g. the current document
+     * @param {!string} fullPath
+     * @param {?Array} results
+     */
+    public setResults(fullPath: string, results) {
+        if (this._running && this._accepts(fullPath)) {
+            this._results[fullPath] = results;
+            this._onChange();
+        }
+    }
+
+    /**
+     * @return {{done: number, total: number}} How many files of the project were inspected
+     */
+    public getProgress() {
+        const total = Object.keys(this._files).length;
+        return {
+            done: Math.max(0, total - this._queue.length - this._inFlight),
+            total: total
+        };
+    }
+
+    private _reset() {
+        this._generation++;
+        this._results = {};
+        this._queue = [];
+        this._queued = {};
+        this._inFlight = 0;
+        this._files = {};
+    }
+
+    /**
+     * Queues a file that was added to the project
+     */
+    private _add(file: File) {
+        if (ProjectManager.isWithinProject(file) && ProjectManager.shouldShow(file) && this._accepts(file.fullPath)) {
+            this._files[file.fullPath] = true;
+            this._enqueue(file.fullPath);
+        }
+    }
+
+    /**
+     * Forgets a file or directory that was removed from the project, with the files in it
+     */
+    private _forget(fullPath: string) {
+        const self = this;
+        const isRemoved = function (path: string) {
+            return path === fullPath || (fullPath[fullPath.length - 1] === "/" && path.indexOf(fullPath) === 0);
+        };
+
+        Object.keys(this._files).forEach(function (path) {
+            if (isRemoved(path)) {
+                delete self._files[path];
+                delete self._results[path];
+            }
+        });
+        this._queue = this._queue.filter(function (path) {
+            if (isRemoved(path)) {
+                delete self._queued[path];
+                return false;
+            }
+            return true;
+        });
+    }
+
+    /**
+     * Queues the files of a directory and forgets the ones that are gone, like requeueAll()
+     * does for the whole project
+     */
+    private _requeueDirectory(directory: Directory) {
+        const self = this;
+        const generation = this._generation;
+        const files: Array<File> = [];
+
+        if (!ProjectManager.isWithinProject(directory)) {
+            return;
+        }
+
+        directory.visit(function (entry) {
+            if (ProjectManager.shouldShow(entry)) {
+                if (entry.isFile) {
+                    files.push(entry as File);
+                }
+                return true;
+            }
+            return false;
+        }, function (err) {
+            if (err || generation !== self._generation) {
+                return;
+            }
+
+            self._forget(directory.fullPath);
+            files.forEach(function (file) {
+                self._add(file);
+            });
+            self._onChange();
+        });
+    }
+
+    private _enqueue(fullPath: string) {
+        if (!this._queued[fullPath] && this._accepts(fullPath)) {
+            this._queued[fullPath] = true;
+            this._queue.push(fullPath);
+            this._schedule();
+        }
+    }
+
+    private _schedule() {
+        if (this._scheduled || !this._queue.length || this._inFlight >= MAX_IN_FLIGHT) {
+            return;
+        }
+
+        const self = this;
+        this._scheduled = true;
+        _requestIdle(function (deadline) {
+            self._scheduled = false;
+            while (self._queue.length && self._inFlight < MAX_IN_FLIGHT &&
+                    (deadline.didTimeout || deadline.timeRemaining() > MIN_IDLE_TIME)) {
+                self._inspectNext();
+            }
+            self._schedule();
+        });
+    }
+
+    private _inspectNext() {
+        const self = this;
+        const generation = this._generation;
+        const fullPath = this._queue.shift()!;
+
+        delete this._queued[fullPath];
+        this._inFlight++;
+
+        this._inspect(FileSystem.getFileForPath(fullPath))
+            .done(function (results) {
+                if (generation === self._generation) {
+                    self._results[fullPath] = results;
+                }
+            })
+            .fail(function () {
+                // The file was deleted or can't be read
+                if (generation === self._generation) {
+                    delete self._results[fullPath];
+                }
+            })
+            .always(function () {
+                if (generation === self._generation) {
+                    self._inFlight--;
+                    self._onChange();
+                    self._schedule();
+                }
+            });
+    }
+}
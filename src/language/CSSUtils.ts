@@ -31,13 +31,17 @@
 import * as CodeMirror from "codemirror";
 import * as Async from "utils/Async";
 import * as DocumentManager from "document/DocumentManager";
+import * as DocumentModule from "document/Document";
 import * as EditorManager from "editor/EditorManager";
+import * as FileSystem from "filesystem/FileSystem";
+import * as FileUtils from "file/FileUtils";
 import * as HTMLUtils from "language/HTMLUtils";
 import * as LanguageManager from "language/LanguageManager";
 import * as ProjectManager from "project/ProjectManager";
 import * as TokenUtils from "utils/TokenUtils";
 import * as _ from "lodash";
 import { Document } from "document/Document";
+import { DispatcherEvents } from "utils/EventDispatcher";
 
 // Use CodeMirror types instead?
 interface Pos {
@@ -133,6 +137,22 @@ interface Rule {
     selectorGroup?: string;
 }
 
+/**
+ * The rules of a stylesheet, as indexed for findMatchingRules()
+ */
+interface IndexedStylesheet {
+    selectors: Array<SelectorInfo>;
+    /**
+     * the selector each rule applies to once nesting is resolved, see _getActualSelector()
+     */
+    actualSelectors: Array<string>;
+    /**
+     * indexes of the rules whose actual selector contains a class, id or tag name, by name
+     * (tag names are lower case)
+     */
+    names: { [name: string]: Array<number> };
+}
+
 // Constants
 export const SELECTOR   = "selector";
 export const PROP_NAME  = "prop.name";
@@ -155,6 +175,25 @@ const _bracketPairs = {
 };
 const _invertedBracketPairs = _.invert(_bracketPairs);
 
+/**
+ * Name under which the rules whose actual selector ends with "*" are indexed, since they match any tag
+ * @const
+ */
+const UNIVERSAL_SELECTOR = "*";
+
+/**
+ * The rules of the project's stylesheets, by path. Stylesheets are indexed the first time
+ * findMatchingRules() needs them and dropped from the index when they change.
+ * @type {Object.<string, IndexedStylesheet>}
+ */
+let _stylesheetIndex: { [fullPath: string]: IndexedStylesheet } = {};
+
+/**
+ * Stylesheets that are being read to be indexed, by path
+ * @type {Object.<string, $.Promise>}
+ */
+let _pendingStylesheets: { [fullPath: string]: JQueryPromise<IndexedStylesheet> } = {};
+
 /**
  * Determines if the given path is a CSS preprocessor file that CSSUtils supports.
  * @param {string} filePath Absolute path to the file.
@@ -1469,9 +1508,34 @@ function _getSelectorInFinalCSSForm(selectorArray: Array<string>): string {
  *      matched selector.
  */
 export function _findAllMatchingSelectorsInText(text, selector, mode?) {
-    const allSelectors = extractAllSelectors(text, mode);
-    const result: Array<SelectorInfo> = [];
+    const matches = _makeSelectorMatcher(selector);
 
+    return extractAllSelectors(text, mode).filter(function (entry) {
+        return matches(_getActualSelector(entry));
+    });
+}
+
+/**
+ * Returns the selector a rule applies to, resolving "&" in nested preprocessor rules
+ * @param {!SelectorInfo} entry
+ * @return {string}
+ */
+function _getActualSelector(entry: SelectorInfo) {
+    if (entry.selector.indexOf("&") !== -1 && entry.parentSelectors) {
+        const selectorArray = entry.parentSelectors.split(" / ");
+        selectorArray.push(entry.selector);
+        return _getSelectorInFinalCSSForm(selectorArray);
+    }
+    return entry.selector;
+}
+
+/**
+ * Makes a function that tells whether the actual selector of a rule matches the
+ * given selector, see _findAllMatchingSelectorsInText()
+ * @param {!string} selector selector to search for
+ * @return {function(string): boolean}
+ */
+function _makeSelectorMatcher(selector): (actualSelector: string) => boolean {
     // For now, we only match the rightmost simple selector, and ignore
     // attribute selectors and pseudo selectors
     const classOrIdSelector = selector[0] === "." || selector[0] === "#";
@@ -1487,24 +1551,142 @@ export function _findAllMatchingSelectorsInText(text, selector, mode?) {
     }
 
     const re = new RegExp(selector + "(\\[[^\\]]*\\]|:{1,2}[\\w-()]+|\\.[\\w-]+|#[\\w-]+)*\\s*$", classOrIdSelector ? "" : "i");
-    allSelectors.forEach(function (entry) {
-        let actualSelector = entry.selector;
-        if (entry.selector.indexOf("&") !== -1 && entry.parentSelectors) {
-            const selectorArray = entry.parentSelectors.split(" / ");
-            selectorArray.push(entry.selector);
-            actualSelector = _getSelectorInFinalCSSForm(selectorArray);
-        }
+    return function (actualSelector) {
         if (actualSelector.search(re) !== -1) {
-            result.push(entry);
-        } else if (!classOrIdSelector) {
-            // Special case for tag selectors - match "*" as the rightmost character
-            if (/\*\s*$/.test(actualSelector)) {
-                result.push(entry);
+            return true;
+        }
+        // Special case for tag selectors - match "*" as the rightmost character
+        return !classOrIdSelector && /\*\s*$/.test(actualSelector);
+    };
+}
+
+/**
+ * Parses the text of a stylesheet and indexes its rules by the names their selectors contain
+ * @param {!string} text
+ * @param {string=} mode language mode of the stylesheet
+ * @return {!IndexedStylesheet}
+ */
+function _indexStylesheetText(text, mode?): IndexedStylesheet {
+    const selectors = extractAllSelectors(text, mode);
+    const actualSelectors = selectors.map(_getActualSelector);
+    const names = Object.create(null);
+
+    actualSelectors.forEach(function (actualSelector, index) {
+        const selectorNames = actualSelector.match(/[.#]?[^\s.#>+~,:()[\]*="'|^$]+/g) || [];
+        if (/\*\s*$/.test(actualSelector)) {
+            selectorNames.push(UNIVERSAL_SELECTOR);
+        }
+        selectorNames.forEach(function (name) {
+            if (name[0] !== "." && name[0] !== "#") {
+                name = name.toLowerCase();
+            }
+            const indexes = names[name] || (names[name] = []);
+            if (indexes[indexes.length - 1] !== index) {
+                indexes.push(index);
             }
+        });
+    });
+
+    return { selectors: selectors, actualSelectors: actualSelectors, names: names };
+}
+
+/**
+ * Returns the rules of an indexed stylesheet that match the given selector. Only the rules
+ * whose selector contains the searched name are tested.
+ * @param {!IndexedStylesheet} stylesheet
+ * @param {!string} selector selector to search for
+ * @return {Array.<SelectorInfo>}
+ */
+function _findMatchingSelectorsInIndex(stylesheet: IndexedStylesheet, selector): Array<SelectorInfo> {
+    const matches = _makeSelectorMatcher(selector);
+    let candidates: Array<number>;
+
+    if (/^[.#]?[\w-]+$/.test(selector)) {
+        const isTagSelector = selector[0] !== "." && selector[0] !== "#";
+        candidates = stylesheet.names[isTagSelector ? selector.toLowerCase() : selector] || [];
+        if (isTagSelector && stylesheet.names[UNIVERSAL_SELECTOR]) {
+            candidates = _.sortBy(_.union(candidates, stylesheet.names[UNIVERSAL_SELECTOR]));
         }
+    } else {
+        // Selectors we can't look up by name are tested against every rule
+        candidates = _.range(stylesheet.selectors.length);
+    }
+
+    return candidates.filter(function (index) {
+        return matches(stylesheet.actualSelectors[index]);
+    }).map(function (index) {
+        return stylesheet.selectors[index];
     });
+}
 
-    return result;
+/**
+ * Returns the indexed rules of a stylesheet, indexing it first if it changed since it was last indexed.
+ * Open documents are indexed with their current text, other stylesheets are read from disk.
+ * @param {!File} file
+ * @return {$.Promise} resolved with the IndexedStylesheet, or rejected if the file can't be read
+ */
+function _getIndexedStylesheet(file): JQueryPromise<IndexedStylesheet> {
+    const fullPath = file.fullPath;
+    let stylesheet = _stylesheetIndex[fullPath];
+
+    if (!stylesheet) {
+        const doc = DocumentManager.getOpenDocumentForPath(fullPath);
+        if (!doc) {
+            return _readStylesheet(file);
+        }
+        stylesheet = _stylesheetIndex[fullPath] = _indexStylesheetText(doc.getText(), doc.getLanguage().getMode());
+    }
+    return $.Deferred<IndexedStylesheet>().resolve(stylesheet).promise();
+}
+
+/**
+ * Reads a stylesheet that isn't open and indexes it, unless it changes while it is read
+ * @param {!File} file
+ * @return {$.Promise} resolved with the IndexedStylesheet
+ */
+function _readStylesheet(file): JQueryPromise<IndexedStylesheet> {
+    const fullPath = file.fullPath;
+    if (_pendingStylesheets[fullPath]) {
+        return _pendingStylesheets[fullPath];
+    }
+
+    const promise = FileUtils.readAsText(file)
+        .then(function (text) {
+            const stylesheet = _indexStylesheetText(text, LanguageManager.getLanguageForPath(fullPath).getMode());
+            if (_pendingStylesheets[fullPath] === promise) {
+                _stylesheetIndex[fullPath] = stylesheet;
+            }
+            return stylesheet;
+        })
+        .always(function () {
+            if (_pendingStylesheets[fullPath] === promise) {
+                delete _pendingStylesheets[fullPath];
+            }
+        });
+
+    _pendingStylesheets[fullPath] = promise;
+    return promise;
+}
+
+/**
+ * Drops a stylesheet, or all stylesheets in a directory, from the index
+ * @param {?string} fullPath path of a file or directory, or null for all stylesheets
+ */
+function _invalidateStylesheets(fullPath: string | null) {
+    if (!fullPath) {
+        _stylesheetIndex = {};
+        _pendingStylesheets = {};
+    } else if (fullPath[fullPath.length - 1] === "/") {
+        Object.keys(_stylesheetIndex).concat(Object.keys(_pendingStylesheets)).forEach(function (path) {
+            if (path.indexOf(fullPath) === 0) {
+                delete _stylesheetIndex[path];
+                delete _pendingStylesheets[path];
+            }
+        });
+    } else {
+        delete _stylesheetIndex[fullPath];
+        delete _pendingStylesheets[fullPath];
+    }
 }
 
 /**
@@ -1532,21 +1714,27 @@ function _addSelectorsToResults(resultSelectors: Array<Rule>, selectorsToAdd: Ar
 function _findMatchingRulesInCSSFiles(selector, resultSelectors: Array<Rule>): JQueryPromise<Array<Rule>> {
     const result          = $.Deferred<Array<Rule>>();
 
-    // Load one CSS file and search its contents
-    function _loadFileAndScan(fullPath, selector) {
+    // Look up the rules of one CSS file in the index, and load the document if some match
+    function _findMatchingRulesInFile(file, selector) {
         const oneFileResult = $.Deferred();
 
-        DocumentManager.getDocumentForPath(fullPath)
-            .done(function (doc) {
-                // Find all matching rules for the given CSS file's content, and add them to the
-                // overall search result
-                const oneCSSFileMatches = _findAllMatchingSelectorsInText(doc.getText(), selector, doc.getLanguage().getMode());
-                _addSelectorsToResults(resultSelectors, oneCSSFileMatches, doc, 0);
-
+        _getIndexedStylesheet(file)
+            .then(function (stylesheet) {
+                const oneCSSFileMatches = _findMatchingSelectorsInIndex(stylesheet, selector);
+                if (!oneCSSFileMatches.length) {
+                    return undefined;
+                }
+                return DocumentManager.getDocumentForPath(file.fullPath)
+                    .done(function (doc) {
+                        // Add the matching rules to the overall search result
+                        _addSelectorsToResults(resultSelectors, oneCSSFileMatches, doc, 0);
+                    });
+            })
+            .done(function () {
                 oneFileResult.resolve();
             })
             .fail(function (error) {
-                console.warn("Unable to read " + fullPath + " during CSS rule search:", error);
+                console.warn("Unable to read " + file.fullPath + " during CSS rule search:", error);
                 oneFileResult.resolve();  // still resolve, so the overall result doesn't reject
             });
 
@@ -1557,7 +1745,7 @@ function _findMatchingRulesInCSSFiles(selector, resultSelectors: Array<Rule>): J
         .done(function (cssFiles) {
             // Load index of all CSS files; then process each CSS file in turn (see above)
             Async.doInParallel(cssFiles, function (fileInfo, number) {
-                return _loadFileAndScan(fileInfo.fullPath, selector);
+                return _findMatchingRulesInFile(fileInfo, selector);
             })
                 .then(result.resolve, result.reject);
         });
@@ -1954,3 +2142,21 @@ export function getRangeSelectors(range) {
     // so we only need to look at the first one.
     return (allSelectors.length ? allSelectors[0].selectorGroup || allSelectors[0].selector : "");
 }
+
+// Drop the stylesheets that change from the index
+(DocumentModule as unknown as DispatcherEvents).on("documentChange", function (event, doc) {
+    _invalidateStylesheets(doc.file.fullPath);
+});
+(DocumentManager as unknown as DispatcherEvents).on("documentRefreshed beforeDocumentDelete", function (event, doc) {
+    _invalidateStylesheets(doc.file.fullPath);
+});
+FileSystem.on("change", function (event, entry) {
+    _invalidateStylesheets(entry ? entry.fullPath : null);
+});
+FileSystem.on("rename", function (event, oldPath, newPath) {
+    _invalidateStylesheets(oldPath);
+    _invalidateStylesheets(newPath);
+});
+(ProjectManager as unknown as DispatcherEvents).on("projectOpen", function () {
+    _invalidateStylesheets(null);
+});
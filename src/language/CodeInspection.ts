@@ -52,8 +52,14 @@ import * as AppInit from "utils/AppInit";
 import * as Resizer from "utils/Resizer";
 import * as StatusBar from "widgets/StatusBar";
 import * as Async from "utils/Async";
+import * as ExtensionMonitor from "utils/ExtensionMonitor";
+import { InspectionWorkerPool } from "language/InspectionWorkerPool";
+import * as InspectionCache from "language/InspectionCache";
+import { BackgroundInspection } from "language/BackgroundInspection";
+import * as ProjectManager from "project/ProjectManager";
 import * as PanelTemplate from "text!htmlContent/problems-panel.html";
 import * as ResultsTemplate from "text!htmlContent/problems-panel-table.html";
+import * as ProjectResultsTemplate from "text!htmlContent/problems-panel-project-table.html";
 import * as Mustache from "thirdparty/mustache/mustache";
 import { DispatcherEvents } from "utils/EventDispatcher";
 
@@ -66,6 +72,9 @@ interface Provider {
     name: string;
     scanFileAsync?<T>(text: string, fullpath: string): JQueryPromise<T>;
     scanFile?(text: string, fullpath: string): Result;
+    workerModule?: string;
+    workerCount?: number;
+    getWorkerOptions?(fullpath: string): any;
 }
 
 interface ProviderResult {
@@ -83,8 +92,20 @@ interface ProviderMap {
     [languageId: string]: Array<Provider>;
 }
 
+interface WorkerPoolEntry {
+    pool: InspectionWorkerPool;
+    /** Number of languages the provider is registered for */
+    refCount: number;
+}
+
 const INDICATOR_ID = "status-inspection";
 
+/** Most problems listed in the panel when the whole project is inspected */
+const MAX_PROJECT_PROBLEMS = 1000;
+
+/** How often the panel is updated while the project is inspected, in ms */
+const PROJECT_RENDER_DELAY = 250;
+
 /** Values for problem's 'type' property */
 export const Type = {
     /** Unambiguous error, such as a syntax error */
@@ -100,6 +121,7 @@ export const Type = {
  */
 const PREF_ENABLED            = "enabled";
 const PREF_COLLAPSED          = "collapsed";
+const PREF_PROJECT            = "project";
 export const _PREF_ASYNC_TIMEOUT      = "asyncTimeout";
 export const _PREF_PREFER_PROVIDERS   = "prefer";
 export const _PREF_PREFERRED_ONLY     = "usePreferredOnly";
@@ -121,6 +143,19 @@ let _enabled = false;
  */
 let _collapsed = false;
 
+/**
+ * Inspects the whole project while the project preference is on, null otherwise.
+ * @private
+ * @type {?BackgroundInspection}
+ */
+let _projectInspection: BackgroundInspection | null = null;
+
+/**
+ * @private
+ * @type {boolean}
+ */
+let _projectHasErrors = false;
+
 /**
  * @private
  * @type {$.Element}
@@ -145,6 +180,13 @@ let _gotoEnabled = false;
  */
 let _providers: ProviderMap = {};
 
+/**
+ * Worker pools of the providers that were registered with a workerModule
+ * @private
+ * @type {WeakMap.<Object, WorkerPoolEntry>}
+ */
+let _workerPools = new WeakMap<Provider, WorkerPoolEntry>();
+
 /**
  * @private
  * @type {boolean}
@@ -170,7 +212,11 @@ function setGotoEnabled(gotoEnabled) {
 }
 
 export function _unregisterAll() {
+    _.forEach(_providers, function (providers) {
+        providers.forEach(_releaseWorkerPool);
+    });
     _providers = {};
+    _workerPools = new WeakMap<Provider, WorkerPoolEntry>();
 }
 
 /**
@@ -265,7 +311,11 @@ export function inspectFile(file, providerList: Array<Provider>): JQueryPromise<
                     results.push({provider: provider, result: scanResult as Result});
                 });
 
-                if (provider.scanFileAsync) {
+                if (ExtensionMonitor.isSuspended(provider)) {
+                    // The extension is over its time budget, see ExtensionMonitor
+                    PerfUtils.finalizeMeasurement(perfTimerProvider);
+                    runPromise.resolve(null);
+                } else if (provider.scanFileAsync) {
                     window.setTimeout(function () {
                         // timeout error
                         const errTimeout = {
@@ -275,7 +325,7 @@ export function inspectFile(file, providerList: Array<Provider>): JQueryPromise<
                         };
                         runPromise.resolve({errors: [errTimeout]});
                     }, prefs.get(_PREF_ASYNC_TIMEOUT));
-                    provider.scanFileAsync(fileText, file.fullPath)
+                    ExtensionMonitor.invoke(provider, "scanFileAsync", provider.scanFileAsync, provider, [fileText, file.fullPath])
                         .done(function (scanResult) {
                             PerfUtils.addMeasurement(perfTimerProvider);
                             runPromise.resolve(scanResult);
@@ -292,7 +342,7 @@ export function inspectFile(file, providerList: Array<Provider>): JQueryPromise<
                         });
                 } else {
                     try {
-                        const scanResult = provider.scanFile(fileText, file.fullPath);
+                        const scanResult = ExtensionMonitor.invoke(provider, "scanFile", provider.scanFile!, provider, [fileText, file.fullPath]);
                         PerfUtils.addMeasurement(perfTimerProvider);
                         runPromise.resolve(scanResult);
                     } catch (err) {
@@ -341,8 +391,10 @@ function updatePanelTitleAndStatusBar(numProblems, providersReportingProblems, a
 
     if (providersReportingProblems.length === 1) {
         // don't show a header if there is only one provider available for this file type
-        $problemsPanelTable.find(".inspector-section").hide();
-        $problemsPanelTable.find("tr").removeClass("forced-hidden");
+        if (!_projectInspection) {
+            $problemsPanelTable.find(".inspector-section").hide();
+            $problemsPanelTable.find("tr").removeClass("forced-hidden");
+        }
 
         if (numProblems === 1 && !aborted) {
             message = StringUtils.format(Strings.SINGLE_ERROR, providersReportingProblems[0].name);
@@ -354,7 +406,9 @@ function updatePanelTitleAndStatusBar(numProblems, providersReportingProblems, a
             message = StringUtils.format(Strings.MULTIPLE_ERRORS, providersReportingProblems[0].name, numProblems);
         }
     } else if (providersReportingProblems.length > 1) {
-        $problemsPanelTable.find(".inspector-section").show();
+        if (!_projectInspection) {
+            $problemsPanelTable.find(".inspector-section").show();
+        }
 
         if (aborted) {
             numProblems += "+";
@@ -365,7 +419,10 @@ function updatePanelTitleAndStatusBar(numProblems, providersReportingProblems, a
         return;
     }
 
-    $problemsPanel.find(".title").text(message);
+    // When the whole project is inspected the title is set by _renderProjectResults()
+    if (!_projectInspection) {
+        $problemsPanel.find(".title").text(message);
+    }
     const tooltip = StringUtils.format(Strings.STATUSBAR_CODE_INSPECTION_TOOLTIP, message);
     StatusBar.updateIndicator(INDICATOR_ID, true, "inspection-errors", tooltip);
 }
@@ -375,9 +432,20 @@ function updatePanelTitleAndStatusBar(numProblems, providersReportingProblems, a
  * bottom panel. Does not run if inspection is disabled or if a providerName is given and does not
  * match the current doc's provider name.
  *
+ * When the whole project is inspected, a provider that requests a run (e.g. because its options
+ * changed) also gets the files of the project it inspects inspected again.
+ *
  * @param {?string} providerName name of the provider that is requesting a run
  */
-export function requestRun() {
+export function requestRun(providerName?: string) {
+    if (providerName && _projectInspection) {
+        _projectInspection.requeue(function (fullPath) {
+            return getProvidersForPath(fullPath).some(function (provider) {
+                return provider.name === providerName;
+            });
+        });
+    }
+
     if (!_enabled) {
         _hasErrors = false;
         _currentPromise = null;
@@ -404,13 +472,19 @@ export function requestRun() {
                 return;
             }
 
+            if (_projectInspection) {
+                _projectInspection.setResults(currentDoc.file.fullPath, results);
+            }
+
             // how many errors in total?
             const errors = results!.reduce(function (a, item) { return a + (item.result ? item.result.errors.length : 0); }, 0);
 
             _hasErrors = Boolean(errors);
 
             if (!errors) {
-                Resizer.hide($problemsPanel);
+                if (!_projectInspection) {
+                    Resizer.hide($problemsPanel);
+                }
 
                 let message = Strings.NO_ERRORS_MULTIPLE_PROVIDER;
                 if (providerList.length === 1) {
@@ -466,16 +540,18 @@ export function requestRun() {
                 }
             });
 
-            // Update results table
-            html = Mustache.render(ResultsTemplate, {reportList: allErrors});
+            // Update results table, unless it lists the problems of the whole project
+            if (!_projectInspection) {
+                html = Mustache.render(ResultsTemplate, {reportList: allErrors});
 
-            $problemsPanelTable
-                .empty()
-                .append(html)
-                .scrollTop(0);  // otherwise scroll pos from previous contents is remembered
+                $problemsPanelTable
+                    .empty()
+                    .append(html)
+                    .scrollTop(0);  // otherwise scroll pos from previous contents is remembered
 
-            if (!_collapsed) {
-                Resizer.show($problemsPanel);
+                if (!_collapsed) {
+                    Resizer.show($problemsPanel);
+                }
             }
 
             updatePanelTitleAndStatusBar(numProblems, providersReportingProblems, aborted);
@@ -488,7 +564,9 @@ export function requestRun() {
         // No provider for current file
         _hasErrors = false;
         _currentPromise = null;
-        Resizer.hide($problemsPanel);
+        if (!_projectInspection) {
+            Resizer.hide($problemsPanel);
+        }
         const language = currentDoc && LanguageManager.getLanguageForPath(currentDoc.file.fullPath);
         if (language) {
             StatusBar.updateIndicator(INDICATOR_ID, true, "inspection-disabled", StringUtils.format(Strings.NO_LINT_AVAILABLE, language.getName()));
@@ -513,9 +591,19 @@ export function requestRun() {
  * a {$.Promise} object resolved with the same type of value as scanFile() is expected to return.
  * Rejecting the promise is treated as an internal error in the provider.
  *
+ * Providers whose scanFile() is slow on large files can run it in a pool of workers instead: they
+ * set workerModule to the URL of an AMD module that exports scanFile(text, fullPath, options), and
+ * optionally getWorkerOptions(fullPath) to compute the options on the main thread. The module can
+ * require "CodeInspection" for the Type constants, but nothing else from Brackets. Such providers
+ * get a scanFileAsync() that scans a snapshot of the text in a worker; scanning a file again while
+ * a scan of it is pending supersedes that scan. Their results are cached by InspectionCache, so
+ * a file is only scanned again when its text or the options change. Their own scanFile(), if any,
+ * is only used when workers aren't available.
+ *
  * @param {string} languageId
  * @param {{name:string, scanFileAsync:?function(string, string):!{$.Promise},
- *         scanFile:?function(string, string):?{errors:!Array, aborted:boolean}}} provider
+ *         scanFile:?function(string, string):?{errors:!Array, aborted:boolean},
+ *         workerModule:?string, workerCount:?number, getWorkerOptions:?function(string):*}} provider
  *
  * Each error is: { pos:{line,ch}, endPos:?{line,ch}, message:string, type:?Type }
  * If type is unspecified, Type.WARNING is assumed.
@@ -529,15 +617,95 @@ export function register(languageId, provider) {
         // If yes, remove the provider before inserting the most recently loaded one
         const indexOfProvider = _.findIndex(_providers[languageId], function (entry) { return entry.name === provider.name; });
         if (indexOfProvider !== -1) {
+            _releaseWorkerPool(_providers[languageId][indexOfProvider]);
             _providers[languageId].splice(indexOfProvider, 1);
         }
     }
 
+    _acquireWorkerPool(provider);
+
+    ExtensionMonitor.attribute(provider);
     _providers[languageId].push(provider);
 
     requestRun();  // in case a file of this type is open currently
 }
 
+/**
+ * @private
+ * Counts a registration of a provider. A provider with a workerModule gets a worker pool on its
+ * first registration, and shares it between all the languages it is registered for.
+ * @param {!Object} provider
+ */
+function _acquireWorkerPool(provider: Provider) {
+    const entry = _workerPools.get(provider);
+    if (entry) {
+        entry.refCount++;
+    } else if (provider.workerModule && !provider.scanFileAsync) {
+        _runInWorkers(provider);
+    }
+}
+
+/**
+ * @private
+ * Counts the removal of a registration of a provider. The worker pool is disposed with the last
+ * one, and the scanFileAsync() that used it is removed so that registering the provider again
+ * starts a new pool.
+ * @param {!Object} provider
+ */
+function _releaseWorkerPool(provider: Provider) {
+    const entry = _workerPools.get(provider);
+    if (entry && --entry.refCount === 0) {
+        entry.pool.dispose();
+        _workerPools.delete(provider);
+        delete provider.scanFileAsync;
+    }
+}
+
+/**
+ * @private
+ * Gives a provider with a workerModule a scanFileAsync() that runs the module in a worker pool
+ * @param {!Object} provider
+ */
+function _runInWorkers(provider: Provider) {
+    const pool = new InspectionWorkerPool(provider.workerModule!, { Type: Type }, provider.workerCount);
+    const scanFile = provider.scanFile;
+
+    function scanOnMainThread(text, fullPath) {
+        try {
+            return $.Deferred().resolve(scanFile!.call(provider, text, fullPath)).promise();
+        } catch (err) {
+            return $.Deferred().reject(err).promise();
+        }
+    }
+
+    _workerPools.set(provider, { pool: pool, refCount: 1 });
+    provider.scanFileAsync = function (text, fullPath) {
+        if (!pool.isAvailable() && scanFile) {
+            return scanOnMainThread(text, fullPath);
+        }
+
+        // The module only sees the text and the options, so its results can be cached
+        const options = provider.getWorkerOptions ? provider.getWorkerOptions(fullPath) : null;
+        const key = InspectionCache.getKey(provider.name, provider.workerModule!, options, text);
+
+        return InspectionCache.get(key).then(function (cached) {
+            if (cached !== undefined) {
+                return cached;
+            }
+            return pool.scan(text, fullPath, options).then(function (result) {
+                // Superseded scans resolve with null
+                if (result) {
+                    InspectionCache.set(key, result);
+                }
+                return result;
+            }, function (err) {
+                // The module failed to load, or the workers crashed
+                return !pool.isAvailable() && scanFile ? scanOnMainThread(text, fullPath) : err;
+            });
+        });
+    };
+}
+
 /**
  * Returns a list of providers registered for given languageId through register function
  */
@@ -552,6 +720,127 @@ function getProvidersForLanguageId(languageId) {
     return result;
 }
 
+/**
+ * @private
+ * Lists the problems of all files inspected so far in the panel
+ */
+function _renderProjectResults() {
+    if (!_projectInspection) {
+        return;
+    }
+
+    const results = _projectInspection.getResults();
+    const reportList: Array<any> = [];
+    let numProblems = 0;
+    let numListed = 0;
+
+    Object.keys(results).sort().forEach(function (fullPath) {
+        const problems: Array<any> = [];
+
+        (results[fullPath] || []).forEach(function (inspectionResult) {
+            if (!inspectionResult.result) {
+                return;
+            }
+            inspectionResult.result.errors.forEach(function (error) {
+                if (error.type !== Type.META) {
+                    numProblems++;
+                }
+                if (numListed + problems.length < MAX_PROJECT_PROBLEMS) {
+                    const line = error.pos && error.pos.line;
+                    problems.push({
+                        friendlyLine: !isNaN(line) && line >= 0 ? line + 1 : "",
+                        ch: error.pos && error.pos.ch,
+                        message: error.message,
+                        type: error.type,
+                        providerName: inspectionResult.provider.name
+                    });
+                }
+            });
+        });
+
+        if (problems.length) {
+            numListed += problems.length;
+            reportList.push({
+                fullPath: fullPath,
+                displayPath: ProjectManager.makeProjectRelativeIfPossible(fullPath),
+                results: problems
+            });
+        }
+    });
+
+    const scrollTop = $problemsPanelTable.scrollTop();
+    $problemsPanelTable
+        .empty()
+        .append(Mustache.render(ProjectResultsTemplate, {reportList: reportList}))
+        .scrollTop(scrollTop);
+
+    let title = StringUtils.format(Strings.PROJECT_ERRORS_PANEL_TITLE, numProblems, reportList.length);
+    const progress = _projectInspection.getProgress();
+    if (progress.done < progress.total) {
+        title = StringUtils.format(Strings.PROJECT_INSPECTION_PROGRESS, title, progress.done, progress.total);
+    }
+    $problemsPanel.find(".title").text(title);
+
+    _projectHasErrors = reportList.length > 0;
+    if (_projectHasErrors && !_collapsed) {
+        Resizer.show($problemsPanel);
+    } else {
+        Resizer.hide($problemsPanel);
+    }
+}
+
+const _renderProjectResultsDebounced = _.debounce(_renderProjectResults, PROJECT_RENDER_DELAY, { maxWait: PROJECT_RENDER_DELAY * 4 });
+
+/**
+ * @private
+ * Starts or stops inspecting the whole project, as the preferences say
+ */
+function _updateProjectInspection() {
+    const enabled = _enabled && prefs.get(PREF_PROJECT);
+
+    CommandManager.get(Commands.VIEW_TOGGLE_PROJECT_INSPECTION).setChecked(prefs.get(PREF_PROJECT));
+
+    if (enabled && !_projectInspection) {
+        _projectInspection = new BackgroundInspection(
+            function (file) {
+                return inspectFile(file, getProvidersForPath(file.fullPath));
+            },
+            function (fullPath) {
+                return getProvidersForPath(fullPath).length > 0;
+            },
+            _renderProjectResultsDebounced
+        );
+        _projectInspection.start();
+    } else if (!enabled && _projectInspection) {
+        _projectInspection.stop();
+        _projectInspection = null;
+        _projectHasErrors = false;
+        _renderProjectResultsDebounced.cancel();
+    } else {
+        return;
+    }
+
+    if (_enabled) {
+        // Puts the problems of the current file back in the panel
+        requestRun();
+    }
+}
+
+/**
+ * Inspect all files of the project in the background, and list their problems in the panel
+ * instead of the problems of the current file.
+ * @param {?boolean} enabled If omitted, the state is toggled.
+ */
+export function toggleProjectInspection(enabled?) {
+    if (enabled === undefined) {
+        enabled = !prefs.get(PREF_PROJECT);
+    }
+
+    prefs.set(PREF_PROJECT, enabled);
+    prefs.save();
+    _updateProjectInspection();
+}
+
 /**
  * Update DocumentManager listeners.
  */
@@ -601,6 +890,8 @@ export function toggleEnabled(enabled, doNotSave) {
         prefs.save();
     }
 
+    _updateProjectInspection();
+
     // run immediately
     requestRun();
 }
@@ -631,7 +922,7 @@ function toggleCollapsed(collapsed?, doNotSave?) {
     if (_collapsed) {
         Resizer.hide($problemsPanel);
     } else {
-        if (_hasErrors) {
+        if (_projectInspection ? _projectHasErrors : _hasErrors) {
             Resizer.show($problemsPanel);
         }
     }
@@ -641,13 +932,21 @@ function toggleCollapsed(collapsed?, doNotSave?) {
 function handleGotoFirstProblem() {
     requestRun();
     if (_gotoEnabled) {
-        $problemsPanel.find("tr:not(.inspector-section)").first().trigger("click");
+        let $rows = $problemsPanel.find("tr:not(.inspector-section)");
+        if (_projectInspection) {
+            const currentDoc = DocumentManager.getCurrentDocument();
+            $rows = $rows.filter(function (this: HTMLElement) {
+                return !!currentDoc && $(this).attr("data-path") === currentDoc.file.fullPath;
+            });
+        }
+        $rows.first().trigger("click");
     }
 }
 
 // Register command handlers
 CommandManager.register(Strings.CMD_VIEW_TOGGLE_INSPECTION, Commands.VIEW_TOGGLE_INSPECTION,        toggleEnabled);
 CommandManager.register(Strings.CMD_GOTO_FIRST_PROBLEM,     Commands.NAVIGATE_GOTO_FIRST_PROBLEM,   handleGotoFirstProblem);
+CommandManager.register(Strings.CMD_VIEW_TOGGLE_PROJECT_INSPECTION, Commands.VIEW_TOGGLE_PROJECT_INSPECTION, toggleProjectInspection);
 
 // Register preferences
 (prefs.definePreference(PREF_ENABLED, "boolean", brackets.config["linting.enabled_by_default"], {
@@ -664,6 +963,13 @@ CommandManager.register(Strings.CMD_GOTO_FIRST_PROBLEM,     Commands.NAVIGATE_GO
         toggleCollapsed(prefs.get(PREF_COLLAPSED), true);
     });
 
+(prefs.definePreference(PREF_PROJECT, "boolean", false, {
+    description: Strings.DESCRIPTION_LINTING_PROJECT
+}) as unknown as DispatcherEvents)
+    .on("change", function (e, data) {
+        _updateProjectInspection();
+    });
+
 prefs.definePreference(_PREF_ASYNC_TIMEOUT, "number", 10000, {
     description: Strings.DESCRIPTION_ASYNC_TIMEOUT
 });
@@ -707,21 +1013,37 @@ AppInit.htmlReady(function () {
                 }
                 $triangle.toggleClass("expanded");
 
+                // Sections of the project problems are files, whose state isn't saved
                 const providerName = $selectedRow.find("input[type='hidden']").val();
-                prefs.set(providerName + ".collapsed", !isExpanded);
-                prefs.save();
+                if (providerName) {
+                    prefs.set(providerName + ".collapsed", !isExpanded);
+                    prefs.save();
+                }
             } else {
                 // This is a problem marker row, show the result on click
                 // Grab the required position data
                 const lineTd    = $selectedRow.find(".line-number");
                 const line      = parseInt(lineTd.text(), 10) - 1;  // convert friendlyLine back to pos.line
-                // if there is no line number available, don't do anything
-                if (!isNaN(line)) {
+                const fullPath  = $selectedRow.attr("data-path");
+                const currentDoc = DocumentManager.getCurrentDocument();
+
+                const showProblem = function () {
                     const character = lineTd.data("character");
 
                     const editor = EditorManager.getCurrentFullEditor();
                     editor.setCursorPos(line, character, true);
                     MainViewManager.focusActivePane();
+                };
+
+                // if there is no line number available, don't do anything
+                if (isNaN(line)) {
+                    return;
+                }
+                if (fullPath && (!currentDoc || currentDoc.file.fullPath !== fullPath)) {
+                    // A problem of another file of the project
+                    CommandManager.execute(Commands.FILE_OPEN, { fullPath: fullPath }).done(showProblem);
+                } else {
+                    showProblem();
                 }
             }
         });
@@ -735,8 +1057,8 @@ AppInit.htmlReady(function () {
     StatusBar.addIndicator(INDICATOR_ID, $(statusIconHtml), true, "", "", "status-indent");
 
     $("#status-inspection").click(function () {
-        // Clicking indicator toggles error panel, if any errors in current file
-        if (_hasErrors) {
+        // Clicking indicator toggles error panel, if any errors in current file (or the project)
+        if (_hasErrors || _projectHasErrors) {
             toggleCollapsed();
         }
     });
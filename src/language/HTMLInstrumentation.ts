@@ -43,6 +43,8 @@
  *
  * As the user makes edits in the editor, we determine how the DOM structure should change
  * based on the edits to the source code; those edits are generated by getUnappliedEditList().
+ * For large documents, getUnappliedEditListAsync() and scanDocumentAsync() parse the text in a
+ * worker when the whole document has to be reparsed, so structural edits don't block typing.
  * HTMLDocument (in LiveDevelopment) takes those edits and sends them to the browser (via
  * RemoteFunctions) so that the DOM structure in the live preview can be updated accordingly.
  *
@@ -52,6 +54,7 @@
 
 import * as DocumentManager from "document/DocumentManager";
 import * as HTMLSimpleDOM from "language/HTMLSimpleDOM";
+import { NodeTable } from "language/HTMLNodeTable";
 import * as HTMLDOMDiff from "language/HTMLDOMDiff";
 import * as _ from "lodash";
 import { DispatcherEvents } from "utils/EventDispatcher";
@@ -68,11 +71,22 @@ interface DOMUpdaterInit {
 
 const allowIncremental = true;
 
+/**
+ * Documents with at least this many characters are parsed in a worker by
+ * getUnappliedEditListAsync() and scanDocumentAsync(). Smaller ones parse faster than
+ * the round trip to the worker takes.
+ */
+const WORKER_MIN_LENGTH = 100000;
+
 // Hash of scanned documents. Key is the full path of the doc. Value is an object
 // with two properties: timestamp and dom. Timestamp is the document timestamp,
 // dom is the root node of a simple DOM tree.
 let _cachedValues = {};
 
+// Full reparses waiting on the worker, keyed by the full path of the doc. Value is an object
+// with the deferred of the most recent getUnappliedEditListAsync() call for that doc.
+let _pendingUpdates = {};
+
 /**
  * @private
  * Removes the cached information (DOM, timestamp, etc.) used by HTMLInstrumentation
@@ -85,6 +99,10 @@ function _removeDocFromCache(evt, document) {
         delete _cachedValues[document.file.fullPath];
         document.off(".htmlInstrumentation");
     }
+    if (_pendingUpdates.hasOwnProperty(document.file.fullPath)) {
+        _pendingUpdates[document.file.fullPath].deferred.reject();
+        delete _pendingUpdates[document.file.fullPath];
+    }
 }
 
 /**
@@ -274,12 +292,15 @@ function _hasAncestorWithID(node, id) {
     return !!ancestor;
 }
 
-function _DOMUpdaterInit(changeList, editor: Editor) {
-    const result: DOMUpdaterInit = {
-        startOffset: 0,
-        isIncremental: false
-    };
-
+/**
+ * @private
+ * Finds the marked tag that can be reparsed on its own to apply the given changes, if any.
+ * @param {Array} changeList CodeMirror change records for the edits since the last update
+ * @param {Editor} editor The editor containing the instrumented HTML.
+ * @return {?{mark: Object, range: {from: {line: number, ch: number}, to: {line: number, ch: number}}}}
+ *     The mark and its current range, or null if the whole document needs to be reparsed.
+ */
+function _getIncrementalUpdateMark(changeList, editor: Editor) {
     function isDangerousEdit(text) {
         // We don't consider & dangerous since entities only affect text content, not
         // overall DOM structure.
@@ -301,16 +322,31 @@ function _DOMUpdaterInit(changeList, editor: Editor) {
             if (startMark) {
                 const range = startMark.find();
                 if (range) {
-                    result.text = editor._codeMirror.getRange(range.from, range.to);
-                    result.changedTagID = startMark.tagID;
-                    result.startOffsetPos = range.from;
-                    result.startOffset = editor._codeMirror.indexFromPos(result.startOffsetPos);
-                    result.isIncremental = true;
+                    return { mark: startMark, range: range };
                 }
             }
         }
     }
 
+    return null;
+}
+
+function _DOMUpdaterInit(changeList, editor: Editor) {
+    const result: DOMUpdaterInit = {
+        startOffset: 0,
+        isIncremental: false
+    };
+
+    const incrementalMark = _getIncrementalUpdateMark(changeList, editor);
+    if (incrementalMark) {
+        const range = incrementalMark.range;
+        result.text = editor._codeMirror.getRange(range.from, range.to);
+        result.changedTagID = incrementalMark.mark.tagID;
+        result.startOffsetPos = range.from;
+        result.startOffset = editor._codeMirror.indexFromPos(result.startOffsetPos);
+        result.isIncremental = true;
+    }
+
     if (!result.changedTagID) {
         // We weren't able to incrementally update, so just rebuild and diff everything.
         result.text = editor.document.getText();
@@ -332,6 +368,9 @@ function _DOMUpdaterInit(changeList, editor: Editor) {
  *     edits the user made in the editor since previousDOM was built. If provided, and the
  *     edits are not structural, DOMUpdater will do a fast incremental reparse. If not provided,
  *     or if one of the edits changes the DOM structure, DOMUpdater will reparse the whole DOM.
+ * @param {HTMLNodeTable.NodeTable=} nodeTable If provided, the editor's whole text already parsed
+ *     (strictly) by HTMLSimpleDOM.buildNodeTableAsync(); it is used instead of reparsing, and
+ *     changeList is ignored.
  */
 class DOMUpdater extends HTMLSimpleDOM.Builder {
     public isIncremental: boolean;
@@ -339,9 +378,10 @@ class DOMUpdater extends HTMLSimpleDOM.Builder {
     private editor: Editor;
     private cm: CodeMirror.Editor & CodeMirror.Doc;
     private previousDOM;
+    private nodeTable: NodeTable | null;
 
-    constructor(previousDOM, editor, changeList) {
-        const result = _DOMUpdaterInit(changeList, editor);
+    constructor(previousDOM, editor, changeList, nodeTable?: NodeTable) {
+        const result = nodeTable ? { startOffset: 0, isIncremental: false } as DOMUpdaterInit : _DOMUpdaterInit(changeList, editor);
         super(result.text, result.startOffset, result.startOffsetPos);
 
         this.changedTagID = result.changedTagID!;
@@ -349,6 +389,7 @@ class DOMUpdater extends HTMLSimpleDOM.Builder {
         this.editor = editor;
         this.cm = editor._codeMirror;
         this.previousDOM = previousDOM;
+        this.nodeTable = nodeTable || null;
     }
 
     /**
@@ -487,7 +528,7 @@ class DOMUpdater extends HTMLSimpleDOM.Builder {
      */
     public update() {
         const markCache = {};
-        const newSubtree = this.build(true, markCache);
+        const newSubtree = this.nodeTable ? this.buildFromNodeTable(this.nodeTable, markCache) : this.build(true, markCache);
         const result = {
             // default result if we didn't identify a changed portion
             newDOM: newSubtree,
@@ -565,15 +606,17 @@ class DOMUpdater extends HTMLSimpleDOM.Builder {
  *     text changes in the editor since previousDOM was built. If specified, we will
  *     attempt to do an incremental update (although we might fall back to a full update
  *     in various cases). If not specified, we will always do a full update.
+ * @param {HTMLNodeTable.NodeTable=} nodeTable If specified, the node table for the editor's
+ *     current text, used for the full update instead of parsing the text again.
  * @return {{dom: Object, edits: Array}} The new DOM representing the current state of the
  *     editor, and an array of edits that can be applied to update the browser (see
  *     HTMLDOMDiff for more information on the edit format).
  */
-function _updateDOM(previousDOM, editor, changeList) {
+function _updateDOM(previousDOM, editor, changeList, nodeTable?: NodeTable) {
     if (!allowIncremental) {
         changeList = undefined;
     }
-    const updater = new DOMUpdater(previousDOM, editor, changeList);
+    const updater = new DOMUpdater(previousDOM, editor, changeList, nodeTable);
     const result = updater.update();
     if (!result) {
         return { errors: updater.errors };
@@ -612,10 +655,12 @@ function _updateDOM(previousDOM, editor, changeList) {
  * @param {Array} changeList A CodeMirror change list describing the text changes made
  *     in the editor since the last update. If specified, we will attempt to do an
  *     incremental update.
+ * @param {HTMLNodeTable.NodeTable=} nodeTable If specified, the strictly parsed node table
+ *     for the editor's current text; a full update is done from it without reparsing.
  * @return {Array} edits A list of edits to apply in the browser. See HTMLDOMDiff for
  *     more information on the format of these edits.
  */
-function getUnappliedEditList(editor, changeList) {
+function getUnappliedEditList(editor, changeList, nodeTable?: NodeTable) {
     const cachedValue = _cachedValues[editor.document.file.fullPath];
 
     // We might not have a previous DOM if the document was empty before this edit.
@@ -624,7 +669,7 @@ function getUnappliedEditList(editor, changeList) {
         changeList = null;
     }
 
-    const result = _updateDOM(cachedValue && cachedValue.dom, editor, changeList);
+    const result = _updateDOM(cachedValue && cachedValue.dom, editor, changeList, nodeTable);
 
     if (!result.errors) {
         _cachedValues[editor.document.file.fullPath] = {
@@ -641,6 +686,72 @@ function getUnappliedEditList(editor, changeList) {
     return { errors: result.errors };
 }
 
+/**
+ * @private
+ * Parses the editor's text in the worker and resolves the pending update for its document.
+ * If the text changed while the worker was busy, the result is dropped and the newer text
+ * is parsed, so there is at most one request per document in the worker.
+ * @param {Editor} editor The editor containing the instrumented HTML
+ */
+function _runPendingUpdate(editor) {
+    const doc = editor.document;
+    const fullPath = doc.file.fullPath;
+    const version = doc.getVersion();
+
+    HTMLSimpleDOM.buildNodeTableAsync(doc.getText(), true).done(function (nodeTable) {
+        const pending = _pendingUpdates[fullPath];
+        if (!pending || !editor._codeMirror) {
+            // The document was closed or the cache was reset
+            return;
+        }
+        if (doc.getVersion() !== version) {
+            _runPendingUpdate(editor);
+            return;
+        }
+        delete _pendingUpdates[fullPath];
+        pending.deferred.resolve(getUnappliedEditList(editor, null, nodeTable));
+    });
+}
+
+/**
+ * Like getUnappliedEditList(), but for large documents that need a full reparse, the text
+ * is parsed in a worker so the UI doesn't block. Incremental updates and small documents are
+ * still handled synchronously, i.e. the promise is already resolved when it's returned.
+ *
+ * While a reparse is pending, further calls for the same document are folded into it: the
+ * promise of the earlier call is rejected and the latest one gets the edits for all changes
+ * made in the meantime. Apply the edits of resolved promises in the order they resolve.
+ *
+ * @param {Editor} editor The editor containing the instrumented HTML
+ * @param {Array} changeList A CodeMirror change list describing the text changes made
+ *     in the editor since the last call.
+ * @return {$.Promise} Resolved with the same result as getUnappliedEditList(), or rejected
+ *     if a later call superseded this one or the document was closed.
+ */
+function getUnappliedEditListAsync(editor, changeList) {
+    const fullPath = editor.document.file.fullPath;
+    const cachedValue = _cachedValues[fullPath];
+    const pending = _pendingUpdates[fullPath];
+    const deferred = $.Deferred();
+
+    if (pending) {
+        pending.deferred.reject();
+        pending.deferred = deferred;
+        return deferred.promise();
+    }
+
+    const needsFullUpdate = !allowIncremental || !cachedValue || !cachedValue.dom || cachedValue.invalid ||
+        !_getIncrementalUpdateMark(changeList, editor);
+
+    if (!needsFullUpdate || editor.document.getText().length < WORKER_MIN_LENGTH) {
+        return deferred.resolve(getUnappliedEditList(editor, changeList)).promise();
+    }
+
+    _pendingUpdates[fullPath] = { deferred: deferred };
+    _runPendingUpdate(editor);
+    return deferred.promise();
+}
+
 /**
  * @private
  * Add SimpleDOMBuilder metadata to browser DOM tree JSON representation
@@ -722,6 +833,23 @@ function _getBrowserDiff(editor, browserSimpleDOM) {
  * @return {Object} Root DOM node of the document.
  */
 function scanDocument(doc) {
+    const cachedDOM = _getCachedScan(doc);
+    if (cachedDOM) {
+        return cachedDOM;
+    }
+
+    const text = doc.getText();
+    return _cacheScan(doc, HTMLSimpleDOM.build(text));
+}
+
+/**
+ * @private
+ * Starts tracking changes to the doc if needed and returns the DOM cached by the last
+ * scan, if it's still up to date.
+ * @param {Document} doc
+ * @return {?Object} Root DOM node of the document, or null if it needs to be scanned.
+ */
+function _getCachedScan(doc) {
     if (!_cachedValues.hasOwnProperty(doc.file.fullPath)) {
         doc.on("change.htmlInstrumentation", function () {
             if (_cachedValues[doc.file.fullPath]) {
@@ -737,10 +865,17 @@ function scanDocument(doc) {
     if (!doc.isDirty && cachedValue && !cachedValue.dirty && cachedValue.timestamp === doc.diskTimestamp) {
         return cachedValue.dom;
     }
+    return null;
+}
 
-    const text = doc.getText();
-    const dom = HTMLSimpleDOM.build(text);
-
+/**
+ * @private
+ * Caches the result of scanning the doc.
+ * @param {Document} doc
+ * @param {?Object} dom Root DOM node of the document, or null if it couldn't be parsed
+ * @return {?Object} dom
+ */
+function _cacheScan(doc, dom) {
     if (dom) {
         // Cache results
         _cachedValues[doc.file.fullPath] = {
@@ -753,6 +888,36 @@ function scanDocument(doc) {
     return dom;
 }
 
+/**
+ * Like scanDocument(), but large documents are parsed in a worker. The promise is
+ * resolved right away if the cached DOM is up to date or the document is small.
+ *
+ * @param {Document} doc The doc to scan.
+ * @return {$.Promise} Resolved with the root DOM node of the document (null if the
+ *     document couldn't be parsed).
+ */
+function scanDocumentAsync(doc) {
+    const cachedDOM = _getCachedScan(doc);
+    if (cachedDOM) {
+        return $.Deferred().resolve(cachedDOM).promise();
+    }
+
+    const text = doc.getText();
+    if (text.length < WORKER_MIN_LENGTH) {
+        return $.Deferred().resolve(_cacheScan(doc, HTMLSimpleDOM.build(text))).promise();
+    }
+
+    const version = doc.getVersion();
+    return HTMLSimpleDOM.buildNodeTableAsync(text).then(function (nodeTable) {
+        if (doc.getVersion() !== version) {
+            // Changed while we were waiting; scan the new text instead
+            return scanDocumentAsync(doc);
+        }
+        // Keep a DOM that scanDocument() cached in the meantime, its IDs may already be in use
+        return _getCachedScan(doc) || _cacheScan(doc, HTMLSimpleDOM.buildFromNodeTable(nodeTable));
+    });
+}
+
 /**
  * Generate instrumented HTML for the specified editor's document, and mark the associated tag
  * ranges in the editor. Each tag has a "data-brackets-id" attribute with a unique ID for its
@@ -836,6 +1001,7 @@ function _markText(editor) {
  */
 function _resetCache() {
     _cachedValues = {};
+    _pendingUpdates = {};
 }
 
 // private methods
@@ -851,5 +1017,7 @@ exports._resetCache                 = _resetCache;
 
 // public API
 exports.scanDocument                = scanDocument;
+exports.scanDocumentAsync           = scanDocumentAsync;
 exports.generateInstrumentedHTML    = generateInstrumentedHTML;
 exports.getUnappliedEditList        = getUnappliedEditList;
+exports.getUnappliedEditListAsync   = getUnappliedEditListAsync;
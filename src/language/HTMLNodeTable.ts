@@ -0,0 +1,411 @@
+/*
+ * Copyright (c) 2013 - 2017 Adobe Systems Incorporated. All rights reserved.
+ * Copyright (c) 2018 - present The quadre code authors. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ *
+ */
+
+/*unittests: HTML SimpleDOM*/
+
+// This module has no dependencies besides the tokenizer, so that it can also be loaded in
+// HTMLNodeTableWorker.js.
+
+import { Tokenizer } from "language/HTMLTokenizer";
+
+/**
+ * A list of tags whose start causes any of a given set of immediate parent
+ * tags to close. This mostly comes from the HTML5 spec section on omitted close tags:
+ * http://www.w3.org/html/wg/drafts/html/master/syntax.html#optional-tags
+ * This doesn't handle general content model violations.
+ */
+const openImpliesClose = {
+    li      : { li: true },
+    dt      : { dd: true, dt: true },
+    dd      : { dd: true, dt: true },
+    address : { p: true },
+    article : { p: true },
+    aside   : { p: true },
+    blockquote : { p: true },
+    colgroup: { caption: true },
+    details : { p: true },
+    dir     : { p: true },
+    div     : { p: true },
+    dl      : { p: true },
+    fieldset: { p: true },
+    figcaption: { p: true },
+    figure  : { p: true },
+    footer  : { p: true },
+    form    : { p: true },
+    h1      : { p: true },
+    h2      : { p: true },
+    h3      : { p: true },
+    h4      : { p: true },
+    h5      : { p: true },
+    h6      : { p: true },
+    header  : { p: true },
+    hgroup  : { p: true },
+    hr      : { p: true },
+    main    : { p: true },
+    menu    : { p: true },
+    nav     : { p: true },
+    ol      : { p: true },
+    p       : { p: true },
+    pre     : { p: true },
+    section : { p: true },
+    table   : { p: true },
+    ul      : { p: true },
+    rb      : { rb: true, rt: true, rtc: true, rp: true },
+    rp      : { rb: true, rt: true, rp: true },
+    rt      : { rb: true, rt: true, rp: true },
+    rtc     : { rb: true, rt: true, rtc: true, rp: true },
+    optgroup: { optgroup: true, option: true },
+    option  : { option: true },
+    tbody   : { caption: true, colgroup: true, thead: true, tbody: true, tfoot: true },
+    tfoot   : { caption: true, colgroup: true, thead: true, tbody: true },
+    thead   : { caption: true, colgroup: true },
+    tr      : { tr: true, th: true, td: true, caption: true },
+    th      : { th: true, td: true },
+    td      : { th: true, td: true },
+    body    : { head: true }
+};
+
+/**
+ * A list of elements which are automatically closed when their parent is closed:
+ * http://www.w3.org/html/wg/drafts/html/master/syntax.html#optional-tags
+ */
+const optionalClose = {
+    html: true,
+    body: true,
+    li: true,
+    dd: true,
+    dt: true, // This is not actually correct, but showing a syntax error is not helpful
+    p: true,
+    rb: true,
+    rt: true,
+    rtc: true,
+    rp: true,
+    optgroup: true,
+    option: true,
+    colgroup: true,
+    caption: true,
+    tbody: true,
+    tfoot: true,
+    tr: true,
+    td: true,
+    th: true
+};
+
+// TODO: handle optional start tags
+
+/**
+ * A list of tags that are self-closing (do not contain other elements).
+ * Mostly taken from http://www.w3.org/html/wg/drafts/html/master/syntax.html#void-elements
+ */
+const voidElements = {
+    area: true,
+    base: true,
+    basefont: true,
+    br: true,
+    col: true,
+    command: true,
+    embed: true,
+    frame: true,
+    hr: true,
+    img: true,
+    input: true,
+    isindex: true,
+    keygen: true,
+    link: true,
+    menuitem: true,
+    meta: true,
+    param: true,
+    source: true,
+    track: true,
+    wbr: true
+};
+
+/**
+ * Number of entries per node in NodeTable.nodes, and the offset of each field in an entry.
+ * Fields that a node doesn't have (e.g. positions of text nodes) are -1. NODE_OPEN_TAG_ENDED
+ * is 1 once the end of an element's open tag was seen, i.e. its attributes are complete.
+ */
+export const NODE_SIZE           = 8;
+export const NODE_PARENT         = 0;
+export const NODE_OPEN_TAG_ENDED = 1;
+export const NODE_START          = 2;
+export const NODE_START_LINE     = 3;
+export const NODE_START_CH       = 4;
+export const NODE_END            = 5;
+export const NODE_END_LINE       = 6;
+export const NODE_END_CH         = 7;
+
+/**
+ * A compact description of the SimpleDOM for a piece of HTML, as built by build(). It holds
+ * everything HTMLSimpleDOM.Builder needs to create the SimpleNode tree, but no node objects,
+ * so it's cheap to send from a worker (the numeric fields are in a transferable Int32Array).
+ *
+ * Nodes are listed in the order the Builder creates them, which is also document order:
+ * a parent always comes before its children, and children are listed in order.
+ *
+ * @typedef {{nodes: Int32Array, tags: Array.<?string>, attributes: Array.<?Object>,
+ *            contents: Array.<?string>, root: number, errors: ?Array.<Object>}}
+ *
+ *     nodes: NODE_SIZE numbers per node, see the NODE_* field offsets above
+ *     tags: lowercased tag name of each element, or null for text nodes
+ *     attributes: attributes of each element, or null for text nodes
+ *     contents: text of each text node, or null for elements
+ *     root: index of the node that is the root of the DOM, or -1 if the parse failed
+ *     errors: errors found while parsing, in the same format as HTMLSimpleDOM.Builder.errors,
+ *         or null if there were none
+ */
+export interface NodeTable {
+    nodes: Int32Array;
+    tags: Array<string | null>;
+    attributes: Array<Record<string, string> | null>;
+    contents: Array<string | null>;
+    root: number;
+    errors: Array<any> | null;
+}
+
+/**
+ * @private
+ *
+ * Adds two {line, ch}-style positions, returning a new pos.
+ */
+export function _addPos(pos1, pos2) {
+    return {line: pos1.line + pos2.line, ch: (pos2.line === 0 ? pos1.ch + pos2.ch : pos2.ch)};
+}
+
+/**
+ * @private
+ *
+ * Offsets the character offset of the given {line, ch} pos by the given amount and returns a new
+ * pos. Not for general purpose use as it does not account for line boundaries.
+ */
+export function _offsetPos(pos, offset) {
+    return {line: pos.line, ch: pos.ch + offset};
+}
+
+/**
+ * Parses the given HTML into a NodeTable. This does the tree construction part of building a
+ * SimpleDOM (matching tags up, closing implied tags, etc.); HTMLSimpleDOM.Builder turns the
+ * result into SimpleNodes.
+ *
+ * @param {string} text The text to parse
+ * @param {?bool} strict if errors are detected, halt and return a table with no root
+ * @param {?int} startOffset starting offset in the text
+ * @param {?{line: int, ch: int}} startOffsetPos line/ch position in the text
+ * @return {NodeTable}
+ */
+export function build(text: string, strict?: boolean, startOffset?: number, startOffsetPos?): NodeTable {
+    const t = new Tokenizer(text);
+    const nodes: Array<number> = [];
+    const tags: Array<string | null> = [];
+    const attributes: Array<Record<string, string> | null> = [];
+    const contents: Array<string | null> = [];
+    const stack: Array<number> = [];
+    let errors: Array<any> | null = null;
+    let currentTag = -1;
+    let lastClosedTag = -1;
+    let lastTextNode = -1;
+    let attributeName: string | null = null;
+    let token;
+
+    startOffset = startOffset || 0;
+    startOffsetPos = startOffsetPos || {line: 0, ch: 0};
+
+    function result(root) {
+        return {
+            nodes: new Int32Array(nodes),
+            tags: tags,
+            attributes: attributes,
+            contents: contents,
+            root: root,
+            errors: errors
+        };
+    }
+
+    function fail(errorToken) {
+        const error: any = { token: errorToken };
+        const startPos    = errorToken ? (errorToken.startPos || errorToken.endPos) : startOffsetPos;
+        const endPos      = errorToken ? errorToken.endPos : startOffsetPos;
+
+        error.startPos = _addPos(startOffsetPos, startPos);
+        error.endPos = _addPos(startOffsetPos, endPos);
+
+        errors = errors || [];
+        errors.push(error);
+        return result(-1);
+    }
+
+    function addNode(parent, tag, attrs, content) {
+        const index = tags.length;
+        nodes.push(parent, 0, -1, -1, -1, -1, -1, -1);
+        tags.push(tag);
+        attributes.push(attrs);
+        contents.push(content);
+        return index;
+    }
+
+    function setStart(node, start, pos) {
+        const base = node * NODE_SIZE;
+        nodes[base + NODE_START] = start;
+        nodes[base + NODE_START_LINE] = pos.line;
+        nodes[base + NODE_START_CH] = pos.ch;
+    }
+
+    function setEnd(node, end, pos) {
+        const base = node * NODE_SIZE;
+        nodes[base + NODE_END] = end;
+        nodes[base + NODE_END_LINE] = pos.line;
+        nodes[base + NODE_END_CH] = pos.ch;
+    }
+
+    function closeTag(endIndex, endPos) {
+        lastClosedTag = stack.pop()!;
+        setEnd(lastClosedTag, startOffset + endIndex, _addPos(startOffsetPos, endPos));
+    }
+
+    // tslint:disable-next-line:no-conditional-assignment
+    while ((token = t.nextToken()) !== null) {
+        // lastTextNode is used to glue text nodes together
+        // If the last node we saw was text but this one is not, then we're done gluing.
+        // If this node is a comment, we might still encounter more text.
+        if (token.type !== "text" && token.type !== "comment") {
+            lastTextNode = -1;
+        }
+
+        if (token.type === "error") {
+            return fail(token);
+        }
+
+        if (token.type === "opentagname") {
+            const newTagName = token.contents.toLowerCase();
+
+            if (openImpliesClose.hasOwnProperty(newTagName)) {
+                const closable = openImpliesClose[newTagName];
+                while (stack.length > 0 && closable.hasOwnProperty(tags[stack[stack.length - 1]]!)) {
+                    // Close the previous tag at the start of this tag.
+                    // Adjust backwards for the < before the tag name.
+                    closeTag(token.start - 1, _offsetPos(token.startPos, -1));
+                }
+            }
+
+            const newTag = addNode(stack.length ? stack[stack.length - 1] : -1, newTagName, {}, null);
+            // ok because we know the previous char was a "<"
+            setStart(newTag, startOffset + token.start - 1, _addPos(startOffsetPos, _offsetPos(token.startPos, -1)));
+            currentTag = newTag;
+
+            if (!voidElements.hasOwnProperty(newTagName)) {
+                stack.push(newTag);
+            }
+        } else if (token.type === "opentagend" || token.type === "selfclosingtag") {
+            // TODO: disallow <p/>?
+            if (currentTag !== -1) {
+                if (token.type === "selfclosingtag" && stack.length && stack[stack.length - 1] === currentTag) {
+                    // This must have been a self-closing tag that we didn't identify as a void element
+                    // (e.g. an SVG tag). Pop it off the stack as if we had encountered its close tag.
+                    closeTag(token.end, token.endPos);
+                } else {
+                    // We're ending an open tag. Record the end of the open tag as the end of the
+                    // range. (If we later find a close tag for this tag, the end will get overwritten
+                    // with the end of the close tag. In the case of a self-closing tag, we should never
+                    // encounter that.)
+                    setEnd(currentTag, startOffset + token.end, _addPos(startOffsetPos, token.endPos));
+                    nodes[currentTag * NODE_SIZE + NODE_OPEN_TAG_ENDED] = 1;
+                    lastClosedTag = currentTag;
+                    currentTag = -1;
+                }
+            }
+        } else if (token.type === "closetag") {
+            // If this is a self-closing element, ignore the close tag.
+            const closeTagName = token.contents.toLowerCase();
+            if (!voidElements.hasOwnProperty(closeTagName)) {
+                // Find the topmost item on the stack that matches. If we can't find one, assume
+                // this is just a dangling closing tag and ignore it.
+                let i;
+                for (i = stack.length - 1; i >= 0; i--) {
+                    if (tags[stack[i]] === closeTagName) {
+                        break;
+                    }
+                }
+                if (i >= 0) {
+                    do {
+                        // For all tags we're implicitly closing (before we hit the matching tag), we want the
+                        // implied end to be the beginning of the close tag (which is two characters, "</", before
+                        // the start of the tagname). For the actual tag we're explicitly closing, we want the
+                        // implied end to be the end of the close tag (which is one character, ">", after the end of
+                        // the tagname).
+                        if (stack.length === i + 1) {
+                            closeTag(token.end + 1, _offsetPos(token.endPos, 1));
+                        } else {
+                            if (strict && !optionalClose.hasOwnProperty(tags[stack[stack.length - 1]]!)) {
+                                // If we're in strict mode, treat unbalanced tags as invalid.
+                                return fail(token);
+                            }
+                            closeTag(token.start - 2, _offsetPos(token.startPos, -2));
+                        }
+                    } while (stack.length > i);
+                } else {
+                    // If we're in strict mode, treat unmatched close tags as invalid. Otherwise
+                    // we just silently ignore them.
+                    if (strict) {
+                        return fail(token);
+                    }
+                }
+            }
+        } else if (token.type === "attribname") {
+            attributeName = token.contents.toLowerCase();
+            // Set the value to the empty string in case this is an empty attribute. If it's not,
+            // it will get overwritten by the attribvalue later.
+            attributes[currentTag]![attributeName!] = "";
+        } else if (token.type === "attribvalue" && attributeName !== null) {
+            attributes[currentTag]![attributeName] = token.contents;
+            attributeName = null;
+        } else if (token.type === "text") {
+            if (stack.length) {
+                // Check to see if we're continuing a previous text.
+                if (lastTextNode !== -1) {
+                    contents[lastTextNode] += token.contents;
+                } else {
+                    lastTextNode = addNode(stack[stack.length - 1], null, null, token.contents);
+                }
+            }
+        }
+    }
+
+    // If we have any tags hanging open, fail the parse if we're in strict mode,
+    // otherwise close them at the end of the document.
+    while (stack.length) {
+        if (strict && !optionalClose.hasOwnProperty(tags[stack[stack.length - 1]]!)) {
+            return fail(token);
+        }
+        closeTag(text.length, t._indexPos);
+    }
+
+    if (lastClosedTag === -1) {
+        // This can happen if the document has no nontrivial content, or if the user tries to
+        // have something at the root other than the HTML tag. In all such cases, we treat the
+        // document as invalid.
+        return fail(token);
+    }
+
+    return result(lastClosedTag);
+}
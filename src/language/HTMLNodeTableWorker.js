@@ -0,0 +1,61 @@
+/*
+ * Copyright (c) 2018 - present The quadre code authors. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ *
+ */
+
+/*eslint-env worker */
+/*global requirejs */
+
+/*unittests: HTML SimpleDOM*/
+
+/**
+ * Worker used by HTMLSimpleDOM.buildNodeTableAsync(). Each message is a request
+ * {id: number, text: string, strict: boolean}; the reply is {id: number, nodeTable: NodeTable},
+ * with the node table's numeric data transferred rather than copied.
+ */
+(function () {
+    "use strict";
+
+    var HTMLNodeTable = null,
+        queue = [];
+
+    function handleRequest(request) {
+        var nodeTable = HTMLNodeTable.build(request.text, request.strict);
+        self.postMessage({ id: request.id, nodeTable: nodeTable }, [nodeTable.nodes.buffer]);
+    }
+
+    // Requests can arrive before the modules are loaded
+    self.onmessage = function (e) {
+        if (HTMLNodeTable) {
+            handleRequest(e.data);
+        } else {
+            queue.push(e.data);
+        }
+    };
+
+    importScripts("../../node_modules/requirejs/require.js");
+    requirejs.config({ baseUrl: "../" });
+    requirejs(["language/HTMLNodeTable"], function (module) {
+        HTMLNodeTable = module;
+        queue.forEach(handleRequest);
+        queue = null;
+    });
+}());
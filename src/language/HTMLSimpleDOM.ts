@@ -24,126 +24,17 @@
 
 /*unittests: HTML Instrumentation*/
 
-import { Tokenizer } from "language/HTMLTokenizer";
+import * as HTMLNodeTable from "language/HTMLNodeTable";
+import * as FileUtils from "file/FileUtils";
 import * as MurmurHash3 from "thirdparty/murmurhash3_gc";
 import * as PerfUtils from "utils/PerfUtils";
 
+export { _offsetPos } from "language/HTMLNodeTable";
+
 export const _seed = Math.floor(Math.random() * 65535);
 
 let tagID = 1;
 
-/**
- * A list of tags whose start causes any of a given set of immediate parent
- * tags to close. This mostly comes from the HTML5 spec section on omitted close tags:
- * http://www.w3.org/html/wg/drafts/html/master/syntax.html#optional-tags
- * This doesn't handle general content model violations.
- */
-const openImpliesClose = {
-    li      : { li: true },
-    dt      : { dd: true, dt: true },
-    dd      : { dd: true, dt: true },
-    address : { p: true },
-    article : { p: true },
-    aside   : { p: true },
-    blockquote : { p: true },
-    colgroup: { caption: true },
-    details : { p: true },
-    dir     : { p: true },
-    div     : { p: true },
-    dl      : { p: true },
-    fieldset: { p: true },
-    figcaption: { p: true },
-    figure  : { p: true },
-    footer  : { p: true },
-    form    : { p: true },
-    h1      : { p: true },
-    h2      : { p: true },
-    h3      : { p: true },
-    h4      : { p: true },
-    h5      : { p: true },
-    h6      : { p: true },
-    header  : { p: true },
-    hgroup  : { p: true },
-    hr      : { p: true },
-    main    : { p: true },
-    menu    : { p: true },
-    nav     : { p: true },
-    ol      : { p: true },
-    p       : { p: true },
-    pre     : { p: true },
-    section : { p: true },
-    table   : { p: true },
-    ul      : { p: true },
-    rb      : { rb: true, rt: true, rtc: true, rp: true },
-    rp      : { rb: true, rt: true, rp: true },
-    rt      : { rb: true, rt: true, rp: true },
-    rtc     : { rb: true, rt: true, rtc: true, rp: true },
-    optgroup: { optgroup: true, option: true },
-    option  : { option: true },
-    tbody   : { caption: true, colgroup: true, thead: true, tbody: true, tfoot: true },
-    tfoot   : { caption: true, colgroup: true, thead: true, tbody: true },
-    thead   : { caption: true, colgroup: true },
-    tr      : { tr: true, th: true, td: true, caption: true },
-    th      : { th: true, td: true },
-    td      : { th: true, td: true },
-    body    : { head: true }
-};
-
-/**
- * A list of elements which are automatically closed when their parent is closed:
- * http://www.w3.org/html/wg/drafts/html/master/syntax.html#optional-tags
- */
-const optionalClose = {
-    html: true,
-    body: true,
-    li: true,
-    dd: true,
-    dt: true, // This is not actually correct, but showing a syntax error is not helpful
-    p: true,
-    rb: true,
-    rt: true,
-    rtc: true,
-    rp: true,
-    optgroup: true,
-    option: true,
-    colgroup: true,
-    caption: true,
-    tbody: true,
-    tfoot: true,
-    tr: true,
-    td: true,
-    th: true
-};
-
-// TODO: handle optional start tags
-
-/**
- * A list of tags that are self-closing (do not contain other elements).
- * Mostly taken from http://www.w3.org/html/wg/drafts/html/master/syntax.html#void-elements
- */
-const voidElements = {
-    area: true,
-    base: true,
-    basefont: true,
-    br: true,
-    col: true,
-    command: true,
-    embed: true,
-    frame: true,
-    hr: true,
-    img: true,
-    input: true,
-    isindex: true,
-    keygen: true,
-    link: true,
-    menuitem: true,
-    meta: true,
-    param: true,
-    source: true,
-    track: true,
-    wbr: true
-};
-
 /**
  * A SimpleNode represents one node in a SimpleDOM tree. Each node can have
  * any set of properties on it, though there are a couple of assumptions made.
@@ -243,25 +134,6 @@ export function _getTextNodeID(textNode) {
     return textNode.parent.children[childIndex - 1].tagID + "t";
 }
 
-/**
- * @private
- *
- * Adds two {line, ch}-style positions, returning a new pos.
- */
-function _addPos(pos1, pos2) {
-    return {line: pos1.line + pos2.line, ch: (pos2.line === 0 ? pos1.ch + pos2.ch : pos2.ch)};
-}
-
-/**
- * @private
- *
- * Offsets the character offset of the given {line, ch} pos by the given amount and returns a new
- * pos. Not for general purpose use as it does not account for line boundaries.
- */
-export function _offsetPos(pos, offset) {
-    return {line: pos.line, ch: pos.ch + offset};
-}
-
 /**
  * A Builder creates a SimpleDOM tree of SimpleNode objects representing the
  * "important" contents of an HTML document. It does not include things like comments.
@@ -274,38 +146,17 @@ export function _offsetPos(pos, offset) {
  * @param {?{line: int, ch: int}} startOffsetPos line/ch position in the text
  */
 export class Builder {
-    private stack: Array<any>;
     private text: string;
-    private t: Tokenizer;
-    private currentTag;
     private startOffset: number;
     private startOffsetPos;
     public errors: Array<unknown>;
 
     constructor(text, startOffset?, startOffsetPos?) {
-        this.stack = [];
         this.text = text;
-        this.t = new Tokenizer(text);
-        this.currentTag = null;
         this.startOffset = startOffset || 0;
         this.startOffsetPos = startOffsetPos || {line: 0, ch: 0};
     }
 
-    private _logError(token) {
-        const error: any = { token: token };
-        const startPos    = token ? (token.startPos || token.endPos) : this.startOffsetPos;
-        const endPos      = token ? token.endPos : this.startOffsetPos;
-
-        error.startPos = _addPos(this.startOffsetPos, startPos);
-        error.endPos = _addPos(this.startOffsetPos, endPos);
-
-        if (!this.errors) {
-            this.errors = [];
-        }
-
-        this.errors.push(error);
-    }
-
     /**
      * Builds the SimpleDOM.
      *
@@ -314,16 +165,6 @@ export class Builder {
      * @return {SimpleNode} root of tree or null if parsing failed
      */
     public build(strict?, markCache?) {
-        const self = this;
-        let token;
-        let lastClosedTag;
-        let lastTextNode;
-        const stack = this.stack;
-        let attributeName: string | null = null;
-        const nodeMap = {};
-
-        markCache = markCache || {};
-
         // Start timers for building full and partial DOMs.
         // Appropriate timer is used, and the other is discarded.
         let timerBuildFull = "HTMLInstr. Build DOM Full";
@@ -333,196 +174,111 @@ export class Builder {
         timerBuildFull = timers[0];
         timerBuildPart = timers[1];
 
-        function closeTag(endIndex, endPos) {
-            lastClosedTag = stack[stack.length - 1];
-            stack.pop();
-            lastClosedTag.update();
+        const nodeTable = HTMLNodeTable.build(this.text, strict, this.startOffset, this.startOffsetPos);
+        const dom = this.buildFromNodeTable(nodeTable, markCache);
 
-            lastClosedTag.end = self.startOffset + endIndex;
-            lastClosedTag.endPos = _addPos(self.startOffsetPos, endPos);
+        if (dom) {
+            PerfUtils.addMeasurement(timerBuildFull);       // use
+            PerfUtils.finalizeMeasurement(timerBuildPart);  // discard
+        } else {
+            PerfUtils.finalizeMeasurement(timerBuildFull);  // discard
+            PerfUtils.addMeasurement(timerBuildPart);       // use
         }
 
-        // tslint:disable-next-line:no-conditional-assignment
-        while ((token = this.t.nextToken()) !== null) {
-            // lastTextNode is used to glue text nodes together
-            // If the last node we saw was text but this one is not, then we're done gluing.
-            // If this node is a comment, we might still encounter more text.
-            if (token.type !== "text" && token.type !== "comment" && lastTextNode) {
-                lastTextNode = null;
-            }
+        return dom;
+    }
 
-            if (token.type === "error") {
-                PerfUtils.finalizeMeasurement(timerBuildFull);  // discard
-                PerfUtils.addMeasurement(timerBuildPart);       // use
-                this._logError(token);
-                return null;
-            }
+    /**
+     * Builds the SimpleDOM from a node table that was already parsed from the text, e.g.
+     * by buildNodeTableAsync(). Tag IDs are assigned here, so the result is the same as
+     * calling `build()` on the same text.
+     *
+     * @param {HTMLNodeTable.NodeTable} nodeTable
+     * @param {?Object} markCache a cache that can be used in ID generation (is passed to `getID`)
+     * @return {SimpleNode} root of tree or null if parsing failed
+     */
+    public buildFromNodeTable(nodeTable: HTMLNodeTable.NodeTable, markCache?) {
+        const table = nodeTable.nodes;
+        const length = nodeTable.tags.length;
+        const created: Array<any> = new Array(length);
+        const nodeMap = {};
 
-            if (token.type === "opentagname") {
-                const newTagName = token.contents.toLowerCase();
+        if (nodeTable.errors) {
+            this.errors = nodeTable.errors;
+        }
+        if (nodeTable.root === -1) {
+            return null;
+        }
 
-                if (openImpliesClose.hasOwnProperty(newTagName)) {
-                    const closable = openImpliesClose[newTagName];
-                    while (stack.length > 0 && closable.hasOwnProperty(stack[stack.length - 1].tag)) {
-                        // Close the previous tag at the start of this tag.
-                        // Adjust backwards for the < before the tag name.
-                        closeTag(token.start - 1, _offsetPos(token.startPos, -1));
-                    }
-                }
+        markCache = markCache || {};
 
-                const newTag = new SimpleNode({
-                    tag: token.contents.toLowerCase(),
+        // Create the nodes in the order they were parsed, so that tag IDs are handed out in
+        // the same order as they would be while tokenizing.
+        for (let i = 0; i < length; i++) {
+            const base = i * HTMLNodeTable.NODE_SIZE;
+            const parentIndex = table[base + HTMLNodeTable.NODE_PARENT];
+            const parent = parentIndex === -1 ? null : created[parentIndex];
+            const tag = nodeTable.tags[i];
+            let newNode;
+
+            if (tag !== null) {
+                newNode = new SimpleNode({
+                    tag: tag,
                     children: [],
                     attributes: {},
-                    parent: (stack.length ? stack[stack.length - 1] : null),
-                    start: this.startOffset + token.start - 1,
-                    startPos: _addPos(this.startOffsetPos, _offsetPos(token.startPos, -1)) // ok because we know the previous char was a "<"
+                    parent: parent,
+                    start: table[base + HTMLNodeTable.NODE_START],
+                    startPos: {
+                        line: table[base + HTMLNodeTable.NODE_START_LINE],
+                        ch: table[base + HTMLNodeTable.NODE_START_CH]
+                    }
                 });
-                newTag.tagID = this.getID(newTag, markCache);
+                newNode.tagID = this.getID(newNode, markCache);
 
                 // During undo in particular, it's possible that tag IDs may be reused and
                 // the marks in the document may be misleading. If a tag ID has been reused,
                 // we apply a new tag ID to ensure that our edits come out correctly.
-                if (nodeMap[newTag.tagID]) {
-                    newTag.tagID = this.getNewID();
+                if (nodeMap[newNode.tagID]) {
+                    newNode.tagID = this.getNewID();
                 }
 
-                nodeMap[newTag.tagID] = newTag;
-                if (newTag.parent) {
-                    newTag.parent.children.push(newTag);
-                }
-                this.currentTag = newTag;
-
-                if (voidElements.hasOwnProperty(newTag.tag)) {
-                    // This is a self-closing element.
-                    newTag.update();
-                } else {
-                    stack.push(newTag);
-                }
-            } else if (token.type === "opentagend" || token.type === "selfclosingtag") {
-                // TODO: disallow <p/>?
-                if (this.currentTag) {
-                    if (token.type === "selfclosingtag" && stack.length && stack[stack.length - 1] === this.currentTag) {
-                        // This must have been a self-closing tag that we didn't identify as a void element
-                        // (e.g. an SVG tag). Pop it off the stack as if we had encountered its close tag.
-                        closeTag(token.end, token.endPos);
-                    } else {
-                        // We're ending an open tag. Record the end of the open tag as the end of the
-                        // range. (If we later find a close tag for this tag, the end will get overwritten
-                        // with the end of the close tag. In the case of a self-closing tag, we should never
-                        // encounter that.)
-                        // Note that we don't need to update the signature here because the signature only
-                        // relies on the tag name and ID, and isn't affected by the tag's attributes, so
-                        // the signature we calculated when creating the tag is still the same. If we later
-                        // find a close tag for this tag, we'll update the signature to account for its
-                        // children at that point (in the next "else" case).
-                        this.currentTag.end = this.startOffset + token.end;
-                        this.currentTag.endPos = _addPos(this.startOffsetPos, token.endPos);
-                        lastClosedTag = this.currentTag;
-                        this.currentTag.updateAttributeSignature();
-                        this.currentTag = null;
-                    }
-                }
-            } else if (token.type === "closetag") {
-                // If this is a self-closing element, ignore the close tag.
-                const closeTagName = token.contents.toLowerCase();
-                if (!voidElements.hasOwnProperty(closeTagName)) {
-                    // Find the topmost item on the stack that matches. If we can't find one, assume
-                    // this is just a dangling closing tag and ignore it.
-                    let i;
-                    for (i = stack.length - 1; i >= 0; i--) {
-                        if (stack[i].tag === closeTagName) {
-                            break;
-                        }
-                    }
-                    if (i >= 0) {
-                        do {
-                            // For all tags we're implicitly closing (before we hit the matching tag), we want the
-                            // implied end to be the beginning of the close tag (which is two characters, "</", before
-                            // the start of the tagname). For the actual tag we're explicitly closing, we want the
-                            // implied end to be the end of the close tag (which is one character, ">", after the end of
-                            // the tagname).
-                            if (stack.length === i + 1) {
-                                closeTag(token.end + 1, _offsetPos(token.endPos, 1));
-                            } else {
-                                if (strict && !optionalClose.hasOwnProperty(stack[stack.length - 1].tag)) {
-                                    // If we're in strict mode, treat unbalanced tags as invalid.
-                                    PerfUtils.finalizeMeasurement(timerBuildFull);
-                                    PerfUtils.addMeasurement(timerBuildPart);
-                                    this._logError(token);
-                                    return null;
-                                }
-                                closeTag(token.start - 2, _offsetPos(token.startPos, -2));
-                            }
-                        } while (stack.length > i);
-                    } else {
-                        // If we're in strict mode, treat unmatched close tags as invalid. Otherwise
-                        // we just silently ignore them.
-                        if (strict) {
-                            PerfUtils.finalizeMeasurement(timerBuildFull);
-                            PerfUtils.addMeasurement(timerBuildPart);
-                            this._logError(token);
-                            return null;
-                        }
-                    }
+                nodeMap[newNode.tagID] = newNode;
+                if (parent) {
+                    parent.children.push(newNode);
                 }
-            } else if (token.type === "attribname") {
-                attributeName = token.contents.toLowerCase();
-                // Set the value to the empty string in case this is an empty attribute. If it's not,
-                // it will get overwritten by the attribvalue later.
-                this.currentTag.attributes[attributeName!] = "";
-            } else if (token.type === "attribvalue" && attributeName !== null) {
-                this.currentTag.attributes[attributeName] = token.contents;
-                attributeName = null;
-            } else if (token.type === "text") {
-                if (stack.length) {
-                    const parent = stack[stack.length - 1];
-                    let newNode;
-
-                    // Check to see if we're continuing a previous text.
-                    if (lastTextNode) {
-                        newNode = lastTextNode;
-                        newNode.content += token.contents;
-                    } else {
-                        newNode = new SimpleNode({
-                            parent: stack[stack.length - 1],
-                            content: token.contents
-                        });
-                        parent.children.push(newNode);
-                        newNode.tagID = _getTextNodeID(newNode);
-                        nodeMap[newNode.tagID] = newNode;
-                        lastTextNode = newNode;
-                    }
 
-                    newNode.update();
+                newNode.attributes = nodeTable.attributes[i];
+                if (table[base + HTMLNodeTable.NODE_END] !== -1) {
+                    newNode.end = table[base + HTMLNodeTable.NODE_END];
+                    newNode.endPos = {
+                        line: table[base + HTMLNodeTable.NODE_END_LINE],
+                        ch: table[base + HTMLNodeTable.NODE_END_CH]
+                    };
                 }
+            } else {
+                newNode = new SimpleNode({
+                    parent: parent,
+                    content: nodeTable.contents[i]
+                });
+                parent!.children.push(newNode);
+                newNode.tagID = _getTextNodeID(newNode);
+                nodeMap[newNode.tagID] = newNode;
             }
+            created[i] = newNode;
         }
 
-        // If we have any tags hanging open, fail the parse if we're in strict mode,
-        // otherwise close them at the end of the document.
-        while (stack.length) {
-            if (strict && !optionalClose.hasOwnProperty(stack[stack.length - 1].tag)) {
-                PerfUtils.finalizeMeasurement(timerBuildFull);
-                PerfUtils.addMeasurement(timerBuildPart);
-                this._logError(token);
-                return null;
+        // Children always come after their parent, so walking backwards computes
+        // every node's signatures before they are needed for its parent's.
+        for (let i = length - 1; i >= 0; i--) {
+            const node = created[i];
+            if (node.isElement() && table[i * HTMLNodeTable.NODE_SIZE + HTMLNodeTable.NODE_OPEN_TAG_ENDED]) {
+                node.updateAttributeSignature();
             }
-            closeTag(this.text.length, this.t._indexPos);
-        }
-
-        const dom = lastClosedTag;
-        if (!dom) {
-            // This can happen if the document has no nontrivial content, or if the user tries to
-            // have something at the root other than the HTML tag. In all such cases, we treat the
-            // document as invalid.
-            this._logError(token);
-            return null;
+            node.update();
         }
 
+        const dom = created[nodeTable.root];
         dom.nodeMap = nodeMap;
-        PerfUtils.addMeasurement(timerBuildFull);       // use
-        PerfUtils.finalizeMeasurement(timerBuildPart);  // discard
 
         return dom;
     }
@@ -562,6 +318,86 @@ export function build(text, strict?) {
     return builder.build(strict);
 }
 
+/**
+ * Builds a SimpleDOM from a node table returned by buildNodeTableAsync().
+ *
+ * @param {HTMLNodeTable.NodeTable} nodeTable
+ * @return {SimpleNode} root of tree or null if parsing failed
+ */
+export function buildFromNodeTable(nodeTable: HTMLNodeTable.NodeTable) {
+    const builder = new Builder("");
+    return builder.buildFromNodeTable(nodeTable);
+}
+
+/**
+ * @private
+ * Worker that parses node tables, created on first use. Null if it hasn't been created
+ * yet or couldn't be started.
+ * @type {?Worker}
+ */
+let _worker: Worker | null = null;
+let _workerFailed = false;
+
+/**
+ * @private
+ * Requests sent to the worker that haven't been answered yet, keyed by request ID.
+ * @type {Object.<number, {deferred: $.Deferred, text: string, strict: boolean}>}
+ */
+let _pendingRequests = {};
+let _nextRequestID = 1;
+
+function _getWorker() {
+    if (!_worker && !_workerFailed && typeof Worker !== "undefined") {
+        _worker = new Worker(FileUtils.getNativeModuleDirectoryPath(module) + "/HTMLNodeTableWorker.js");
+        _worker.onmessage = function (e) {
+            const request = _pendingRequests[e.data.id];
+            if (request) {
+                delete _pendingRequests[e.data.id];
+                request.deferred.resolve(e.data.nodeTable);
+            }
+        };
+        _worker.onerror = function (e) {
+            console.error("HTMLSimpleDOM: node table worker failed, parsing on the main thread instead", e.message);
+
+            // Answer anything that was waiting on the worker, and don't use it again
+            const requests = _pendingRequests;
+            _pendingRequests = {};
+            _worker!.terminate();
+            _worker = null;
+            _workerFailed = true;
+            Object.keys(requests).forEach(function (id) {
+                const request = requests[id];
+                request.deferred.resolve(HTMLNodeTable.build(request.text, request.strict));
+            });
+        };
+    }
+    return _worker;
+}
+
+/**
+ * Parses the text into a node table in a worker, so that tokenizing a large document doesn't
+ * block the UI. Pass the result to buildFromNodeTable() or Builder.buildFromNodeTable() to get
+ * the same SimpleDOM that `build()` would return for the text. If workers aren't available the
+ * text is parsed on the main thread.
+ *
+ * @param {string} text Text of document to parse
+ * @param {bool} strict True for strict parsing
+ * @return {$.Promise} Resolved with the HTMLNodeTable.NodeTable for the text
+ */
+export function buildNodeTableAsync(text: string, strict?: boolean): JQueryPromise<HTMLNodeTable.NodeTable> {
+    const deferred = $.Deferred();
+    const worker = _getWorker();
+
+    if (!worker) {
+        return deferred.resolve(HTMLNodeTable.build(text, strict)).promise();
+    }
+
+    const id = _nextRequestID++;
+    _pendingRequests[id] = { deferred: deferred, text: text, strict: !!strict };
+    worker.postMessage({ id: id, text: text, strict: !!strict });
+    return deferred.promise();
+}
+
 /**
  * @private
  *
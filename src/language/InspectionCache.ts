@@ -0,0 +1,129 @@
+/*
+ * Copyright (c) 2018 - present The quadre code authors. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ *
+ */
+
+/*unittests: Code Inspection*/
+
+/**
+ * InspectionCache keeps the results of code inspection providers in the application support
+ * directory, so that files which didn't change since they were last inspected (in this session
+ * or an earlier one) aren't inspected again.
+ *
+ * Entries are keyed by a hash of the provider name, the module that inspects the file, the provider
+ * options, the app version and the text of the file. The text is hashed twice with different seeds
+ * and its length is part of the key too, so that two texts practically never share a key. Only
+ * results that depend on nothing else can be cached, see CodeInspection.
+ */
+
+import * as _ from "lodash";
+import PersistentCache = require("utils/PersistentCache");
+import * as MurmurHash3 from "thirdparty/murmurhash3_gc";
+
+const CACHE_FILENAME = "inspection-cache.json";
+
+/** Seed of the second hash of the text */
+const SECOND_SEED = 0x5bd1e995;
+
+/** Number of results kept, the least recently used ones are dropped first */
+const MAX_ENTRIES = 5000;
+
+interface CacheEntry {
+    result: any;
+    used: number;
+}
+
+let _entries: { [key: string]: CacheEntry } = {};
+
+const _cache = new PersistentCache(CACHE_FILENAME, {
+    logName: "InspectionCache",
+    saveDelay: 2000,
+    deserialize: function (data) {
+        _entries = data || {};
+    },
+    serialize: function () {
+        const keys = Object.keys(_entries);
+
+        if (keys.length > MAX_ENTRIES) {
+            _.sortBy(keys, function (key) {
+                return _entries[key].used;
+            }).slice(0, keys.length - MAX_ENTRIES).forEach(function (key) {
+                delete _entries[key];
+            });
+        }
+        return _entries;
+    }
+});
+
+/**
+ * @private
+ * Moves the cache file and forgets the loaded entries.
+ * @param {?string} path File, or null to go back to the default one
+ */
+// For unit tests
+export function _setCachePath(path) {
+    _cache.setPath(path);
+    _entries = {};
+}
+
+/**
+ * Builds the cache key of a result
+ * @param {!string} providerName
+ * @param {!string} modulePath Path or URL of the module that produces the result, so that
+ *     another module registered under the same provider name doesn't get its results
+ * @param {*} options Everything besides the text that the result depends on, must be JSON-able
+ * @param {!string} text Text of the file
+ * @return {!string}
+ */
+export function getKey(providerName: string, modulePath: string, options: any, text: string) {
+    const meta = JSON.stringify([brackets.metadata.version, providerName, modulePath, options === undefined ? null : options]);
+    return MurmurHash3.hashString(meta, meta.length, 0).toString(16) + "-" +
+        MurmurHash3.hashString(text, text.length, 0).toString(16) + "-" +
+        MurmurHash3.hashString(text, text.length, SECOND_SEED).toString(16) + "-" + text.length.toString(16);
+}
+
+/**
+ * Looks up a result
+ * @param {!string} key From getKey()
+ * @return {!$.Promise} Resolved with a copy of the cached result, or undefined if there is none
+ */
+export function get(key: string): JQueryPromise<any> {
+    return _cache.load().then(function () {
+        const entry = _entries.hasOwnProperty(key) ? _entries[key] : null;
+        if (!entry) {
+            return undefined;
+        }
+        entry.used = Date.now();
+        return _.cloneDeep(entry.result);
+    });
+}
+
+/**
+ * Adds a result to the cache
+ * @param {!string} key From getKey()
+ * @param {?{errors: !Array, aborted: boolean}} result
+ */
+export function set(key: string, result: any) {
+    _cache.load().done(function () {
+        _entries[key] = { result: _.cloneDeep(result), used: Date.now() };
+        _cache.scheduleSave();
+    });
+}
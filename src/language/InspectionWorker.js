@@ -0,0 +1,80 @@
+/*
+ * Copyright (c) 2018 - present The quadre code authors. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ *
+ */
+
+
+/*eslint-env worker */
+/*global requirejs, define */
+
+/*unittests: Code Inspection*/
+
+/**
+ * Worker used by InspectionWorkerPool. The first message is {type: "init", baseUrl, moduleName,
+ * context}: the provider module to load, and the object it gets as the "CodeInspection" module.
+ * Every other message is a request {id, text, fullPath, options}; the reply is {id, result} with
+ * what the module's scanFile() returned, or {id, error} if it threw. If the module fails to load
+ * the worker replies {type: "error", message}.
+ */
+(function () {
+    "use strict";
+
+    var provider = null,
+        queue = [];
+
+    function handleRequest(request) {
+        var result;
+        try {
+            result = provider.scanFile(request.text, request.fullPath, request.options);
+        } catch (err) {
+            self.postMessage({ id: request.id, error: String((err && err.message) || err) });
+            return;
+        }
+        // null means "superseded" to the pool, no problems are reported as an empty list
+        self.postMessage({ id: request.id, result: result || { errors: [] } });
+    }
+
+    function init(data) {
+        importScripts("../../node_modules/requirejs/require.js");
+        define("CodeInspection", [], function () {
+            return data.context;
+        });
+        requirejs.config({ baseUrl: data.baseUrl });
+        requirejs([data.moduleName], function (module) {
+            provider = module;
+            queue.forEach(handleRequest);
+            queue = null;
+        }, function (err) {
+            self.postMessage({ type: "error", message: err.message });
+        });
+    }
+
+    // Requests can arrive before the provider module is loaded
+    self.onmessage = function (e) {
+        if (e.data.type === "init") {
+            init(e.data);
+        } else if (provider) {
+            handleRequest(e.data);
+        } else {
+            queue.push(e.data);
+        }
+    };
+}());
@@ -0,0 +1,240 @@
+/*
+ * Copyright (c) 2018 - present The quadre code authors. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ *
+ */
+
+/*unittests: Code Inspection*/
+
+/**
+ * Runs the provider module of a code inspection provider in a pool of workers, so that linting
+ * a large file doesn't block the UI. See CodeInspection.register() for the provider side.
+ *
+ * Every worker loads InspectionWorker.js, which loads the provider module with require.js and
+ * calls its scanFile(text, fullPath, options) for every request. Scanning a file again supersedes
+ * the previous scan of that file: a scan that hasn't started yet is dropped, and a worker that is
+ * still busy with it is terminated (and replaced on demand). Superseded scans resolve with null.
+ */
+
+import * as _ from "lodash";
+import * as FileUtils from "file/FileUtils";
+
+/** Most workers a pool starts, whatever the number of cores */
+const MAX_WORKERS = 2;
+
+interface Job {
+    id: number;
+    fullPath: string;
+    text: string;
+    options: any;
+    deferred: JQueryDeferred<any>;
+}
+
+interface PoolWorker {
+    worker: Worker;
+    job: Job | null;
+}
+
+let _nextJobID = 1;
+
+export class InspectionWorkerPool {
+    private _baseUrl: string;
+    private _moduleName: string;
+    private _context: any;
+    private _size: number;
+    private _workers: Array<PoolWorker> = [];
+    private _queue: Array<Job> = [];
+    private _failed = false;
+
+    /**
+     * @param {string} moduleUrl URL or absolute path of the provider module, e.g. from ExtensionUtils.getModuleUrl()
+     * @param {Object} context Exposed to the provider module as the "CodeInspection" module
+     * @param {number=} size Most workers to start, by default one less than the number of cores (at most 2)
+     */
+    constructor(moduleUrl: string, context: any, size?: number) {
+        const moduleFile = moduleUrl.substr(moduleUrl.lastIndexOf("/") + 1);
+
+        this._baseUrl = moduleUrl.substr(0, moduleUrl.length - moduleFile.length);
+        this._moduleName = moduleFile.replace(/\.js$/, "");
+        this._context = context;
+        this._size = size || Math.max(1, Math.min(MAX_WORKERS, (navigator.hardwareConcurrency || 2) - 1));
+    }
+
+    /**
+     * @return {boolean} false if workers aren't supported or the provider module failed to load
+     */
+    public isAvailable() {
+        return !this._failed && typeof Worker !== "undefined";
+    }
+
+    /**
+     * Scans a snapshot of a file in a worker. Supersedes the pending scan of the same file,
+     * unless that one is for the same text and options, in which case its promise is returned.
+     *
+     * @param {string} text
+     * @param {string} fullPath
+     * @param {*} options Passed to the scanFile() of the provider module, must be cloneable
+     * @return {$.Promise} Resolved with what the provider module returned, or null if the scan was
+     *     superseded. Rejected if scanFile() threw or the pool isn't available.
+     */
+    public scan(text: string, fullPath: string, options: any): JQueryPromise<any> {
+        if (!this.isAvailable()) {
+            return $.Deferred().reject("Inspection workers are not available").promise();
+        }
+
+        const pending = this._findJob(fullPath);
+        if (pending) {
+            if (pending.text === text && _.isEqual(pending.options, options)) {
+                return pending.deferred.promise();
+            }
+            this._cancel(pending);
+        }
+
+        const job: Job = {
+            id: _nextJobID++,
+            fullPath: fullPath,
+            text: text,
+            options: options,
+            deferred: $.Deferred()
+        };
+        this._queue.push(job);
+        this._dispatch();
+
+        return job.deferred.promise();
+    }
+
+    /**
+     * Terminates the workers. Pending scans resolve with null.
+     */
+    public dispose() {
+        const jobs = this._takeJobs();
+        this._failed = true;
+        jobs.forEach(function (job) {
+            job.deferred.resolve(null);
+        });
+    }
+
+    private _findJob(fullPath: string) {
+        const running = _.find(this._workers, function (entry) {
+            return !!entry.job && entry.job.fullPath === fullPath;
+        });
+        return running ? running.job : _.find(this._queue, { fullPath: fullPath });
+    }
+
+    private _cancel(job: Job) {
+        const index = this._queue.indexOf(job);
+        if (index !== -1) {
+            this._queue.splice(index, 1);
+        } else {
+            // The worker can't be interrupted, start a new one instead
+            const entry = _.find(this._workers, function (candidate) {
+                return candidate.job === job;
+            })!;
+            entry.worker.terminate();
+            this._workers.splice(this._workers.indexOf(entry), 1);
+        }
+        job.deferred.resolve(null);
+    }
+
+    /**
+     * @private
+     * Terminates all workers and returns the jobs that they and the queue had
+     */
+    private _takeJobs() {
+        const jobs = this._queue;
+
+        this._queue = [];
+        this._workers.forEach(function (entry) {
+            entry.worker.terminate();
+            if (entry.job) {
+                jobs.push(entry.job);
+            }
+        });
+        this._workers = [];
+        return jobs;
+    }
+
+    private _fail(message: string) {
+        console.error("[CodeInspection] Inspection worker for " + this._moduleName + " failed: " + message);
+
+        const jobs = this._takeJobs();
+        this._failed = true;
+        jobs.forEach(function (job) {
+            job.deferred.reject(message);
+        });
+    }
+
+    private _createWorker(): PoolWorker {
+        const self = this;
+        const entry: PoolWorker = {
+            worker: new Worker(FileUtils.getNativeModuleDirectoryPath(module) + "/InspectionWorker.js"),
+            job: null
+        };
+
+        entry.worker.onmessage = function (e) {
+            const data = e.data;
+            if (data.type === "error") {
+                self._fail(data.message);
+                return;
+            }
+
+            const job = entry.job;
+            if (job && job.id === data.id) {
+                entry.job = null;
+                if (data.error) {
+                    job.deferred.reject(data.error);
+                } else {
+                    job.deferred.resolve(data.result);
+                }
+                self._dispatch();
+            }
+        };
+        entry.worker.onerror = function (e) {
+            self._fail(e.message);
+        };
+        entry.worker.postMessage({
+            type: "init",
+            baseUrl: this._baseUrl,
+            moduleName: this._moduleName,
+            context: this._context
+        });
+
+        this._workers.push(entry);
+        return entry;
+    }
+
+    private _dispatch() {
+        while (this._queue.length) {
+            let entry = _.find(this._workers, function (candidate) {
+                return !candidate.job;
+            });
+            if (!entry) {
+                if (this._workers.length >= this._size) {
+                    return;
+                }
+                entry = this._createWorker();
+            }
+
+            const job = this._queue.shift()!;
+            entry.job = job;
+            entry.worker.postMessage({ id: job.id, text: job.text, fullPath: job.fullPath, options: job.options });
+        }
+    }
+}
@@ -0,0 +1,376 @@
+/*
+ * Copyright (c) 2018 - present The quadre code authors. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ *
+ */
+
+/*unittests: JSUtils*/
+
+/**
+ * JSFunctionIndex keeps the function definitions of JavaScript files: for every file the start
+ * offsets of the functions it defines, by name, and for every function name the files that
+ * define one. JSUtils.findMatchingFunctions() uses it, so that a search only parses the files
+ * that changed since they were last indexed and only loads the documents that define the name.
+ *
+ * Files are parsed in a worker (JSFunctionIndexWorker.js). Offsets are offsets into the text with
+ * normalized line endings, like the text of a Document, whatever the line endings of the file on
+ * disk are. The index is kept in the application support directory so that it survives restarts;
+ * entries are checked against the modification time of their file before they are used for the
+ * first time in a session, and again after the file or its document changed.
+ */
+
+import * as _ from "lodash";
+import * as Async from "utils/Async";
+import * as DocumentManager from "document/DocumentManager";
+import * as DocumentModule from "document/Document";
+import * as FileSystem from "filesystem/FileSystem";
+import * as FileUtils from "file/FileUtils";
+import * as JSFunctionParser from "language/JSFunctionParser";
+import { DispatcherEvents } from "utils/EventDispatcher";
+import PersistentCache = require("utils/PersistentCache");
+
+const CACHE_FILENAME = "js-function-index.json";
+
+/** Format of the cache file, a file with another version is ignored */
+const CACHE_VERSION = 2;
+
+/** Number of files kept in the cache file, the least recently used ones are dropped first */
+const MAX_ENTRIES = 20000;
+
+/**
+ * Function names of a file, each followed by the start offsets of the functions with that name,
+ * as sent by the worker
+ */
+type FlatFunctionList = Array<string | Array<number>>;
+
+interface IndexEntry {
+    /** Modification time of the file that was parsed, null if the text of a modified document was */
+    timestamp: number | null;
+    functions: FlatFunctionList;
+    used: number;
+}
+
+let _entries: { [fullPath: string]: IndexEntry } = {};
+
+/** Paths of the files that define a function, by function name */
+let _pathsByName = new Map<string, Set<string>>();
+
+/** Paths of the entries that are known to be up to date */
+let _verified: { [fullPath: string]: boolean } = {};
+
+/** Files that are being indexed, by path */
+let _pending: { [fullPath: string]: JQueryPromise<any> } = {};
+
+let _worker: Worker | null = null;
+let _workerFailed = false;
+let _pendingRequests: { [id: number]: { deferred: JQueryDeferred<FlatFunctionList>, text: string } } = {};
+let _nextRequestID = 1;
+
+function _addToNameIndex(fullPath: string, functions: FlatFunctionList) {
+    for (let i = 0; i < functions.length; i += 2) {
+        const name = functions[i] as string;
+        let paths = _pathsByName.get(name);
+        if (!paths) {
+            paths = new Set<string>();
+            _pathsByName.set(name, paths);
+        }
+        paths.add(fullPath);
+    }
+}
+
+function _removeFromNameIndex(fullPath: string, functions: FlatFunctionList) {
+    for (let i = 0; i < functions.length; i += 2) {
+        const paths = _pathsByName.get(functions[i] as string);
+        if (paths) {
+            paths.delete(fullPath);
+            if (!paths.size) {
+                _pathsByName.delete(functions[i] as string);
+            }
+        }
+    }
+}
+
+function _setEntry(fullPath: string, entry: IndexEntry | null) {
+    if (_entries.hasOwnProperty(fullPath)) {
+        _removeFromNameIndex(fullPath, _entries[fullPath].functions);
+        delete _entries[fullPath];
+    }
+    if (entry) {
+        _entries[fullPath] = entry;
+        _addToNameIndex(fullPath, entry.functions);
+    }
+    _cache.scheduleSave();
+}
+
+const _cache = new PersistentCache(CACHE_FILENAME, {
+    logName: "JSFunctionIndex",
+    saveDelay: 2000,
+    deserialize: function (data) {
+        _entries = data && data.version === CACHE_VERSION ? data.entries : {};
+        Object.keys(_entries).forEach(function (fullPath) {
+            _addToNameIndex(fullPath, _entries[fullPath].functions);
+        });
+    },
+    serialize: function () {
+        const entries = {};
+
+        // The text of modified documents isn't on disk, so those entries would never be valid
+        const paths = Object.keys(_entries).filter(function (fullPath) {
+            return _entries[fullPath].timestamp !== null;
+        });
+        _.sortBy(paths, function (fullPath) {
+            return -_entries[fullPath].used;
+        }).slice(0, MAX_ENTRIES).forEach(function (fullPath) {
+            entries[fullPath] = _entries[fullPath];
+        });
+        return { version: CACHE_VERSION, entries: entries };
+    }
+});
+
+/**
+ * @private
+ * Moves the cache file and forgets the index.
+ * @param {?string} path File, or null to go back to the default one
+ */
+// For unit tests
+export function _setCachePath(path) {
+    _cache.setPath(path);
+    _entries = {};
+    _pathsByName = new Map<string, Set<string>>();
+    _verified = {};
+    _pending = {};
+}
+
+/**
+ * @private
+ * Parses text on the main thread, when the worker isn't available
+ */
+function _parseNow(text: string): FlatFunctionList {
+    const allFunctions = JSFunctionParser.findAllFunctionsInText(text);
+    const functions: FlatFunctionList = [];
+
+    Object.keys(allFunctions).forEach(function (name) {
+        functions.push(name, allFunctions[name].map(function (funcEntry) {
+            return funcEntry.offsetStart;
+        }));
+    });
+    return functions;
+}
+
+function _getWorker() {
+    if (!_worker && !_workerFailed && typeof Worker !== "undefined") {
+        _worker = new Worker(FileUtils.getNativeModuleDirectoryPath(module) + "/JSFunctionIndexWorker.js");
+        _worker.onmessage = function (e) {
+            const request = _pendingRequests[e.data.id];
+            if (request) {
+                delete _pendingRequests[e.data.id];
+                request.deferred.resolve(e.data.functions);
+            }
+        };
+        _worker.onerror = function (e) {
+            console.error("[JSFunctionIndex] Parser worker failed, parsing on the main thread instead", e.message);
+
+            // Answer anything that was waiting on the worker, and don't use it again
+            const requests = _pendingRequests;
+            _pendingRequests = {};
+            _worker!.terminate();
+            _worker = null;
+            _workerFailed = true;
+            Object.keys(requests).forEach(function (id) {
+                requests[id].deferred.resolve(_parseNow(requests[id].text));
+            });
+        };
+    }
+    return _worker;
+}
+
+/**
+ * @private
+ * Parses text in the worker, or on the main thread if workers aren't available
+ * @param {!string} text
+ * @return {$.Promise} Resolved with the FlatFunctionList of the text
+ */
+function _parse(text: string): JQueryPromise<FlatFunctionList> {
+    const deferred = $.Deferred<FlatFunctionList>();
+    const worker = _getWorker();
+
+    if (!worker) {
+        return deferred.resolve(_parseNow(text)).promise();
+    }
+
+    const id = _nextRequestID++;
+    _pendingRequests[id] = { deferred: deferred, text: text };
+    worker.postMessage({ id: id, text: text });
+    return deferred.promise();
+}
+
+/**
+ * @private
+ * Brings the entry of a file up to date: modified documents are parsed from their text, other
+ * files are parsed again if their modification time changed since they were indexed.
+ * @param {!File} file
+ * @return {$.Promise} Resolved when the entry is up to date, rejected if the file can't be read
+ */
+function _updateFile(file): JQueryPromise<any> {
+    const fullPath = file.fullPath;
+    if (_verified[fullPath]) {
+        return $.Deferred().resolve().promise();
+    }
+    if (_pending[fullPath]) {
+        return _pending[fullPath];
+    }
+
+    function index(text: string, timestamp: number | null) {
+        // Offsets have to match the text of the Document, which has LF line endings
+        return _parse(DocumentModule.Document.normalizeText(text)).then(function (functions) {
+            if (_pending[fullPath] === promise) {
+                _setEntry(fullPath, { timestamp: timestamp, functions: functions, used: Date.now() });
+            }
+        });
+    }
+
+    const doc = DocumentManager.getOpenDocumentForPath(fullPath);
+    let promise: JQueryPromise<any>;
+    if (doc && doc.isDirty) {
+        promise = index(doc.getText(), null);
+    } else {
+        const deferred = $.Deferred();
+        file.stat(function (err, stat) {
+            if (err) {
+                deferred.reject(err);
+            } else {
+                deferred.resolve(stat.mtime.getTime());
+            }
+        });
+        promise = deferred.then(function (timestamp) {
+            const entry = _entries.hasOwnProperty(fullPath) ? _entries[fullPath] : null;
+            if (entry && entry.timestamp === timestamp) {
+                entry.used = Date.now();
+                return undefined;
+            }
+            return FileUtils.readAsText(file).then(function (text) {
+                return index(text!, timestamp);
+            });
+        });
+    }
+
+    _pending[fullPath] = promise;
+    promise
+        .done(function () {
+            if (_pending[fullPath] === promise) {
+                _verified[fullPath] = true;
+            }
+        })
+        .fail(function () {
+            if (_pending[fullPath] === promise) {
+                _setEntry(fullPath, null);
+            }
+        })
+        .always(function () {
+            if (_pending[fullPath] === promise) {
+                delete _pending[fullPath];
+            }
+        });
+    return promise;
+}
+
+/**
+ * Brings the index up to date for the given files
+ * @param {!Array.<File>} files
+ * @return {$.Promise} Resolved when the files are indexed. Files that can't be read are left out
+ *     of the index, they don't fail the promise.
+ */
+export function update(files): JQueryPromise<any> {
+    return _cache.load().then(function () {
+        return Async.doInParallel(files, function (file) {
+            const oneResult = $.Deferred();
+            _updateFile(file).always(function () {
+                oneResult.resolve();
+            });
+            return oneResult.promise();
+        });
+    });
+}
+
+/**
+ * Looks up the functions with the given name. Call update() first for the files to search.
+ * @param {!string} functionName
+ * @param {!Array.<File>} files Files to search
+ * @return {!Array.<{fullPath: string, offsets: Array.<number>}>} Files that define a function
+ *     with that name, with the start offsets of those functions
+ */
+export function findFunctions(functionName: string, files): Array<{ fullPath: string, offsets: Array<number> }> {
+    const paths = _pathsByName.get(functionName);
+    const results: Array<{ fullPath: string, offsets: Array<number> }> = [];
+
+    if (!paths) {
+        return results;
+    }
+
+    files.forEach(function (file) {
+        const fullPath = file.fullPath;
+        if (paths.has(fullPath)) {
+            const functions = _entries[fullPath].functions;
+            for (let i = 0; i < functions.length; i += 2) {
+                if (functions[i] === functionName) {
+                    results.push({ fullPath: fullPath, offsets: functions[i + 1] as Array<number> });
+                    break;
+                }
+            }
+        }
+    });
+    return results;
+}
+
+/**
+ * @private
+ * Marks the entries of a file, or of all files in a directory, as possibly out of date
+ * @param {?string} fullPath path of a file or directory, or null for all files
+ */
+function _invalidate(fullPath: string | null) {
+    if (!fullPath) {
+        _verified = {};
+        _pending = {};
+    } else if (fullPath[fullPath.length - 1] === "/") {
+        Object.keys(_verified).concat(Object.keys(_pending)).forEach(function (path) {
+            if (path.indexOf(fullPath) === 0) {
+                delete _verified[path];
+                delete _pending[path];
+            }
+        });
+    } else {
+        delete _verified[fullPath];
+        delete _pending[fullPath];
+    }
+}
+
+(DocumentModule as unknown as DispatcherEvents).on("documentChange", function (event, doc) {
+    _invalidate(doc.file.fullPath);
+});
+(DocumentManager as unknown as DispatcherEvents).on("documentSaved documentRefreshed beforeDocumentDelete", function (event, doc) {
+    _invalidate(doc.file.fullPath);
+});
+FileSystem.on("change", function (event, entry) {
+    _invalidate(entry ? entry.fullPath : null);
+});
+FileSystem.on("rename", function (event, oldPath, newPath) {
+    _invalidate(oldPath);
+    _invalidate(newPath);
+});
@@ -0,0 +1,76 @@
+/*
+ * Copyright (c) 2018 - present The quadre code authors. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ *
+ */
+
+/*eslint-env worker */
+/*global requirejs */
+
+/*unittests: JSUtils*/
+
+/**
+ * Worker used by JSFunctionIndex. Each message is a request {id: number, text: string}; the reply is
+ * {id: number, functions: Array}, a flat list of function names each followed by the start offsets
+ * of the functions with that name.
+ */
+(function () {
+    "use strict";
+
+    var JSFunctionParser = null,
+        queue = [];
+
+    function handleRequest(request) {
+        var allFunctions = JSFunctionParser.findAllFunctionsInText(request.text),
+            functions = [];
+
+        Object.keys(allFunctions).forEach(function (name) {
+            functions.push(name, allFunctions[name].map(function (funcEntry) {
+                return funcEntry.offsetStart;
+            }));
+        });
+        self.postMessage({ id: request.id, functions: functions });
+    }
+
+    // Requests can arrive before the modules are loaded
+    self.onmessage = function (e) {
+        if (JSFunctionParser) {
+            handleRequest(e.data);
+        } else {
+            queue.push(e.data);
+        }
+    };
+
+    importScripts("../../node_modules/requirejs/require.js");
+    requirejs.config({
+        baseUrl: "../",
+        map: {
+            "*": {
+                "acorn":       "thirdparty/acorn/acorn",
+                "acorn_loose": "thirdparty/acorn/acorn_loose"
+            }
+        }
+    });
+    requirejs(["language/JSFunctionParser"], function (module) {
+        JSFunctionParser = module;
+        queue.forEach(handleRequest);
+        queue = null;
+    });
+}());
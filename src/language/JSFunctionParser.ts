@@ -0,0 +1,156 @@
+/*
+ * Copyright (c) 2013 - 2017 Adobe Systems Incorporated. All rights reserved.
+ * Copyright (c) 2018 - present The quadre code authors. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ *
+ */
+
+/*unittests: JSUtils*/
+
+// This module has no dependencies besides Acorn, so that it can also be loaded in
+// JSFunctionIndexWorker.js.
+
+import * as Acorn from "thirdparty/acorn/acorn";
+import * as AcornLoose from "thirdparty/acorn/acorn_loose";
+import * as ASTWalker from "thirdparty/acorn/walk";
+
+export interface FunctionInfo {
+    offsetStart: number;
+    label: string | null;
+    location: any;
+}
+
+export interface FunctionInfoMap {
+    [functionName: string]: Array<FunctionInfo>;
+}
+
+/**
+ * Return an object mapping function name to offset info for all functions in the specified text.
+ * Offset info is an array, since multiple functions of the same name can exist.
+ * @param {!string} text Document text
+ * @return {Object.<string, Array.<{offsetStart: number, label: ?string, location: Object}>}
+ */
+export function findAllFunctionsInText(text): FunctionInfoMap {
+    let AST;
+    const results: FunctionInfoMap = {};
+    let functionName;
+    let resultNode;
+    let memberPrefix;
+
+    try {
+        AST = Acorn.parse(text, {locations: true});
+    } catch (e) {
+        AST = AcornLoose.parse_dammit(text, {locations: true});
+    }
+
+    function _addResult(node, offset?, prefix?) {
+        memberPrefix = prefix ? prefix + " - " : "";
+        resultNode = node.id || node.key || node;
+        functionName = resultNode.name;
+        if (!Array.isArray(results[functionName])) {
+            results[functionName] = [];
+        }
+
+        results[functionName].push(
+            {
+                offsetStart: offset || node.start,
+                label: memberPrefix ? memberPrefix + functionName : null,
+                location: resultNode.loc
+            }
+        );
+    }
+
+    ASTWalker.simple(AST, {
+        /*
+            function <functionName> () {}
+        */
+        FunctionDeclaration: function (node) {
+            // As acorn_loose marks identifier names with '✖' under erroneous declarations
+            // we should have a check to discard such 'FunctionDeclaration' nodes
+            if (node.id.name !== "✖") {
+                _addResult(node);
+            }
+        },
+        /*
+            class <className> () {}
+        */
+        ClassDeclaration: function (node) {
+            _addResult(node);
+            ASTWalker.simple(node, {
+                /*
+                    class <className> () {
+                        <methodName> () {
+
+                        }
+                    }
+                */
+                MethodDefinition: function (methodNode) {
+                    _addResult(methodNode, methodNode.key.start, node.id.name);
+                }
+            });
+        },
+        /*
+            var <functionName> = function () {}
+
+            or
+
+            var <functionName> = () => {}
+        */
+        VariableDeclarator: function (node) {
+            if (node.init && (node.init.type === "FunctionExpression" || node.init.type === "ArrowFunctionExpression")) {
+                _addResult(node);
+            }
+        },
+        /*
+            SomeFunction.prototype.<functionName> = function () {}
+        */
+        AssignmentExpression: function (node) {
+            if (node.right && node.right.type === "FunctionExpression") {
+                if (node.left && node.left.type === "MemberExpression" && node.left.property) {
+                    _addResult(node.left.property);
+                }
+            }
+        },
+        /*
+            {
+                <functionName>: function() {}
+            }
+        */
+        Property: function (node) {
+            if (node.value && node.value.type === "FunctionExpression") {
+                if (node.key && node.key.type === "Identifier") {
+                    _addResult(node.key);
+                }
+            }
+        },
+        /*
+            <functionName>: function() {}
+        */
+        LabeledStatement: function (node) {
+            if (node.body && node.body.type === "FunctionDeclaration") {
+                if (node.label) {
+                    _addResult(node.label);
+                }
+            }
+        }
+    });
+
+    return results;
+}
@@ -27,36 +27,17 @@
  */
 
 import * as _ from "lodash";
-import * as Acorn from "thirdparty/acorn/acorn";
-import * as AcornLoose from "thirdparty/acorn/acorn_loose";
-import * as ASTWalker from "thirdparty/acorn/walk";
 
 // Load brackets modules
 import * as CodeMirror from "codemirror";
 import * as Async from "utils/Async";
 import * as DocumentManager from "document/DocumentManager";
-import ChangedDocumentTracker = require("document/ChangedDocumentTracker");
-import * as FileSystem from "filesystem/FileSystem";
 import * as FileUtils from "file/FileUtils";
+import * as JSFunctionIndex from "language/JSFunctionIndex";
+import * as JSFunctionParser from "language/JSFunctionParser";
 import * as PerfUtils from "utils/PerfUtils";
 import * as StringUtils from "utils/StringUtils";
 
-interface FunctionInfo {
-    offsetStart: number;
-    label: string | null;
-    location: any;
-}
-
-interface FunctionInfoMap {
-    [functionName: string]: Array<FunctionInfo>;
-}
-
-/**
- * Tracks dirty documents between invocations of findMatchingFunctions.
- * @type {ChangedDocumentTracker}
- */
-const _changedDocumentTracker = new ChangedDocumentTracker();
-
 /**
  * @private
  * Return an object mapping function name to offset info for all functions in the specified text.
@@ -65,112 +46,8 @@ const _changedDocumentTracker = new ChangedDocumentTracker();
  * @return {Object.<string, Array.<{offsetStart: number, offsetEnd: number}>}
  */
 function _findAllFunctionsInText(text) {
-    let AST;
-    const results: FunctionInfoMap = {};
-    let functionName;
-    let resultNode;
-    let memberPrefix;
-
     PerfUtils.markStart((PerfUtils as any).JSUTILS_REGEXP);
-
-    try {
-        AST = Acorn.parse(text, {locations: true});
-    } catch (e) {
-        AST = AcornLoose.parse_dammit(text, {locations: true});
-    }
-
-    function _addResult(node, offset?, prefix?) {
-        memberPrefix = prefix ? prefix + " - " : "";
-        resultNode = node.id || node.key || node;
-        functionName = resultNode.name;
-        if (!Array.isArray(results[functionName])) {
-            results[functionName] = [];
-        }
-
-        results[functionName].push(
-            {
-                offsetStart: offset || node.start,
-                label: memberPrefix ? memberPrefix + functionName : null,
-                location: resultNode.loc
-            }
-        );
-    }
-
-    ASTWalker.simple(AST, {
-        /*
-            function <functionName> () {}
-        */
-        FunctionDeclaration: function (node) {
-            // As acorn_loose marks identifier names with '✖' under erroneous declarations
-            // we should have a check to discard such 'FunctionDeclaration' nodes
-            if (node.id.name !== "✖") {
-                _addResult(node);
-            }
-        },
-        /*
-            class <className> () {}
-        */
-        ClassDeclaration: function (node) {
-            _addResult(node);
-            ASTWalker.simple(node, {
-                /*
-                    class <className> () {
-                        <methodName> () {
-
-                        }
-                    }
-                */
-                MethodDefinition: function (methodNode) {
-                    _addResult(methodNode, methodNode.key.start, node.id.name);
-                }
-            });
-        },
-        /*
-            var <functionName> = function () {}
-
-            or
-
-            var <functionName> = () => {}
-        */
-        VariableDeclarator: function (node) {
-            if (node.init && (node.init.type === "FunctionExpression" || node.init.type === "ArrowFunctionExpression")) {
-                _addResult(node);
-            }
-        },
-        /*
-            SomeFunction.prototype.<functionName> = function () {}
-        */
-        AssignmentExpression: function (node) {
-            if (node.right && node.right.type === "FunctionExpression") {
-                if (node.left && node.left.type === "MemberExpression" && node.left.property) {
-                    _addResult(node.left.property);
-                }
-            }
-        },
-        /*
-            {
-                <functionName>: function() {}
-            }
-        */
-        Property: function (node) {
-            if (node.value && node.value.type === "FunctionExpression") {
-                if (node.key && node.key.type === "Identifier") {
-                    _addResult(node.key);
-                }
-            }
-        },
-        /*
-            <functionName>: function() {}
-        */
-        LabeledStatement: function (node) {
-            if (node.body && node.body.type === "FunctionDeclaration") {
-                if (node.label) {
-                    _addResult(node.label);
-                }
-            }
-        }
-    });
-
+    const results = JSFunctionParser.findAllFunctionsInText(text);
     PerfUtils.addMeasurement((PerfUtils as any).JSUTILS_REGEXP);
 
     return results;
@@ -284,178 +161,6 @@ function _computeOffsets(doc, functionName, functions, rangeResults) {
     });
 }
 
-/**
- * @private
- * Read a file and build a function list. Result is cached in fileInfo.
- * @param {!FileInfo} fileInfo File to parse
- * @param {!$.Deferred} result Deferred to resolve with all functions found and the document
- */
-function _readFile(fileInfo, result) {
-    DocumentManager.getDocumentForPath(fileInfo.fullPath)
-        .done(function (doc) {
-            const allFunctions = _findAllFunctionsInText(doc.getText());
-
-            // Cache the result in the fileInfo object
-            fileInfo.JSUtils = {};
-            fileInfo.JSUtils.functions = allFunctions;
-            fileInfo.JSUtils.timestamp = doc.diskTimestamp;
-
-            result.resolve({doc: doc, functions: allFunctions});
-        })
-        .fail(function (error) {
-            result.reject(error);
-        });
-}
-
-/**
- * Determines if the document function cache is up to date.
- * @param {FileInfo} fileInfo
- * @return {$.Promise} A promise resolved with true with true when a function cache is available for the document. Resolves
- *   with false when there is no cache or the cache is stale.
- */
-function _shouldGetFromCache(fileInfo) {
-    const result = $.Deferred();
-    const isChanged = _changedDocumentTracker.isPathChanged(fileInfo.fullPath);
-
-    if (isChanged && fileInfo.JSUtils) {
-        // See if it's dirty and in the working set first
-        const doc = DocumentManager.getOpenDocumentForPath(fileInfo.fullPath);
-
-        if (doc && doc.isDirty) {
-            result.resolve(false);
-        } else {
-            // If a cache exists, check the timestamp on disk
-            const file = FileSystem.getFileForPath(fileInfo.fullPath);
-
-            file.stat(function (err, stat) {
-                if (!err) {
-                    result.resolve(fileInfo.JSUtils.timestamp.getTime() === stat.mtime.getTime());
-                } else {
-                    result.reject(err);
-                }
-            });
-        }
-    } else {
-        // Use the cache if the file did not change and the cache exists
-        result.resolve(!isChanged && fileInfo.JSUtils);
-    }
-
-    return result.promise();
-}
-
-/**
- * @private
- * Compute lineStart and lineEnd for each matched function
- * @param {!Array.<{doc: Document, fileInfo: FileInfo, functions: Array.<offsetStart: number, offsetEnd: number>}>} docEntries
- * @param {!string} functionName
- * @param {!Array.<document: Document, name: string, lineStart: number, lineEnd: number>} rangeResults
- * @return {$.Promise} A promise resolved with an array of document ranges to populate a MultiRangeInlineEditor.
- */
-function _getOffsetsForFunction(docEntries, functionName) {
-    // Filter for documents that contain the named function
-    const result              = $.Deferred();
-    const matchedDocuments: Array<any> = [];
-    const rangeResults        = [];
-
-    docEntries.forEach(function (docEntry) {
-        // Need to call _.has here since docEntry.functions could have an
-        // entry for "hasOwnProperty", which results in an error if trying
-        // to invoke docEntry.functions.hasOwnProperty().
-        if (_.has(docEntry.functions, functionName)) {
-            const functionsInDocument = docEntry.functions[functionName];
-            matchedDocuments.push({doc: docEntry.doc, fileInfo: docEntry.fileInfo, functions: functionsInDocument});
-        }
-    });
-
-    Async.doInParallel(matchedDocuments, function (docEntry) {
-        const doc         = docEntry.doc;
-        const oneResult   = $.Deferred();
-
-        // doc will be undefined if we hit the cache
-        if (!doc) {
-            DocumentManager.getDocumentForPath(docEntry.fileInfo.fullPath)
-                .done(function (fetchedDoc) {
-                    _computeOffsets(fetchedDoc, functionName, docEntry.functions, rangeResults);
-                })
-                .always(function () {
-                    oneResult.resolve();
-                });
-        } else {
-            _computeOffsets(doc, functionName, docEntry.functions, rangeResults);
-            oneResult.resolve();
-        }
-
-        return oneResult.promise();
-    }).done(function () {
-        result.resolve(rangeResults);
-    });
-
-    return result.promise();
-}
-
-/**
- * Resolves with a record containing the Document or FileInfo and an Array of all
- * function names with offsets for the specified file. Results may be cached.
- * @param {FileInfo} fileInfo
- * @return {$.Promise} A promise resolved with a document info object that
- *   contains a map of all function names from the document and each function's start offset.
- */
-function _getFunctionsForFile(fileInfo) {
-    const result = $.Deferred();
-
-    _shouldGetFromCache(fileInfo)
-        .done(function (useCache) {
-            if (useCache) {
-                // Return cached data. doc property is undefined since we hit the cache.
-                // _getOffsets() will fetch the Document if necessary.
-                result.resolve({/*doc: undefined,*/fileInfo: fileInfo, functions: fileInfo.JSUtils.functions});
-            } else {
-                _readFile(fileInfo, result);
-            }
-        }).fail(function (err) {
-            result.reject(err);
-        });
-
-    return result.promise();
-}
-
-/**
- * @private
- * Get all functions for each FileInfo.
- * @param {Array.<FileInfo>} fileInfos
- * @return {$.Promise} A promise resolved with an array of document info objects that each
- *   contain a map of all function names from the document and each function's start offset.
- */
-function _getFunctionsInFiles(fileInfos) {
-    const result      = $.Deferred();
-    const docEntries: Array<any> = [];
-
-    PerfUtils.markStart((PerfUtils as any).JSUTILS_GET_ALL_FUNCTIONS);
-
-    Async.doInParallel(fileInfos, function (fileInfo) {
-        const oneResult = $.Deferred();
-
-        _getFunctionsForFile(fileInfo)
-            .done(function (docInfo) {
-                docEntries.push(docInfo);
-            })
-            .always(function (error) {
-                // If one file fails, continue to search
-                oneResult.resolve();
-            });
-
-        return oneResult.promise();
-    }).always(function () {
-        // Reset ChangedDocumentTracker now that the cache is up to date.
-        _changedDocumentTracker.reset();
-
-        PerfUtils.addMeasurement((PerfUtils as any).JSUTILS_GET_ALL_FUNCTIONS);
-        result.resolve(docEntries);
-    });
-
-    return result.promise();
-}
-
 /**
  * Return all functions that have the specified name, searching across all the given files.
  *
@@ -479,10 +184,29 @@ export function findMatchingFunctions(functionName, fileInfos, keepAllFiles) {
         jsFiles = fileInfos;
     }
 
-    // RegExp search (or cache lookup) for all functions in the project
-    _getFunctionsInFiles(jsFiles).done(function (docEntries) {
-        // Compute offsets for all matched functions
-        _getOffsetsForFunction(docEntries, functionName).done(function (rangeResults) {
+    // Bring the function index up to date, then only load the documents that define the function
+    PerfUtils.markStart((PerfUtils as any).JSUTILS_GET_ALL_FUNCTIONS);
+    JSFunctionIndex.update(jsFiles).always(function () {
+        PerfUtils.addMeasurement((PerfUtils as any).JSUTILS_GET_ALL_FUNCTIONS);
+
+        const rangeResults = [];
+        Async.doInParallel(JSFunctionIndex.findFunctions(functionName, jsFiles), function (match) {
+            const oneResult = $.Deferred();
+
+            DocumentManager.getDocumentForPath(match.fullPath)
+                .done(function (doc) {
+                    const functions = match.offsets.map(function (offsetStart) {
+                        return { offsetStart: offsetStart };
+                    });
+                    _computeOffsets(doc, functionName, functions, rangeResults);
+                })
+                .always(function () {
+                    // If one file fails, continue with the others
+                    oneResult.resolve();
+                });
+
+            return oneResult.promise();
+        }).always(function () {
             result.resolve(rangeResults);
         });
     });
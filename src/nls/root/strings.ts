@@ -210,6 +210,8 @@ export = {
     "FIND_IN_FILES_INDEXING"            : "Indexing for Instant Search\u2026",
     "REPLACE_IN_FILES_ERRORS_TITLE"     : "Replace Errors",
     "REPLACE_IN_FILES_ERRORS"           : "The following files weren't modified because they changed after the search or couldn't be written.",
+    "REPLACE_IN_FILES_PROGRESS"         : "Replacing\u2026 {0} of {1} files",
+    "REPLACE_IN_FILES_CANCEL_HINT"      : "Click to stop replacing in the remaining files",
 
     "ERROR_FETCHING_UPDATE_INFO_TITLE"  : "Error Getting Update Info",
     "ERROR_FETCHING_UPDATE_INFO_MSG"    : "There was a problem getting the latest update information from the server. Please make sure you are connected to the Internet and try again.",
@@ -316,6 +318,8 @@ export = {
     "NOTHING_TO_LINT"                       : "Nothing to lint",
     "LINTER_TIMED_OUT"                      : "{0} has timed out after waiting for {1} ms",
     "LINTER_FAILED"                         : "{0} terminated with error: {1}",
+    "PROJECT_ERRORS_PANEL_TITLE"            : "{0} Problems in {1} Files",
+    "PROJECT_INSPECTION_PROGRESS"           : "{0} (inspected {1} of {2} files)",
 
     /**
      * Command Name Constants
@@ -409,6 +413,7 @@ export = {
     "CMD_TOGGLE_WORD_WRAP"                : "Word Wrap",
     "CMD_LIVE_HIGHLIGHT"                  : "Live Preview Highlight",
     "CMD_VIEW_TOGGLE_INSPECTION"          : "Lint Files on Save",
+    "CMD_VIEW_TOGGLE_PROJECT_INSPECTION"  : "Lint Project in Background",
     "CMD_WORKINGSET_SORT_BY_ADDED"        : "Sort by Added",
     "CMD_WORKINGSET_SORT_BY_NAME"         : "Sort by Name",
     "CMD_WORKINGSET_SORT_BY_TYPE"         : "Sort by Type",
@@ -629,6 +634,7 @@ export = {
     "CMD_SWITCH_LANGUAGE"                       : "Switch Language",
     "CMD_RUN_UNIT_TESTS"                        : "Run Tests",
     "CMD_SHOW_PERF_DATA"                        : "Show Performance Data",
+    "CMD_SHOW_EXTENSION_PERF"                   : "Show Extension Performance",
     "CMD_ENABLE_NODE_DEBUGGER"                  : "Enable Node Debugger",
     "CMD_LOG_NODE_STATE"                        : "Log Node State to Console",
     "CMD_RESTART_NODE"                          : "Restart Node",
@@ -749,6 +755,10 @@ export = {
     "DESCRIPTION_CODE_FOLDING_MAKE_SELECTIONS_FOLDABLE": "true to enable code folding on selected text in the editor",
     "DESCRIPTION_EXTENSION_MANAGER_SHOW"             : "true to show the Extension Manager",
     "DESCRIPTION_DISABLED_DEFAULT_EXTENSIONS"        : "Default extensions that are disabled",
+    "DESCRIPTION_LAZY_EXTENSION_ACTIVATION"          : "false to load every extension at startup, even those that list activationEvents in their package.json",
+    "DESCRIPTION_EXTENSION_MONITOR"                  : "true to measure the time extensions spend in event handlers, code hint and lint providers and keydown hooks (takes effect after a reload)",
+    "DESCRIPTION_EXTENSION_MONITOR_BUDGET"           : "Maximum p95 time in milliseconds of a single extension callback, used with extensions.monitorAction",
+    "DESCRIPTION_EXTENSION_MONITOR_ACTION"           : "What happens to extensions over their time budget: none, throttle (skip their callbacks for a while) or disable (skip them until resumed)",
     "DESCRIPTION_ATTR_HINTS"                         : "Enable/disable HTML attribute hints",
     "DESCRIPTION_CSS_PROP_HINTS"                     : "Enable/disable CSS/LESS/SCSS property hints",
     "DESCRIPTION_JS_HINTS"                           : "Enable/disable JavaScript code hints",
@@ -835,6 +845,7 @@ export = {
     "DESCRIPTION_THEME"                              : "Select a {APP_NAME} theme",
     "DESCRIPTION_USE_THEME_SCROLLBARS"               : "true to allow custom scroll bars",
     "DESCRIPTION_LINTING_COLLAPSED"                  : "true to collapse linting panel",
+    "DESCRIPTION_LINTING_PROJECT"                    : "true to lint all files of the project in the background and list their problems in the linting panel",
     "DESCRIPTION_FONT_FAMILY"                        : "Change font family",
     "DESCRIPTION_FONT_SIZE"                          : "Change font size; e.g. 13px",
     "DESCRIPTION_FIND_IN_FILES_NODE"                 : "true to enable node based search",
@@ -844,6 +855,7 @@ export = {
     "DESCRIPTION_OPEN_USER_PREFS_IN_SECOND_PANE"     : "false to open user preferences file in left/top pane",
     "DESCRIPTION_MERGE_PANES_WHEN_LAST_FILE_CLOSED"  : "true to collapse panes after the last file from the pane is closed via pane header close button",
     "DESCRIPTION_SHOW_PANE_HEADER_BUTTONS"           : "Toggle when to show the close and flip-view buttons on the header.",
+    "DESCRIPTION_MAX_LIVE_EDITORS"                   : "Number of editors a pane keeps alive. The editors of less recently used files are closed and restored when the file is shown again. 0 keeps all editors alive",
     "DEFAULT_PREFERENCES_JSON_HEADER_COMMENT"        : "/*\n * This is a read-only file with the preferences supported\n * by {APP_NAME}.\n * Use this file as a reference to modify your preferences\n * file \"brackets.json\" opened in the other pane.\n * For more information on how to use preferences inside\n * {APP_NAME}, refer to the web page at https://github.com/adobe/brackets/wiki/How-to-Use-Brackets#preferences\n */",
     "DEFAULT_PREFERENCES_JSON_DEFAULT"               : "Default",
     "DESCRIPTION_PURE_CODING_SURFACE"                : "true to enable code only mode and hide all other UI elements in {APP_NAME}",
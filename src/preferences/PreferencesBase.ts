@@ -47,8 +47,8 @@
  * at all, undefined is returned.
  *
  * Each Scope has an associated Storage object that knows how to load and
- * save the preferences value for that Scope. There are two implementations:
- * MemoryStorage and FileStorage.
+ * save the preferences value for that Scope. There are three implementations:
+ * MemoryStorage, FileStorage and JournaledFileStorage (used for the view state).
  *
  * The final concept used is that of Layers, which can be added to Scopes. Generally, a Layer looks
  * for a collection of preferences that are nested in some fashion in the Scope's
@@ -198,7 +198,7 @@ class ParsingError extends Error {
  *                              The invalid copy will be sent to trash in case the user wants to refer to it.
  */
 export class FileStorage {
-    private path: string;
+    protected path: string;
     private createIfMissing: boolean;
     private recreateIfInvalid: boolean;
     private _lineEndings: FileUtils.LineEndings | null;
@@ -337,6 +337,329 @@ export class FileStorage {
 EventDispatcher.makeEventDispatcher(FileStorage.prototype);
 
 
+/** Suffix of the journal file next to the file of a JournaledFileStorage */
+const JOURNAL_SUFFIX = ".journal";
+
+/** Depth up to which JournaledFileStorage journals the changes of nested objects separately */
+const JOURNAL_DEPTH = 3;
+
+/** Delay after the last save before the changes are written, and longest delay, in ms */
+const JOURNAL_FLUSH_DELAY = 1000;
+const JOURNAL_FLUSH_MAX_DELAY = 5000;
+
+/** Size of the journal above which it is folded into the file */
+const JOURNAL_MAX_SIZE = 512 * 1024;
+
+/**
+ * @private
+ * Copies the plain objects of a value up to JOURNAL_DEPTH, keeping references to everything else.
+ * Comparing data to such a copy finds the values that were set since.
+ */
+function _journalShadow(value, depth) {
+    if (depth >= JOURNAL_DEPTH || !_.isPlainObject(value)) {
+        return value;
+    }
+    const shadow = {};
+    Object.keys(value).forEach(function (key) {
+        shadow[key] = _journalShadow(value[key], depth + 1);
+    });
+    return shadow;
+}
+
+/**
+ * @private
+ * Adds a journal line for every value that was set or removed since the shadow was taken,
+ * and returns the shadow of the new data.
+ */
+function _journalChanges(value, shadow, path: Array<string>, lines: Array<string>) {
+    if (path.length < JOURNAL_DEPTH && _.isPlainObject(value) && _.isPlainObject(shadow)) {
+        const next = {};
+        Object.keys(shadow).forEach(function (key) {
+            if (!value.hasOwnProperty(key)) {
+                lines.push(JSON.stringify([path.concat(key)]) + "\n");
+            }
+        });
+        Object.keys(value).forEach(function (key) {
+            next[key] = _journalChanges(value[key], shadow.hasOwnProperty(key) ? shadow[key] : undefined, path.concat(key), lines);
+        });
+        return next;
+    }
+
+    if (value !== shadow) {
+        lines.push(JSON.stringify([path, value]) + "\n");
+    }
+    return _journalShadow(value, path.length);
+}
+
+/**
+ * @private
+ * Applies the lines of a journal to data. Stops at the first line that can't be parsed,
+ * which is the last one if the app quit while appending it.
+ */
+function _applyJournal(data, text: string) {
+    const lines = text.split("\n");
+    for (let i = 0; i < lines.length; i++) {
+        if (!lines[i]) {
+            continue;
+        }
+
+        let entry;
+        try {
+            entry = JSON.parse(lines[i]);
+        } catch (e) {
+            console.warn("Ignoring the end of a corrupt preferences journal at line " + (i + 1));
+            return;
+        }
+
+        const path: Array<string> = entry[0];
+        const key = path[path.length - 1];
+        let parent = data;
+        for (let j = 0; j < path.length - 1; j++) {
+            if (!_.isPlainObject(parent[path[j]])) {
+                parent[path[j]] = {};
+            }
+            parent = parent[path[j]];
+        }
+
+        if (entry.length > 1) {
+            parent[key] = entry[1];
+        } else {
+            delete parent[key];
+        }
+    }
+}
+
+/**
+ * Loads/saves preferences from a JSON file on disk, like FileStorage, but writes the changes
+ * to an append-only journal next to the file instead of rewriting the whole file on every save.
+ *
+ * Saves are batched: the values that were set or removed since the previous save are found by
+ * comparing the data to a shallow copy (objects nested up to JOURNAL_DEPTH levels are compared
+ * key by key, deeper values by reference) and appended to the journal together a moment later.
+ * When the journal grows too large it is folded into the file, which is written to a temporary
+ * file and renamed over the original so that it is never left half-written.
+ *
+ * Values that are changed in place, without being set again, are only written when the journal
+ * is folded. Scope.set() ignores such changes too.
+ *
+ * @constructor
+ * @param {string}  path        Path to the preferences file
+ * @param {boolean} createIfMissing True if the file should be created if it doesn't exist.
+ *                              If this is not set, then the file will not be created.
+ * @param {boolean} recreateIfInvalid True if the file needs to be recreated if it is invalid.
+ */
+export class JournaledFileStorage extends FileStorage {
+    private _data: any = null;
+    private _shadow: any = {};
+    private _pendingLines: Array<string> = [];
+    private _pendingSaves: Array<JQueryDeferred<any>> = [];
+    private _journalSize = 0;
+    private _lastWrite: JQueryPromise<any> = $.Deferred().resolve().promise();
+    private _flushDebounced: any;
+
+    constructor(path, createIfMissing, recreateIfInvalid?) {
+        super(path, createIfMissing, recreateIfInvalid);
+
+        const self = this;
+        this._flushDebounced = _.debounce(function () {
+            self.flush();
+        }, JOURNAL_FLUSH_DELAY, { maxWait: JOURNAL_FLUSH_MAX_DELAY });
+
+        // The window can close before a batch is written
+        window.addEventListener("unload", function () {
+            self._flushSync();
+        });
+    }
+
+    /**
+     * Loads the preferences from the file and applies the journal.
+     *
+     * @return {Promise} Resolved with the data once it has been parsed.
+     */
+    public load() {
+        const self = this;
+
+        // Changes made before a reload still belong to the previous data
+        return this.flush().then(function () {
+            return FileStorage.prototype.load.call(self);
+        }).then(function (data) {
+            const result = $.Deferred();
+            const journalPath = self.path && self.path + JOURNAL_SUFFIX;
+
+            if (!journalPath) {
+                return result.resolve(data).promise();
+            }
+
+            appshell.fs.readTextFile(journalPath, "utf8", function (err, text) {
+                self._journalSize = 0;
+                if (!err && text) {
+                    _applyJournal(data, text);
+                    self._journalSize = text.length;
+                }
+                self._data = data;
+                self._shadow = _journalShadow(data, 0);
+                result.resolve(data);
+            });
+            return result.promise();
+        });
+    }
+
+    /**
+     * Journals the values that changed since the previous save.
+     *
+     * @param {Object} newData data to save
+     * @return {Promise} Promise resolved (with no arguments) once the changes have been written
+     */
+    public save(newData) {
+        const result = $.Deferred();
+
+        if (!this.path) {
+            return result.resolve().promise();
+        }
+
+        this._data = newData;
+        try {
+            this._shadow = _journalChanges(newData, this._shadow, [], this._pendingLines);
+        } catch (e) {
+            return result.reject("Unable to convert prefs to JSON" + e.toString()).promise();
+        }
+
+        this._pendingSaves.push(result);
+        if (appshell.windowGoingAway) {
+            this._flushSync();
+        } else {
+            this._flushDebounced();
+        }
+        return result.promise();
+    }
+
+    /**
+     * Changes the path to the preferences file, after writing the pending changes to the previous one.
+     *
+     * @param {string} newPath location of this settings file
+     */
+    public setPath(newPath) {
+        this.flush();
+        super.setPath(newPath);
+    }
+
+    /**
+     * Writes the pending changes now, and folds the journal into the file if it grew too large.
+     *
+     * @param {boolean=} compact true to fold the journal into the file in any case
+     * @return {Promise} Resolved once everything saved so far has been written
+     */
+    public flush(compact?: boolean): JQueryPromise<any> {
+        const self = this;
+        const path = this.path;
+        const lines = this._pendingLines;
+        const saves = this._pendingSaves;
+        const result = $.Deferred();
+
+        this._flushDebounced.cancel();
+        this._pendingLines = [];
+        this._pendingSaves = [];
+
+        const text = lines.join("");
+        this._journalSize += text.length;
+        const needsCompaction = compact || this._journalSize > JOURNAL_MAX_SIZE;
+        const snapshot = path && needsCompaction && this._data ? JSON.stringify(this._data) : null;
+        if (snapshot !== null) {
+            this._journalSize = 0;
+        }
+
+        // Writes are serialized, so the journal lines stay in order
+        this._lastWrite = this._lastWrite.then(null, function () {
+            return $.Deferred().resolve().promise();
+        }).then(function () {
+            return self._write(path, text, snapshot);
+        });
+        this._lastWrite
+            .done(function () {
+                saves.forEach(function (save) {
+                    save.resolve();
+                });
+                result.resolve();
+            })
+            .fail(function (err) {
+                const message = "Unable to save prefs at " + path + " " + err;
+                saves.forEach(function (save) {
+                    save.reject(message);
+                });
+                result.reject(message);
+            });
+
+        return result.promise();
+    }
+
+    /**
+     * @private
+     * Appends lines to the journal, then writes the whole data to the file and empties the
+     * journal if a snapshot is given. The lines are appended first so that the journal never
+     * holds older values than the file if the app quits in between.
+     */
+    private _write(path, text: string, snapshot: string | null) {
+        const result = $.Deferred();
+        const journalPath = path + JOURNAL_SUFFIX;
+
+        function writeSnapshot() {
+            if (snapshot === null) {
+                result.resolve();
+                return;
+            }
+            FileSystem.getFileForPath(path).write(snapshot, { blind: true, atomic: true }, function (err) {
+                if (err) {
+                    result.reject(err);
+                    return;
+                }
+                appshell.fs.writeFile(journalPath, "", "utf8", function (err2) {
+                    if (err2) {
+                        result.reject(err2);
+                    } else {
+                        result.resolve();
+                    }
+                });
+            });
+        }
+
+        if (!text) {
+            writeSnapshot();
+        } else {
+            appshell.fs.appendFile(journalPath, text, "utf8", function (err) {
+                if (err) {
+                    result.reject(err);
+                } else {
+                    writeSnapshot();
+                }
+            });
+        }
+        return result.promise();
+    }
+
+    /**
+     * @private
+     * Appends the pending lines synchronously, for when the window is going away
+     */
+    private _flushSync() {
+        const saves = this._pendingSaves;
+
+        this._flushDebounced.cancel();
+        if (this.path && this._pendingLines.length) {
+            try {
+                appshell.fs.appendFileSync(this.path + JOURNAL_SUFFIX, this._pendingLines.join(""), "utf8");
+            } catch (e) {
+                console.error("Unable to save prefs at " + this.path + " " + e);
+            }
+        }
+        this._pendingLines = [];
+        this._pendingSaves = [];
+        saves.forEach(function (save) {
+            save.resolve();
+        });
+    }
+}
+
+
 /**
  * A `Scope` is a data container that is tied to a `Storage`.
  *
@@ -606,6 +929,22 @@ EventDispatcher.makeEventDispatcher(Scope.prototype);
 
 // Utility functions for the PathLayer
 
+/**
+ * @private
+ *
+ * Compiled matchers of the globs seen so far. Globs come from preference files,
+ * so there are few of them but each one is matched very often.
+ */
+const _globMatchers: { [glob: string]: (filename: string) => boolean } = {};
+
+/**
+ * @private
+ *
+ * Incremented whenever a layer changes what it resolves to without a change event,
+ * e.g. when the project path changes. PreferencesSystem drops its resolution cache then.
+ */
+let _layerGeneration = 0;
+
 /**
  * @private
  *
@@ -623,7 +962,11 @@ function _findMatchingGlob(pathData, filename) {
     }
 
     for (const glob of globs) {
-        if (globmatch(filename, glob)) {
+        let matcher = _globMatchers[glob];
+        if (!matcher) {
+            matcher = _globMatchers[glob] = globmatch.compile(glob);
+        }
+        if (matcher(filename)) {
             return glob;
         }
     }
@@ -741,6 +1084,7 @@ export class ProjectLayer implements Layer {
      */
     public setProjectPath(projectPath) {
         this.projectPath = projectPath;
+        _layerGeneration++;
     }
 }
 
@@ -1030,6 +1374,7 @@ export class PathLayer implements Layer {
         } else {
             this.prefFilePath = FileUtils.getDirectoryPath(prefFilePath);
         }
+        _layerGeneration++;
     }
 
     /**
@@ -1063,6 +1408,27 @@ export class PathLayer implements Layer {
 }
 
 
+/**
+ * @private
+ *
+ * Builds the key under which PreferencesSystem caches a resolved value. Built-in layers only
+ * depend on the path and the language of the context. Contexts with any other property
+ * might be read by custom layers and aren't cached.
+ *
+ * @param {Array.<string>} scopeOrder Scope order used for the lookup
+ * @param {Object} context Normalized context
+ * @return {?string} The key, or null if values for this context can't be cached
+ */
+function _getResolutionKey(scopeOrder, context) {
+    for (const prop in context) {
+        if (prop !== "scopeOrder" && prop !== "path" && prop !== "language") {
+            return null;
+        }
+    }
+
+    return scopeOrder.join("\n") + "\n\n" + (context.path || "") + "\n\n" + (context.language || "");
+}
+
 /**
  * Represents a single, known Preference.
  *
@@ -1299,6 +1665,8 @@ export class PreferencesSystem {
     public _pathScopeFilenames;
     public _pathScopes;
     private _changeEventQueue;
+    private _resolved: Map<string, Map<string, any>>;
+    private _resolvedGeneration: number;
 
     constructor(contextBuilder?) {
         this.contextBuilder = contextBuilder;
@@ -1338,6 +1706,10 @@ export class PreferencesSystem {
         // Keeps track of change events that need to be sent when change events are resumed
         this._changeEventQueue = null;
 
+        // Values returned by get(), by preference ID and context, see _getResolutionKey
+        this._resolved = new Map();
+        this._resolvedGeneration = _layerGeneration;
+
         const notifyPrefChange = function (this: PreferencesSystem, id) {
             const pref = this._knownPrefs[id];
             if (pref) {
@@ -1374,6 +1746,8 @@ export class PreferencesSystem {
         if (this._knownPrefs.hasOwnProperty(id)) {
             throw new Error("Preference " + id + " was redefined");
         }
+        // The type and validator affect the resolved value
+        this._forgetResolved([id]);
         const pref = this._knownPrefs[id] = new Preference({
             type: type,
             initial: initial,
@@ -1428,6 +1802,7 @@ export class PreferencesSystem {
         });
         if (index > -1) {
             defaultScopeOrder.splice(index, 0, id);
+            this._clearResolved();
         } else {
             // error
             throw new Error("Internal error: scope " + before + " should be in the scope order");
@@ -1549,6 +1924,8 @@ export class PreferencesSystem {
             promise
                 .then(function (this: PreferencesSystem) {
                     this._scopes[id] = scope;
+                    // Contexts with their own scope order may already list it
+                    this._clearResolved();
                     this._tryAddToScopeOrder(shadowEntry);
                 }.bind(this))
                 .fail(function (err) {
@@ -1592,6 +1969,7 @@ export class PreferencesSystem {
         const scope = this._scopes[id];
         if (scope) {
             _.pull(this._defaults.scopeOrder, id);
+            this._clearResolved();
             scope.off(".prefsys");
             (this as unknown as EventDispatcher.DispatcherEvents).trigger(SCOPEORDER_CHANGE, {
                 id: id,
@@ -1684,6 +2062,7 @@ export class PreferencesSystem {
         });
         this._defaults._shadowScopeOrder.splice(shadowIndex, 1);
         delete this._scopes[id];
+        this._clearResolved();
     }
 
     /**
@@ -1710,6 +2089,43 @@ export class PreferencesSystem {
     public get(id, context?) {
         context = this._getContext(context);
 
+        const key = _getResolutionKey(this._getScopeOrder(context), context);
+        if (key === null) {
+            return _.cloneDeep(this._resolve(id, context));
+        }
+
+        if (this._resolvedGeneration !== _layerGeneration) {
+            this._clearResolved();
+        }
+
+        let resolvedForId = this._resolved.get(id);
+        if (!resolvedForId) {
+            resolvedForId = new Map();
+            this._resolved.set(id, resolvedForId);
+        }
+
+        let result;
+        if (resolvedForId.has(key)) {
+            result = resolvedForId.get(key);
+        } else {
+            result = _.cloneDeep(this._resolve(id, context));
+            resolvedForId.set(key, result);
+        }
+
+        // Callers may modify the objects they get
+        return (result !== null && typeof result === "object") ? _.cloneDeep(result) : result;
+    }
+
+    /**
+     * @private
+     *
+     * Looks up the value of a preference in the scopes, without the resolution cache.
+     *
+     * @param {string} id Name of the preference
+     * @param {Object} context Normalized context, see _getContext
+     * @return {*} The value, not copied
+     */
+    private _resolve(id, context) {
         const scopeOrder = this._getScopeOrder(context);
 
         for (const scopeName of scopeOrder) {
@@ -1723,11 +2139,36 @@ export class PreferencesSystem {
                         if (pref && pref.type === "object") {
                             result = _.extend({}, pref.initial, result);
                         }
-                        return _.cloneDeep(result);
+                        return result;
                     }
                 }
             }
         }
+
+        return undefined;
+    }
+
+    /**
+     * @private
+     *
+     * Forgets the resolved values of the given preferences, for all contexts.
+     *
+     * @param {Array.<string>} ids Preference IDs
+     */
+    private _forgetResolved(ids) {
+        for (const id of ids) {
+            this._resolved.delete(id);
+        }
+    }
+
+    /**
+     * @private
+     *
+     * Forgets all resolved values, e.g. when the order of the scopes changes.
+     */
+    public _clearResolved() {
+        this._resolved.clear();
+        this._resolvedGeneration = _layerGeneration;
     }
 
     /**
@@ -1863,6 +2304,7 @@ export class PreferencesSystem {
      * @param {{path: string, language: string}} newContext New context
      */
     public signalContextChanged(oldContext, newContext) {
+        // Resolved values stay valid: the context is part of their key
         let changes: Array<any> = [];
 
         _.each(this._scopes, function (scope) {
@@ -1933,6 +2375,9 @@ export class PreferencesSystem {
      * @param {{ids: Array.<string>}} data Message to send
      */
     private _triggerChange(data) {
+        // Even when the event is queued, get() must see the new values right away
+        this._forgetResolved(data.ids);
+
         if (this._changeEventQueue) {
             this._changeEventQueue = _.union(this._changeEventQueue, data.ids);
         } else {
@@ -115,7 +115,7 @@ userScopeLoading
 // It's for more internal, implicit things like window size, working set, etc.
 export const stateManager = new PreferencesBase.PreferencesSystem();
 const userStateFile = brackets.app.getApplicationSupportDirectory() + "/" + STATE_FILENAME;
-const smUserScope = new PreferencesBase.Scope(new PreferencesBase.FileStorage(userStateFile, true, true));
+const smUserScope = new PreferencesBase.Scope(new PreferencesBase.JournaledFileStorage(userStateFile, true, true));
 export const stateProjectLayer = new PreferencesBase.ProjectLayer();
 smUserScope.addLayer(stateProjectLayer);
 export const smUserScopeLoading = stateManager.addScope("user", smUserScope);
@@ -67,7 +67,9 @@ const _exclusionListRegEx = /\.pyc$|^\.git$|^\.svn$|^\.DS_Store$|^Icon\r|^Thumbs
 export const defaultIgnoreGlobs = [
     "**/(.pyc|.git|.svn|.DS_Store|Thumbs.db|.hg|CVS|.hgtags|.idea|.c9revisions|.SyncArchive|.SyncID|.SyncIgnore)",
     "**/bower_components",
-    "**/node_modules"
+    "**/node_modules",
+    // temporary files of atomic writes, see writeTextFileAtomic() in app/appshell/fs-additions.ts
+    "**/.*.tmp~"
 ];
 
 /**
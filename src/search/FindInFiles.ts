@@ -238,9 +238,7 @@ function _getSearchMatches(contents, queryExpr: RegExp) {
 
         // We have the max hits in just this 1 file. Stop searching this file.
         // This fixed issue #1829 where code hangs on too many hits.
-        // Adds one over MAX_TOTAL_RESULTS in order to know if the search has exceeded
-        // or is equal to MAX_TOTAL_RESULTS. Additional result removed in SearchModel
-        if (matches.length > SearchModel.MAX_TOTAL_RESULTS) {
+        if (matches.length >= SearchModel.MAX_TOTAL_RESULTS) {
             queryExpr.lastIndex = 0;
             break;
         }
@@ -262,12 +260,7 @@ function _getSearchMatches(contents, queryExpr: RegExp) {
  *      An array of changes as described in the Document constructor
  */
 function _updateResults(doc, changeList) {
-    let i;
-    let diff;
     let matches;
-    let lines;
-    let start;
-    let howMany;
     let resultsChanged = false;
     const fullPath = doc.file.fullPath;
     let resultInfo = searchModel.results[fullPath];
@@ -275,77 +268,73 @@ function _updateResults(doc, changeList) {
     // Remove the results before we make any changes, so the SearchModel can accurately update its count.
     searchModel.removeResults(fullPath);
 
-    changeList.forEach(function (change) {
-        lines = [];
-        start = 0;
-        howMany = 0;
-
-        // There is no from or to positions, so the entire file changed, we must search all over again
-        if (!change.from || !change.to) {
-            // TODO: add unit test exercising timestamp logic in this case
-            // We don't just call _updateSearchMatches() here because we want to continue iterating through changes in
-            // the list and update at the end.
-            resultInfo = {matches: _getSearchMatches(doc.getText(), searchModel.queryExpr!), timestamp: doc.diskTimestamp};
-            resultsChanged = true;
-
-        } else {
-            // Get only the lines that changed
-            for (i = 0; i < change.text.length; i++) {
-                lines.push(doc.getLine(change.from.line + i));
-            }
+    // Collapse the change list into the one span of lines it touched, so that an edit with many
+    // cursors rescans that span once instead of once per change.
+    const change = DocumentModule.Document.summarizeChangeList(changeList);
 
-            // We need to know how many newlines were inserted/deleted in order to update the rest of the line indices;
-            // this is the total number of newlines inserted (which is the length of the lines array minus
-            // 1, since the last line in the array is inserted without a newline after it) minus the
-            // number of original newlines being removed.
-            diff = lines.length - 1 - (change.to.line - change.from.line);
+    if (change.replacesAll) {
+        // The entire file changed, we must search all over again
+        // TODO: add unit test exercising timestamp logic in this case
+        resultInfo = {matches: _getSearchMatches(doc.getText(), searchModel.queryExpr!), timestamp: doc.diskTimestamp};
+        resultsChanged = true;
 
-            if (resultInfo) {
-                // Search the last match before a replacement, the amount of matches deleted and update
-                // the lines values for all the matches after the change
-                resultInfo.matches.forEach(function (item) {
-                    if (item.end.line < change.from.line) {
-                        start++;
-                    } else if (item.end.line <= change.to.line) {
-                        howMany++;
-                    } else {
-                        item.start.line += diff;
-                        item.end.line   += diff;
-                    }
-                });
+    } else {
+        // Get only the lines that changed
+        const lines: Array<string> = [];
+        for (let i = change.fromLine; i <= change.newToLine; i++) {
+            lines.push(doc.getLine(i));
+        }
 
-                // Delete the lines that where deleted or replaced
-                if (howMany > 0) {
-                    resultInfo.matches.splice(start, howMany);
+        // Number of lines inserted (or removed, if negative) in front of the rest of the matches
+        const diff = change.newToLine - change.toLine;
+        let start = 0;
+        let howMany = 0;
+
+        if (resultInfo) {
+            // Search the last match before a replacement, the amount of matches deleted and update
+            // the lines values for all the matches after the change
+            resultInfo.matches.forEach(function (item) {
+                if (item.end.line < change.fromLine) {
+                    start++;
+                } else if (item.end.line <= change.toLine) {
+                    howMany++;
+                } else {
+                    item.start.line += diff;
+                    item.end.line   += diff;
                 }
-                resultsChanged = true;
+            });
+
+            // Delete the lines that where deleted or replaced
+            if (howMany > 0) {
+                resultInfo.matches.splice(start, howMany);
             }
+            resultsChanged = true;
+        }
 
-            // Searches only over the lines that changed
-            matches = _getSearchMatches(lines.join("\r\n"), searchModel.queryExpr!);
-            if (matches.length) {
-                // Updates the line numbers, since we only searched part of the file
-                matches.forEach(function (value, key) {
-                    matches[key].start.line += change.from.line;
-                    matches[key].end.line   += change.from.line;
-                });
-
-                // If the file index exists, add the new matches to the file at the start index found before
-                if (resultInfo) {
-                    Array.prototype.splice.apply(resultInfo.matches, [start, 0].concat(matches));
-                // If not, add the matches to a new file index
-                } else {
-                    // TODO: add unit test exercising timestamp logic in self case
-                    resultInfo = {
-                        matches:   matches,
-                        collapsed: false,
-                        timestamp: doc.diskTimestamp
-                    };
-                }
-                resultsChanged = true;
+        // Searches only over the lines that changed
+        matches = _getSearchMatches(lines.join("\r\n"), searchModel.queryExpr!);
+        if (matches.length) {
+            // Updates the line numbers, since we only searched part of the file
+            matches.forEach(function (value, key) {
+                matches[key].start.line += change.fromLine;
+                matches[key].end.line   += change.fromLine;
+            });
+
+            // If the file index exists, add the new matches to the file at the start index found before
+            if (resultInfo) {
+                Array.prototype.splice.apply(resultInfo.matches, [start, 0].concat(matches));
+            // If not, add the matches to a new file index
+            } else {
+                // TODO: add unit test exercising timestamp logic in self case
+                resultInfo = {
+                    matches:   matches,
+                    collapsed: false,
+                    timestamp: doc.diskTimestamp
+                };
             }
+            resultsChanged = true;
         }
-    });
+    }
 
     // Always re-add the results, even if nothing changed.
     if (resultInfo && resultInfo.matches.length) {
@@ -481,7 +470,7 @@ function _doSearchInOneFile(file): JQueryPromise<boolean> {
             // Note that we don't fire a model change here, since this is always called by some outer batch
             // operation that will fire it once it's done.
             const matches = _getSearchMatches(text, searchModel.queryExpr!);
-            searchModel.setResults(file.fullPath, {matches: matches, timestamp: timestamp});
+            searchModel.setResultsUpToMaximum(file.fullPath, {matches: matches, timestamp: timestamp});
             result.resolve(!!matches.length);
         })
         .fail(function () {
@@ -606,7 +595,6 @@ function _doSearch(queryInfo, candidateFilesPromise, filter) {
                         searchModel.results = rcvdObject.results;
                         searchModel.numMatches = rcvdObject.numMatches;
                         searchModel.numFiles = rcvdObject.numFiles;
-                        searchModel.exceedsMaximum = rcvdObject.exceedsMaximum;
                         searchModel.allResultsAvailable = rcvdObject.allResultsAvailable;
                         searchDeferred.resolve();
                     })
@@ -1015,6 +1003,7 @@ export function getNextPageofSearchResults() {
             } else {
                 searchModel.results = rcvdObject.results;
             }
+            searchModel.allResultsAvailable = rcvdObject.allResultsAvailable;
             searchModel.fireChanged();
             searchDeferred.resolve();
         })
@@ -55,6 +55,12 @@ import { DispatcherEvents } from "utils/EventDispatcher";
 /** @const Maximum number of files to do replacements in-memory instead of on disk. */
 const MAX_IN_MEMORY = 20;
 
+/** @const Id of the status bar indicator that shows the progress of a replace across files. */
+const REPLACE_PROGRESS_INDICATOR_ID = "status-replace-in-files";
+
+/** @type {jQueryObject} The replace progress indicator. Initialized in htmlReady() */
+let $replaceProgress: JQuery;
+
 /** @type {SearchResultsView} The results view. Initialized in htmlReady() */
 let _resultsView: SearchResultsView;
 
@@ -316,7 +322,21 @@ function _finishReplaceBatch(model) {
     function processReplace(forceFilesOpen) {
         StatusBar.showBusyIndicator(true);
         FindInFiles.doReplace(resultsClone, replaceText, { forceFilesOpen: forceFilesOpen, isRegexp: isRegexp })
-            .fail(function (errors) {
+            .progress(function (numDone, numTotal) {
+                if (numDone < numTotal) {
+                    $replaceProgress.text(StringUtils.format(Strings.REPLACE_IN_FILES_PROGRESS, numDone, numTotal));
+                    StatusBar.updateIndicator(REPLACE_PROGRESS_INDICATOR_ID, true, undefined, Strings.REPLACE_IN_FILES_CANCEL_HINT);
+                }
+            })
+            .fail(function (allErrors) {
+                // Files skipped because the user stopped the replace aren't errors worth reporting
+                const errors = allErrors.filter(function (errorInfo) {
+                    return errorInfo.error !== FindUtils.ERROR_REPLACE_CANCELLED;
+                });
+                if (!errors.length) {
+                    return;
+                }
+
                 const message = Strings.REPLACE_IN_FILES_ERRORS + FileUtils.makeDialogFileList(
                     errors.map(function (errorInfo) {
                         return ProjectManager.makeProjectRelativeIfPossible(errorInfo.item);
@@ -337,6 +357,7 @@ function _finishReplaceBatch(model) {
                 );
             })
             .always(function () {
+                StatusBar.updateIndicator(REPLACE_PROGRESS_INDICATOR_ID, false, undefined, undefined);
                 StatusBar.hideBusyIndicator();
             });
     }
@@ -462,6 +483,12 @@ export function closeResultsPanel() {
 // Initialize items dependent on HTML DOM
 AppInit.htmlReady(function () {
     const model = FindInFiles.searchModel;
+
+    $replaceProgress = $("<div>").click(function () {
+        FindUtils.cancelReplacements();
+    });
+    StatusBar.addIndicator(REPLACE_PROGRESS_INDICATOR_ID, $replaceProgress, false, "", Strings.REPLACE_IN_FILES_CANCEL_HINT);
+
     _resultsView = new SearchResultsView(model, "find-in-files-results", "find-in-files.results");
     (_resultsView as unknown as DispatcherEvents)
         .on("replaceBatch", function () {
@@ -476,13 +503,6 @@ AppInit.htmlReady(function () {
                     _resultsView.showNextPage();
                 }
             });
-        })
-        .on("getLastPage", function () {
-            FindInFiles.getAllSearchResults().done(function () {
-                if (FindInFiles.searchModel.hasResults()) {
-                    _resultsView.showLastPage();
-                }
-            });
         });
 });
 
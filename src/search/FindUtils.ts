@@ -39,6 +39,10 @@ interface WorkingSetFileMap {
 }
 
 export const ERROR_FILE_CHANGED = "fileChanged";
+export const ERROR_REPLACE_CANCELLED = "replaceCancelled";
+
+/** @const Maximum number of files that are read and rewritten on disk at the same time during a replace. */
+const MAX_CONCURRENT_DISK_REPLACEMENTS = 8;
 
 // events raised by FindUtils
 export const SEARCH_FILE_FILTERS_CHANGED = "fileFiltersChanged";
@@ -53,6 +57,9 @@ let indexingInProgress = false;
 let nodeSearchCount = 0;
 let collapseResults = false;
 
+/** @type {?{cancelled: boolean}} Cancellation state of the replace currently in progress, if any */
+let _currentReplace: { cancelled: boolean } | null = null;
+
 EventDispatcher.makeEventDispatcher(exports);
 
 // define preferences for find in files
@@ -199,26 +206,25 @@ function _doReplaceOnDisk(fullPath, matchInfo, replaceText, isRegexp) {
             return $.Deferred().reject(ERROR_FILE_CHANGED).promise();
         }
 
-        // Note that this assumes that the matches are sorted.
-        // TODO: is there a more efficient way to do this in a large string?
-        const result: Array<string> = [];
+        // Note that this assumes that the matches are sorted. Line endings are converted
+        // per segment as the new contents are built, so the text is only walked once.
+        const convertLineEndings = lineEndings === FileUtils.LINE_ENDINGS_CRLF;
+        function toOriginalLineEndings(text) {
+            return convertLineEndings ? text.replace(/\n/g, "\r\n") : text;
+        }
+
+        let newContents = "";
         let lastIndex = 0;
         matchInfo.matches.forEach(function (match) {
             if (match.isChecked) {
-                result.push(contents.slice(lastIndex, match.startOffset));
-                result.push(isRegexp ? parseRegexp(replaceText, match.result) : replaceText);
+                newContents += toOriginalLineEndings(contents.slice(lastIndex, match.startOffset));
+                newContents += toOriginalLineEndings(isRegexp ? parseRegexp(replaceText, match.result) : replaceText);
                 lastIndex = match.endOffset;
             }
         });
-        result.push(contents.slice(lastIndex));
-
-        let newContents = result.join("");
-        // TODO: duplicated logic from Document - should refactor this?
-        if (lineEndings === FileUtils.LINE_ENDINGS_CRLF) {
-            newContents = newContents.replace(/\n/g, "\r\n");
-        }
+        newContents += toOriginalLineEndings(contents.slice(lastIndex));
 
-        return Async.promisify(file, "write", newContents);
+        return Async.promisify(file, "write", newContents, { atomic: true });
     });
 }
 
@@ -284,12 +290,56 @@ export function hasCheckedMatches(result) {
  * @return {$.Promise} A promise that's resolved when the replacement is finished or rejected with an array of errors
  *      if there were one or more errors. Each individual item in the array will be a {item: string, error: string} object,
  *      where item is the full path to the file that could not be updated, and error is either a FileSystem error or one
- *      of the `FindUtils.ERROR_*` constants.
+ *      of the `FindUtils.ERROR_*` constants. Files skipped because of cancelReplacements() are reported with
+ *      `ERROR_REPLACE_CANCELLED`. Progress is notified with the number of files done and the total number of files.
  */
 export function performReplacements(results, replaceText, options) {
-    return Async.doInParallel_aggregateErrors(Object.keys(results), function (fullPath) {
+    const replaceState = { cancelled: false };
+    const result = $.Deferred();
+    _currentReplace = replaceState;
+
+    // Documents that are already open are replaced synchronously, as promised above. Everything
+    // else is read and written through a bounded pool so a replace across thousands of files
+    // doesn't hold all of their contents in memory or open all of their handles at once.
+    const paths = Object.keys(results);
+    const openPaths = paths.filter(function (fullPath) {
+        return !!DocumentManager.getOpenDocumentForPath(fullPath);
+    });
+    const otherPaths = _.difference(paths, openPaths);
+    const total = paths.length;
+    let errors: Array<Async.Error> = [];
+
+    Async.doInParallel_aggregateErrors(openPaths, function (fullPath) {
+        return _doReplaceInOneFile(fullPath, results[fullPath], replaceText, options);
+    }).fail(function (openErrors) {
+        errors = errors.concat(openErrors);
+    });
+    result.notify(openPaths.length, total);
+
+    Async.doInParallelLimited_aggregateErrors(otherPaths, function (fullPath) {
+        if (replaceState.cancelled) {
+            return $.Deferred().reject(ERROR_REPLACE_CANCELLED).promise();
+        }
         return _doReplaceInOneFile(fullPath, results[fullPath], replaceText, options);
-    }).done(function () {
+    }, MAX_CONCURRENT_DISK_REPLACEMENTS)
+        .progress(function (numCompleted) {
+            result.notify(openPaths.length + numCompleted, total);
+        })
+        .fail(function (otherErrors) {
+            errors = errors.concat(otherErrors);
+        })
+        .always(function () {
+            if (_currentReplace === replaceState) {
+                _currentReplace = null;
+            }
+            if (errors.length) {
+                result.reject(errors);
+            } else {
+                result.resolve();
+            }
+        });
+
+    return result.promise().done(function () {
         if (options && options.forceFilesOpen) {
             // If the currently selected document wasn't modified by the search, or there is no open document,
             // then open the first modified document.
@@ -328,6 +378,19 @@ export function performReplacements(results, replaceText, options) {
     });
 }
 
+/**
+ * Stops the replacement started by the last call to performReplacements(). Files that are already
+ * being written are finished; files that haven't been started yet are left untouched.
+ * @return {boolean} true if a replacement was in progress
+ */
+export function cancelReplacements() {
+    if (!_currentReplace) {
+        return false;
+    }
+    _currentReplace.cancelled = true;
+    return true;
+}
+
 /**
  * Returns label text to indicate the search scope. Already HTML-escaped.
  * @param {?Entry} scope
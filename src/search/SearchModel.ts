@@ -41,7 +41,7 @@ interface WorkingSetFileMap {
  */
 export class SearchModel {
     /**
-     *  @const Constant used to define the maximum results found.
+     *  @const Constant used to define the maximum results found by the in-browser search.
      *  Note that this is a soft limit - we'll likely go slightly over it since
      *  we always add all the searches in a given file.
      */
@@ -96,17 +96,11 @@ export class SearchModel {
     public numMatches = 0;
 
     /**
-     * Whether or not we hit the maximum number of results for the type of search we did.
+     * Whether or not the in-browser search hit the maximum number of results.
      * @type {boolean}
      */
     public foundMaximum = false;
 
-    /**
-     * Whether or not we exceeded the maximum number of results in the search we did.
-     * @type {boolean}
-     */
-    public exceedsMaximum = false;
-
     public numFiles;
     public allResultsAvailable: boolean;
 
@@ -127,7 +121,6 @@ export class SearchModel {
         this.scope = null;
         this.numMatches = 0;
         this.foundMaximum = false;
-        this.exceedsMaximum = false;
         if (numMatchesBefore !== 0) {
             this.fireChanged();
         }
@@ -163,7 +156,7 @@ export class SearchModel {
     public setResults(fullpath, resultInfo) {
         this.removeResults(fullpath);
 
-        if (this.foundMaximum || !resultInfo.matches.length) {
+        if (!resultInfo.matches.length) {
             return;
         }
 
@@ -173,15 +166,24 @@ export class SearchModel {
 
         this.results[fullpath] = resultInfo;
         this.numMatches += resultInfo.matches.length;
+    }
+
+    /**
+     * Same as setResults(), but stops taking results once MAX_TOTAL_RESULTS matches were found.
+     * Only the in-browser search uses it, since it keeps every match in memory; the node search
+     * pages its results and has no total limit.
+     * @param {string} fullpath Full path to the file containing the matches.
+     * @param {!{matches: Object, timestamp: Date, collapsed: boolean=}} resultInfo See setResults().
+     */
+    public setResultsUpToMaximum(fullpath, resultInfo) {
+        if (this.foundMaximum) {
+            this.removeResults(fullpath);
+            return;
+        }
+
+        this.setResults(fullpath, resultInfo);
         if (this.numMatches >= SearchModel.MAX_TOTAL_RESULTS) {
             this.foundMaximum = true;
-
-            // Remove final result if there have been over MAX_TOTAL_RESULTS found
-            if (this.numMatches > SearchModel.MAX_TOTAL_RESULTS) {
-                this.results[fullpath].matches.pop();
-                this.numMatches--;
-                this.exceedsMaximum = true;
-            }
         }
     }
 
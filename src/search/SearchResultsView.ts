@@ -24,6 +24,10 @@
 
 /*
  * Panel showing search results for a Find/Replace in Files operation.
+ *
+ * The rows of all the results are indexed in typed arrays, but only the rows that are scrolled into
+ * view are in the DOM, so that the panel stays responsive with hundreds of thousands of results.
+ * Results that the model doesn't have yet are requested a page at a time while scrolling.
  */
 
 import * as CommandManager from "command/CommandManager";
@@ -44,25 +48,30 @@ import * as Mustache from "thirdparty/mustache/mustache";
 
 import * as searchPanelTemplate from "text!htmlContent/search-panel.html";
 import * as searchResultsTemplate from "text!htmlContent/search-results.html";
+import * as searchResultRowsTemplate from "text!htmlContent/search-result-rows.html";
 import * as searchSummaryTemplate from "text!htmlContent/search-summary.html";
 
-interface SearchItem {
-    fileIndex: number;
-    filename: string;
-    fullPath: string;
-    isChecked: boolean;
-    items: Array<any>;
-    // TODO: verify types, collapsed is correct here?
-    collapsed?: boolean;
-    isCollapsed: boolean;
-}
+/**
+ * @const
+ * Number of rows rendered above and below the visible ones, so that scrolling a bit
+ * doesn't show empty space before the rows are rendered.
+ * @type {number}
+ */
+const OVERSCAN_ROWS = 20;
 
 /**
  * @const
- * The maximum results to show per page.
+ * The next page of results is requested when there are fewer rows than this below the rendered ones.
  * @type {number}
  */
-const RESULTS_PER_PAGE = 100;
+const NEXT_PAGE_THRESHOLD = 50;
+
+/**
+ * @const
+ * Height of a row, in pixels, until a rendered row could be measured.
+ * @type {number}
+ */
+const DEFAULT_ROW_HEIGHT = 29;
 
 /**
  * @const
@@ -76,11 +85,25 @@ export class SearchResultsView {
     /** @type {SearchModel} The search results model we're viewing. */
     private _model;
 
+    /** @type {Array.<string>} Full paths of the files that have results, in the order they are displayed */
+    private _files: Array<string> = [];
+
+    /** @type {Array.<string>} Display name of each file of _files, built when its row is first rendered */
+    private _fileNames: Array<string> = [];
+
     /**
-     * Array with content used in the Results Panel
-     * @type {Array.<{fileIndex: number, filename: string, fullPath: string, items: Array.<Object>}>}
+     * Index of the rows of the results list: a row shows the match _rowMatches[i] of the file
+     * _rowFiles[i], or the title of that file if _rowMatches[i] is -1. Rows of collapsed files are left out.
+     * @type {Int32Array}
      */
-    private _searchList: Array<SearchItem> = [];
+    private _rowFiles = new Int32Array(0);
+    private _rowMatches = new Int32Array(0);
+
+    /** @type {Object.<string, HTMLElement>} The rows in the DOM, by "fileIndex:matchIndex" */
+    private _rowElements: { [key: string]: HTMLElement } = {};
+
+    /** @type {number} Height of a row, 0 until a rendered row could be measured */
+    private _rowHeight = 0;
 
     /** @type {Panel} Bottom panel holding the search results */
     private _panel;
@@ -88,21 +111,30 @@ export class SearchResultsView {
     /** @type {?string} The full path of the file that was open in the main editor on the initial search */
     private _initialFilePath = null;
 
-    /** @type {number} The index of the first result that is displayed */
-    private _currentStart = 0;
-
     /** @type {boolean} Used to remake the replace all summary after it is changed */
     private _allChecked = false;
 
-    /** @type {$.Element} The currently selected row */
-    private _$selectedRow: JQuery | null;
+    /** @type {boolean} Whether the next page of results was requested and hasn't been shown yet */
+    private _nextPageRequested = false;
+
+    /** @type {?string} The file of the selected row */
+    private _selectedPath: string | null = null;
+
+    /** @type {number} The match of the selected row, -1 for the title of the file */
+    private _selectedMatch = -1;
 
     /** @type {$.Element} The element where the title is placed */
     private _$summary;
 
-    /** @type {$.Element} The table that holds the results */
+    /** @type {$.Element} The scrolling container of the results */
     private _$table: JQuery;
 
+    /** @type {$.Element} Holds the rendered rows, sized to the height of all the rows */
+    private _$scroller: JQuery | null = null;
+
+    /** @type {HTMLTableSectionElement} The body of the table that holds the rendered rows */
+    private _tbody: HTMLTableSectionElement | null = null;
+
     /** @type {number} The ID we use for timeouts when handling model changes. */
     private _timeoutID;
 
@@ -114,6 +146,7 @@ export class SearchResultsView {
      * Handles the search results panel.
      * Dispatches the following events:
      *      replaceBatch - when the "Replace" button is clicked.
+     *      getNextPage - when the results are scrolled near the end and the model doesn't have all the results.
      *      close - when the panel is closed.
      *
      * @param {SearchModel} model The model that this view is showing.
@@ -160,10 +193,18 @@ export class SearchResultsView {
 
     /**
      * @private
-     * Adds the listeners for close, prev, next, first, last and check all
+     * Adds the listeners for close, scrolling, selection, expand/collapse and check all
      */
     private _addPanelListeners() {
         const self = this;
+
+        // Scroll events don't bubble, listen on the container itself
+        this._$table
+            .off(".searchResults")
+            .on("scroll.searchResults", function () {
+                self._renderRows();
+            });
+
         this._panel.$panel
             .off(".searchResults")  // Remove the old events
             .on("dblclick.searchResults", ".toolbar", function () {
@@ -172,33 +213,13 @@ export class SearchResultsView {
             .on("click.searchResults", ".close", function () {
                 self.close();
             })
-            // The link to go the first page
-            .on("click.searchResults", ".first-page:not(.disabled)", function () {
-                self._currentStart = 0;
-                self._render();
-                HealthLogger.searchDone(HealthLogger.SEARCH_FIRST_PAGE);
-            })
-            // The link to go the previous page
-            .on("click.searchResults", ".prev-page:not(.disabled)", function () {
-                self._currentStart -= RESULTS_PER_PAGE;
-                self._render();
-                HealthLogger.searchDone(HealthLogger.SEARCH_PREV_PAGE);
-            })
-            // The link to go to the next page
-            .on("click.searchResults", ".next-page:not(.disabled)", function () {
-                (self as unknown as EventDispatcher.DispatcherEvents).trigger("getNextPage");
-                HealthLogger.searchDone(HealthLogger.SEARCH_NEXT_PAGE);
-            })
-            // The link to go to the last page
-            .on("click.searchResults", ".last-page:not(.disabled)", function () {
-                (self as unknown as EventDispatcher.DispatcherEvents).trigger("getLastPage");
-                HealthLogger.searchDone(HealthLogger.SEARCH_LAST_PAGE);
+            .on("panelResizeUpdate.searchResults", function () {
+                self._renderRows();
             })
 
             // Add the file to the working set on double click
             .on("dblclick.searchResults", ".table-container tr:not(.file-section)", function (this: any, e) {
-                const item = self._searchList[$(this).data("file-index")];
-                FileViewController.openFileAndAddToWorkingSet(item.fullPath);
+                FileViewController.openFileAndAddToWorkingSet(self._files[$(this).data("file-index")]);
             })
 
             // Add the click event listener directly on the table parent
@@ -206,50 +227,36 @@ export class SearchResultsView {
                 const $row = $(e.target).closest("tr");
 
                 if ($row.length) {
-                    if (self._$selectedRow) {
-                        self._$selectedRow.removeClass("selected");
-                    }
-                    $row.addClass("selected");
-                    self._$selectedRow = $row;
+                    const fullPath   = self._files[$row.data("file-index")];
+                    const matchIndex = $row.hasClass("file-section") ? -1 : $row.data("match-index");
 
-                    let searchItem = self._searchList[$row.data("file-index")];
-                    let fullPath   = searchItem.fullPath;
+                    self._$table.find("tr.selected").removeClass("selected");
+                    $row.addClass("selected");
+                    self._selectedPath  = fullPath;
+                    self._selectedMatch = matchIndex;
 
                     // This is a file title row, expand/collapse on click
-                    if ($row.hasClass("file-section")) {
-                        let $titleRows;
+                    if (matchIndex === -1) {
                         const collapsed = !self._model.results[fullPath].collapsed;
 
                         if (e.metaKey || e.ctrlKey) { // Expand all / Collapse all
-                            $titleRows = $(e.target).closest("table").find(".file-section");
-                        } else {
-                            // Clicking the file section header collapses/expands result rows for that file
-                            $titleRows = $row;
-                        }
-
-                        $titleRows.each(function (this: any) {
-                            fullPath   = self._searchList[$(this).data("file-index")].fullPath;
-                            searchItem = self._model.results[fullPath];
-
-                            if (searchItem.collapsed !== collapsed) {
-                                searchItem.collapsed = collapsed;
-                                $(this).nextUntil(".file-section").toggle();
-                                $(this).find(".disclosure-triangle").toggleClass("expanded");
-                            }
-                        });
-
-                        // In Expand/Collapse all, reset all search results 'collapsed' flag to same value(true/false).
-                        if (e.metaKey || e.ctrlKey) {
                             FindUtils.setCollapseResults(collapsed);
                             _.forEach(self._model.results, function (item) {
                                 item.collapsed = collapsed;
                             });
+                        } else {
+                            // Clicking the file section header collapses/expands result rows for that file
+                            self._model.results[fullPath].collapsed = collapsed;
                         }
 
+                        // Only the rows after the clicked one move, the rendered rows that stay are reused
+                        self._indexRows();
+                        self._renderRows();
+
                     // This is a file row, show the result on click
                     } else {
                         // Grab the required item data
-                        const item = searchItem.items[$row.data("item-index")];
+                        const item = self._model.results[fullPath].matches[matchIndex];
 
                         CommandManager.execute(Commands.FILE_OPEN, {fullPath: fullPath})
                             .done(function (doc) {
@@ -260,45 +267,12 @@ export class SearchResultsView {
                 }
             });
 
-        function updateHeaderCheckbox($checkAll) {
-            const $allFileRows     = self._panel.$panel.find(".file-section");
-            const $checkedFileRows = $allFileRows.filter(function (this: any, index) {
-                return $(this).find(".check-one-file").is(":checked");
+        // The checkboxes only show the rendered rows, the state of every match is kept in the model
+        function updateHeaderCheckbox() {
+            self._allChecked = _.every(self._model.results, function (item: any) {
+                return _.every(item.matches, "isChecked");
             });
-            if ($checkedFileRows.length === $allFileRows.length) {
-                $checkAll.prop("checked", true);
-            }
-        }
-
-        function updateFileAndHeaderCheckboxes($clickedRow, isChecked) {
-            const $firstMatch = ($clickedRow.data("item-index") === 0)
-                ? $clickedRow
-                : $clickedRow.prevUntil(".file-section").last();
-            const $fileRow = $firstMatch.prev();
-            const $siblingRows = $fileRow.nextUntil(".file-section");
-            const $fileCheckbox = $fileRow.find(".check-one-file");
-            const $checkAll = self._panel.$panel.find(".check-all");
-
-            if (isChecked) {
-                if (!$fileCheckbox.is(":checked")) {
-                    const $checkedSibilings = $siblingRows.filter(function (this: any, index) {
-                        return $(this).find(".check-one").is(":checked");
-                    });
-                    if ($checkedSibilings.length === $siblingRows.length) {
-                        $fileCheckbox.prop("checked", true);
-                        if (!$checkAll.is(":checked")) {
-                            updateHeaderCheckbox($checkAll);
-                        }
-                    }
-                }
-            } else {
-                if ($checkAll.is(":checked")) {
-                    $checkAll.prop("checked", false);
-                }
-                if ($fileCheckbox.is(":checked")) {
-                    $fileCheckbox.prop("checked", false);
-                }
-            }
+            self._panel.$panel.find(".check-all").prop("checked", self._allChecked);
         }
 
         // Add the Click handlers for replace functionality if required
@@ -317,33 +291,24 @@ export class SearchResultsView {
                 })
                 .on("click.searchResults", ".check-one-file", function (this: any, e) {
                     const isChecked = $(this).is(":checked");
-                    const $row = $(e.target).closest("tr");
-                    const item = self._searchList[$row.data("file-index")];
-                    const $matchRows = $row.nextUntil(".file-section");
-                    const $checkAll = self._panel.$panel.find(".check-all");
+                    const fileIndex = $(e.target).closest("tr").data("file-index");
 
-                    if (item) {
-                        self._model.results[item.fullPath].matches.forEach(function (match) {
-                            match.isChecked = isChecked;
-                        });
-                    }
-                    $matchRows.find(".check-one").prop("checked", isChecked);
-                    if (!isChecked) {
-                        if ($checkAll.is(":checked")) {
-                            $checkAll.prop("checked", false);
-                        }
-                    } else if (!$checkAll.is(":checked")) {
-                        updateHeaderCheckbox($checkAll);
-                    }
+                    self._model.results[self._files[fileIndex]].matches.forEach(function (match) {
+                        match.isChecked = isChecked;
+                    });
+                    self._$table.find("tr[data-file-index='" + fileIndex + "'] .check-one").prop("checked", isChecked);
+                    updateHeaderCheckbox();
                     e.stopPropagation();
                 })
                 .on("click.searchResults", ".check-one", function (this: any, e) {
                     const $row = $(e.target).closest("tr");
-                    const item = self._searchList[$row.data("file-index")];
-                    const match = self._model.results[item.fullPath].matches[$row.data("match-index")];
+                    const fileIndex = $row.data("file-index");
+                    const matches = self._model.results[self._files[fileIndex]].matches;
 
-                    match.isChecked = $(this).is(":checked");
-                    updateFileAndHeaderCheckboxes($row, match.isChecked);
+                    matches[$row.data("match-index")].isChecked = $(this).is(":checked");
+                    self._$table.find("tr.file-section[data-file-index='" + fileIndex + "'] .check-one-file")
+                        .prop("checked", _.every(matches, "isChecked"));
+                    updateHeaderCheckbox();
                     e.stopPropagation();
                 })
                 .on("click.searchResults", ".replace-checked", function (e) {
@@ -359,7 +324,6 @@ export class SearchResultsView {
      */
     private _showSummary() {
         const count     = this._model.countFilesMatches();
-        const lastIndex = this._getLastIndex(count.matches);
         let typeStr = (count.matches > 1) ? Strings.FIND_IN_FILES_MATCHES : Strings.FIND_IN_FILES_MATCH;
 
         if (this._searchResultsType === "reference") {
@@ -375,7 +339,7 @@ export class SearchResultsView {
         // This text contains some formatting, so all the strings are assumed to be already escaped
         const summary = StringUtils.format(
             Strings.FIND_TITLE_SUMMARY,
-            this._model.exceedsMaximum ? Strings.FIND_IN_FILES_MORE_THAN : "",
+            "",
             String(count.matches),
             typeStr,
             filesStr
@@ -388,10 +352,6 @@ export class SearchResultsView {
             scope:       this._model.scope ? "&nbsp;" + FindUtils.labelForScope(this._model.scope) + "&nbsp;" : "",
             summary:     summary,
             allChecked:  this._allChecked,
-            hasPages:    count.matches > RESULTS_PER_PAGE,
-            results:     StringUtils.format(Strings.FIND_IN_FILES_PAGING, this._currentStart + 1, lastIndex),
-            hasPrev:     this._currentStart > 0,
-            hasNext:     lastIndex < count.matches,
             replace:     this._model.isReplace,
             Strings:     Strings
         }));
@@ -399,186 +359,228 @@ export class SearchResultsView {
 
     /**
      * @private
-     * Shows the current set of results.
+     * Rebuilds the row index from the files and the collapsed state of their results.
      */
-    private _render() {
-        let searchItems;
-        let match;
-        let i;
-        let item;
-        let multiLine;
-        const count            = this._model.countFilesMatches();
-        const searchFiles      = this._model.prioritizeOpenFile(this._initialFilePath);
-        const lastIndex        = this._getLastIndex(count.matches);
-        let matchesCounter   = 0;
-        let showMatches      = false;
-        let allInFileChecked = true;
-        const self             = this;
+    private _indexRows() {
+        const results = this._model.results;
+        let numRows = 0;
 
-        this._showSummary();
-        this._searchList = [];
-
-        // Iterates throuh the files to display the results sorted by filenamess. The loop ends as soon as
-        // we filled the results for one page
-        searchFiles.some(function (fullPath) {
-            showMatches = true;
-            item = self._model.results[fullPath];
-
-            // Since the amount of matches on this item plus the amount of matches we skipped until
-            // now is still smaller than the first match that we want to display, skip these.
-            if (matchesCounter + item.matches.length < self._currentStart) {
-                matchesCounter += item.matches.length;
-                showMatches = false;
-
-            // If we still haven't skipped enough items to get to the first match, but adding the
-            // item matches to the skipped ones is greater the the first match we want to display,
-            // then we can display the matches from this item skipping the first ones
-            } else if (matchesCounter < self._currentStart) {
-                i = self._currentStart - matchesCounter;
-                matchesCounter = self._currentStart;
-
-            // If we already skipped enough matches to get to the first match to display, we can start
-            // displaying from the first match of this item
-            } else if (matchesCounter < lastIndex) {
-                i = 0;
-
-            // We can't display more items by now. Break the loop
-            } else {
-                return true;
-            }
+        this._files.forEach(function (fullPath) {
+            const item = results[fullPath];
+            numRows += 1 + (item.collapsed ? 0 : item.matches.length);
+        });
 
-            if (showMatches && i < item.matches.length) {
-                // Add a row for each match in the file
-                searchItems = [];
-
-                allInFileChecked = true;
-                // Add matches until we get to the last match of this item, or filling the page
-                while (i < item.matches.length && matchesCounter < lastIndex) {
-                    match     = item.matches[i];
-                    multiLine = match.start.line !== match.end.line;
-
-                    searchItems.push({
-                        fileIndex:   self._searchList.length,
-                        itemIndex:   searchItems.length,
-                        matchIndex:  i,
-                        line:        match.start.line + 1,
-                        pre:         match.line.substr(0, match.start.ch - match.highlightOffset),
-                        highlight:   match.line.substring(match.start.ch - match.highlightOffset, multiLine ? undefined : match.end.ch - match.highlightOffset),
-                        post:        multiLine ? "\u2026" : match.line.substr(match.end.ch - match.highlightOffset),
-                        start:       match.start,
-                        end:         match.end,
-                        isChecked:   match.isChecked,
-                        isCollapsed: item.collapsed
-                    });
-                    if (!match.isChecked) {
-                        allInFileChecked = false;
-                    }
-                    matchesCounter++;
-                    i++;
-                }
+        const rowFiles   = new Int32Array(numRows);
+        const rowMatches = new Int32Array(numRows);
+        let row = 0;
 
-                // Add a row for each file
-                const relativePath    = FileUtils.getDirectoryPath(ProjectManager.makeProjectRelativeIfPossible(fullPath));
-                const directoryPath   = FileUtils.getDirectoryPath(relativePath);
-                const displayFileName = StringUtils.format(
-                    Strings.FIND_IN_FILES_FILE_PATH,
-                    StringUtils.breakableUrl(FileUtils.getBaseName(fullPath)),
-                    StringUtils.breakableUrl(directoryPath),
-                    directoryPath ? "&mdash;" : ""
-                );
-
-                self._searchList.push({
-                    fileIndex:   self._searchList.length,
-                    filename:    displayFileName,
-                    fullPath:    fullPath,
-                    isChecked:   allInFileChecked,
-                    items:       searchItems,
-                    isCollapsed: item.collapsed
-                });
-            }
+        this._files.forEach(function (fullPath, fileIndex) {
+            const item = results[fullPath];
 
-            return undefined;
+            rowFiles[row] = fileIndex;
+            rowMatches[row++] = -1;
+            if (!item.collapsed) {
+                for (let i = 0; i < item.matches.length; i++) {
+                    rowFiles[row] = fileIndex;
+                    rowMatches[row++] = i;
+                }
+            }
         });
 
+        this._rowFiles   = rowFiles;
+        this._rowMatches = rowMatches;
+    }
 
-        // Insert the search results
-        this._$table
-            .empty()
-            .append(Mustache.render(searchResultsTemplate, {
-                replace:       this._model.isReplace,
-                searchList:    this._searchList,
-                Strings:       Strings
-            }));
+    /**
+     * @private
+     * Returns the display name of a file, with its directory
+     * @param {number} fileIndex
+     * @return {string}
+     */
+    private _getFileName(fileIndex) {
+        if (this._fileNames[fileIndex] === undefined) {
+            const fullPath      = this._files[fileIndex];
+            const relativePath  = FileUtils.getDirectoryPath(ProjectManager.makeProjectRelativeIfPossible(fullPath));
+            const directoryPath = FileUtils.getDirectoryPath(relativePath);
+
+            this._fileNames[fileIndex] = StringUtils.format(
+                Strings.FIND_IN_FILES_FILE_PATH,
+                StringUtils.breakableUrl(FileUtils.getBaseName(fullPath)),
+                StringUtils.breakableUrl(directoryPath),
+                directoryPath ? "&mdash;" : ""
+            );
+        }
+        return this._fileNames[fileIndex];
+    }
 
-        if (this._$selectedRow) {
-            this._$selectedRow.removeClass("selected");
-            this._$selectedRow = null;
+    /**
+     * @private
+     * Returns the data the row template needs for a row
+     * @param {number} row
+     * @return {Object}
+     */
+    private _getRowData(row) {
+        const fileIndex  = this._rowFiles[row];
+        const matchIndex = this._rowMatches[row];
+        const item       = this._model.results[this._files[fileIndex]];
+
+        if (matchIndex === -1) {
+            return {
+                isFile:      true,
+                fileIndex:   fileIndex,
+                filename:    this._getFileName(fileIndex),
+                isChecked:   _.every(item.matches, "isChecked"),
+                isCollapsed: item.collapsed
+            };
         }
 
-        this._panel.show();
-        this._$table.scrollTop(0); // Otherwise scroll pos from previous contents is remembered
+        const match     = item.matches[matchIndex];
+        const multiLine = match.start.line !== match.end.line;
+
+        return {
+            isFile:      false,
+            fileIndex:   fileIndex,
+            matchIndex:  matchIndex,
+            line:        match.start.line + 1,
+            pre:         match.line.substr(0, match.start.ch - match.highlightOffset),
+            highlight:   match.line.substring(match.start.ch - match.highlightOffset, multiLine ? undefined : match.end.ch - match.highlightOffset),
+            post:        multiLine ? "\u2026" : match.line.substr(match.end.ch - match.highlightOffset),
+            isChecked:   match.isChecked
+        };
     }
 
     /**
-     * Updates the results view after a model change, preserving scroll position and selection.
+     * @private
+     * Renders the rows that are visible in the results container, plus a few above and below.
+     * Rows that are already in the DOM are reused, and the next page of results is requested
+     * when the rendered rows get near the end of the results.
      */
-    private _updateResults() {
-        // In general this shouldn't get called if the panel is closed, but in case some
-        // asynchronous process kicks this (e.g. a debounced model change), we double-check.
-        if (this._panel.isVisible()) {
-            const scrollTop  = this._$table.scrollTop();
-            const index      = this._$selectedRow ? this._$selectedRow.index() : null;
-            const numMatches = this._model.countFilesMatches().matches;
+    private _renderRows() {
+        const tbody = this._tbody;
+        if (!tbody) {
+            return;
+        }
 
-            if (this._currentStart > numMatches) {
-                this._currentStart = this._getLastCurrentStart(numMatches);
+        const container   = this._$table[0];
+        const numRows     = this._rowFiles.length;
+        const rowHeight   = this._rowHeight || DEFAULT_ROW_HEIGHT;
+        const visibleRows = Math.ceil(container.clientHeight / rowHeight);
+        let first         = Math.max(0, Math.floor(container.scrollTop / rowHeight) - OVERSCAN_ROWS);
+
+        // Start on an even row so that the stripes of the rows don't swap while scrolling
+        first -= first % 2;
+        const end = Math.min(numRows, first + visibleRows + 2 * OVERSCAN_ROWS);
+
+        const keys: Array<string> = [];
+        const newRows: Array<any> = [];
+        for (let row = first; row < end; row++) {
+            const key = this._rowFiles[row] + ":" + this._rowMatches[row];
+            keys.push(key);
+            if (!this._rowElements[key]) {
+                newRows.push(this._getRowData(row));
+            } else if (this._rowMatches[row] === -1) {
+                // The file may have been expanded or collapsed since the row was rendered
+                $(this._rowElements[key]).find(".disclosure-triangle")
+                    .toggleClass("expanded", !this._model.results[this._files[this._rowFiles[row]]].collapsed);
             }
+        }
 
-            this._render();
+        const $newRows = newRows.length
+            ? $(Mustache.render(searchResultRowsTemplate, {
+                replace: this._model.isReplace,
+                rows:    newRows,
+                Strings: Strings
+            })).filter("tr")
+            : $();
+        const rowElements: { [key: string]: HTMLElement } = {};
+        const fragment = document.createDocumentFragment();
+        const selectedFile = this._files.indexOf(this._selectedPath!);
+        let nextNewRow = 0;
+
+        for (let i = 0; i < keys.length; i++) {
+            const element = this._rowElements[keys[i]] || $newRows[nextNewRow++];
+            const row = first + i;
+
+            element.classList.toggle("selected", this._rowFiles[row] === selectedFile && this._rowMatches[row] === this._selectedMatch);
+            rowElements[keys[i]] = element;
+            fragment.appendChild(element);
+        }
 
-            this._$table.scrollTop(scrollTop);
-            if (index) {
-                this._$selectedRow = this._$table.find("tr:eq(" + index + ")");
-                this._$selectedRow.addClass("selected");
+        // Remove the rows natively, jQuery would clean up the data of the rows that are reused
+        while (tbody.firstChild) {
+            tbody.removeChild(tbody.firstChild);
+        }
+        tbody.appendChild(fragment);
+        this._rowElements = rowElements;
+
+        if (!this._rowHeight && tbody.rows.length && container.clientHeight) {
+            this._rowHeight = tbody.getBoundingClientRect().height / tbody.rows.length;
+            if (this._rowHeight) {
+                this._renderRows();
+                return;
             }
         }
+
+        this._$scroller!.css("height", numRows * rowHeight);
+        this._$scroller!.children("table").css("top", first * rowHeight);
+
+        if (end + NEXT_PAGE_THRESHOLD >= numRows && !this._model.allResultsAvailable && !this._nextPageRequested) {
+            this._nextPageRequested = true;
+            (this as unknown as EventDispatcher.DispatcherEvents).trigger("getNextPage");
+            HealthLogger.searchDone(HealthLogger.SEARCH_NEXT_PAGE);
+        }
     }
 
     /**
      * @private
-     * Returns one past the last result index displayed for the current page.
-     * @param {number} numMatches
-     * @return {number}
+     * Shows the current set of results.
+     * @param {number=} scrollTop Where to scroll the results, the top by default
      */
-    private _getLastIndex(numMatches) {
-        return Math.min(this._currentStart + RESULTS_PER_PAGE, numMatches);
-    }
+    private _render(scrollTop?: number) {
+        const results = this._model.results;
 
-    /**
-     * Shows the next page of the resultrs view if possible
-     */
-    public showNextPage() {
-        this._currentStart += RESULTS_PER_PAGE;
-        this._render();
+        this._showSummary();
+        this._files = this._model.prioritizeOpenFile(this._initialFilePath).filter(function (fullPath) {
+            return results[fullPath].matches.length > 0;
+        });
+        this._fileNames = [];
+        this._indexRows();
+
+        // Insert the table that holds the rendered rows
+        this._$table
+            .empty()
+            .append(Mustache.render(searchResultsTemplate, {
+                replace: this._model.isReplace
+            }));
+        this._$scroller  = this._$table.children(".search-results-scroller");
+        this._tbody      = this._$scroller.find("tbody")[0] as HTMLTableSectionElement;
+        this._rowElements = {};
+
+        // Size the rows before scrolling, the container can't be scrolled past its contents
+        this._$scroller.css("height", this._rowFiles.length * (this._rowHeight || DEFAULT_ROW_HEIGHT));
+        this._panel.show();
+        this._$table.scrollTop(scrollTop || 0); // Otherwise scroll pos from previous contents is remembered
+        this._renderRows();
     }
 
     /**
-     * Shows the last page of the results view.
+     * Updates the results view after a model change, preserving scroll position and selection.
      */
-    public showLastPage() {
-        this._currentStart = this._getLastCurrentStart();
-        this._render();
+    private _updateResults() {
+        // In general this shouldn't get called if the panel is closed, but in case some
+        // asynchronous process kicks this (e.g. a debounced model change), we double-check.
+        if (this._panel.isVisible()) {
+            this._render(this._$table.scrollTop());
+        }
     }
 
     /**
-     * @private
-     * Returns the last possible current start based on the given number of matches
-     * @param {number=} numMatches
-     * @return {number}
+     * Shows the results that were added to the model after a getNextPage event,
+     * and requests another page if the results are still scrolled near their end.
      */
-    private _getLastCurrentStart(numMatches?) {
-        numMatches = numMatches || this._model.countFilesMatches().matches;
-        return Math.floor((numMatches - 1) / RESULTS_PER_PAGE) * RESULTS_PER_PAGE;
+    public showNextPage() {
+        this._nextPageRequested = false;
+        this._renderRows();
     }
 
     /**
@@ -586,9 +588,10 @@ export class SearchResultsView {
      */
     public open() {
         // Clear out any paging/selection state.
-        this._currentStart  = 0;
-        this._$selectedRow  = null;
-        this._allChecked    = true;
+        this._selectedPath      = null;
+        this._selectedMatch     = -1;
+        this._allChecked        = true;
+        this._nextPageRequested = false;
 
         // Save the currently open document's fullpath, if any, so we can sort it to the top of the result list.
         const currentDoc = DocumentManager.getCurrentDocument();
@@ -607,8 +610,12 @@ export class SearchResultsView {
     public close() {
         if (this._panel && this._panel.isVisible()) {
             this._$table.empty();
+            this._$scroller  = null;
+            this._tbody      = null;
+            this._rowElements = {};
             this._panel.hide();
             this._panel.$panel.off(".searchResults");
+            this._$table.off(".searchResults");
             this._model.off("change.SearchResultsView");
             (this as unknown as EventDispatcher.DispatcherEvents).trigger("close");
         }
@@ -32,16 +32,13 @@ var fs = require("fs"),
     _domainManager,
     MAX_FILE_SIZE_TO_INDEX = 16777216, //16MB
     MAX_DISPLAY_LENGTH = 200,
-    MAX_TOTAL_RESULTS = 100000, // only 100,000 search results are supported
-    MAX_RESULTS_IN_A_FILE = MAX_TOTAL_RESULTS,
+    MAX_RESULTS_IN_A_FILE = 100000, // guards against regexps like /^/ on huge files
     MAX_RESULTS_TO_RETURN = 120;
 
 var results = {},
     numMatches = 0,
     numFiles = 0,
-    evaluatedMatches,
     foundMaximum = false,
-    exceedsMaximum = false,
     currentCrawlIndex = 0,
     savedSearchObject = null,
     lastSearchedIndex = 0,
@@ -250,9 +247,8 @@ function setResults(fullpath, resultInfo, maxResultsToReturn) {
 
     results[fullpath] = resultInfo;
     numMatches += resultInfo.matches.length;
-    evaluatedMatches += resultInfo.matches.length;
     maxResultsToReturn = maxResultsToReturn || MAX_RESULTS_TO_RETURN;
-    if (numMatches >= maxResultsToReturn || evaluatedMatches > MAX_TOTAL_RESULTS) {
+    if (numMatches >= maxResultsToReturn) {
         foundMaximum = true;
     }
 }
@@ -409,10 +405,6 @@ function getNumMatches(fileList, queryExpr) {
             numFiles++;
             matches += temp;
         }
-        if (matches > MAX_TOTAL_RESULTS) {
-            exceedsMaximum = true;
-            break;
-        }
     }
     return matches;
 }
@@ -434,16 +426,12 @@ function doSearch(searchObject, nextPages) {
     numMatches = 0;
     numFiles = 0;
     foundMaximum = false;
-    if (!nextPages) {
-        exceedsMaximum = false;
-        evaluatedMatches = 0;
-    }
     var queryObject = parseQueryInfo(searchObject.queryInfo);
     if (searchObject.files) {
         files = searchObject.files;
     }
     if (searchObject.getAllResults) {
-        searchObject.maxResultsToReturn = MAX_TOTAL_RESULTS;
+        searchObject.maxResultsToReturn = Infinity;
     }
     doSearchInFiles(files, queryObject.queryExpr, searchObject.startFileIndex, searchObject.maxResultsToReturn);
     if (crawlComplete && !nextPages) {
@@ -451,8 +439,7 @@ function doSearch(searchObject, nextPages) {
     }
     var sendObject = {
         "results":  results,
-        "foundMaximum":  foundMaximum,
-        "exceedsMaximum":  exceedsMaximum
+        "foundMaximum":  foundMaximum
     };
 
     if (!nextPages) {
@@ -460,7 +447,8 @@ function doSearch(searchObject, nextPages) {
         sendObject.numFiles = numFiles;
     }
 
-    if (searchObject.getAllResults) {
+    // The pages are taken from the files in order, the last page is the one that reached the last file
+    if (searchObject.getAllResults || lastSearchedIndex >= files.length) {
         sendObject.allResultsAvailable = true;
     }
     return sendObject;
@@ -529,7 +517,7 @@ function getNextPage() {
         "results":  {},
         "numMatches": 0,
         "foundMaximum":  foundMaximum,
-        "exceedsMaximum":  exceedsMaximum
+        "allResultsAvailable": true
     };
     if (!savedSearchObject) {
         return sendObject;
@@ -546,8 +534,7 @@ function getAllResults() {
     var sendObject = {
         "results":  {},
         "numMatches": 0,
-        "foundMaximum":  foundMaximum,
-        "exceedsMaximum":  exceedsMaximum
+        "foundMaximum":  foundMaximum
     };
     if (!savedSearchObject) {
         return sendObject;
@@ -25,6 +25,34 @@ function fnmatch(filepath, glob) {
   return minimatch(filepath, glob, matchOptions);
 };
 
+// Compiles a glob once into a function that takes a filepath and returns the
+// same result as fnmatch(filepath, glob). Use it for globs that are matched
+// against many paths; fnmatch goes through a small cache that is wiped
+// whenever more than 100 patterns are in use.
+fnmatch.compile = function (glob) {
+  var fileMatcher = null,
+      dirMatcher = null;
+
+  glob = glob.replace(/\*\*/g, '{*,**/**/**}');
+
+  // same shortcuts as minimatch()
+  if (glob.charAt(0) === "#") {
+    return function () { return false; };
+  }
+  if (glob.trim() === "") {
+    return function (filepath) { return filepath === ""; };
+  }
+
+  return function (filepath) {
+    if (filepath[filepath.length - 1] !== "/") {
+      fileMatcher = fileMatcher || new Minimatch(glob, {dot: true, noext: true, matchBase: true});
+      return fileMatcher.match(filepath);
+    }
+    dirMatcher = dirMatcher || new Minimatch(glob, {dot: true, noext: true});
+    return dirMatcher.match(filepath);
+  };
+};
+
 var LRU = function LRUCache () {
         // not quite an LRU, but still space-limited.
         var cache = {}
@@ -312,6 +312,82 @@ export function doInParallel_aggregateErrors(items, beginProcessItem): JQueryPro
     return masterDeferred.promise();
 }
 
+/**
+ * Executes a series of tasks in parallel, but never runs more than maxConcurrent of them at once.
+ * Like doInParallel_aggregateErrors(), the returned Promise is only resolved/rejected once all
+ * tasks are complete, and is rejected with an array of {item, error} objects if any task failed.
+ *
+ * The returned Promise is notified via progress() each time a task completes, with two arguments:
+ * the number of completed tasks and the total number of tasks.
+ *
+ * With maxConcurrent = 2:
+ *  M  ------------d
+ *  1 >---d        .
+ *  2 >------d     .
+ *  3     >-----d  .
+ *  4        >-----d
+ *
+ * @param {!Array.<*>} items
+ * @param {!function(*, number):Promise} beginProcessItem
+ * @param {number} maxConcurrent Maximum number of tasks in flight at any time. Must be at least 1.
+ * @return {$.Promise}
+ */
+export function doInParallelLimited_aggregateErrors(items, beginProcessItem, maxConcurrent: number): JQueryPromise<any> { // eslint-disable-line @typescript-eslint/camelcase
+    const errors: Array<Error> = [];
+    const masterDeferred = $.Deferred();
+    const limit = Math.max(maxConcurrent, 1);
+    let nextIndex = 0;
+    let numInFlight = 0;
+    let numCompleted = 0;
+    let pumping = false;
+
+    if (items.length === 0) {
+        return masterDeferred.resolve().promise();
+    }
+
+    function startItem(i) {
+        const item = items[i];
+
+        beginProcessItem(item, i)
+            .fail(function (error) {
+                errors.push({ item: item, error: error });
+            })
+            .always(function () {
+                numInFlight--;
+                numCompleted++;
+                masterDeferred.notify(numCompleted, items.length);
+
+                if (numCompleted === items.length) {
+                    if (errors.length) {
+                        masterDeferred.reject(errors);
+                    } else {
+                        masterDeferred.resolve();
+                    }
+                } else {
+                    pump();
+                }
+            });
+    }
+
+    // Tasks that complete synchronously call back into pump() while it is still looping;
+    // the guard keeps that from recursing once per item.
+    function pump() {
+        if (pumping) {
+            return;
+        }
+        pumping = true;
+        while (numInFlight < limit && nextIndex < items.length) {
+            numInFlight++;
+            startItem(nextIndex++);
+        }
+        pumping = false;
+    }
+
+    pump();
+
+    return masterDeferred.promise();
+}
+
 /** Value passed to fail() handlers that have been triggered due to withTimeout()'s timeout */
 export const ERROR_TIMEOUT = {};
 
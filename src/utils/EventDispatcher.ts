@@ -53,6 +53,7 @@
  */
 
 import * as _ from "lodash";
+import * as ExtensionMonitor from "utils/ExtensionMonitor";
 
 const LEAK_WARNING_THRESHOLD = 15;
 
@@ -103,6 +104,9 @@ const on = function (this: any, events, fn) {
         }
     }
 
+    // Handlers registered by extensions are measured by ExtensionMonitor
+    const owner = ExtensionMonitor.getCaller();
+
     // Attach listener for each event clause
     for (i = 0; i < eventsList.length; i++) {
         const eventName = eventsList[i].eventName;
@@ -113,6 +117,9 @@ const on = function (this: any, events, fn) {
             this._eventHandlers[eventName] = [];
         }
         eventsList[i].handler = fn;
+        if (owner) {
+            ExtensionMonitor.setOwner(eventsList[i], owner);
+        }
         this._eventHandlers[eventName].push(eventsList[i]);
 
         // Check for suspicious number of listeners being added to one object-event pair
@@ -225,7 +232,7 @@ const trigger = function (this: any, eventName, ...args) {
     for (i = 0; i < handlerList.length; i++) {
         try {
             // Call one handler
-            handlerList[i].handler.apply(null, applyArgs);
+            ExtensionMonitor.invoke(handlerList[i], eventName, handlerList[i].handler, null, applyArgs);
         } catch (err) {
             console.error("Exception in '" + eventName + "' listener on", this, String(err), err.stack);
             console.assert();  // causes dev tools to pause, just like an uncaught exception
@@ -266,6 +273,18 @@ export function triggerWithArray(dispatcher, eventName, argsArray) {
     dispatcher.trigger.apply(dispatcher, triggerArgs);
 }
 
+/**
+ * Returns true if any listeners are attached for the given event. Lets dispatchers skip computing
+ * event arguments that nobody would receive.
+ * @param {!Object} dispatcher
+ * @param {string} eventName Event name, without namespace
+ * @return {boolean}
+ */
+export function hasListeners(dispatcher, eventName) {
+    const handlerList = dispatcher._eventHandlers && dispatcher._eventHandlers[eventName];
+    return !!(handlerList && handlerList.length);
+}
+
 /**
  * Utility for attaching an event handler to an object that has not YET had makeEventDispatcher() called
  * on it, but will in the future. Once 'futureDispatcher' becomes a real event dispatcher, any handlers
@@ -0,0 +1,367 @@
+/*
+ * Copyright (c) 2018 - present The quadre code authors. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ *
+ */
+
+/**
+ * ExtensionBundleCache keeps one concatenated file per extension holding every AMD module
+ * the extension loaded at startup, so the next start can load the whole module graph with
+ * a single script instead of one request per module.
+ *
+ * Bundles come from two places:
+ *  - a prebuilt index (BUNDLE_INDEX_FILENAME) written next to the extensions at build time
+ *    by the "extension-bundles" gulp task. It is trusted as long as the app version matches.
+ *  - a cache in the application support directory, written after an extension loads without
+ *    a bundle. Each entry remembers the modification time and size of every file it was built
+ *    from and is dropped as soon as one of them changes.
+ *
+ * A bundle only contains named define() calls, so it is handed to the extension's own
+ * require.js context through the "bundles" config option. Contexts, module ids and
+ * initExtension are exactly the same as without the cache; modules that aren't in the
+ * bundle (e.g. ones loaded lazily later) are still loaded on demand.
+ */
+
+import * as _ from "lodash";
+import * as Async from "utils/Async";
+import * as FileSystem from "filesystem/FileSystem";
+import * as FileUtils from "file/FileUtils";
+import PersistentCache = require("utils/PersistentCache");
+import * as MurmurHash3 from "thirdparty/murmurhash3_gc";
+
+/** Name of the bundle index, both for the prebuilt and for the runtime cache */
+export const BUNDLE_INDEX_FILENAME = "extension-bundles.json";
+
+const CACHE_DIRNAME = "extension-cache";
+
+// Turns the anonymous define() of every wrapped module into a named one, see _wrapModule()
+const BUNDLE_HEADER = "(function (define) {\n" +
+    "    function named(id) {\n" +
+    "        var namedDefine = function () {\n" +
+    "            var args = Array.prototype.slice.call(arguments);\n" +
+    "            if (typeof args[0] !== \"string\") {\n" +
+    "                args.unshift(id);\n" +
+    "            }\n" +
+    "            return define.apply(this, args);\n" +
+    "        };\n" +
+    "        namedDefine.amd = define.amd;\n" +
+    "        return namedDefine;\n" +
+    "    }\n";
+const BUNDLE_FOOTER = "}(define));\n";
+
+interface BundleInfo {
+    id: string;
+    path: string;
+    modules: Array<string>;
+}
+
+interface BundledModule {
+    id: string;
+    relPath: string;
+    isText: boolean;
+}
+
+/** Modification time and size of a file, null if the file didn't exist */
+type FileStamp = { mtime: number, size: number } | null;
+
+interface CacheEntry {
+    bundle: string;
+    hash: string;
+    locale: string;
+    modules: Array<string>;
+    files: { [relPath: string]: FileStamp };
+}
+
+let _index: { [baseUrl: string]: CacheEntry } = {};
+const _prebuiltIndexPromises: { [directory: string]: JQueryPromise<any> } = {};
+
+// The runtime cache: the index and the bundles it lists share one directory
+const _cache = new PersistentCache(CACHE_DIRNAME + "/" + BUNDLE_INDEX_FILENAME, {
+    logName: "Extension",
+    saveDelay: 1000,
+    deserialize: function (data) {
+        _index = data || {};
+    },
+    serialize: function () {
+        return _index;
+    }
+});
+
+/**
+ * @private
+ * Moves the runtime bundle cache and forgets the loaded index.
+ * @param {?string} path Directory, or null to go back to the default one
+ */
+// For unit tests
+export function _setCacheDirectory(path) {
+    _cache.setPath(path ? path + "/" + BUNDLE_INDEX_FILENAME : null);
+    _index = {};
+}
+
+function _readJSON(path) {
+    return FileUtils.readAsText(FileSystem.getFileForPath(path)).then(function (text) {
+        try {
+            return JSON.parse(text);
+        } catch (err) {
+            return $.Deferred().reject(err).promise();
+        }
+    });
+}
+
+/**
+ * @private
+ * Reads the prebuilt index of an extensions directory once.
+ * Resolves with null if there isn't one or it was built for another version.
+ */
+function _loadPrebuiltIndex(directory) {
+    if (!_prebuiltIndexPromises[directory]) {
+        const result = $.Deferred();
+        _readJSON(directory + "/" + BUNDLE_INDEX_FILENAME)
+            .done(function (index) {
+                result.resolve(index && index.version === brackets.metadata.version ? index : null);
+            })
+            .fail(function () {
+                result.resolve(null);
+            });
+        _prebuiltIndexPromises[directory] = result.promise();
+    }
+    return _prebuiltIndexPromises[directory];
+}
+
+function _stripTrailingSlash(path) {
+    return path.replace(/\/$/, "");
+}
+
+function _bundleId(hash) {
+    return "extension-bundle-" + hash;
+}
+
+/**
+ * @private
+ * Resolves with the FileStamp of a file, never rejected
+ */
+function _stat(path): JQueryPromise<FileStamp> {
+    const result = $.Deferred<FileStamp>();
+    FileSystem.getFileForPath(path).stat(function (err, stat) {
+        result.resolve(err ? null : { mtime: stat.mtime.getTime(), size: stat.size });
+    });
+    return result.promise();
+}
+
+/**
+ * @private
+ * Resolves with true if none of the files an entry was built from has changed. The size is
+ * compared too, since an edit within the mtime resolution of the file system keeps the mtime.
+ */
+function _validateEntry(baseUrl, entry: CacheEntry) {
+    if (entry.locale !== brackets.getLocale()) {
+        return $.Deferred().resolve(false).promise();
+    }
+
+    const result = $.Deferred();
+    const checks = Object.keys(entry.files).map(function (relPath) {
+        return { path: baseUrl + "/" + relPath, stamp: entry.files[relPath] as FileStamp | undefined };
+    });
+    let valid = true;
+
+    // The bundle itself only has to exist
+    checks.push({ path: _cache.getDirectory() + "/" + entry.bundle, stamp: undefined });
+
+    Async.doInParallel(checks, function (check) {
+        return _stat(check.path).done(function (stamp) {
+            if (check.stamp === undefined) {
+                valid = valid && stamp !== null;
+            } else if (!_.isEqual(stamp, check.stamp)) {
+                valid = false;
+            }
+        });
+    }).always(function () {
+        result.resolve(valid);
+    });
+
+    return result.promise();
+}
+
+/**
+ * Looks up the bundle of an extension.
+ *
+ * @param {!string} baseUrl Absolute path of the extension
+ * @return {!$.Promise} Resolved with {id, path, modules}, or with null if there is no usable
+ *      bundle. Never rejected.
+ */
+export function getBundle(baseUrl) {
+    baseUrl = _stripTrailingSlash(baseUrl);
+
+    const directory = FileUtils.getDirectoryPath(baseUrl).replace(/\/$/, "");
+    const name = FileUtils.getBaseName(baseUrl);
+
+    return _loadPrebuiltIndex(directory).then(function (prebuilt) {
+        const prebuiltEntry = prebuilt && prebuilt.extensions[name];
+        if (prebuiltEntry) {
+            return {
+                id: _bundleId(prebuiltEntry.hash),
+                path: directory + "/" + prebuiltEntry.bundle,
+                modules: prebuiltEntry.modules
+            };
+        }
+
+        return _cache.load().then(function () {
+            const entry = _index[baseUrl];
+            if (!entry) {
+                return null;
+            }
+            return _validateEntry(baseUrl, entry).then(function (valid) {
+                if (!valid) {
+                    removeBundle(baseUrl);
+                    return null;
+                }
+                return {
+                    id: _bundleId(entry.hash),
+                    path: _cache.getDirectory() + "/" + entry.bundle,
+                    modules: entry.modules
+                };
+            });
+        });
+    });
+}
+
+/**
+ * Adds a bundle to a require.js config, so that the context loads the bundle
+ * instead of the individual modules it contains.
+ *
+ * @param {!Object} config require.js config of the extension
+ * @param {!{id: string, path: string, modules: Array.<string>}} bundle As returned by getBundle()
+ */
+export function applyBundle(config, bundle: BundleInfo) {
+    config.paths = _.clone(config.paths) || {};
+    config.paths[bundle.id] = bundle.path.replace(/\.js$/, "");
+    config.bundles = _.clone(config.bundles) || {};
+    config.bundles[bundle.id] = bundle.modules;
+}
+
+/**
+ * Forgets the cached bundle of an extension, e.g. because loading it failed.
+ * Prebuilt bundles are left alone.
+ *
+ * @param {!string} baseUrl Absolute path of the extension
+ */
+export function removeBundle(baseUrl) {
+    baseUrl = _stripTrailingSlash(baseUrl);
+
+    const entry = _index[baseUrl];
+    if (entry) {
+        delete _index[baseUrl];
+        FileSystem.getFileForPath(_cache.getDirectory() + "/" + entry.bundle).unlink(_.noop);
+        _cache.scheduleSave();
+    }
+}
+
+/**
+ * @private
+ * Wraps the source of an AMD module so that its anonymous define() gets the module id.
+ */
+function _wrapModule(id, text) {
+    return "(function (define) {\n" + text + "\n}(named(" + JSON.stringify(id) + ")));\n";
+}
+
+/**
+ * Builds the bundle of an extension from the modules its require.js context has defined so far,
+ * and stores it in the runtime cache. Only modules that live inside the extension are bundled;
+ * shimmed modules and loader plugin resources other than text! are skipped.
+ *
+ * @param {!string} contextName Name of the require.js context of the extension
+ * @param {!string} baseUrl Absolute path of the extension
+ * @return {!$.Promise} Resolved when the bundle has been written
+ */
+export function recordBundle(contextName, baseUrl) {
+    baseUrl = _stripTrailingSlash(baseUrl);
+
+    const context = brackets.libRequire.s.contexts[contextName];
+    if (!context) {
+        return $.Deferred().reject().promise();
+    }
+
+    const shim = context.config.shim || {};
+    const prefix = baseUrl + "/";
+    const modules: Array<BundledModule> = [];
+
+    Object.keys(context.defined).sort().forEach(function (id) {
+        const isText = id.indexOf("text!") === 0;
+        if ((!isText && id.indexOf("!") !== -1) || shim[id]) {
+            return;
+        }
+
+        const url = isText ? context.require.toUrl(id.substr("text!".length)) : context.nameToUrl(id);
+        if (url.indexOf(prefix) === 0) {
+            modules.push({ id: id, relPath: url.substr(prefix.length), isText: isText });
+        }
+    });
+
+    if (!modules.length) {
+        return $.Deferred().resolve().promise();
+    }
+
+    const files: { [relPath: string]: FileStamp } = {};
+    const sources: Array<string> = [];
+
+    return Async.doInParallel(modules, function (module, i) {
+        // Stat before reading: if the file changes in between, the entry is merely invalid next time
+        return _stat(prefix + module.relPath).then(function (stamp) {
+            files[module.relPath] = stamp;
+            return FileUtils.readAsText(FileSystem.getFileForPath(prefix + module.relPath));
+        }).done(function (text) {
+            if (module.isText) {
+                // Use the resource as the text plugin delivered it
+                sources[i] = "define(" + JSON.stringify(module.id) + ", function () { return " + JSON.stringify(context.defined[module.id]) + "; });\n";
+            } else {
+                sources[i] = _wrapModule(module.id, text);
+            }
+        });
+    }, true).then(function () {
+        // The config affects how module ids resolve, so it invalidates the bundle too
+        return _stat(prefix + "requirejs-config.json").done(function (stamp) {
+            files["requirejs-config.json"] = stamp;
+        });
+    }).then(function () {
+        const content = BUNDLE_HEADER + sources.join("") + BUNDLE_FOOTER;
+        const hash = MurmurHash3.hashString(content, content.length, 0).toString(16);
+        const bundle = contextName.replace(/[^\w\-.]/g, "_") + "-" + hash + ".js";
+
+        return _cache.writeFile(bundle, content).then(function () {
+            const previous = _index[baseUrl];
+            if (previous && previous.bundle !== bundle) {
+                FileSystem.getFileForPath(_cache.getDirectory() + "/" + previous.bundle).unlink(_.noop);
+            }
+
+            _index[baseUrl] = {
+                bundle: bundle,
+                hash: hash,
+                locale: brackets.getLocale(),
+                modules: modules.filter(function (module) {
+                    return !module.isText;
+                }).map(function (module) {
+                    return module.id;
+                }),
+                files: files
+            };
+            _cache.scheduleSave();
+        });
+    });
+}
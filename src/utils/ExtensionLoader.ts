@@ -29,15 +29,34 @@
  *          extension root.
  *      "loadFailed" - when an extension load is unsuccessful. The second argument is the file path to the
  *          extension root.
+ *      "activated" - when an extension that was waiting for one of its activation events has been loaded.
+ *          The second argument is the file path to the extension root.
+ *
+ * Extensions can list activation events in the "activationEvents" array of their package.json to be
+ * loaded on demand rather than at startup. Such an extension dispatches "load" right away, and runs its
+ * main module on the first of these events:
+ *      "onStartupFinished" - once the app is ready
+ *      "onLanguage:<languageId>" - when an editor for a document in that language becomes active
+ *      "onCommand:<commandId>" - when the command is executed; its main module must register the command
+ * Extensions without activation events, or with "*" among them, are loaded at startup as before.
  */
 
 import "utils/Global";
 
 import * as _ from "lodash";
+import * as AppInit from "utils/AppInit";
+import * as CommandManager from "command/CommandManager";
+import * as DocumentManager from "document/DocumentManager";
+import * as EditorManager from "editor/EditorManager";
 import * as EventDispatcher from "utils/EventDispatcher";
 import * as FileSystem from "filesystem/FileSystem";
 import * as FileUtils from "file/FileUtils";
+import * as PreferencesManager from "preferences/PreferencesManager";
+import * as Strings from "strings";
 import * as Async from "utils/Async";
+import * as StartupTimeline from "utils/StartupTimeline";
+import * as ExtensionBundleCache from "utils/ExtensionBundleCache";
+import * as ExtensionMonitor from "utils/ExtensionMonitor";
 import * as ExtensionUtils from "utils/ExtensionUtils";
 import { UrlParams } from "utils/UrlParams";
 import * as PathUtils from "thirdparty/path-utils/path-utils";
@@ -45,6 +64,12 @@ import * as PathUtils from "thirdparty/path-utils/path-utils";
 // default async initExtension timeout
 const INIT_EXTENSION_TIMEOUT = 10000;
 
+// activation events, see the module docs
+const ACTIVATION_ALWAYS             = "*";
+const ACTIVATION_STARTUP_FINISHED   = "onStartupFinished";
+const ACTIVATION_LANGUAGE_PREFIX    = "onLanguage:";
+const ACTIVATION_COMMAND_PREFIX     = "onCommand:";
+
 let _init       = false;
 const _extensions = {};
 let _initExtensionTimeout = INIT_EXTENSION_TIMEOUT;
@@ -56,6 +81,45 @@ let srcPath     = FileUtils.getNativeBracketsDirectoryPath();
  */
 const contexts    = {};
 
+/**
+ * Activation functions of extensions waiting for an editor in a given language
+ * @type {Object.<string, Array.<function(): $.Promise>>}
+ */
+const _languageActivations = {};
+
+/**
+ * Activation functions of extensions waiting for the end of startup
+ * @type {Array.<function(): $.Promise>}
+ */
+const _startupActivations: Array<() => JQueryPromise<any>> = [];
+const _startupActivationDeferred = $.Deferred();
+let _startupFinished = false;
+
+PreferencesManager.definePreference("extensions.lazyActivation", "boolean", true, {
+    description: Strings.DESCRIPTION_LAZY_EXTENSION_ACTIVATION
+});
+
+PreferencesManager.definePreference("extensions.monitor", "boolean", false, {
+    description: Strings.DESCRIPTION_EXTENSION_MONITOR
+});
+PreferencesManager.definePreference("extensions.monitorBudget", "number", 50, {
+    description: Strings.DESCRIPTION_EXTENSION_MONITOR_BUDGET
+});
+PreferencesManager.definePreference("extensions.monitorAction", "string", ExtensionMonitor.ACTION_NONE, {
+    description: Strings.DESCRIPTION_EXTENSION_MONITOR_ACTION,
+    values: [ExtensionMonitor.ACTION_NONE, ExtensionMonitor.ACTION_THROTTLE, ExtensionMonitor.ACTION_DISABLE]
+});
+
+/**
+ * @private
+ * Applies the extension monitor preferences. Only callbacks that extensions register while the
+ * monitor is enabled are measured, so turning it on takes full effect after a reload.
+ */
+function _updateExtensionMonitor() {
+    ExtensionMonitor.setEnabled(PreferencesManager.get("extensions.monitor"));
+    ExtensionMonitor.setBudget(PreferencesManager.get("extensions.monitorBudget"), PreferencesManager.get("extensions.monitorAction"));
+}
+
 // The native directory path ends with either "test" or "www". We need "www" to
 // load the text and i18n modules.
 srcPath = srcPath.replace(/\/test$/, "/www"); // convert from "test" to "www"
@@ -173,13 +237,26 @@ function loadExtensionModule(name, config, entryPoint) {
         locale: brackets.getLocale()
     };
 
-    // Read optional requirejs-config.json
-    const promise = _mergeConfig(_.cloneDeep(extensionConfig)).then(function (mergedConfig) {
+    let bundle;
+
+    StartupTimeline.beginAsync("extension", name);
+
+    // Read optional requirejs-config.json and look for a bundle of the extension's modules
+    const promise = $.when(
+        _mergeConfig(_.cloneDeep(extensionConfig)),
+        ExtensionBundleCache.getBundle(config.baseUrl)
+    ).then(function (mergedConfig, _bundle) {
+        bundle = _bundle;
+        if (bundle) {
+            ExtensionBundleCache.applyBundle(mergedConfig, bundle);
+        }
+
         // Create new RequireJS context and load extension entry point
         const extensionRequire = brackets.libRequire.config(mergedConfig);
         const extensionRequireDeferred = $.Deferred<any>();
 
         contexts[name] = extensionRequire;
+        ExtensionMonitor.registerExtension(name);
         extensionRequire([entryPoint], extensionRequireDeferred.resolve, extensionRequireDeferred.reject);
 
         return extensionRequireDeferred.promise();
@@ -235,11 +312,118 @@ function loadExtensionModule(name, config, entryPoint) {
         }
     });
 
+    promise.always(function () {
+        StartupTimeline.endAsync("extension", name);
+    }).done(function () {
+        if (!bundle) {
+            // Bundle everything the extension loaded so the next start needs a single script
+            ExtensionBundleCache.recordBundle(name, config.baseUrl);
+        }
+    }).fail(function () {
+        if (bundle) {
+            // Don't let a broken bundle stop the extension from loading again
+            ExtensionBundleCache.removeBundle(config.baseUrl);
+        }
+    });
+
     return promise;
 }
 
 /**
- * Loads the extension that lives at baseUrl into its own Require.js context
+ * @private
+ * Returns the activation events of an extension, or null if it should be loaded right away.
+ * @param {Object} metadata package.json of the extension
+ * @return {?Array.<string>}
+ */
+function _getActivationEvents(metadata) {
+    const events = metadata && metadata.activationEvents;
+    if (!Array.isArray(events) || !events.length || events.indexOf(ACTIVATION_ALWAYS) !== -1 ||
+            !PreferencesManager.get("extensions.lazyActivation")) {
+        return null;
+    }
+    return events;
+}
+
+/**
+ * @private
+ * Runs the activation functions waiting for the language of an editor.
+ * @param {?Editor} editor
+ */
+function _activateForEditor(editor) {
+    if (!editor) {
+        return;
+    }
+
+    const languageId = editor.document.getLanguage().getId();
+    const activations = _languageActivations[languageId];
+    if (activations) {
+        delete _languageActivations[languageId];
+        activations.forEach(function (activate) {
+            activate();
+        });
+    }
+}
+
+/**
+ * @private
+ * Sets up the activation events of an extension instead of loading it.
+ *
+ * @param {!string} name, used to identify the extension
+ * @param {!{baseUrl: string}} config object with baseUrl property containing absolute path of extension
+ * @param {!string} entryPoint, name of the main js file to load
+ * @param {!Array.<string>} events activation events from the extension's package.json
+ * @return {!$.Promise} A promise object that is resolved once the activation events are set up.
+ */
+function _deferActivation(name, config, entryPoint, events) {
+    let activation;
+
+    function activate() {
+        if (!activation) {
+            activation = loadExtensionModule(name, config, entryPoint).then(function () {
+                exports.trigger("activated", config.baseUrl);
+            }, function () {
+                exports.trigger("loadFailed", config.baseUrl);
+            });
+        }
+        return activation;
+    }
+
+    events.forEach(function (event) {
+        if (event === ACTIVATION_STARTUP_FINISHED) {
+            if (_startupFinished) {
+                activate();
+            } else {
+                _startupActivations.push(activate);
+            }
+        } else if (event.indexOf(ACTIVATION_LANGUAGE_PREFIX) === 0) {
+            const languageId = event.substr(ACTIVATION_LANGUAGE_PREFIX.length);
+            _languageActivations[languageId] = _languageActivations[languageId] || [];
+            _languageActivations[languageId].push(activate);
+        } else if (event.indexOf(ACTIVATION_COMMAND_PREFIX) === 0) {
+            CommandManager.registerPlaceholder(event.substr(ACTIVATION_COMMAND_PREFIX.length), activate);
+        } else {
+            console.warn("[Extension] Unknown activation event " + event + " for " + name);
+        }
+    });
+
+    // An editor in one of the languages may be open already
+    _activateForEditor(EditorManager.getActiveEditor());
+
+    return $.Deferred().resolve().promise();
+}
+
+/**
+ * @private
+ * Returns a promise resolved once the extensions activated at the end of startup have been loaded.
+ * @return {!$.Promise}
+ */
+export function _getStartupActivationPromise() {
+    return _startupActivationDeferred.promise();
+}
+
+/**
+ * Loads the extension that lives at baseUrl into its own Require.js context. If the extension lists
+ * activation events in its package.json, only these are set up and loading happens on the first one.
  *
  * @param {!string} name, used to identify the extension
  * @param {!{baseUrl: string}} config object with baseUrl property containing absolute path of extension
@@ -262,6 +446,10 @@ export function loadExtension(name, config, entryPoint) {
             }
 
             if (!metadata.disabled) {
+                const activationEvents = _getActivationEvents(metadata);
+                if (activationEvents) {
+                    return _deferActivation(name, config, entryPoint, activationEvents);
+                }
                 return loadExtensionModule(name, config, entryPoint);
             }
 
@@ -457,5 +645,26 @@ export function init(paths) {
     return promise;
 }
 
+(EditorManager as unknown as EventDispatcher.DispatcherEvents).on("activeEditorChange", function (e, current) {
+    _activateForEditor(current);
+});
+(DocumentManager as unknown as EventDispatcher.DispatcherEvents).on("currentDocumentLanguageChanged", function () {
+    _activateForEditor(EditorManager.getActiveEditor());
+});
+
+AppInit.appReady(function () {
+    // Let the first document render before loading the extensions waiting for the end of startup
+    window.setTimeout(function () {
+        _startupFinished = true;
+        Async.waitForAll(_startupActivations.splice(0).map(function (activate) {
+            return activate();
+        })).always(_startupActivationDeferred.resolve);
+    }, 0);
+});
+
+PreferencesManager.on("change", "extensions.monitor", _updateExtensionMonitor);
+PreferencesManager.on("change", "extensions.monitorBudget", _updateExtensionMonitor);
+PreferencesManager.on("change", "extensions.monitorAction", _updateExtensionMonitor);
+_updateExtensionMonitor();
 
 EventDispatcher.makeEventDispatcher(exports);
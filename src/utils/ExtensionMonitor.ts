@@ -0,0 +1,412 @@
+/*
+ * Copyright (c) 2018 - present The quadre code authors. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ *
+ */
+
+/**
+ * ExtensionMonitor attributes the time spent in callbacks that core modules call on behalf of
+ * extensions (event handlers, code hint and inspection providers, global keydown hooks) to the
+ * extension that registered them.
+ *
+ * A callback is attributed when it is registered: the monitor walks the current stack and looks
+ * for a script that was loaded by the require.js context of an extension (ExtensionLoader gives
+ * each extension its own context, and require.js tags every script it loads with the name of its
+ * context). Core modules then run the callback through invoke(), which measures it.
+ *
+ * For every extension the monitor keeps the latency of the most recent calls, from which it
+ * computes the p95, and an estimate of the memory allocated by the calls (the growth of the JS
+ * heap while they run, which is only precise when the heap isn't collected meanwhile). Extensions
+ * whose p95 exceeds a budget can be throttled (their callbacks are skipped for a while) or
+ * disabled (skipped until resumed).
+ *
+ * The monitor is disabled by default; attributing callbacks costs a stack walk per registration.
+ *
+ * This module must not depend on modules that use EventDispatcher, since EventDispatcher uses it.
+ */
+
+/** Number of recent calls of each extension the p95 is computed from */
+const SAMPLE_SIZE = 200;
+
+/** Number of calls an extension needs before it can be throttled or disabled */
+const MIN_SAMPLES = 20;
+
+/** How long the callbacks of a throttled extension are skipped, in ms */
+const THROTTLE_PERIOD = 2000;
+
+/** Name of the require.js context of core modules */
+const CORE_CONTEXT = "_";
+
+/**
+ * What happens to an extension whose p95 exceeds the budget
+ * @enum {string}
+ */
+export const ACTION_NONE     = "none";
+export const ACTION_THROTTLE = "throttle";
+export const ACTION_DISABLE  = "disable";
+
+interface ExtensionRecord {
+    name: string;
+    calls: number;
+    selfTime: number;
+    maxTime: number;
+    allocated: number;
+    samples: Array<number>;
+    nextSample: number;
+    slowestCall: string;
+    skipped: number;
+    disabled: boolean;
+    throttledUntil: number;
+}
+
+export interface ExtensionStats {
+    name: string;
+    calls: number;
+    avg: number;
+    p95: number;
+    max: number;
+    allocatedPerCall: number;
+    slowestCall: string;
+    skipped: number;
+    state: string;
+}
+
+interface Frame {
+    childTime: number;
+}
+
+let _enabled = false;
+let _budget = 50;
+let _action = ACTION_NONE;
+
+/** Names of the require.js contexts that belong to extensions */
+const _extensions: { [contextName: string]: boolean } = {};
+
+/** Require.js context of each script, by script URL */
+let _scriptContexts: { [url: string]: string } = {};
+let _scriptCount = 0;
+
+/** Owning extension of each attributed callback, handler record or provider */
+let _owners = new WeakMap<object, string>();
+
+let _records: { [name: string]: ExtensionRecord } = {};
+
+/** Calls that are currently running, the innermost last */
+const _frames: Array<Frame> = [];
+
+const _memory = (window.performance as any).memory;
+
+/**
+ * Turns monitoring on or off. Callbacks registered while monitoring is off are never measured.
+ * @param {boolean} enabled
+ */
+export function setEnabled(enabled) {
+    _enabled = !!enabled;
+}
+
+/**
+ * @return {boolean} true if callbacks are attributed and measured
+ */
+export function isEnabled() {
+    return _enabled;
+}
+
+/**
+ * Sets the latency budget and what happens to the extensions that exceed it.
+ * Re-enables extensions that were throttled or disabled before.
+ * @param {number} budget Maximum p95 latency of a single callback, in ms
+ * @param {string} action One of ACTION_NONE, ACTION_THROTTLE or ACTION_DISABLE
+ */
+export function setBudget(budget, action) {
+    _budget = budget;
+    _action = action;
+    Object.keys(_records).forEach(resume);
+}
+
+/**
+ * Called by ExtensionLoader for the require.js context of every extension it loads
+ * @param {!string} name Name of the extension, which is also the name of its context
+ */
+export function registerExtension(name) {
+    _extensions[name] = true;
+}
+
+/**
+ * @private
+ * Refreshes the map of script URLs to require.js contexts when require.js added scripts
+ */
+function _updateScriptContexts() {
+    const scripts = document.scripts;
+    if (scripts.length === _scriptCount) {
+        return;
+    }
+
+    _scriptContexts = {};
+    _scriptCount = scripts.length;
+    for (let i = 0; i < scripts.length; i++) {
+        const context = scripts[i].getAttribute("data-requirecontext");
+        if (context && context !== CORE_CONTEXT) {
+            _scriptContexts[scripts[i].src] = context;
+        }
+    }
+}
+
+/**
+ * Returns the name of the extension whose code is closest to the top of the current stack,
+ * or null if no extension is on the stack or monitoring is off.
+ * @return {?string}
+ */
+export function getCaller() {
+    if (!_enabled) {
+        return null;
+    }
+
+    const stack = new Error().stack;
+    if (!stack) {
+        return null;
+    }
+
+    _updateScriptContexts();
+
+    const urlRegex = /\(?((?:file|https?):\/\/[^\s)]+?):\d+:\d+\)?$/;
+    const lines = stack.split("\n");
+    for (let i = 1; i < lines.length; i++) {
+        const match = urlRegex.exec(lines[i]);
+        if (match) {
+            const context = _scriptContexts[match[1]];
+            if (context && _extensions[context]) {
+                return context;
+            }
+        }
+    }
+    return null;
+}
+
+/**
+ * Attributes a callback (or a provider object, or any other object that core modules later pass
+ * to invoke()) to the extension that is registering it. Does nothing if the caller isn't an extension.
+ * @param {!Object} target
+ */
+export function attribute(target: object) {
+    const owner = getCaller();
+    if (owner) {
+        setOwner(target, owner);
+    }
+}
+
+/**
+ * Attributes an object to an extension that was already found with getCaller(),
+ * e.g. when one registration creates several targets.
+ * @param {!Object} target
+ * @param {!string} name Name of the extension
+ */
+export function setOwner(target: object, name: string) {
+    _owners.set(target, name);
+}
+
+/**
+ * @param {!Object} target
+ * @return {?string} The extension a callback or provider was attributed to
+ */
+export function getOwner(target: object) {
+    return _owners.get(target) || null;
+}
+
+function _getRecord(name) {
+    let record = _records[name];
+    if (!record) {
+        record = _records[name] = {
+            name: name,
+            calls: 0,
+            selfTime: 0,
+            maxTime: 0,
+            allocated: 0,
+            samples: [],
+            nextSample: 0,
+            slowestCall: "",
+            skipped: 0,
+            disabled: false,
+            throttledUntil: 0
+        };
+    }
+    return record;
+}
+
+function _percentile(values: Array<number>, p) {
+    if (!values.length) {
+        return 0;
+    }
+    const sorted = values.slice().sort(function (a, b) { return a - b; });
+    return sorted[Math.min(sorted.length - 1, Math.ceil(p / 100 * sorted.length) - 1)];
+}
+
+/**
+ * @private
+ * Throttles or disables an extension after a call that took longer than the budget,
+ * if the extension is over budget for most of its recent calls too
+ */
+function _checkBudget(record: ExtensionRecord) {
+    if (_action === ACTION_NONE || record.samples.length < MIN_SAMPLES ||
+            _percentile(record.samples, 95) <= _budget) {
+        return;
+    }
+
+    if (_action === ACTION_DISABLE) {
+        record.disabled = true;
+        console.warn("[ExtensionMonitor] Disabled the callbacks of " + record.name + ", p95 is over " + _budget + "ms");
+    } else {
+        record.throttledUntil = performance.now() + THROTTLE_PERIOD;
+        console.warn("[ExtensionMonitor] Throttling the callbacks of " + record.name + ", p95 is over " + _budget + "ms");
+    }
+}
+
+function _record(name, label, selfTime, allocated) {
+    const record = _getRecord(name);
+
+    record.calls++;
+    record.selfTime += selfTime;
+    record.allocated += allocated;
+    if (selfTime > record.maxTime) {
+        record.maxTime = selfTime;
+        record.slowestCall = label;
+    }
+    record.samples[record.nextSample] = selfTime;
+    record.nextSample = (record.nextSample + 1) % SAMPLE_SIZE;
+
+    if (selfTime > _budget) {
+        _checkBudget(record);
+    }
+}
+
+/**
+ * @param {!Object} target Callback or provider passed to attribute()
+ * @return {boolean} true if the callbacks of the owning extension are currently skipped
+ */
+export function isSuspended(target: object) {
+    if (!_enabled) {
+        return false;
+    }
+    const owner = _owners.get(target);
+    const record = owner && _records[owner];
+    return !!record && (record.disabled || record.throttledUntil > performance.now());
+}
+
+/**
+ * Calls fn, measuring it if target was attributed to an extension. Calls of suspended
+ * extensions are skipped and return undefined.
+ *
+ * The time of nested calls is only counted for the innermost extension, so an extension isn't
+ * blamed for the handlers of other extensions that run while it triggers an event.
+ *
+ * @param {!Object} target Callback or provider passed to attribute()
+ * @param {!string} label Describes the call, e.g. "hasHints" or an event name
+ * @param {!Function} fn
+ * @param {*} thisArg
+ * @param {!Array|Arguments} args
+ * @return {*} What fn returned
+ */
+export function invoke(target: object, label: string, fn: Function, thisArg, args) {
+    const owner = _enabled ? _owners.get(target) : undefined;
+    if (!owner) {
+        return fn.apply(thisArg, args);
+    }
+
+    if (isSuspended(target)) {
+        _records[owner].skipped++;
+        return undefined;
+    }
+
+    const frame = { childTime: 0 };
+    const heapBefore = _memory ? _memory.usedJSHeapSize : 0;
+    const start = performance.now();
+
+    _frames.push(frame);
+    try {
+        return fn.apply(thisArg, args);
+    } finally {
+        _frames.pop();
+
+        const elapsed = performance.now() - start;
+        const allocated = _memory ? Math.max(0, _memory.usedJSHeapSize - heapBefore) : 0;
+        if (_frames.length) {
+            _frames[_frames.length - 1].childTime += elapsed;
+        }
+        _record(owner, label, Math.max(0, elapsed - frame.childTime), allocated);
+    }
+}
+
+/**
+ * Makes the callbacks of a throttled or disabled extension run again
+ * @param {!string} name
+ */
+export function resume(name) {
+    const record = _records[name];
+    if (record) {
+        record.disabled = false;
+        record.throttledUntil = 0;
+    }
+}
+
+/**
+ * Returns the statistics of every extension whose callbacks ran, slowest p95 first
+ * @return {!Array.<ExtensionStats>}
+ */
+export function getStats(): Array<ExtensionStats> {
+    const now = performance.now();
+
+    return Object.keys(_records).map(function (name) {
+        const record = _records[name];
+        let state = "ok";
+        if (record.disabled) {
+            state = ACTION_DISABLE;
+        } else if (record.throttledUntil > now) {
+            state = ACTION_THROTTLE;
+        }
+        return {
+            name: name,
+            calls: record.calls,
+            avg: record.calls ? record.selfTime / record.calls : 0,
+            p95: _percentile(record.samples, 95),
+            max: record.maxTime,
+            allocatedPerCall: record.calls ? record.allocated / record.calls : 0,
+            slowestCall: record.slowestCall,
+            skipped: record.skipped,
+            state: state
+        };
+    }).sort(function (a, b) {
+        return b.p95 - a.p95;
+    });
+}
+
+/**
+ * Forgets the statistics of all extensions and makes suspended extensions run again
+ */
+export function reset() {
+    _records = {};
+}
+
+/**
+ * @private
+ * Forgets all attributions too, for unit tests
+ */
+export function _reset() {
+    reset();
+    _owners = new WeakMap<object, string>();
+}
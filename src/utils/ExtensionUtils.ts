@@ -22,8 +22,6 @@
  *
  */
 
-/*global less */
-
 /**
  * ExtensionUtils defines utility methods for implementing extensions.
  */
@@ -31,6 +29,7 @@
 import * as Async from "utils/Async";
 import * as FileSystem from "filesystem/FileSystem";
 import * as FileUtils from "file/FileUtils";
+import * as LessCache from "utils/LessCache";
 import * as PathUtils from "thirdparty/path-utils/path-utils";
 import * as PreferencesManager from "preferences/PreferencesManager";
 
@@ -93,7 +92,6 @@ function isAbsolutePathOrUrl(pathOrUrl) {
  * @return {!$.Promise} A promise object that is resolved with CSS code if the LESS code can be parsed
  */
 export function parseLessCode(code, url) {
-    const result = $.Deferred();
     let options;
 
     if (url) {
@@ -115,15 +113,8 @@ export function parseLessCode(code, url) {
         }
     }
 
-    less.render(code, options, function onParse(err, tree) {
-        if (err) {
-            result.reject(err);
-        } else {
-            result.resolve(tree.css);
-        }
-    });
-
-    return result.promise();
+    // The compiled CSS is cached across sessions
+    return LessCache.render(code, options);
 }
 
 /**
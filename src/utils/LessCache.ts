@@ -0,0 +1,414 @@
+/*
+ * Copyright (c) 2018 - present The quadre code authors. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ *
+ */
+
+/// <amd-dependency path="module" name="module"/>
+
+/*global less */
+
+/**
+ * LessCache keeps the CSS compiled from LESS code (themes, extension stylesheets) in the
+ * application support directory, so that a warm start doesn't run the LESS compiler at all.
+ *
+ * Entries are keyed by a hash of the code, the compiler options and the app version (which covers
+ * the variables and mixins shipped with the app). The CSS of each entry is a file of its own; the
+ * index only remembers the modification time of every file the code imported, and an entry is
+ * dropped as soon as one of them changes. On a miss the code is compiled in node, off the UI
+ * thread, and only compiled in the window when node isn't available.
+ *
+ * The index also remembers the version of the compiler that produced its entries. Hits don't wait
+ * for node to report its version; it is checked in the background, and all entries are dropped
+ * when it changed.
+ */
+
+import * as _ from "lodash";
+import * as Async from "utils/Async";
+import * as FileSystem from "filesystem/FileSystem";
+import * as FileUtils from "file/FileUtils";
+import NodeDomain = require("utils/NodeDomain");
+import PersistentCache = require("utils/PersistentCache");
+import * as MurmurHash3 from "thirdparty/murmurhash3_gc";
+
+const INDEX_FILENAME = "less-cache.json";
+const CACHE_DIRNAME = "less-cache";
+
+/** Number of compiled style sheets kept, the least recently used ones are dropped first */
+const MAX_ENTRIES = 100;
+
+interface CacheEntry {
+    imports: { [path: string]: number };
+    used: number;
+}
+
+interface CompileResult {
+    css: string;
+    imports: Array<string>;
+}
+
+let _index: { [key: string]: CacheEntry } = {};
+
+/** Version of the compiler that produced the entries of the index, null if not known yet */
+let _indexCompilerVersion: string | null = null;
+
+let _lessDomain: NodeDomain | null = null;
+let _compilerVersionPromise: JQueryPromise<string> | null = null;
+let _checkPromise: JQueryPromise<string> | null = null;
+const _pending: { [key: string]: JQueryPromise<string> } = {};
+
+// The index, next to one CSS file per entry
+const _cache = new PersistentCache(CACHE_DIRNAME + "/" + INDEX_FILENAME, {
+    logName: "LessCache",
+    saveDelay: 1000,
+    deserialize: function (data) {
+        // Older versions kept the entries at the top level, with the compiler version in the keys
+        if (data && data.entries) {
+            _index = data.entries;
+            _indexCompilerVersion = data.compilerVersion || null;
+        } else {
+            Object.keys(data || {}).forEach(function (key) {
+                FileSystem.getFileForPath(_getCSSPath(key)).unlink(_.noop);
+            });
+            _index = {};
+            _indexCompilerVersion = null;
+        }
+    },
+    serialize: function () {
+        return {
+            compilerVersion: _indexCompilerVersion,
+            entries: _index
+        };
+    }
+});
+
+/**
+ * @private
+ * Moves the cache and forgets the loaded index.
+ * @param {?string} path Directory, or null to go back to the default one
+ */
+// For unit tests
+export function _setCacheDirectory(path) {
+    _cache.setPath(path ? path + "/" + INDEX_FILENAME : null);
+    _index = {};
+    _indexCompilerVersion = null;
+    _checkPromise = null;
+}
+
+function _getCSSPath(key) {
+    return _cache.getDirectory() + "/" + key + ".css";
+}
+
+function _getLessDomain() {
+    if (!_lessDomain) {
+        const domainPath = FileUtils.getNativeBracketsDirectoryPath() + "/" +
+            FileUtils.getNativeModuleDirectoryPath(module) + "/node/LessCompilerDomain";
+        _lessDomain = new NodeDomain("lessCompiler", domainPath);
+    }
+    return _lessDomain;
+}
+
+function _getWindowCompilerVersion() {
+    return "window-" + (less.version ? less.version.join(".") : "");
+}
+
+/**
+ * @private
+ * Resolves with the version of the compiler that compiles misses: the one in node, or the
+ * window's if node isn't available. Never rejected.
+ */
+function _getCompilerVersion(): JQueryPromise<string> {
+    if (!_compilerVersionPromise) {
+        const result = $.Deferred<string>();
+
+        if (brackets.inBrowser) {
+            result.resolve(_getWindowCompilerVersion());
+        } else {
+            _getLessDomain().exec("getVersion")
+                .done(function (version) {
+                    result.resolve("node-" + version);
+                })
+                .fail(function () {
+                    result.resolve(_getWindowCompilerVersion());
+                });
+        }
+
+        _compilerVersionPromise = result.promise();
+    }
+    return _compilerVersionPromise;
+}
+
+/**
+ * @private
+ * Builds the cache key of some LESS code
+ */
+function _getKey(code, options) {
+    const text = JSON.stringify([brackets.metadata.version, options || null, code]);
+    return MurmurHash3.hashString(text, text.length, 0).toString(16) + "-" + code.length.toString(16);
+}
+
+/**
+ * @private
+ * Returns the path of an imported file, or null if it isn't a local file
+ */
+function _getImportPath(url) {
+    if (url.indexOf("file://") === 0) {
+        url = decodeURI(url.replace(/^file:\/\/(localhost)?/, ""));
+        if (/^\/[A-Za-z]:\//.test(url)) {
+            url = url.substr(1);
+        }
+    }
+    url = url.replace(/\\/g, "/");
+    return FileSystem.isAbsolutePath(url) ? url : null;
+}
+
+function _stat(path) {
+    const result = $.Deferred();
+    FileSystem.getFileForPath(path).stat(function (err, stat) {
+        if (err) {
+            result.reject(err);
+        } else {
+            result.resolve(stat.mtime.getTime());
+        }
+    });
+    return result.promise();
+}
+
+/**
+ * @private
+ * Resolves with true if none of the files an entry imported has changed
+ */
+function _validateEntry(entry: CacheEntry) {
+    const result = $.Deferred();
+    let valid = true;
+
+    Async.doInParallel(Object.keys(entry.imports), function (path) {
+        return _stat(path).then(function (mtime) {
+            valid = valid && mtime === entry.imports[path];
+        }, function () {
+            valid = false;
+        });
+    }).always(function () {
+        result.resolve(valid);
+    });
+
+    return result.promise();
+}
+
+/**
+ * @private
+ * Compiles LESS code in the window, used when node isn't available
+ */
+function _renderInProcess(code, options): JQueryPromise<CompileResult> {
+    const result = $.Deferred();
+
+    less.render(code, options, function onParse(err, tree) {
+        if (err) {
+            result.reject(err);
+        } else {
+            result.resolve({ css: tree.css, imports: tree.imports || [] });
+        }
+    });
+
+    return result.promise();
+}
+
+/**
+ * @private
+ * Compiles LESS code with the compiler _getCompilerVersion() reported: in node, or in the window
+ * when node isn't available. Falls back to the window's compiler if node fails, the result then
+ * comes with fromFallback set since it may differ from what the node compiler produces.
+ */
+function _compile(code, options, compilerVersion): JQueryPromise<CompileResult & { fromFallback?: boolean }> {
+    if (compilerVersion.indexOf("node-") !== 0) {
+        return _renderInProcess(code, options);
+    }
+
+    const result = $.Deferred();
+
+    _getLessDomain().exec("render", code, options || {})
+        .done(function (compiled) {
+            result.resolve(compiled);
+        })
+        .fail(function (err) {
+            // Syntax errors reproduce in the window and come with the details less provides there
+            console.warn("[LessCache] Compiling in node failed, compiling in the window: " + err);
+            _renderInProcess(code, options).then(function (compiled) {
+                result.resolve(_.extend({ fromFallback: true }, compiled));
+            }, result.reject);
+        });
+
+    return result.promise();
+}
+
+/**
+ * @private
+ * Forgets an entry and deletes its CSS file
+ */
+function _remove(key) {
+    if (_index.hasOwnProperty(key)) {
+        delete _index[key];
+        FileSystem.getFileForPath(_getCSSPath(key)).unlink(_.noop);
+        _cache.scheduleSave();
+    }
+}
+
+/**
+ * @private
+ * Makes sure the entries of the index come from the compiler that compiles misses now, and drops
+ * them all if they don't. Needs the index to be loaded.
+ * @return {!$.Promise} Resolved with the version of the compiler once the index matches it
+ */
+function _checkCompilerVersion(): JQueryPromise<string> {
+    if (!_checkPromise) {
+        _checkPromise = _getCompilerVersion().done(function (compilerVersion) {
+            if (_indexCompilerVersion === compilerVersion) {
+                return;
+            }
+            if (_indexCompilerVersion !== null) {
+                console.log("[LessCache] The compiler changed from " + _indexCompilerVersion + " to " + compilerVersion +
+                    ", dropping the cached CSS");
+                Object.keys(_index).forEach(_remove);
+            }
+            _indexCompilerVersion = compilerVersion;
+            _cache.scheduleSave();
+        });
+    }
+    return _checkPromise;
+}
+
+/**
+ * @private
+ * Adds compiled code to the cache. Code that imported files which aren't local files
+ * is not cached, since there is no way to tell when they change.
+ */
+function _store(key, compiled: CompileResult) {
+    const paths = (compiled.imports || []).map(_getImportPath);
+    if (paths.indexOf(null) !== -1) {
+        _remove(key);
+        return;
+    }
+
+    const imports: { [path: string]: number } = {};
+    Async.doInParallel(paths, function (path) {
+        return _stat(path).done(function (mtime) {
+            imports[path!] = mtime;
+        });
+    }, true).then(function () {
+        return _cache.writeFile(key + ".css", compiled.css);
+    }).done(function () {
+        _index[key] = { imports: imports, used: Date.now() };
+
+        const keys = Object.keys(_index);
+        if (keys.length > MAX_ENTRIES) {
+            _.sortBy(keys, function (oldKey) {
+                return _index[oldKey].used;
+            }).slice(0, keys.length - MAX_ENTRIES).forEach(_remove);
+        }
+        _cache.scheduleSave();
+    });
+}
+
+/**
+ * @private
+ * Resolves with the CSS of an entry, or with null if the entry is missing or out of date
+ */
+function _lookup(key): JQueryPromise<string | null> {
+    const entry = _index.hasOwnProperty(key) ? _index[key] : null;
+    if (!entry) {
+        return $.Deferred<string | null>().resolve(null).promise();
+    }
+
+    return _validateEntry(entry).then(function (valid) {
+        if (!valid) {
+            return null;
+        }
+        const result = $.Deferred<string | null>();
+        FileUtils.readAsText(FileSystem.getFileForPath(_getCSSPath(key)))
+            .done(function (css) {
+                entry.used = Date.now();
+                result.resolve(css!);
+            })
+            .fail(function () {
+                result.resolve(null);
+            });
+        return result.promise();
+    });
+}
+
+/**
+ * Compiles LESS code to CSS, or returns the CSS cached for the same code.
+ *
+ * @param {!string} code LESS code
+ * @param {Object=} options Options for less.render(), e.g. filename and rootpath
+ * @return {!$.Promise} Resolved with the CSS code, rejected with the compiler's error
+ */
+export function render(code, options?): JQueryPromise<string> {
+    return _cache.load().then(function () {
+        const key = _getKey(code, options);
+
+        if (_pending[key]) {
+            return _pending[key];
+        }
+
+        const promise = _lookup(key).then(function (css) {
+            if (css !== null) {
+                // Checked once the hit is served, entries of another compiler are dropped then
+                _checkCompilerVersion();
+                return css;
+            }
+
+            // Misses are compiled once the entries match the compiler
+            return _checkCompilerVersion().then(function (compilerVersion) {
+                // An out of date entry stays until the new CSS replaces its file
+                const compiling = _compile(code, options, compilerVersion);
+                compiling.fail(function () {
+                    _remove(key);
+                });
+                return compiling.then(function (compiled) {
+                    if (compiled.fromFallback) {
+                        _remove(key);
+                    } else {
+                        _store(key, compiled);
+                    }
+                    return compiled.css;
+                });
+            });
+        });
+
+        _pending[key] = promise;
+        promise.always(function () {
+            delete _pending[key];
+        });
+
+        return promise;
+    });
+}
+
+/**
+ * @private
+ * Whether the CSS of some LESS code is cached, for unit tests
+ * @param {!string} code
+ * @param {Object=} options
+ * @return {boolean}
+ */
+export function _isCached(code, options?) {
+    return _index.hasOwnProperty(_getKey(code, options));
+}
@@ -55,6 +55,24 @@ const RETRY_DELAY         = 500;   // 1/2 second
  */
 const MAX_COUNTER_VALUE = 4294967295; // 2^32 - 1
 
+/**
+ * Version of the binary framing of large messages, see app/socket-server/framing.ts
+ * @type {string}
+ */
+const FRAMING_VERSION = "binary-1";
+
+/**
+ * Kinds of the values extracted from binary frames
+ * @type {number}
+ */
+const REF_STRING = 0;
+
+/**
+ * localStorage key of the domain descriptions cached between runs
+ * @type {string}
+ */
+const DESCRIPTIONS_KEY = "nodeDomainDescriptions";
+
 /**
  * @private
  * Helper function to auto-reject a deferred after a given amount of time.
@@ -121,6 +139,110 @@ interface NodeDomainEvent {
     [domainKey: string]: NodeEvent;
 }
 
+interface DomainDescriptions {
+    version: string;
+    domains: { [domainKey: string]: any };
+}
+
+/**
+ * @private
+ * Whether connections ask the server for binary framing when they connect
+ * @type {boolean}
+ */
+let _useBinaryFraming = true;
+
+let _textDecoder: TextDecoder | null = null;
+
+/**
+ * @private
+ * Decodes a binary frame: a JSON header holding the message without its large values,
+ * followed by those values. Strings are decoded from UTF-8, raw bytes become ArrayBuffers.
+ * @param {ArrayBuffer} data
+ * @return {?{type: string, message: Object}} null if the frame is malformed
+ */
+function _decodeFrame(data: ArrayBuffer) {
+    if (data.byteLength < 4) {
+        return null;
+    }
+    const headerLength = new DataView(data).getUint32(0, true);
+    const payloadStart = 4 + headerLength;
+    if (payloadStart > data.byteLength) {
+        return null;
+    }
+
+    if (!_textDecoder) {
+        _textDecoder = new TextDecoder("utf-8");
+    }
+    const frame = JSON.parse(_textDecoder.decode(new Uint8Array(data, 4, headerLength)));
+    const root = { message: frame.message };
+
+    frame.refs.forEach(function (ref) {
+        const path = ref[0];
+        const start = payloadStart + ref[2];
+        const value = ref[1] === REF_STRING
+            ? _textDecoder!.decode(new Uint8Array(data, start, ref[3]))
+            : data.slice(start, start + ref[3]);
+
+        let parent: any = root;
+        let key: string | number = "message";
+        path.forEach(function (next) {
+            parent = parent[key];
+            key = next;
+        });
+        parent[key] = value;
+    });
+
+    return { type: frame.type, message: root.message };
+}
+
+/**
+ * @private
+ * Descriptions (commands and events) of the domains the server reported in
+ * this or an earlier run of the same version, lazily read from localStorage
+ */
+let _descriptions: DomainDescriptions | null = null;
+
+function _getDescriptions() {
+    const version = brackets.metadata.version;
+    if (!_descriptions) {
+        try {
+            _descriptions = JSON.parse(window.localStorage.getItem(DESCRIPTIONS_KEY) || "null");
+        } catch (err) {
+            console.warn("[NodeConnection] Ignoring corrupt domain descriptions: " + err);
+        }
+        if (!_descriptions || _descriptions.version !== version || !_descriptions.domains) {
+            _descriptions = { version: version, domains: {} };
+        }
+    }
+    return _descriptions;
+}
+
+/**
+ * @private
+ * Remembers the descriptions of the domains in an API spec, writes them to
+ * localStorage only if one of them changed
+ */
+function _saveDescriptions(spec) {
+    const descriptions = _getDescriptions();
+    let changed = false;
+
+    Object.keys(spec).forEach(function (domainKey) {
+        const text = JSON.stringify(spec[domainKey]);
+        if (JSON.stringify(descriptions.domains[domainKey]) !== text) {
+            descriptions.domains[domainKey] = JSON.parse(text);
+            changed = true;
+        }
+    });
+
+    if (changed) {
+        try {
+            window.localStorage.setItem(DESCRIPTIONS_KEY, JSON.stringify(descriptions));
+        } catch (err) {
+            console.warn("[NodeConnection] Could not save the domain descriptions: " + err);
+        }
+    }
+}
+
 /**
  * Provides an interface for interacting with the node server.
  * @constructor
@@ -180,11 +302,11 @@ class NodeConnection {
 
     /**
      * @private
-     * @type {Array.<jQuery.Deferred>}
+     * @type {Array.<{deferred: jQuery.Deferred, domainNames: ?Array.<string>}>}
      * List of deferred objects that should be resolved pending
-     * a successful refresh of the API
+     * a successful refresh of the API that includes the given domains
      */
-    private _pendingInterfaceRefreshDeferreds: Array<any>;
+    private _pendingInterfaceRefreshDeferreds: Array<{ deferred: JQueryDeferred<any>, domainNames?: Array<string> }>;
 
     /**
      * @private
@@ -194,8 +316,16 @@ class NodeConnection {
      */
     private _pendingCommandDeferreds: Array<JQueryDeferred<any>>;
 
+    /**
+     * @private
+     * @type {boolean}
+     * Whether the server agreed to send large messages as binary frames
+     */
+    private _binaryFraming = false;
+
     constructor() {
         this.domains = {};
+        this.domainEvents = {};
         this._registeredModules = [];
         this._pendingInterfaceRefreshDeferreds = [];
         this._pendingCommandDeferreds = [];
@@ -226,6 +356,8 @@ class NodeConnection {
         // clear out the domains, since we may get different ones
         // on the next connection
         this.domains = {};
+        this.domainEvents = {};
+        this._binaryFraming = false;
 
         // shut down the old connection if there is one
         if (this._ws && this._ws.readyState !== WebSocket.CLOSED) {
@@ -235,9 +367,10 @@ class NodeConnection {
                 // Do nothing
             }
         }
-        const failedDeferreds = this._pendingInterfaceRefreshDeferreds
-            .concat(this._pendingCommandDeferreds);
-        failedDeferreds.forEach(function (d) {
+        this._pendingInterfaceRefreshDeferreds.forEach(function (pending) {
+            pending.deferred.reject("cleanup");
+        });
+        this._pendingCommandDeferreds.forEach(function (d) {
             d.reject("cleanup");
         });
         this._pendingInterfaceRefreshDeferreds = [];
@@ -293,6 +426,11 @@ class NodeConnection {
             self._port = port;
             self._ws!.onmessage = self._receive.bind(self);
 
+            // The server answers before it sends any binary frame
+            if (_useBinaryFraming) {
+                self._send({ type: "capabilities", framing: [FRAMING_VERSION] });
+            }
+
             // refresh the current domains, then re-register any
             // "autoregister" modules
             self._refreshInterface().then(
@@ -366,11 +504,16 @@ class NodeConnection {
      * @param {boolean} autoReload Whether to auto-reload the domains if the server
      *    fails and restarts. Note that the reload is initiated by the
      *    client, so it will only happen after the client reconnects.
+     * @param {Array.<string>=} domainNames Names of the domains the modules register.
+     *    If the descriptions of all of them were cached in an earlier run, the
+     *    promise resolves as soon as the server loaded the modules, without waiting
+     *    for the API refresh; the refresh replaces the cached descriptions later.
      * @return {jQuery.Promise} Promise that resolves after the load has
      *    succeeded and the new API is availale at NodeConnection.domains,
      *    or that rejects on failure.
      */
-    public loadDomains(paths, autoReload) {
+    public loadDomains(paths, autoReload, domainNames?: Array<string>) {
+        const self = this;
         const deferred = $.Deferred();
         setDeferredTimeout(deferred, CONNECTION_TIMEOUT);
         let pathArray = paths;
@@ -379,9 +522,18 @@ class NodeConnection {
         }
 
         if (autoReload) {
-            Array.prototype.push.apply(this._registeredModules, pathArray);
+            pathArray.forEach(function (path) {
+                if (self._registeredModules.indexOf(path) === -1) {
+                    self._registeredModules.push(path);
+                }
+            });
         }
 
+        const cachedDomains = _getDescriptions().domains;
+        const useCached = !!domainNames && domainNames.every(function (domainName) {
+            return cachedDomains.hasOwnProperty(domainName);
+        });
+
         if (this.domains.base && this.domains.base.loadDomainModulesFromPaths) {
             this.domains.base.loadDomainModulesFromPaths(pathArray).then(
                 function (success) { // command call succeeded
@@ -389,6 +541,13 @@ class NodeConnection {
                         // response from commmand call was "false" so we know
                         // the actual load failed.
                         deferred.reject("loadDomainModulesFromPaths failed");
+                    } else if (useCached && deferred.state() === "pending") {
+                        // The server loads modules synchronously, so commands sent
+                        // from now on reach the new domains
+                        domainNames!.forEach(function (domainName) {
+                            self._addDomain(domainName, cachedDomains[domainName]);
+                        });
+                        deferred.resolve();
                     }
                     // if the load succeeded, we wait for the API refresh to
                     // resolve the deferred.
@@ -398,7 +557,7 @@ class NodeConnection {
                 }
             );
 
-            this._pendingInterfaceRefreshDeferreds.push(deferred);
+            this._pendingInterfaceRefreshDeferreds.push({ deferred: deferred, domainNames: domainNames });
         } else {
             deferred.reject("this.domains.base is undefined");
         }
@@ -451,7 +610,17 @@ class NodeConnection {
         const data = message.data;
         let m;
 
-        if (message.data instanceof ArrayBuffer) {
+        if (message.data instanceof ArrayBuffer && this._binaryFraming) {
+            try {
+                m = _decodeFrame(data);
+            } catch (e) {
+                m = null;
+            }
+            if (!m) {
+                console.error("[NodeConnection] received malformed binary frame");
+                return;
+            }
+        } else if (message.data instanceof ArrayBuffer) {
             // The first four bytes encode the command ID as an unsigned 32-bit integer
             if (data.byteLength < 4) {
                 console.error("[NodeConnection] received malformed binary message");
@@ -481,6 +650,9 @@ class NodeConnection {
         }
 
         switch (m.type) {
+            case "capabilities":
+                this._binaryFraming = m.message.framing === FRAMING_VERSION;
+                break;
             case "event":
                 if (m.message.domain === "base" && m.message.event === "newDomains") {
                     this._refreshInterface();
@@ -523,11 +695,49 @@ class NodeConnection {
         }
     }
 
+    /**
+     * @private
+     * Exposes the commands and events of a domain described by the server
+     * @param {string} domainKey Name of the domain
+     * @param {{commands: Object, events: Object}} domainSpec
+     */
+    private _addDomain(domainKey, domainSpec) {
+        const self = this;
+
+        function makeCommandFunction(domainName, commandName) {
+            return function () {
+                const deferred = $.Deferred();
+                const parameters = Array.prototype.slice.call(arguments, 0);
+                const id = self._getNextCommandID();
+                self._pendingCommandDeferreds[id] = deferred;
+                self._send({
+                    id: id,
+                    domain: domainName,
+                    command: commandName,
+                    parameters: parameters
+                });
+                return deferred;
+            };
+        }
+
+        this.domains[domainKey] = {};
+        Object.keys(domainSpec.commands).forEach(function (commandKey) {
+            self.domains[domainKey][commandKey] = makeCommandFunction(domainKey, commandKey);
+        });
+        this.domainEvents[domainKey] = {};
+        Object.keys(domainSpec.events).forEach(function (eventKey) {
+            const eventSpec = domainSpec.events[eventKey];
+            const parameters = eventSpec.parameters;
+            self.domainEvents[domainKey][eventKey] = parameters;
+        });
+    }
+
     /**
      * @private
      * Helper function for refreshing the interface in the "domain" property.
      * Automatically called when the connection receives a base:newDomains
      * event from the server, and also called at connection time.
+     * Triggers "interfaceRefresh" once the new interface is in place.
      */
     private _refreshInterface() {
         const deferred = $.Deferred();
@@ -537,47 +747,34 @@ class NodeConnection {
         this._pendingInterfaceRefreshDeferreds = [];
         deferred.then(
             function () {
-                pendingDeferreds.forEach(function (d) { d.resolve(); });
+                // A refresh that was requested before the server loaded some domains
+                // doesn't list them, those loads wait for the next refresh
+                pendingDeferreds.forEach(function (pending) {
+                    const complete = !pending.domainNames || pending.domainNames.every(function (domainName) {
+                        return self.domains.hasOwnProperty(domainName);
+                    });
+                    if (complete) {
+                        pending.deferred.resolve();
+                    } else if (pending.deferred.state() === "pending") {
+                        self._pendingInterfaceRefreshDeferreds.push(pending);
+                    }
+                });
             },
             function (err) {
-                pendingDeferreds.forEach(function (d) { d.reject(err); });
+                pendingDeferreds.forEach(function (pending) { pending.deferred.reject(err); });
             }
         );
 
         function refreshInterfaceCallback(spec) {
-            function makeCommandFunction(domainName, commandName) {
-                return function () {
-                    const deferred = $.Deferred();
-                    const parameters = Array.prototype.slice.call(arguments, 0);
-                    const id = self._getNextCommandID();
-                    self._pendingCommandDeferreds[id] = deferred;
-                    self._send({
-                        id: id,
-                        domain: domainName,
-                        command: commandName,
-                        parameters: parameters
-                    });
-                    return deferred;
-                };
-            }
-
-            // TODO: Don't replace the domain object every time. Instead, merge.
-            self.domains = {};
-            self.domainEvents = {};
+            // Merge instead of replacing: domains added from the cached descriptions
+            // after this refresh was requested aren't in the spec yet. The server
+            // never unloads a domain, the domains are only reset with the connection.
             Object.keys(spec).forEach(function (domainKey) {
-                const domainSpec = spec[domainKey];
-                self.domains[domainKey] = {};
-                Object.keys(domainSpec.commands).forEach(function (commandKey) {
-                    self.domains[domainKey][commandKey] = makeCommandFunction(domainKey, commandKey);
-                });
-                self.domainEvents[domainKey] = {};
-                Object.keys(domainSpec.events).forEach(function (eventKey) {
-                    const eventSpec = domainSpec.events[eventKey];
-                    const parameters = eventSpec.parameters;
-                    self.domainEvents[domainKey][eventKey] = parameters;
-                });
+                self._addDomain(domainKey, spec[domainKey]);
             });
+            _saveDescriptions(spec);
             deferred.resolve();
+            (self as unknown as EventDispatcher.DispatcherEvents).trigger("interfaceRefresh");
         }
 
         if (this.connected()) {
@@ -599,6 +796,16 @@ class NodeConnection {
     public static _getConnectionTimeout() {
         return CONNECTION_TIMEOUT;
     }
+
+    /**
+     * @private
+     * Sets whether connections that connect from now on negotiate binary framing,
+     * for unit tests and benchmarks
+     * @param {boolean} enabled
+     */
+    public static _setBinaryFraming(enabled) {
+        _useBinaryFraming = enabled;
+    }
 }
 
 EventDispatcher.makeEventDispatcher(NodeConnection.prototype);
@@ -27,9 +27,128 @@
 import NodeConnection = require("utils/NodeConnection");
 import * as EventDispatcher from "utils/EventDispatcher";
 
-// Used to remove all listeners at once when the connection drops
+// Used to remove all listeners of a domain at once when the connection drops.
+// Each domain appends a number, since all domains listen to the same connection.
 const EVENT_NAMESPACE = ".NodeDomainEvent";
 
+// Namespace of the "close" and "interfaceRefresh" listeners of a domain, which
+// stay until dispose(). Numbered like EVENT_NAMESPACE.
+const CONNECTION_NAMESPACE = ".NodeDomain";
+
+interface PendingLoad {
+    domainName: string;
+    domainPath: string;
+    deferred: JQueryDeferred<any>;
+}
+
+/**
+ * @private
+ * The connection shared by all domains
+ * @type {?NodeConnection}
+ */
+let _connection: NodeConnection | null = null;
+
+/**
+ * @private
+ * Resolves when the shared connection is open, null after it was disconnected
+ * @type {?jQuery.Promise}
+ */
+let _connectPromise: JQueryPromise<any> | null = null;
+
+/**
+ * @private
+ * Domains to load with the next batch
+ * @type {Array.<PendingLoad>}
+ */
+let _pendingLoads: Array<PendingLoad> = [];
+
+/**
+ * @private
+ * Settles when the last batch of domains finished loading. Batches are loaded one
+ * after the other, so that the API refresh of one batch can't resolve the next one.
+ * @type {jQuery.Promise}
+ */
+let _lastBatch: JQueryPromise<any> = $.Deferred().resolve().promise();
+
+let _domainCount = 0;
+
+/**
+ * @private
+ * Returns the connection shared by all domains, connecting it if it isn't yet
+ * (or if connecting failed before).
+ * @return {NodeConnection}
+ */
+function _getConnection() {
+    if (!_connection) {
+        _connection = new NodeConnection();
+        (_connection as unknown as EventDispatcher.DispatcherEvents).on("close", function (event, promise) {
+            _connectPromise = promise || null;
+        });
+    }
+    if (!_connectPromise || _connectPromise.state() === "rejected") {
+        _connectPromise = _connection.connect(true);
+    }
+    return _connection;
+}
+
+/**
+ * @private
+ * Loads the domains requested so far with a single loadDomains call.
+ * If that fails, loads them one by one so a broken domain doesn't fail the others.
+ */
+function _loadPendingDomains() {
+    const batch = _pendingLoads;
+    const connection = _connection!;
+    _pendingLoads = [];
+
+    function loadOneByOne() {
+        let promise: JQueryPromise<any> = $.Deferred().resolve().promise();
+        batch.forEach(function (load) {
+            const loadOne = function () {
+                return connection.loadDomains(load.domainPath, true, [load.domainName])
+                    .then(load.deferred.resolve, load.deferred.reject);
+            };
+            promise = promise.then(loadOne, loadOne);
+        });
+        return promise;
+    }
+
+    function loadBatch() {
+        const paths = batch.map(function (load) { return load.domainPath; });
+        const domainNames = batch.map(function (load) { return load.domainName; });
+
+        return connection.loadDomains(paths, true, domainNames)
+            .then(function () {
+                batch.forEach(function (load) {
+                    load.deferred.resolve();
+                });
+            }, function (err) {
+                if (batch.length === 1) {
+                    batch[0].deferred.reject(err);
+                    return err;
+                }
+                return loadOneByOne();
+            });
+    }
+
+    _lastBatch = _lastBatch.then(loadBatch, loadBatch);
+}
+
+/**
+ * @private
+ * Queues a domain to load with the other domains that are requested in the same turn
+ * @return {jQuery.Promise} Resolves once the domain is loaded
+ */
+function _requestLoad(domainName, domainPath) {
+    const deferred = $.Deferred();
+
+    _pendingLoads.push({ domainName: domainName, domainPath: domainPath, deferred: deferred });
+    if (_pendingLoads.length === 1) {
+        Promise.resolve().then(_loadPendingDomains);
+    }
+    return deferred.promise();
+}
+
 /**
  * Provides a simple abstraction for executing the commands of a single
  * domain loaded via a NodeConnection. Automatically handles connection
@@ -52,13 +171,17 @@ const EVENT_NAMESPACE = ".NodeDomainEvent";
  *
  *     myDomain.on("someEvent", someHandler);
  *
+ * All domains share one connection. Domains created in the same turn (e.g.
+ * by the modules loaded at startup) are loaded with a single request.
+ *
  * @constructor
  * @param {string} domainName Name of the registered Node Domain
  * @param {string} domainPath Full path of the JavaScript Node domain specification
  */
 class NodeDomain {
     /**
-     * The underlying Node connection object for this domain.
+     * The underlying Node connection object for this domain, which is
+     * shared with all other domains. Don't disconnect it.
      *
      * @type {NodeConnection}
      */
@@ -97,23 +220,58 @@ class NodeDomain {
      */
     private _domainLoaded = false;
 
+    /**
+     * The namespace of the listeners this domain adds to the connection.
+     *
+     * @type {string}
+     * @private
+     */
+    private _eventNamespace: string;
+
+    /**
+     * The namespace of the listeners this domain adds to follow the state of the connection.
+     *
+     * @type {string}
+     * @private
+     */
+    private _connectionNamespace: string;
+
+    /**
+     * Whether dispose() was called.
+     *
+     * @type {boolean}
+     * @private
+     */
+    private _disposed = false;
+
     constructor(domainName, domainPath) {
-        const connection = new NodeConnection();
+        const connection = _getConnection();
 
         this.connection = connection;
         this._domainName = domainName;
         this._domainPath = domainPath;
         this._domainLoaded = false;
+        ++_domainCount;
+        this._eventNamespace = EVENT_NAMESPACE + _domainCount;
+        this._connectionNamespace = CONNECTION_NAMESPACE + _domainCount;
         this._load = this._load.bind(this);
-        this._connectionPromise = connection.connect(true)
+        this._connectionPromise = _connectPromise!
             .then(this._load);
 
-        (connection as unknown as EventDispatcher.DispatcherEvents).on("close", function (this: NodeDomain, event, promise) {
-            (this.connection as unknown as EventDispatcher.DispatcherEvents).off(EVENT_NAMESPACE);
+        (connection as unknown as EventDispatcher.DispatcherEvents).on("close" + this._connectionNamespace, function (this: NodeDomain, event, promise) {
+            (this.connection as unknown as EventDispatcher.DispatcherEvents).off(this._eventNamespace);
             this._domainLoaded = false;
             // in case of calling .disconnect() on connection, promise is undefined
             this._connectionPromise = promise ? promise.then(this._load) : null;
         }.bind(this));
+
+        // The events of a domain loaded from cached descriptions may have
+        // changed, bind them again to the ones the server reports
+        (connection as unknown as EventDispatcher.DispatcherEvents).on("interfaceRefresh" + this._connectionNamespace, function (this: NodeDomain) {
+            if (this._domainLoaded) {
+                this._bindEvents();
+            }
+        }.bind(this));
     }
 
     /**
@@ -125,27 +283,54 @@ class NodeDomain {
      * @private
      */
     private _load() {
-        const connection = this.connection;
-        return connection.loadDomains(this._domainPath, true)
+        return _requestLoad(this._domainName, this._domainPath)
             .done(function (this: NodeDomain) {
+                if (this._disposed) {
+                    return;
+                }
                 this._domainLoaded = true;
                 this._connectionPromise = null;
-
-                const eventNames = Object.keys(connection.domainEvents[this._domainName]);
-                eventNames.forEach(function (this: NodeDomain, domainEvent) {
-                    const connectionEvent = this._domainName + ":" + domainEvent + EVENT_NAMESPACE;
-
-                    (connection as unknown as EventDispatcher.DispatcherEvents).on(connectionEvent, function (this: NodeDomain) {
-                        const params = Array.prototype.slice.call(arguments, 1);
-                        EventDispatcher.triggerWithArray(this, domainEvent, params);
-                    }.bind(this));
-                }, this);
+                this._bindEvents();
             }.bind(this))
             .fail(function (this: NodeDomain, err) {
                 console.error("[NodeDomain] Error loading domain \"" + this._domainName + "\": " + err);
             }.bind(this));
     }
 
+    /**
+     * Re-triggers the events of the domain that the connection receives on this object.
+     *
+     * @private
+     */
+    private _bindEvents() {
+        const connection = this.connection as unknown as EventDispatcher.DispatcherEvents;
+        const domainEvents = this.connection.domainEvents[this._domainName] || {};
+
+        connection.off(this._eventNamespace);
+        Object.keys(domainEvents).forEach(function (this: NodeDomain, domainEvent) {
+            const connectionEvent = this._domainName + ":" + domainEvent + this._eventNamespace;
+
+            connection.on(connectionEvent, function (this: NodeDomain) {
+                const params = Array.prototype.slice.call(arguments, 1);
+                EventDispatcher.triggerWithArray(this, domainEvent, params);
+            }.bind(this));
+        }, this);
+    }
+
+    /**
+     * Stops listening to the shared connection. The domain stays loaded in node, since other
+     * NodeDomains may use it, but this object doesn't run commands or trigger events anymore.
+     */
+    public dispose() {
+        const connection = this.connection as unknown as EventDispatcher.DispatcherEvents;
+
+        connection.off(this._eventNamespace);
+        connection.off(this._connectionNamespace);
+        this._disposed = true;
+        this._domainLoaded = false;
+        this._connectionPromise = null;
+    }
+
     /**
      * Synchronously determine whether the domain is ready; i.e., whether the
      * connection is open and the domain is loaded.
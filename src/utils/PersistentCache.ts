@@ -0,0 +1,223 @@
+/*
+ * Copyright (c) 2018 - present The quadre code authors. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ *
+ */
+
+/**
+ * PersistentCache keeps data that is expensive to rebuild (compiled code, indexes) in a JSON file
+ * in the application support directory, so that it survives restarts. The file is read once, the
+ * first time the data is needed, and written back some time after the last change. Writes go
+ * through a temporary file, so a crash while writing never leaves a truncated file behind.
+ *
+ * Test windows and the spec runner keep their files in a "_test_" subdirectory, so running the
+ * tests never uses or replaces the data of the real app.
+ *
+ * Usage:
+ *
+ *     const _cache = new PersistentCache("my-cache.json", {
+ *         logName: "MyCache",
+ *         saveDelay: 1000,
+ *         deserialize: function (data) { _entries = data || {}; },
+ *         serialize: function () { return _entries; }
+ *     });
+ *
+ *     _cache.load().then(...);    // reads the file the first time only
+ *     _cache.scheduleSave();      // after changing _entries
+ */
+
+import * as _ from "lodash";
+import * as FileSystem from "filesystem/FileSystem";
+import FileSystemError = require("filesystem/FileSystemError");
+import * as FileUtils from "file/FileUtils";
+
+interface PersistentCacheOptions {
+    /** Name of the owning module, used in log messages */
+    logName: string;
+
+    /** Time in milliseconds to wait after the last change before the file is written */
+    saveDelay: number;
+
+    /** Receives the data read from the file, or null if there is no usable file */
+    deserialize: (data: any) => void;
+
+    /** Returns the data to write, must be JSON-able */
+    serialize: () => any;
+}
+
+/**
+ * @private
+ * Creates a directory and any missing parent directories.
+ * Always resolves, errors show up when the files are written.
+ */
+function _createDirectory(path: string): JQueryPromise<any> {
+    const result = $.Deferred();
+
+    FileSystem.getDirectoryForPath(path).create(function (err) {
+        const parentPath = FileUtils.getParentPath(path);
+        if (err === FileSystemError.NOT_FOUND && parentPath && parentPath !== path) {
+            _createDirectory(parentPath).always(function () {
+                FileSystem.getDirectoryForPath(path).create(function () {
+                    result.resolve();
+                });
+            });
+        } else {
+            // Usually ALREADY_EXISTS
+            result.resolve();
+        }
+    });
+
+    return result.promise();
+}
+
+class PersistentCache {
+    private _relativePath: string;
+    private _options: PersistentCacheOptions;
+    private _path: string | null = null;
+    private _loadPromise: JQueryPromise<any> | null = null;
+    private _directoryPromise: JQueryPromise<any> | null = null;
+    private _saveDebounced: (() => void) & _.Cancelable;
+
+    /**
+     * @param {!string} relativePath Path of the file, relative to the application support directory
+     * @param {!PersistentCacheOptions} options
+     */
+    constructor(relativePath: string, options: PersistentCacheOptions) {
+        this._relativePath = relativePath;
+        this._options = options;
+        this._saveDebounced = _.debounce(this._save.bind(this), options.saveDelay);
+    }
+
+    /**
+     * Returns the absolute path of the file
+     * @return {!string}
+     */
+    public getPath(): string {
+        if (!this._path) {
+            const win = window as any;
+            this._path = brackets.app.getApplicationSupportDirectory() +
+                (win.isBracketsTestWindow || win.isSpecRunner ? "/_test_/" : "/") + this._relativePath;
+        }
+        return this._path;
+    }
+
+    /**
+     * Returns the directory that holds the file, other files of the owning module can go there too
+     * @return {!string}
+     */
+    public getDirectory(): string {
+        return FileUtils.getDirectoryPath(this.getPath()).replace(/\/$/, "");
+    }
+
+    /**
+     * Moves the file, e.g. to a temporary directory in unit tests. Pending writes are dropped
+     * and the file is read again on the next load(); the owner has to forget its data itself.
+     * @param {?string} path Absolute path, or null to go back to the default one
+     */
+    public setPath(path: string | null) {
+        this._saveDebounced.cancel();
+        this._path = path;
+        this._loadPromise = null;
+        this._directoryPromise = null;
+    }
+
+    /**
+     * Reads the file and passes its data to options.deserialize(), the first time only
+     * @return {!$.Promise} Resolved once the data is loaded, never rejected
+     */
+    public load(): JQueryPromise<any> {
+        if (!this._loadPromise) {
+            const options = this._options;
+            const result = $.Deferred();
+            let data = null;
+
+            FileUtils.readAsText(FileSystem.getFileForPath(this.getPath()))
+                .done(function (text) {
+                    try {
+                        data = JSON.parse(text!);
+                    } catch (err) {
+                        console.error("[" + options.logName + "] Ignoring corrupt cache: " + err);
+                    }
+                })
+                .always(function () {
+                    options.deserialize(data);
+                    result.resolve();
+                });
+            this._loadPromise = result.promise();
+        }
+        return this._loadPromise;
+    }
+
+    /**
+     * Writes the data returned by options.serialize() once no change was scheduled for
+     * options.saveDelay milliseconds
+     */
+    public scheduleSave() {
+        this._saveDebounced();
+    }
+
+    /**
+     * Writes another file to the directory of the cache, creating the directory if needed
+     * @param {!string} name File name
+     * @param {!string} content
+     * @return {!$.Promise} Resolved when the file is written
+     */
+    public writeFile(name: string, content: string): JQueryPromise<any> {
+        const path = this.getDirectory() + "/" + name;
+        return this._ensureDirectory().then(function () {
+            return PersistentCache._write(path, content);
+        });
+    }
+
+    private static _write(path: string, content: string): JQueryPromise<any> {
+        const result = $.Deferred();
+
+        FileSystem.getFileForPath(path).write(content, { blind: true, atomic: true }, function (err) {
+            if (err) {
+                result.reject(err);
+            } else {
+                result.resolve();
+            }
+        });
+
+        return result.promise();
+    }
+
+    private _ensureDirectory(): JQueryPromise<any> {
+        if (!this._directoryPromise) {
+            this._directoryPromise = _createDirectory(this.getDirectory());
+        }
+        return this._directoryPromise;
+    }
+
+    private _save() {
+        const path = this.getPath();
+        const logName = this._options.logName;
+        const content = JSON.stringify(this._options.serialize());
+
+        this._ensureDirectory().then(function () {
+            return PersistentCache._write(path, content);
+        }).fail(function (err) {
+            console.error("[" + logName + "] Error -- could not write the cache: " + err);
+        });
+    }
+}
+
+export = PersistentCache;
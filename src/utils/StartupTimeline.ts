@@ -0,0 +1,203 @@
+/*
+ * Copyright (c) 2018 - present The quadre code authors. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ *
+ */
+
+/**
+ * StartupTimeline records the named phases of the renderer's startup as Chrome trace events
+ * (the format read by chrome://tracing and the DevTools performance panel). Once startup is
+ * complete the events are handed to the shell, which merges them with the phases of the main
+ * process and the preload script and can write them to a file (see app/startup-trace.ts).
+ *
+ * Unlike PerfUtils, which aggregates durations by name, the timeline keeps absolute timestamps
+ * (microseconds since the epoch) so that phases of different processes line up. Nothing is
+ * recorded after finish(), so code that also runs long after startup can call it freely.
+ */
+
+// make sure the global brackets variable is loaded
+import "utils/Global";
+
+interface TraceEvent {
+    name: string;
+    cat: string;
+    ph: string;
+    ts: number;
+    dur?: number;
+    pid: number;
+    tid: number;
+    id?: string;
+    args?: {};
+}
+
+const CATEGORY = "startup";
+
+const _pid = (window as any).node ? (window as any).node.process.pid : 0;
+
+let _events: Array<TraceEvent> = [];
+let _openPhases: { [name: string]: number } = {};
+let _finished = false;
+
+/**
+ * Current time in the unit of the timeline, microseconds since the epoch
+ * @return {number}
+ */
+export function now() {
+    return Math.round((performance.timeOrigin + performance.now()) * 1000);
+}
+
+function _msToTimestamp(ms) {
+    return Math.round(ms * 1000);
+}
+
+/**
+ * Adds a phase that has already completed.
+ * @param {!string} name
+ * @param {!number} start Start time, as returned by now()
+ * @param {!number} end End time, as returned by now()
+ * @param {Object=} args Shown with the phase in trace viewers
+ */
+export function addPhase(name, start, end, args?) {
+    if (_finished) {
+        return;
+    }
+    _events.push({ name: name, cat: CATEGORY, ph: "X", ts: start, dur: end - start, pid: _pid, tid: 0, args: args });
+}
+
+/**
+ * Starts a phase. Phases started with begin() must nest, use beginAsync() for
+ * work that overlaps with other phases, like loading extensions in parallel.
+ * @param {!string} name
+ */
+export function begin(name) {
+    if (_finished) {
+        return;
+    }
+    _openPhases[name] = now();
+}
+
+/**
+ * Ends a phase started with begin(). Does nothing if the phase isn't running.
+ * @param {!string} name
+ * @param {Object=} args Shown with the phase in trace viewers
+ */
+export function end(name, args?) {
+    const start = _openPhases[name];
+    if (start !== undefined) {
+        delete _openPhases[name];
+        addPhase(name, start, now(), args);
+    }
+}
+
+/**
+ * Starts a phase that may overlap with others.
+ * @param {!string} category Groups related phases, e.g. "extension"
+ * @param {!string} name
+ */
+export function beginAsync(category, name) {
+    if (_finished) {
+        return;
+    }
+    _events.push({ name: name, cat: category, ph: "b", ts: now(), pid: _pid, tid: 0, id: category + ":" + name });
+}
+
+/**
+ * Ends a phase started with beginAsync()
+ * @param {!string} category
+ * @param {!string} name
+ */
+export function endAsync(category, name) {
+    if (_finished) {
+        return;
+    }
+    _events.push({ name: name, cat: category, ph: "e", ts: now(), pid: _pid, tid: 0, id: category + ":" + name });
+}
+
+/**
+ * Records a point in time.
+ * @param {!string} name
+ */
+export function mark(name) {
+    if (_finished) {
+        return;
+    }
+    _events.push({ name: name, cat: CATEGORY, ph: "i", ts: now(), pid: _pid, tid: 0 });
+}
+
+/**
+ * @private
+ * Phases the browser measured before any of our code ran
+ */
+function _getNavigationPhases(): Array<TraceEvent> {
+    const timing = performance.timing;
+    const origin = timing.navigationStart;
+
+    function phase(name, start, end) {
+        return { name: name, cat: CATEGORY, ph: "X", ts: _msToTimestamp(start), dur: _msToTimestamp(end - start), pid: _pid, tid: 0 };
+    }
+
+    if (!origin || !timing.domContentLoadedEventEnd) {
+        return [];
+    }
+
+    return [
+        phase("renderer: fetch index.html", origin, timing.responseEnd),
+        phase("renderer: parse index.html", timing.responseEnd, timing.domInteractive),
+        phase("renderer: DOMContentLoaded", timing.domContentLoadedEventStart, timing.domContentLoadedEventEnd)
+    ];
+}
+
+/**
+ * Returns the trace events recorded so far, in Chrome trace event format.
+ * @return {{traceEvents: Array.<Object>, displayTimeUnit: string}}
+ */
+export function getTrace() {
+    return {
+        traceEvents: _getNavigationPhases().concat(_events),
+        displayTimeUnit: "ms"
+    };
+}
+
+/**
+ * Marks the end of startup and hands the recorded events to the shell.
+ * Phases that are still running are left out. Only the first call has an effect.
+ */
+export function finish() {
+    if (_finished) {
+        return;
+    }
+    mark("startup complete");
+    _finished = true;
+    _openPhases = {};
+
+    if (brackets.app.reportStartupTrace) {
+        brackets.app.reportStartupTrace(getTrace().traceEvents, true);
+    }
+}
+
+/**
+ * @private
+ * Forgets all recorded events, for unit tests.
+ */
+export function _reset() {
+    _events = [];
+    _openPhases = {};
+    _finished = false;
+}
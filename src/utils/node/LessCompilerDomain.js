@@ -0,0 +1,125 @@
+/*
+ * Copyright (c) 2018 - present The quadre code authors. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ *
+ */
+
+/*eslint-env node */
+/*jslint node: true */
+"use strict";
+
+var less = require("less");
+
+/**
+ * Turns a file:// URL into a path, node's file manager only reads paths.
+ * @param {string} url
+ * @return {string}
+ */
+function toPath(url) {
+    if (url && url.indexOf("file://") === 0) {
+        url = decodeURI(url.replace(/^file:\/\/(localhost)?/, ""));
+        // file:///C:/... on Windows
+        if (/^\/[A-Za-z]:\//.test(url)) {
+            url = url.substr(1);
+        }
+    }
+    return url;
+}
+
+/**
+ * Compiles LESS code. Relative imports are read from the directory of options.filename.
+ * @param {string} code
+ * @param {Object} options Options for less.render()
+ * @param {function(?Error, {css: string, imports: Array.<string>})} callback
+ */
+function cmdRender(code, options, callback) {
+    options = Object.assign({}, options);
+    if (options.filename) {
+        options.filename = toPath(options.filename);
+    }
+    if (options.currentFileInfo) {
+        options.currentFileInfo = Object.assign({}, options.currentFileInfo, {
+            currentDirectory: toPath(options.currentFileInfo.currentDirectory),
+            entryPath: toPath(options.currentFileInfo.entryPath),
+            filename: toPath(options.currentFileInfo.filename),
+            rootFilename: toPath(options.currentFileInfo.rootFilename)
+        });
+    }
+
+    less.render(code, options).then(function (output) {
+        callback(null, { css: output.css, imports: output.imports });
+    }, function (err) {
+        callback(err);
+    });
+}
+
+/**
+ * Returns the version of the compiler, which is part of the cache keys of LessCache
+ * @return {string}
+ */
+function cmdGetVersion() {
+    return less.version.join(".");
+}
+
+/**
+ * Initializes the domain
+ * @param {DomainManager} domainManager
+ */
+function init(domainManager) {
+    if (!domainManager.hasDomain("lessCompiler")) {
+        domainManager.registerDomain("lessCompiler", {major: 0, minor: 1});
+    }
+    domainManager.registerCommand(
+        "lessCompiler",
+        "render",
+        cmdRender,
+        true,
+        "Compiles LESS code to CSS",
+        [{
+            name: "code",
+            type: "string",
+            description: "LESS code"
+        }, {
+            name: "options",
+            type: "object",
+            description: "options passed to less.render()"
+        }],
+        [{
+            name: "result",
+            type: "{css: string, imports: Array.<string>}",
+            description: "CSS code and the files imported while compiling"
+        }]
+    );
+    domainManager.registerCommand(
+        "lessCompiler",
+        "getVersion",
+        cmdGetVersion,
+        false,
+        "Returns the version of the compiler",
+        [],
+        [{
+            name: "version",
+            type: "string",
+            description: "version of less, e.g. \"3.9.0\""
+        }]
+    );
+}
+
+exports.init = init;
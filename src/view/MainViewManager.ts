@@ -1140,7 +1140,10 @@ function _createPaneIfNecessary(paneId) {
             }
         });
         newPane.on("viewDestroy.mainView", function (e, view) {
-            _removeFileFromMRU(newPane.id, view.getFile());
+            // Hibernated editors stay in the view list, and in the MRU list
+            if (newPane.findInViewList(view.getFile().fullPath) === -1) {
+                _removeFileFromMRU(newPane.id, view.getFile());
+            }
         });
     }
 
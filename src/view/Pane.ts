@@ -59,9 +59,19 @@
  *  - currentViewChange - Whenever the current view changes.
  *             (e, newView:View, oldView:View)
  *
- *  - viewDestroy - Whenever a view has been destroyed
+ *  - viewDestroy - Whenever a view has been destroyed, including editors that are hibernated
  *             (e, view:View)
  *
+ * Editor Hibernation:
+ *
+ * Editors of files in the view list stay alive until the file is removed from the pane, so tabbing through
+ * a large working set used to keep a CodeMirror instance alive for every file shown once. When a pane has
+ * more editors than the `pane.maxLiveEditors` preference allows, the editors of the least recently used files
+ * are hibernated: their view state is stored in `ViewStateManager`, their undo history is kept by the pane
+ * and the editor is destroyed. The file stays in the view list and opening it again creates a new editor,
+ * which gets the view state and undo history back. Only editors of unmodified documents without inline
+ * widgets are hibernated, since their text can be read from disk again.
+ *
  * View Interface:
  *
  * The view is an anonymous object which has the following method signatures. see ImageViewer for an example or the sample
@@ -188,6 +198,11 @@ interface ViewMap {
     [fullpath: string]: View;
 }
 
+interface HibernatedEditor {
+    diskTimestamp: number;
+    history: any;
+}
+
 interface State {
     file: string;
     active: boolean;
@@ -222,6 +237,12 @@ PreferencesManager.definePreference("pane.mergePanesWhenLastFileClosed", "boolea
     description: Strings.DESCRIPTION_MERGE_PANES_WHEN_LAST_FILE_CLOSED
 });
 
+// Define maxLiveEditors, the number of editors a pane keeps alive before it hibernates
+// the editors of the least recently used files. 0 keeps all editors alive.
+PreferencesManager.definePreference("pane.maxLiveEditors", "number", 20, {
+    description: Strings.DESCRIPTION_MAX_LIVE_EDITORS
+});
+
 /**
  * Make an index request object
  * @param {boolean} requestIndex - true to request an index, false if not
@@ -349,6 +370,13 @@ export class Pane {
      */
     private _currentView: View | null = null;
 
+    /**
+     * Undo history of the hibernated editors, by path
+     * @type {Object.<string, HibernatedEditor>}
+     * @private
+     */
+    private _hibernatedEditors: { [fullPath: string]: HibernatedEditor } = {};
+
     /**
      * The last thing that received a focus event
      * @type {?DomElement}
@@ -531,6 +559,7 @@ export class Pane {
         this._viewListAddedOrder = [];
         this._views = {};
         this._currentView = null;
+        this._hibernatedEditors = {};
         this.showInterstitial(true);
     }
 
@@ -633,6 +662,11 @@ export class Pane {
             // insert the view into the working set
             destinationPane._addToViewList(file,  _makeIndexRequestObject(true, destinationIndex));
 
+            if (self._hibernatedEditors.hasOwnProperty(file.fullPath)) {
+                destinationPane._hibernatedEditors[file.fullPath] = self._hibernatedEditors[file.fullPath];
+                delete self._hibernatedEditors[file.fullPath];
+            }
+
             // if we had a view, it had previously been opened
             // otherwise, the file was in the working set unopened
             if (view) {
@@ -678,6 +712,7 @@ export class Pane {
         this._viewList = _.union(this._viewList, other._viewList);
         this._viewListMRUOrder = _.union(this._viewListMRUOrder, other._viewListMRUOrder);
         this._viewListAddedOrder = _.union(this._viewListAddedOrder, other._viewListAddedOrder);
+        _.extend(this._hibernatedEditors, other._hibernatedEditors);
 
         const self = this;
         const viewsToDestroy: Array<View> = [];
@@ -965,6 +1000,7 @@ export class Pane {
             this._viewListMRUOrder.splice(this.findInViewListMRUOrder(file.fullPath), 1);
             this._viewListAddedOrder.splice(this.findInViewListAddedOrder(file.fullPath), 1);
         }
+        delete this._hibernatedEditors[file.fullPath];
 
         // Destroy the view
         const view = this._views[file.fullPath];
@@ -1115,6 +1151,10 @@ export class Pane {
             this._views[newname] = view;
             delete this._views[oldname];
         }
+        if (this._hibernatedEditors.hasOwnProperty(oldname)) {
+            this._hibernatedEditors[newname] = this._hibernatedEditors[oldname];
+            delete this._hibernatedEditors[oldname];
+        }
 
         this.updateHeaderText();
 
@@ -1175,6 +1215,11 @@ export class Pane {
             this._views[path] = view;
         }
 
+        if (this._hibernatedEditors.hasOwnProperty(path)) {
+            this._wakeEditor(view, this._hibernatedEditors[path]);
+            delete this._hibernatedEditors[path];
+        }
+
         // Ensure that we don't endup marking the custom views
         if (view.markPaneId) {
             view.markPaneId(this.id);
@@ -1233,12 +1278,76 @@ export class Pane {
         if (oldView) {
             this.destroyViewIfNotNeeded(oldView);
         }
+        this._hibernateEditors();
 
         if (!this._views.hasOwnProperty(newPath)) {
             console.error(newPath + " found in pane working set but pane.addView() has not been called for the view created for it");
         }
     }
 
+    /**
+     * Hibernates the editors of the least recently used files that exceed the pane.maxLiveEditors budget
+     * @private
+     */
+    private _hibernateEditors() {
+        const maxLiveEditors = PreferencesManager.get("pane.maxLiveEditors");
+        if (!maxLiveEditors || maxLiveEditors < 0) {
+            return;
+        }
+
+        const self = this;
+        let liveEditors = 0;
+        this._viewListMRUOrder.forEach(function (file) {
+            const view: any = self._views[file.fullPath];
+            if (!view || !view._codeMirror || !view.document) {
+                return;
+            }
+
+            liveEditors++;
+            if (liveEditors > maxLiveEditors && view !== self._currentView &&
+                    !view.document.isDirty && view.document.diskTimestamp && !view.getInlineWidgets().length) {
+                self._hibernateEditor(view);
+            }
+        });
+    }
+
+    /**
+     * Stores the view state and undo history of an editor, then destroys it
+     * @param {!Editor} editor - editor of an unmodified document
+     * @private
+     */
+    private _hibernateEditor(editor) {
+        ViewStateManager.updateViewState(editor);
+        this._hibernatedEditors[editor.document.file.fullPath] = {
+            diskTimestamp: editor.document.diskTimestamp.getTime(),
+            history: editor._codeMirror.getHistory()
+        };
+        this._doDestroyView(editor);
+    }
+
+    /**
+     * Gives the undo history back to the new editor of a hibernated file, unless the file changed
+     * on disk meanwhile. The view state is restored by the view factory, like for other views.
+     * @param {!View} view - view that was just created for the file
+     * @param {!HibernatedEditor} hibernated
+     * @private
+     */
+    private _wakeEditor(view, hibernated: HibernatedEditor) {
+        const document = view.document;
+        if (view._codeMirror && document && !document.isDirty && document.diskTimestamp &&
+                document.diskTimestamp.getTime() === hibernated.diskTimestamp) {
+            view._codeMirror.setHistory(hibernated.history);
+        }
+    }
+
+    /**
+     * @param {!string} fullPath
+     * @return {boolean} true if the editor of the file was hibernated and hasn't been created again since
+     */
+    public isEditorHibernated(fullPath) {
+        return this._hibernatedEditors.hasOwnProperty(fullPath);
+    }
+
     /**
      * Update header and content height
      */
@@ -22,7 +22,6 @@
  */
 
 /*jslint regexp: true */
-/*global less */
 
 import * as _ from "lodash";
 import * as EventDispatcher from "utils/EventDispatcher";
@@ -30,6 +29,7 @@ import * as FileSystem from "filesystem/FileSystem";
 import * as FileUtils from "file/FileUtils";
 import * as EditorManager from "editor/EditorManager";
 import * as ExtensionUtils from "utils/ExtensionUtils";
+import * as LessCache from "utils/LessCache";
 import * as ThemeSettings from "view/ThemeSettings";
 import * as ThemeView from "view/ThemeView";
 import * as PreferencesManager from "preferences/PreferencesManager";
@@ -165,27 +165,17 @@ function fixPath(path) {
 /**
  * @private
  * Takes the content of a file and feeds it through the less processor in order
- * to provide support for less files.
+ * to provide support for less files. The resulting CSS is cached across sessions.
  *
  * @param {string} content is the css/less string to be processed
  * @param {Theme} theme is the object the css/less corresponds to
  * @return {$.Promise} promise with the processed css/less as the resolved value
  */
 function lessifyTheme(content, theme) {
-    const deferred = $.Deferred();
-
-    less.render("#editor-holder {" + content + "\n}", {
+    return LessCache.render("#editor-holder {" + content + "\n}", {
         rootpath: fixPath(stylesPath),
         filename: fixPath(theme.file._path)
-    }, function (err, tree) {
-        if (err) {
-            deferred.reject(err);
-        } else {
-            deferred.resolve(tree.css);
-        }
     });
-
-    return deferred.promise();
 }
 
 /**
@@ -0,0 +1,202 @@
+/*
+ * Copyright (c) 2018 - present The quadre code authors. All rights reserved.
+ * @license MIT
+ *
+ */
+
+"use strict";
+
+const common       = require("./lib/common");
+const file         = require("./lib/file");
+const childProcess = require("child_process");
+const os           = require("os");
+const path         = require("path");
+const fs           = require("fs-extra");
+const gulp         = require("gulp");
+const log          = require("fancy-log");
+const PluginError  = require("plugin-error");
+const { argv }     = require("yargs");
+
+const taskName = "benchmark-startup";
+
+// Marked by StartupTimeline.finish() in the renderer
+const STARTUP_COMPLETE = "startup complete";
+
+/**
+ * Seeds the user data directory of a run with the project to open, so the app
+ * neither shows the getting started project nor the first launch notifications.
+ */
+function prepareUserData(userDataDir, projectPath) {
+    const state = {
+        projectPath: projectPath.replace(/\\/g, "/").replace(/\/?$/, "/"),
+        afterFirstLaunch: "true"
+    };
+    fs.ensureDirSync(userDataDir);
+    // Started from the repo the app runs as dev build and uses state-dev.json
+    ["state.json", "state-dev.json"].forEach(function (name) {
+        const statePath = path.join(userDataDir, name);
+        if (!fs.existsSync(statePath)) {
+            common.writeJSON(statePath, state);
+        }
+    });
+}
+
+function launch(tracePath, userDataDir) {
+    const electron = path.join("node_modules", ".bin", "electron");
+    const args = [
+        ".",
+        "--trace-startup=" + tracePath,
+        "--quit-after-startup",
+        "--user-data-dir=" + userDataDir
+    ];
+
+    return new Promise(function (resolve, reject) {
+        const cp = childProcess.spawn(electron, args, { cwd: process.cwd(), shell: process.platform === "win32" });
+        cp.on("error", reject);
+        cp.on("exit", function (code) {
+            if (code !== 0) {
+                return reject(new Error("Process exited with code " + code));
+            }
+            if (!fs.existsSync(tracePath)) {
+                return reject(new Error("No startup trace was written to " + tracePath));
+            }
+            resolve(file.readJSON(tracePath));
+        });
+    });
+}
+
+/**
+ * Sums the durations of the complete ("X") events of one trace by name and
+ * adds the total time from the first event to the end of startup.
+ */
+function getPhaseDurations(trace) {
+    const events = trace.traceEvents;
+    const durations = {};
+    let first = Infinity;
+    let complete = null;
+
+    events.forEach(function (event) {
+        first = Math.min(first, event.ts);
+        if (event.ph === "X") {
+            durations[event.name] = (durations[event.name] || 0) + event.dur / 1000;
+        } else if (event.name === STARTUP_COMPLETE) {
+            complete = event.ts;
+        }
+    });
+
+    if (complete !== null) {
+        durations.total = (complete - first) / 1000;
+    }
+    return durations;
+}
+
+function percentile(values, p) {
+    const sorted = values.slice().sort(function (a, b) { return a - b; });
+    const index = Math.min(sorted.length - 1, Math.ceil(p / 100 * sorted.length) - 1);
+    return sorted[Math.max(0, index)];
+}
+
+function summarize(runs) {
+    const summary = {};
+    runs.forEach(function (durations) {
+        Object.keys(durations).forEach(function (name) {
+            summary[name] = summary[name] || [];
+            summary[name].push(durations[name]);
+        });
+    });
+    Object.keys(summary).forEach(function (name) {
+        const values = summary[name];
+        summary[name] = {
+            runs: values.length,
+            p50: Math.round(percentile(values, 50) * 10) / 10,
+            p95: Math.round(percentile(values, 95) * 10) / 10
+        };
+    });
+    return summary;
+}
+
+function printSummary(summary, mode) {
+    const names = Object.keys(summary);
+    const width = Math.max.apply(null, names.map(function (name) { return name.length; }).concat([5]));
+    const pad = function (str, len) { return (str + " ".repeat(len)).substr(0, len); };
+    const padLeft = function (str, len) { return (" ".repeat(len) + str).substr(-len); };
+
+    log.info(mode + " start (ms)");
+    log.info(pad("phase", width) + padLeft("p50", 10) + padLeft("p95", 10));
+    names.forEach(function (name) {
+        log.info(pad(name, width) + padLeft(String(summary[name].p50), 10) + padLeft(String(summary[name].p95), 10));
+    });
+}
+
+/**
+ * Returns the phases whose p95 is above the budget, a JSON file mapping phase names to milliseconds
+ */
+function checkBudget(summary, budgetPath) {
+    const budget = file.readJSON(budgetPath);
+    return Object.keys(budget).filter(function (name) {
+        return summary[name] && summary[name].p95 > budget[name];
+    }).map(function (name) {
+        return name + ": p95 " + summary[name].p95 + "ms > " + budget[name] + "ms";
+    });
+}
+
+/**
+ * Launches the app --runs times on a fixture project and reports p50/p95 per startup phase.
+ * With --cold (the default) every run gets a fresh user data directory, --warm reuses one
+ * that was primed by an extra, unmeasured run. Headless Linux needs a display, e.g. xvfb-run.
+ */
+function benchmarkStartup(cb) {
+    const runs        = Number(argv["runs"]) || 10;
+    const mode        = argv["warm"] ? "warm" : "cold";
+    const projectPath = common.resolve(argv["project"] || "test/perf/OpenFile-perf-files");
+    const workDir     = fs.mkdtempSync(path.join(os.tmpdir(), "quadre-startup-"));
+    const warmDataDir = path.join(workDir, "user-data");
+    const durations   = [];
+
+    function userDataFor(run) {
+        return mode === "warm" ? warmDataDir : path.join(workDir, "user-data-" + run);
+    }
+
+    function measure(run) {
+        const userDataDir = userDataFor(run);
+        prepareUserData(userDataDir, projectPath);
+        return launch(path.join(workDir, "run-" + run + ".json"), userDataDir);
+    }
+
+    let promise = mode === "warm" ? measure("prime") : Promise.resolve();
+    for (let i = 0; i < runs; i++) {
+        promise = promise.then(function () {
+            return measure(i).then(function (trace) {
+                durations.push(getPhaseDurations(trace));
+            });
+        });
+    }
+
+    promise
+        .then(() => {
+            const summary = summarize(durations);
+            printSummary(summary, mode);
+
+            if (argv["results"]) {
+                common.writeJSON(common.resolve(argv["results"]), { mode: mode, runs: runs, phases: summary });
+            }
+
+            const overBudget = argv["budget"] ? checkBudget(summary, common.resolve(argv["budget"])) : [];
+            fs.removeSync(workDir);
+
+            if (overBudget.length) {
+                overBudget.forEach(function (msg) {
+                    log.error(msg);
+                });
+                return cb(new PluginError(taskName, overBudget.length + " phase(s) over budget"));
+            }
+            cb();
+        })
+        .catch((err) => {
+            log.error(err);
+            cb(new PluginError(taskName, err, { showStack: true }));
+        });
+}
+benchmarkStartup.description = "Measure cold or warm startup of the app, per phase";
+
+gulp.task(taskName, benchmarkStartup);
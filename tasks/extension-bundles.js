@@ -0,0 +1,110 @@
+/*
+ * Copyright (c) 2018 - present The quadre code authors. All rights reserved.
+ * @license MIT
+ *
+ */
+
+"use strict";
+
+const crypto = require("crypto");
+const fs = require("fs");
+const path = require("path");
+const gulp = require("gulp");
+const log = require("fancy-log");
+const requirejs = require("requirejs");
+const common = require("./lib/common");
+const file = require("./lib/file");
+
+const WWW_DIR = "dist/www";
+const EXTENSIONS_DIR = "dist/www/extensions/default";
+
+// Must match ExtensionBundleCache.BUNDLE_INDEX_FILENAME
+const BUNDLE_INDEX_FILENAME = "extension-bundles.json";
+
+// Modules the app provides to every extension context, see ExtensionLoader
+const EMPTY_PATHS = ["react", "react-dom", "fileSystemImpl"];
+
+function readRequireJSConfig(extensionDir) {
+    const configPath = path.join(extensionDir, "requirejs-config.json");
+    return fs.existsSync(configPath) ? file.readJSON(configPath) : {};
+}
+
+function bundleExtension(name) {
+    const extensionDir = common.resolve(path.join(EXTENSIONS_DIR, name));
+    const tempOut = path.join(extensionDir, "bundle.tmp.js");
+    const extensionConfig = readRequireJSConfig(extensionDir);
+    const paths = Object.assign({}, extensionConfig.paths, {
+        "text": common.resolve(path.join(WWW_DIR, "thirdparty/text/text")),
+        "i18n": common.resolve(path.join(WWW_DIR, "thirdparty/i18n/i18n"))
+    });
+    let included = [];
+
+    EMPTY_PATHS.forEach(function (id) {
+        paths[id] = "empty:";
+    });
+
+    return new Promise(function (resolve, reject) {
+        requirejs.optimize({
+            baseUrl: extensionDir,
+            name: "main",
+            out: tempOut,
+            paths: paths,
+            shim: extensionConfig.shim,
+            map: extensionConfig.map,
+            exclude: ["text", "i18n"],
+            inlineText: true,
+            optimize: "none",
+            logLevel: 4,
+            onModuleBundleComplete: function (data) {
+                included = data.included;
+            }
+        }, function () {
+            resolve();
+        }, reject);
+    }).then(function () {
+        const content = fs.readFileSync(tempOut, "utf8");
+        const hash = crypto.createHash("md5").update(content).digest("hex").substr(0, 8);
+        const bundle = name + "/bundle-" + hash + ".js";
+
+        fs.renameSync(tempOut, path.join(extensionDir, "bundle-" + hash + ".js"));
+
+        // Inlined plugin resources are named defines in the bundle, only list the modules
+        const modules = included.filter(function (relPath) {
+            return relPath.indexOf("!") === -1;
+        }).map(function (relPath) {
+            return relPath.replace(/\\/g, "/").replace(/\.js$/, "");
+        });
+
+        return { bundle: bundle, hash: hash, modules: modules };
+    });
+}
+
+function extensionBundles() {
+    // Written by "build-config", the version brackets.metadata will have at runtime
+    const appConfig = file.readJSON(path.join(WWW_DIR, "config.json"));
+    const index = {
+        version: appConfig.version,
+        extensions: {}
+    };
+
+    const names = fs.readdirSync(EXTENSIONS_DIR).filter(function (name) {
+        return fs.existsSync(path.join(EXTENSIONS_DIR, name, "main.js"));
+    });
+
+    // One at a time, the optimizer keeps global state while it runs
+    return names.reduce(function (promise, name) {
+        return promise.then(function () {
+            return bundleExtension(name).then(function (entry) {
+                index.extensions[name] = entry;
+            }, function (err) {
+                // The extension keeps loading module by module
+                log.warn("Could not bundle extension " + name + ": " + err);
+            });
+        });
+    }, Promise.resolve()).then(function () {
+        common.writeJSON(path.join(EXTENSIONS_DIR, BUNDLE_INDEX_FILENAME), index);
+    });
+}
+extensionBundles.description = "Bundle the module graph of each default extension for faster startup";
+
+gulp.task("extension-bundles", extensionBundles);
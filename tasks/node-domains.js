@@ -0,0 +1,94 @@
+/*
+ * Copyright (c) 2018 - present The quadre code authors. All rights reserved.
+ * @license MIT
+ *
+ */
+
+"use strict";
+
+const path = require("path");
+const gulp = require("gulp");
+const log = require("fancy-log");
+const PluginError = require("plugin-error");
+const common = require("./lib/common");
+
+const DIST_DIR = "dist";
+
+// Domains that must work in the packaged app, with the modules they require
+const DOMAINS = [
+    {
+        path: "www/utils/node/LessCompilerDomain.js",
+        modules: ["less"],
+        check: function (commands, cb) {
+            const version = commands.lessCompiler.getVersion();
+            commands.lessCompiler.render("@c: #fff; a { color: @c; }", {}, function (err, result) {
+                if (!err && result.css.indexOf("#fff") === -1) {
+                    err = new Error("unexpected output " + JSON.stringify(result.css));
+                }
+                cb(err, "less " + version);
+            });
+        }
+    }
+];
+
+// Records the commands a domain registers, the way DomainManager calls them
+function createDomainManager(commands) {
+    return {
+        hasDomain: function (domainName) {
+            return commands.hasOwnProperty(domainName);
+        },
+        registerDomain: function (domainName) {
+            commands[domainName] = commands[domainName] || {};
+        },
+        registerCommand: function (domainName, commandName, commandFunction) {
+            commands[domainName][commandName] = commandFunction;
+        },
+        registerEvent: function () {
+            // Events are not checked
+        },
+        emitEvent: function () {
+            // Events are not checked
+        }
+    };
+}
+
+function checkDomain(domain) {
+    const distDir = common.resolve(DIST_DIR);
+    const domainPath = path.join(distDir, domain.path);
+
+    return new Promise(function (resolve, reject) {
+        // The packaged app only has what "npm-install-dist" put in dist, a module found in the
+        // node_modules of the repository (devDependencies) would be missing there
+        domain.modules.forEach(function (name) {
+            const modulePath = require.resolve(name, { paths: [path.dirname(domainPath)] });
+            if (path.relative(distDir, modulePath).split(path.sep)[0] === "..") {
+                throw new Error(name + " is not installed in " + DIST_DIR + ", found " + modulePath);
+            }
+        });
+
+        const commands = {};
+        require(domainPath).init(createDomainManager(commands));
+        domain.check(commands, function (err, message) {
+            if (err) {
+                reject(err);
+            } else {
+                log.info(domain.path + ": " + message);
+                resolve();
+            }
+        });
+    }).catch(function (err) {
+        throw new Error(domain.path + ": " + err.message);
+    });
+}
+
+function nodeDomainsCheck(cb) {
+    Promise.all(DOMAINS.map(checkDomain)).then(function () {
+        cb();
+    }, function (err) {
+        log.error(err.message);
+        cb(new PluginError("node-domains-check", err));
+    });
+}
+nodeDomainsCheck.description = "Make sure the node domains load with the modules installed in the dist folder";
+
+gulp.task("node-domains-check", nodeDomainsCheck);
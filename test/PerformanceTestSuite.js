@@ -27,4 +27,12 @@ define(function (require, exports, module) {
 
     // Each suite or spec must have this.category === "performance" to be filtered properly
     require("perf/Performance-test");
+    require("perf/CodeFolding-test");
+    require("perf/DocumentManager-test");
+    require("perf/PreferencesSystem-test");
+    require("perf/FileFilters-test");
+    require("perf/KeyBindingManager-test");
+    require("perf/NodeConnection-test");
+    require("perf/EditorHibernation-test");
+    require("perf/CodeHints-test");
 });
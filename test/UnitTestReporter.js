@@ -413,6 +413,17 @@ define(function (require, exports, module) {
         this._currentPerfUtils = null;
     };
 
+    /**
+     * Records a value measured by the spec itself, e.g. a heap size, for the current running spec.
+     * @param {string} name Name to print with the value
+     * @param {*} value
+     */
+    UnitTestReporter.prototype.logValue = function (name, value) {
+        if (this._currentPerfRecord) {
+            this._currentPerfRecord.push({ name: name, value: value });
+        }
+    };
+
     /**
      * Clears the current set of performance measurements.
      */
@@ -46,6 +46,7 @@ define(function (require, exports, module) {
     require("spec/ExtensionInstallation-test");
     require("spec/ExtensionLoader-test");
     require("spec/ExtensionManager-test");
+    require("spec/ExtensionMonitor-test");
     require("spec/ExtensionUtils-test");
     require("spec/FileFilters-test");
     require("spec/FileSystem-test");
@@ -0,0 +1,125 @@
+/*
+ * Copyright (c) 2018 - present The quadre code authors. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ *
+ */
+
+define(function (require, exports, module) {
+    "use strict";
+
+    var CommandManager,             // loaded from brackets.test
+        Commands,                   // loaded from brackets.test
+        EditorManager,              // loaded from brackets.test
+        ExtensionLoader,            // loaded from brackets.test
+        PerfUtils,                  // loaded from brackets.test
+        SpecRunnerUtils             = require("spec/SpecRunnerUtils"),
+        UnitTestReporter            = require("test/UnitTestReporter");
+
+    var COPIES = 3,
+        NUM_FOLDS = 300,
+        NUM_VIEWPORTS = 300,
+        VIEWPORT_SIZE = 60;
+
+    var testPath = SpecRunnerUtils.getTestPath("/perf/OpenFile-perf-files/");
+
+    describe("CodeFolding Performance", function () {
+
+        this.category = "performance";
+
+        var testWindow;
+
+        beforeEach(function () {
+            SpecRunnerUtils.createTestWindowAndRun(this, function (w) {
+                testWindow = w;
+
+                CommandManager  = testWindow.brackets.test.CommandManager;
+                Commands        = testWindow.brackets.test.Commands;
+                EditorManager   = testWindow.brackets.test.EditorManager;
+                ExtensionLoader = testWindow.brackets.test.ExtensionLoader;
+                PerfUtils       = testWindow.brackets.test.PerfUtils;
+            });
+        });
+
+        afterEach(function () {
+            testWindow      = null;
+            CommandManager  = null;
+            Commands        = null;
+            EditorManager   = null;
+            ExtensionLoader = null;
+            PerfUtils       = null;
+            SpecRunnerUtils.closeTestWindow();
+        });
+
+        it("should update the fold gutter while scrolling a large file with many folds", function () {
+            runs(function () {
+                var promise = CommandManager.execute(Commands.FILE_OPEN, {fullPath: testPath + "jquery.mobile-1.1.0.js"});
+                waitsForDone(promise, "open file");
+            });
+
+            runs(function () {
+                var editor = EditorManager.getCurrentFullEditor(),
+                    cm = editor._codeMirror,
+                    foldGutter = ExtensionLoader.getRequireContextForExtension("CodeFolding")("foldhelpers/foldgutter"),
+                    text = editor.document.getText(),
+                    step,
+                    i;
+
+                // About 20k lines
+                editor.document.setText(new Array(COPIES + 1).join(text + "\n"));
+
+                step = Math.floor(cm.lineCount() / NUM_FOLDS);
+                for (i = 0; i < cm.lineCount() && Object.keys(cm._lineFolds).length < NUM_FOLDS; i += step) {
+                    cm.foldCode(i);
+                }
+
+                function scroll() {
+                    var lineCount = cm.lineCount(),
+                        n,
+                        from;
+                    for (n = 0; n < NUM_VIEWPORTS; n++) {
+                        from = Math.floor(n * (lineCount - VIEWPORT_SIZE) / NUM_VIEWPORTS);
+                        foldGutter.updateInViewport(cm, from, from + VIEWPORT_SIZE);
+                    }
+                }
+
+                // Finds the ranges of the lines that come into view for the first time
+                var firstTimer = PerfUtils.markStart("CodeFolding first scroll x" + NUM_VIEWPORTS);
+                scroll();
+                PerfUtils.addMeasurement(firstTimer);
+
+                var scrollTimer = PerfUtils.markStart("CodeFolding scroll x" + NUM_VIEWPORTS);
+                scroll();
+                PerfUtils.addMeasurement(scrollTimer);
+
+                // An edit near the top only drops the ranges that depend on the edited lines
+                cm.replaceRange("\n", {line: 10, ch: 0});
+                var editTimer = PerfUtils.markStart("CodeFolding scroll after edit x" + NUM_VIEWPORTS);
+                scroll();
+                PerfUtils.addMeasurement(editTimer);
+
+                expect(Object.keys(cm._lineFolds).length).toBeGreaterThan(0);
+
+                var reporter = UnitTestReporter.getActiveReporter();
+                reporter.logTestWindow(/CodeFolding/);
+                reporter.clearTestWindow();
+            });
+        });
+    });
+});
@@ -0,0 +1,178 @@
+/*
+ * Copyright (c) 2018 - present The quadre code authors. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ *
+ */
+
+
+define(function (require, exports, module) {
+    "use strict";
+
+    var CodeHintManager,            // loaded from brackets.test
+        EditorManager,              // loaded from brackets.test
+        FileSystem,                 // loaded from brackets.test
+        PerfUtils,                  // loaded from brackets.test
+        SpecRunnerUtils             = require("spec/SpecRunnerUtils"),
+        UnitTestReporter            = require("test/UnitTestReporter");
+
+    var NUM_ROUNDS = 20;
+
+    /**
+     * Each scenario types text at a position of a file, one character after the other, while
+     * the hint list is open
+     */
+    var SCENARIOS = [
+        {
+            name: "CSS property names",
+            file: "style.css",
+            content: "body {\n    \n}\n",
+            pos: { line: 1, ch: 4 },
+            text: "border-bottom-color"
+        },
+        {
+            name: "CSS property values",
+            file: "style.css",
+            content: "body {\n    color: \n}\n",
+            pos: { line: 1, ch: 11 },
+            text: "lightgoldenrodyellow"
+        },
+        {
+            name: "HTML tags",
+            file: "index.html",
+            content: "<html>\n<body>\n\n</body>\n</html>\n",
+            pos: { line: 2, ch: 0 },
+            text: "<blockquote"
+        },
+        {
+            name: "HTML attributes",
+            file: "index.html",
+            content: "<html>\n<body>\n<div \n</body>\n</html>\n",
+            pos: { line: 2, ch: 5 },
+            text: "contenteditable"
+        }
+    ];
+
+    describe("Code Hints Performance", function () {
+
+        this.category = "performance";
+
+        var testWindow,
+            tempDir = SpecRunnerUtils.getTempDirectory();
+
+        beforeFirst(function () {
+            SpecRunnerUtils.createTempDirectory();
+        });
+
+        afterLast(function () {
+            SpecRunnerUtils.removeTempDirectory();
+        });
+
+        beforeEach(function () {
+            SpecRunnerUtils.createTestWindowAndRun(this, function (w) {
+                testWindow = w;
+
+                CodeHintManager = testWindow.brackets.test.CodeHintManager;
+                EditorManager   = testWindow.brackets.test.EditorManager;
+                FileSystem      = testWindow.brackets.test.FileSystem;
+                PerfUtils       = testWindow.brackets.test.PerfUtils;
+            });
+
+            runs(function () {
+                var promises = [
+                    SpecRunnerUtils.createTextFile(tempDir + "/style.css", "", FileSystem),
+                    SpecRunnerUtils.createTextFile(tempDir + "/index.html", "", FileSystem)
+                ];
+                waitsForDone($.when.apply($, promises), "create the files");
+            });
+
+            SpecRunnerUtils.loadProjectInTestWindow(tempDir);
+        });
+
+        afterEach(function () {
+            testWindow      = null;
+            CodeHintManager = null;
+            EditorManager   = null;
+            FileSystem      = null;
+            PerfUtils       = null;
+            SpecRunnerUtils.closeTestWindow();
+        });
+
+        /**
+         * Types a character like the keyboard does: the keypress tells CodeHintManager which
+         * character was typed, the change of the document updates the hint list
+         * @return {number} Time spent handling the change, in ms
+         */
+        function typeCharacter(editor, character) {
+            var start;
+
+            editor.trigger("keypress", editor, { charCode: character.charCodeAt(0) });
+
+            start = testWindow.performance.now();
+            editor.document.replaceRange(character, editor.getCursorPos(), undefined, "+input");
+            return testWindow.performance.now() - start;
+        }
+
+        function measureScenario(scenario) {
+            runs(function () {
+                waitsForDone(SpecRunnerUtils.openProjectFiles([scenario.file]), "open " + scenario.file);
+            });
+
+            runs(function () {
+                var editor = EditorManager.getCurrentFullEditor(),
+                    latencies = [],
+                    listOpen = 0,
+                    timer = PerfUtils.markStart("Code hints " + scenario.name + ": type " + NUM_ROUNDS + " x " + scenario.text.length + " characters"),
+                    round,
+                    i;
+
+                for (round = 0; round < NUM_ROUNDS; round++) {
+                    editor.document.setText(scenario.content);
+                    editor.setCursorPos(scenario.pos);
+
+                    for (i = 0; i < scenario.text.length; i++) {
+                        latencies.push(typeCharacter(editor, scenario.text[i]));
+                        if (CodeHintManager.isOpen()) {
+                            listOpen++;
+                        }
+                    }
+                }
+                PerfUtils.addMeasurement(timer);
+
+                latencies.sort(function (a, b) { return a - b; });
+
+                var reporter = UnitTestReporter.getActiveReporter();
+                reporter.logValue("Code hints " + scenario.name + ": median keystroke (ms)", latencies[Math.floor(latencies.length / 2)].toFixed(2));
+                reporter.logValue("Code hints " + scenario.name + ": p95 keystroke (ms)", latencies[Math.ceil(latencies.length * 0.95) - 1].toFixed(2));
+
+                // Otherwise the scenario measured typing, not hinting
+                expect(listOpen).toBeGreaterThan(0);
+
+                reporter.logTestWindow(/Code hints/);
+                reporter.clearTestWindow();
+            });
+        }
+
+        SCENARIOS.forEach(function (scenario) {
+            it("should update the " + scenario.name + " hints while typing", function () {
+                measureScenario(scenario);
+            });
+        });
+    });
+});
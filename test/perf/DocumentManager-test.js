@@ -0,0 +1,98 @@
+/*
+ * Copyright (c) 2018 - present The quadre code authors. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ *
+ */
+
+define(function (require, exports, module) {
+    "use strict";
+
+    var DocumentManager,            // loaded from brackets.test
+        PerfUtils,                  // loaded from brackets.test
+        SpecRunnerUtils             = require("spec/SpecRunnerUtils"),
+        UnitTestReporter            = require("test/UnitTestReporter");
+
+    var NUM_OPEN_DOCUMENTS = 500,
+        NUM_LOOKUPS = 20000;
+
+    describe("DocumentManager Performance", function () {
+
+        this.category = "performance";
+
+        var testWindow;
+
+        beforeEach(function () {
+            SpecRunnerUtils.createTestWindowAndRun(this, function (w) {
+                testWindow = w;
+
+                DocumentManager = testWindow.brackets.test.DocumentManager;
+                PerfUtils       = testWindow.brackets.test.PerfUtils;
+            });
+        });
+
+        afterEach(function () {
+            testWindow      = null;
+            DocumentManager = null;
+            PerfUtils       = null;
+            SpecRunnerUtils.closeTestWindow();
+        });
+
+        it("should look up open documents by path", function () {
+            var docs = [],
+                paths = [],
+                found = 0,
+                i;
+
+            for (i = 0; i < NUM_OPEN_DOCUMENTS; i++) {
+                docs.push(DocumentManager.createUntitledDocument(i, ".js"));
+                docs[i].addRef();
+            }
+
+            // Mostly misses, like a replace across many files that aren't open
+            for (i = 0; i < NUM_LOOKUPS; i++) {
+                paths.push(i % 10 === 0 ? docs[i % NUM_OPEN_DOCUMENTS].file.fullPath : "/perf/notOpen" + i + ".js");
+            }
+
+            var lookupTimer = PerfUtils.markStart("DocumentManager.getOpenDocumentForPath x" + NUM_LOOKUPS);
+            paths.forEach(function (path) {
+                if (DocumentManager.getOpenDocumentForPath(path)) {
+                    found++;
+                }
+            });
+            PerfUtils.addMeasurement(lookupTimer);
+
+            var listTimer = PerfUtils.markStart("DocumentManager.getAllOpenDocuments x" + NUM_OPEN_DOCUMENTS);
+            for (i = 0; i < NUM_OPEN_DOCUMENTS; i++) {
+                DocumentManager.getAllOpenDocuments();
+            }
+            PerfUtils.addMeasurement(listTimer);
+
+            docs.forEach(function (doc) {
+                doc.releaseRef();
+            });
+
+            expect(found).toBe(NUM_LOOKUPS / 10);
+
+            var reporter = UnitTestReporter.getActiveReporter();
+            reporter.logTestWindow(/DocumentManager\./);
+            reporter.clearTestWindow();
+        });
+    });
+});
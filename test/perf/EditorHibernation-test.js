@@ -0,0 +1,164 @@
+/*
+ * Copyright (c) 2018 - present The quadre code authors. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ *
+ */
+
+define(function (require, exports, module) {
+    "use strict";
+
+    var CommandManager,             // loaded from brackets.test
+        Commands,                   // loaded from brackets.test
+        FileSystem,                 // loaded from brackets.test
+        MainViewManager,            // loaded from brackets.test
+        PerfUtils,                  // loaded from brackets.test
+        PreferencesManager,         // loaded from brackets.test
+        SpecRunnerUtils             = require("spec/SpecRunnerUtils"),
+        UnitTestReporter            = require("test/UnitTestReporter");
+
+    var NUM_FILES = 60,
+        MAX_LIVE_EDITORS = 10,
+        SOURCE_FILE = SpecRunnerUtils.getTestPath("/perf/OpenFile-perf-files/jquery.mobile-1.1.0.js");
+
+    describe("Editor Hibernation Performance", function () {
+
+        this.category = "performance";
+
+        var testWindow,
+            tempDir = SpecRunnerUtils.getTempDirectory();
+
+        beforeFirst(function () {
+            SpecRunnerUtils.createTempDirectory();
+        });
+
+        afterLast(function () {
+            SpecRunnerUtils.removeTempDirectory();
+        });
+
+        beforeEach(function () {
+            SpecRunnerUtils.createTestWindowAndRun(this, function (w) {
+                testWindow = w;
+
+                CommandManager     = testWindow.brackets.test.CommandManager;
+                Commands           = testWindow.brackets.test.Commands;
+                FileSystem         = testWindow.brackets.test.FileSystem;
+                MainViewManager    = testWindow.brackets.test.MainViewManager;
+                PerfUtils          = testWindow.brackets.test.PerfUtils;
+                PreferencesManager = testWindow.brackets.test.PreferencesManager;
+            });
+
+            runs(function () {
+                var deferred = $.Deferred();
+                FileSystem.getFileForPath(SOURCE_FILE).read({}, function (err, text) {
+                    if (err) {
+                        deferred.reject(err);
+                        return;
+                    }
+                    var i,
+                        promises = [];
+                    for (i = 0; i < NUM_FILES; i++) {
+                        promises.push(SpecRunnerUtils.createTextFile(tempDir + "/file" + i + ".js", text, FileSystem));
+                    }
+                    $.when.apply($, promises).then(deferred.resolve, deferred.reject);
+                });
+                waitsForDone(deferred.promise(), "create the files");
+            });
+
+            SpecRunnerUtils.loadProjectInTestWindow(tempDir);
+        });
+
+        afterEach(function () {
+            PreferencesManager.set("pane.maxLiveEditors", undefined);
+            MainViewManager._closeAll(MainViewManager.ALL_PANES);
+            testWindow         = null;
+            CommandManager     = null;
+            Commands           = null;
+            FileSystem         = null;
+            MainViewManager    = null;
+            PerfUtils          = null;
+            PreferencesManager = null;
+            SpecRunnerUtils.closeTestWindow();
+        });
+
+        function usedHeapSize() {
+            // Only precise when the test window was started with --expose-gc
+            if (testWindow.gc) {
+                testWindow.gc();
+            }
+            return testWindow.performance.memory ? testWindow.performance.memory.usedJSHeapSize : 0;
+        }
+
+        function openFile(i) {
+            return CommandManager.execute(Commands.CMD_ADD_TO_WORKINGSET_AND_OPEN, { fullPath: tempDir + "/file" + i + ".js" });
+        }
+
+        /**
+         * Opens every file in the working set one after the other, then shows the first one again,
+         * and records the heap growth and how long showing the first file took
+         */
+        function measureWorkingSet(maxLiveEditors) {
+            var label = "Editor hibernation " + (maxLiveEditors ? maxLiveEditors + " live editors" : "off"),
+                heapBefore;
+
+            runs(function () {
+                PreferencesManager.set("pane.maxLiveEditors", maxLiveEditors);
+                heapBefore = usedHeapSize();
+
+                var timer = PerfUtils.markStart(label + ": open " + NUM_FILES + " files"),
+                    promise = openFile(0),
+                    i;
+
+                for (i = 1; i < NUM_FILES; i++) {
+                    promise = promise.then(openFile.bind(null, i));
+                }
+                promise.done(function () {
+                    PerfUtils.addMeasurement(timer);
+                });
+                waitsForDone(promise, "open the files", 60000);
+            });
+
+            runs(function () {
+                var reporter = UnitTestReporter.getActiveReporter();
+                reporter.logValue(label + ": heap growth (MB)", Math.round((usedHeapSize() - heapBefore) / 1024 / 1024));
+
+                var timer = PerfUtils.markStart(label + ": show the least recently used file");
+                waitsForDone(openFile(0).done(function () {
+                    PerfUtils.addMeasurement(timer);
+                }), "show the first file");
+            });
+
+            runs(function () {
+                expect(MainViewManager.getWorkingSetSize(MainViewManager.ALL_PANES)).toBe(NUM_FILES);
+
+                var reporter = UnitTestReporter.getActiveReporter();
+                reporter.logTestWindow(/Editor hibernation/);
+                reporter.clearTestWindow();
+            });
+        }
+
+        it("should keep every editor alive", function () {
+            measureWorkingSet(0);
+        });
+
+        it("should hibernate the least recently used editors", function () {
+            measureWorkingSet(MAX_LIVE_EDITORS);
+        });
+    });
+});
@@ -0,0 +1,126 @@
+/*
+ * Copyright (c) 2018 - present The quadre code authors. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ *
+ */
+
+define(function (require, exports, module) {
+    "use strict";
+
+    var FileFilters,                // loaded from brackets.test
+        PerfUtils,                  // loaded from brackets.test
+        SpecRunnerUtils             = require("spec/SpecRunnerUtils"),
+        UnitTestReporter            = require("test/UnitTestReporter");
+
+    var NUM_GLOBS = 60,
+        NUM_PATHS = 200000;
+
+    /**
+     * Exclusion globs like the ones people collect over time: folder names,
+     * extensions and a few globs with wildcards in the middle.
+     */
+    function makeGlobs() {
+        var globs = [],
+            i;
+
+        for (i = 0; i < NUM_GLOBS; i++) {
+            switch (i % 4) {
+                case 0:
+                    globs.push("/vendor" + i + "/");
+                    break;
+                case 1:
+                    globs.push("*.gen" + i + ".js");
+                    break;
+                case 2:
+                    globs.push("build" + i);
+                    break;
+                default:
+                    globs.push("/out" + i + "/**/*.map");
+            }
+        }
+        return globs;
+    }
+
+    describe("FileFilters Performance", function () {
+
+        this.category = "performance";
+
+        var testWindow;
+
+        beforeEach(function () {
+            SpecRunnerUtils.createTestWindowAndRun(this, function (w) {
+                testWindow = w;
+
+                FileFilters = testWindow.brackets.test.FileFilters;
+                PerfUtils   = testWindow.brackets.test.PerfUtils;
+            });
+        });
+
+        afterEach(function () {
+            testWindow  = null;
+            FileFilters = null;
+            PerfUtils   = null;
+            SpecRunnerUtils.closeTestWindow();
+        });
+
+        it("should filter many paths against many globs", function () {
+            var filter = FileFilters.compile(makeGlobs()),
+                paths = [],
+                files,
+                passed = 0,
+                i;
+
+            // One in a hundred paths is excluded
+            for (i = 0; i < NUM_PATHS; i++) {
+                paths.push(i % 100 === 0 ?
+                        "/project/vendor4/lib/file" + i + ".js" :
+                        "/project/src/module" + (i % 500) + "/sub/file" + i + ".js");
+            }
+            files = paths.map(function (path) {
+                return { fullPath: path };
+            });
+
+            // Like _inSearchScope() during incremental updates
+            var pathTimer = PerfUtils.markStart("FileFilters.filterPath x" + NUM_PATHS);
+            paths.forEach(function (path) {
+                if (FileFilters.filterPath(filter, path)) {
+                    passed++;
+                }
+            });
+            PerfUtils.addMeasurement(pathTimer);
+
+            var listTimer = PerfUtils.markStart("FileFilters.filterFileList x" + NUM_PATHS);
+            var filtered = FileFilters.filterFileList(filter, files);
+            PerfUtils.addMeasurement(listTimer);
+
+            var matchingTimer = PerfUtils.markStart("FileFilters.getPathsMatchingFilter x" + NUM_PATHS);
+            var matching = FileFilters.getPathsMatchingFilter(filter, paths);
+            PerfUtils.addMeasurement(matchingTimer);
+
+            expect(passed).toBe(NUM_PATHS - NUM_PATHS / 100);
+            expect(filtered.length).toBe(passed);
+            expect(matching.length).toBe(NUM_PATHS / 100);
+
+            var reporter = UnitTestReporter.getActiveReporter();
+            reporter.logTestWindow(/FileFilters\./);
+            reporter.clearTestWindow();
+        });
+    });
+});
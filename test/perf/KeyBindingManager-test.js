@@ -0,0 +1,139 @@
+/*
+ * Copyright (c) 2018 - present The quadre code authors. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ *
+ */
+
+define(function (require, exports, module) {
+    "use strict";
+
+    var CommandManager,             // loaded from brackets.test
+        KeyBindingManager,          // loaded from brackets.test
+        PerfUtils,                  // loaded from brackets.test
+        SpecRunnerUtils             = require("spec/SpecRunnerUtils"),
+        UnitTestReporter            = require("test/UnitTestReporter");
+
+    var NUM_COMMANDS = 2000,
+        NUM_KEYSTROKES = 50000,
+        MODIFIERS = ["Ctrl-", "Alt-", "Ctrl-Alt-", "Ctrl-Shift-", "Alt-Shift-", "Ctrl-Alt-Shift-"],
+        KEYS = "ABCDEFGHIJKLMNOPQRSTUVWXYZ0123456789".split("");
+
+    function makeKeyEvent(keyCode, ctrlKey, altKey, shiftKey) {
+        return {
+            keyCode: keyCode,
+            ctrlKey: ctrlKey,
+            altKey: altKey,
+            shiftKey: shiftKey,
+            metaKey: false,
+            stopPropagation: function () {},
+            preventDefault: function () {}
+        };
+    }
+
+    describe("KeyBindingManager Performance", function () {
+
+        this.category = "performance";
+
+        var testWindow;
+
+        beforeEach(function () {
+            SpecRunnerUtils.createTestWindowAndRun(this, function (w) {
+                testWindow = w;
+
+                CommandManager      = testWindow.brackets.test.CommandManager;
+                KeyBindingManager   = testWindow.brackets.test.KeyBindingManager;
+                PerfUtils           = testWindow.brackets.test.PerfUtils;
+            });
+        });
+
+        afterEach(function () {
+            testWindow          = null;
+            CommandManager      = null;
+            KeyBindingManager   = null;
+            PerfUtils           = null;
+            SpecRunnerUtils.closeTestWindow();
+        });
+
+        it("should dispatch keystrokes with many registered commands", function () {
+            var executed = 0,
+                bindings = [],
+                typing = [],
+                shortcuts = [],
+                i;
+
+            function execute() {
+                executed++;
+            }
+
+            // Like a setup with many extensions, a few hundred of the commands have a shortcut
+            for (i = 0; i < NUM_COMMANDS; i++) {
+                CommandManager.register("Perf Command " + i, "perf.command" + i, execute);
+                if (i < MODIFIERS.length * KEYS.length) {
+                    bindings.push({
+                        commandID: "perf.command" + i,
+                        key: MODIFIERS[i % MODIFIERS.length] + KEYS[Math.floor(i / MODIFIERS.length)]
+                    });
+                }
+            }
+
+            // Don't let the core bindings of these keys get in the way
+            bindings.forEach(function (binding) {
+                KeyBindingManager.removeBinding(binding.key);
+            });
+
+            var addTimer = PerfUtils.markStart("KeyBindingManager.addBinding x" + bindings.length);
+            bindings.forEach(function (binding) {
+                KeyBindingManager.addBinding(binding.commandID, binding.key);
+            });
+            PerfUtils.addMeasurement(addTimer);
+
+            for (i = 0; i < KEYS.length; i++) {
+                // Typing without modifiers, none of which is bound
+                typing.push(makeKeyEvent(KEYS[i].charCodeAt(0), false, false, false));
+                // Ctrl-Alt-Shift shortcuts, all of which are bound
+                shortcuts.push(makeKeyEvent(KEYS[i].charCodeAt(0), true, true, true));
+            }
+
+            var typingTimer = PerfUtils.markStart("KeyBindingManager typing x" + NUM_KEYSTROKES);
+            for (i = 0; i < NUM_KEYSTROKES; i++) {
+                KeyBindingManager._handleKeyEvent(typing[i % typing.length]);
+            }
+            PerfUtils.addMeasurement(typingTimer);
+
+            var shortcutTimer = PerfUtils.markStart("KeyBindingManager shortcuts x" + NUM_KEYSTROKES);
+            for (i = 0; i < NUM_KEYSTROKES; i++) {
+                KeyBindingManager._handleKeyEvent(shortcuts[i % shortcuts.length]);
+            }
+            PerfUtils.addMeasurement(shortcutTimer);
+
+            var removeTimer = PerfUtils.markStart("KeyBindingManager.removeBinding x" + bindings.length);
+            bindings.forEach(function (binding) {
+                KeyBindingManager.removeBinding(binding.key);
+            });
+            PerfUtils.addMeasurement(removeTimer);
+
+            expect(executed).toBe(NUM_KEYSTROKES);
+
+            var reporter = UnitTestReporter.getActiveReporter();
+            reporter.logTestWindow(/KeyBindingManager/);
+            reporter.clearTestWindow();
+        });
+    });
+});
@@ -0,0 +1,108 @@
+/*
+ * Copyright (c) 2018 - present The quadre code authors. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ *
+ */
+
+/*eslint-env node */
+/*jslint node: true */
+"use strict";
+
+var LINE = "    var message = \"a \\\"quoted\\\" string\";\tcallSomething(message, 42); // comment\n";
+
+/**
+ * Payloads like the ones domains send, built once so that building them isn't measured
+ * @type {Object.<string, *>}
+ */
+var _payloads = {};
+
+function repeatLine(length) {
+    return new Array(Math.ceil(length / LINE.length) + 1).join(LINE);
+}
+
+function buildPayload(kind) {
+    var i;
+
+    switch (kind) {
+    case "small":
+        return { ok: true, path: "/project/src/main.js", mtime: 1234567890 };
+    case "searchResults":
+        // Like FindInFiles results: many small matches
+        var results = {};
+        for (i = 0; i < 5000; i++) {
+            var path = "/project/src/module" + (i % 100) + ".js";
+            results[path] = results[path] || { matches: [] };
+            results[path].matches.push({
+                start: { line: i, ch: 4 },
+                end: { line: i, ch: 11 },
+                line: LINE,
+                isChecked: true
+            });
+        }
+        return results;
+    case "fileText":
+        // Like the text of a file sent to Tern
+        return { path: "/project/src/big.js", text: repeatLine(1024 * 1024) };
+    case "fileTexts":
+        var files = [];
+        for (i = 0; i < 50; i++) {
+            files.push({ path: "/project/src/file" + i + ".js", text: repeatLine(20 * 1024) });
+        }
+        return files;
+    case "buffer":
+        var buffer = Buffer.alloc(256 * 1024);
+        for (i = 0; i < buffer.length; i++) {
+            buffer[i] = i % 256;
+        }
+        return buffer;
+    }
+    return null;
+}
+
+/**
+ * @param {string} kind One of "small", "searchResults", "fileText", "fileTexts" or "buffer"
+ * @return {*}
+ */
+function cmdGetPayload(kind) {
+    if (!_payloads.hasOwnProperty(kind)) {
+        _payloads[kind] = buildPayload(kind);
+    }
+    return _payloads[kind];
+}
+
+/**
+ * @param {DomainManager} domainManager
+ */
+function init(domainManager) {
+    if (!domainManager.hasDomain("payloadTest")) {
+        domainManager.registerDomain("payloadTest", {major: 0, minor: 1});
+    }
+    domainManager.registerCommand(
+        "payloadTest",
+        "getPayload",
+        cmdGetPayload,
+        false,
+        "Returns a payload of the given kind",
+        [{name: "kind", type: "string"}],
+        [{name: "payload", type: "*"}]
+    );
+}
+
+exports.init = init;
@@ -0,0 +1,136 @@
+/*
+ * Copyright (c) 2018 - present The quadre code authors. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ *
+ */
+
+define(function (require, exports, module) {
+    "use strict";
+
+    var NodeConnection,             // loaded from brackets.test
+        PerfUtils,                  // loaded from brackets.test
+        SpecRunnerUtils             = require("spec/SpecRunnerUtils"),
+        UnitTestReporter            = require("test/UnitTestReporter");
+
+    var TIMEOUT = 60000,
+        ROUND_TRIPS = 20,
+        PAYLOADS = ["small", "searchResults", "fileText", "fileTexts", "buffer"];
+
+    var domainPath = SpecRunnerUtils.getTestPath("/perf/NodeConnection-perf-files/PayloadDomain");
+
+    describe("NodeConnection Performance", function () {
+
+        this.category = "performance";
+
+        var testWindow,
+            connection;
+
+        beforeEach(function () {
+            SpecRunnerUtils.createTestWindowAndRun(this, function (w) {
+                testWindow = w;
+
+                NodeConnection = testWindow.brackets.getModule("utils/NodeConnection");
+                PerfUtils      = testWindow.brackets.test.PerfUtils;
+            });
+        });
+
+        afterEach(function () {
+            if (connection) {
+                connection.disconnect();
+            }
+            NodeConnection._setBinaryFraming(true);
+            testWindow     = null;
+            connection     = null;
+            NodeConnection = null;
+            PerfUtils      = null;
+            SpecRunnerUtils.closeTestWindow();
+        });
+
+        /**
+         * Requests every payload ROUND_TRIPS times, one request after the other,
+         * and measures the time until the last response was received
+         */
+        function measurePayloads(binaryFraming) {
+            var done = false;
+
+            runs(function () {
+                NodeConnection._setBinaryFraming(binaryFraming);
+                connection = new NodeConnection();
+
+                var framing = binaryFraming ? "binary" : "JSON";
+                var promise = connection.connect(false).then(function () {
+                    return connection.loadDomains(domainPath, false);
+                });
+
+                PAYLOADS.forEach(function (kind) {
+                    promise = promise.then(function () {
+                        // Warm up, the domain builds each payload on the first request
+                        return connection.domains.payloadTest.getPayload(kind);
+                    }).then(function () {
+                        var timer = PerfUtils.markStart("NodeConnection " + kind + " " + framing + " x" + ROUND_TRIPS),
+                            next = connection.domains.payloadTest.getPayload(kind),
+                            i;
+
+                        for (i = 1; i < ROUND_TRIPS; i++) {
+                            next = next.then(function () {
+                                return connection.domains.payloadTest.getPayload(kind);
+                            });
+                        }
+                        return next.then(function (payload) {
+                            PerfUtils.addMeasurement(timer);
+                            expect(payload).toBeTruthy();
+                        });
+                    });
+                });
+
+                promise.always(function () {
+                    expect(promise.state()).toBe("resolved");
+                    done = true;
+                });
+            });
+
+            waitsFor(function () {
+                return done;
+            }, "the payloads to be received", TIMEOUT);
+        }
+
+        it("should receive payloads as JSON text", function () {
+            measurePayloads(false);
+
+            runs(function () {
+                var reporter = UnitTestReporter.getActiveReporter();
+                reporter.logTestWindow(/NodeConnection/);
+                reporter.clearTestWindow();
+            });
+        });
+
+        it("should receive payloads as binary frames", function () {
+            measurePayloads(true);
+
+            runs(function () {
+                expect(connection._binaryFraming).toBe(true);
+
+                var reporter = UnitTestReporter.getActiveReporter();
+                reporter.logTestWindow(/NodeConnection/);
+                reporter.clearTestWindow();
+            });
+        });
+    });
+});
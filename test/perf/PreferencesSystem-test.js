@@ -0,0 +1,142 @@
+/*
+ * Copyright (c) 2018 - present The quadre code authors. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ *
+ */
+
+define(function (require, exports, module) {
+    "use strict";
+
+    var PreferencesBase,            // loaded from brackets.test
+        PerfUtils,                  // loaded from brackets.test
+        SpecRunnerUtils             = require("spec/SpecRunnerUtils"),
+        UnitTestReporter            = require("test/UnitTestReporter");
+
+    var NUM_PATH_OVERRIDES = 200,
+        NUM_FILES = 50,
+        NUM_LOOKUPS = 20000,
+        EDITOR_PREFS = ["spaceUnits", "tabSize", "useTabChar", "wordWrap", "closeBrackets", "linting.enabled"],
+        LANGUAGES = ["javascript", "html", "css", "markdown"];
+
+    /**
+     * A project .brackets.json with many path overrides, most of which
+     * don't match the files that are edited.
+     */
+    function makeProjectPrefs() {
+        var data = {
+                spaceUnits: 4,
+                path: {},
+                language: {}
+            },
+            i;
+
+        for (i = 0; i < NUM_PATH_OVERRIDES; i++) {
+            data.path["vendor/lib" + i + "/**.js"] = {
+                spaceUnits: 2,
+                "linting.enabled": false
+            };
+        }
+        data.path["src/**/*.css"] = { tabSize: 2 };
+        LANGUAGES.forEach(function (language) {
+            data.language[language] = { wordWrap: language === "markdown" };
+        });
+        return data;
+    }
+
+    describe("PreferencesSystem Performance", function () {
+
+        this.category = "performance";
+
+        var testWindow;
+
+        beforeEach(function () {
+            SpecRunnerUtils.createTestWindowAndRun(this, function (w) {
+                testWindow = w;
+
+                PreferencesBase = testWindow.brackets.getModule("preferences/PreferencesBase");
+                PerfUtils       = testWindow.brackets.test.PerfUtils;
+            });
+        });
+
+        afterEach(function () {
+            testWindow      = null;
+            PreferencesBase = null;
+            PerfUtils       = null;
+            SpecRunnerUtils.closeTestWindow();
+        });
+
+        it("should resolve editor preferences for many files", function () {
+            var pm = new PreferencesBase.PreferencesSystem(),
+                projectScope = new PreferencesBase.Scope(new PreferencesBase.MemoryStorage(makeProjectPrefs())),
+                contexts = [],
+                lookups = 0,
+                i;
+
+            projectScope.addLayer(new PreferencesBase.PathLayer("/project/.brackets.json"));
+            projectScope.addLayer(new PreferencesBase.LanguageLayer());
+            pm.addScope("user", new PreferencesBase.MemoryStorage({ useTabChar: false }));
+            pm.addScope("project", projectScope);
+            EDITOR_PREFS.forEach(function (id) {
+                pm.definePreference(id, "number", 0);
+            });
+
+            for (i = 0; i < NUM_FILES; i++) {
+                contexts.push({
+                    path: "/project/src/module" + i + "/file" + i + (i % 2 ? ".js" : ".css"),
+                    language: LANGUAGES[i % LANGUAGES.length]
+                });
+            }
+
+            function lookup() {
+                var n;
+                for (n = 0; n < NUM_LOOKUPS; n++) {
+                    pm.get(EDITOR_PREFS[n % EDITOR_PREFS.length], contexts[n % NUM_FILES]);
+                    lookups++;
+                }
+            }
+
+            // Every lookup resolves through all scopes and globs
+            var uncachedTimer = PerfUtils.markStart("PreferencesSystem.get uncached x" + NUM_LOOKUPS);
+            for (i = 0; i < NUM_LOOKUPS; i++) {
+                pm._clearResolved();
+                pm.get(EDITOR_PREFS[i % EDITOR_PREFS.length], contexts[i % NUM_FILES]);
+            }
+            PerfUtils.addMeasurement(uncachedTimer);
+
+            // Like editors reading their options on every pane switch and change
+            var cachedTimer = PerfUtils.markStart("PreferencesSystem.get x" + NUM_LOOKUPS);
+            lookup();
+            PerfUtils.addMeasurement(cachedTimer);
+
+            // A preference change in between only drops the values of that preference
+            var changeTimer = PerfUtils.markStart("PreferencesSystem.get after change x" + NUM_LOOKUPS);
+            pm.set("spaceUnits", 3, { location: { scope: "user" } });
+            lookup();
+            PerfUtils.addMeasurement(changeTimer);
+
+            expect(lookups).toBe(2 * NUM_LOOKUPS);
+            expect(pm.get("spaceUnits", contexts[0])).toBe(4);
+
+            var reporter = UnitTestReporter.getActiveReporter();
+            reporter.logTestWindow(/PreferencesSystem\.get/);
+            reporter.clearTestWindow();
+        });
+    });
+});
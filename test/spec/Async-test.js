@@ -423,6 +423,87 @@ define(function (require, exports, module) {
             });
         });
 
+        describe("doInParallelLimited_aggregateErrors", function () {
+            var deferreds, started, inFlight, maxInFlight;
+
+            beforeEach(function () {
+                deferreds = [];
+                started = [];
+                inFlight = 0;
+                maxInFlight = 0;
+            });
+
+            function beginItem(item) {
+                var deferred = new $.Deferred();
+                deferreds[item] = deferred;
+                started.push(item);
+                inFlight++;
+                maxInFlight = Math.max(maxInFlight, inFlight);
+                deferred.always(function () {
+                    inFlight--;
+                });
+                return deferred.promise();
+            }
+
+            it("should never run more than maxConcurrent tasks at once", function () {
+                var done = false;
+
+                Async.doInParallelLimited_aggregateErrors([0, 1, 2, 3, 4], beginItem, 2).done(function () {
+                    done = true;
+                });
+
+                expect(started).toEqual([0, 1]);
+                deferreds[1].resolve();
+                expect(started).toEqual([0, 1, 2]);
+                deferreds[0].resolve();
+                deferreds[2].resolve();
+                deferreds[3].resolve();
+                expect(done).toBe(false);
+                deferreds[4].resolve();
+
+                expect(done).toBe(true);
+                expect(maxInFlight).toBe(2);
+            });
+
+            it("should report progress and aggregate errors from failed tasks", function () {
+                var progress = [],
+                    errors;
+
+                Async.doInParallelLimited_aggregateErrors([0, 1, 2], beginItem, 2)
+                    .progress(function (numCompleted, numTotal) {
+                        progress.push(numCompleted + "/" + numTotal);
+                    })
+                    .fail(function (err) {
+                        errors = err;
+                    });
+
+                deferreds[0].reject("bad");
+                deferreds[1].resolve();
+                deferreds[2].resolve();
+
+                expect(progress).toEqual(["1/3", "2/3", "3/3"]);
+                expect(errors).toEqual([{ item: 0, error: "bad" }]);
+            });
+
+            it("should handle many synchronously completing tasks", function () {
+                var items = [],
+                    done = false,
+                    i;
+
+                for (i = 0; i < 10000; i++) {
+                    items.push(i);
+                }
+
+                Async.doInParallelLimited_aggregateErrors(items, function () {
+                    return new $.Deferred().resolve().promise();
+                }, 4).done(function () {
+                    done = true;
+                });
+
+                expect(done).toBe(true);
+            });
+        });
+
         describe("Async PromiseQueue", function () {
             var queue, calledFns;
 
@@ -1990,6 +1990,58 @@ define(function (require, exports, module) {
                     });
                 });
             });
+
+            describe("Selector index", function () {
+
+                function findRules(selector) {
+                    var rules = null;
+                    runs(function () {
+                        var promise = CSSUtils.findMatchingRules(selector)
+                            .done(function (result) { rules = result; });
+                        waitsForDone(promise, "CSSUtils.findMatchingRules()");
+                    });
+                    return function () {
+                        return rules;
+                    };
+                }
+
+                it("should not read the stylesheets again until they change", function () {
+                    var FileUtils = testWindow.brackets.getModule("file/FileUtils"),
+                        rules;
+
+                    findRules("html");
+                    runs(function () {
+                        spyOn(FileUtils, "readAsText").andCallThrough();
+                    });
+                    rules = findRules("#issue403");
+                    runs(function () {
+                        expect(rules().length).toBe(1);
+                        expect(FileUtils.readAsText).not.toHaveBeenCalled();
+                    });
+                });
+
+                it("should drop the text of a document that is closed without saving", function () {
+                    var rules;
+
+                    runs(function () {
+                        var promise = FileViewController.openAndSelectDocument(testPath + "/simple.css", FileViewController.PROJECT_MANAGER);
+                        waitsForDone(promise, "FileViewController.openAndSelectDocument()");
+                    });
+                    runs(function () {
+                        var doc = DocumentManager.getCurrentDocument();
+                        doc.setText(doc.getText() + "\n\n.TESTSELECTOR {\n    font-size: 12px;\n}\n");
+                    });
+                    rules = findRules(".TESTSELECTOR");
+                    runs(function () {
+                        expect(rules().length).toBe(1);
+                    });
+                    testWindow.closeAllFiles();
+                    rules = findRules(".TESTSELECTOR");
+                    runs(function () {
+                        expect(rules().length).toBe(0);
+                    });
+                });
+            });
         });
 
     }); //describe("CSS Parsing")
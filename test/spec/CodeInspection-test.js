@@ -489,6 +489,183 @@ define(function (require, exports, module) {
                 });
             });
 
+            describe("Providers running in workers", function () {
+                var workerModule = SpecRunnerUtils.getTestPath("/spec/CodeInspection-test-worker/LineCountLinter.js"),
+                    InspectionCache;
+
+                beforeEach(function () {
+                    // Start every spec without cached results
+                    InspectionCache = testWindow.brackets.getModule("language/InspectionCache");
+                    InspectionCache._setCachePath(SpecRunnerUtils.getTempDirectory() + "/inspection-cache-" + Date.now() + ".json");
+                });
+
+                afterEach(function () {
+                    InspectionCache._setCachePath(null);
+                    InspectionCache = null;
+                });
+
+                function createWorkerCodeInspector(name, options) {
+                    var provider = {
+                        name: name,
+                        workerModule: workerModule,
+                        getWorkerOptions: function () {
+                            return options;
+                        },
+                        scanFile: function () {
+                            return successfulLintResult();
+                        }
+                    };
+                    spyOn(provider, "scanFile").andCallThrough();
+
+                    return provider;
+                }
+
+                it("should run the provider module in a worker", function () {
+                    var provider = createWorkerCodeInspector("javascript worker linter", { prefix: "lines: " }),
+                        result;
+                    CodeInspection.register("javascript", provider);
+
+                    runs(function () {
+                        var promise = CodeInspection.inspectFile(simpleJavascriptFileEntry);
+                        promise.done(function (r) {
+                            result = r;
+                        });
+
+                        waitsForDone(promise, "file linting", 5000);
+                    });
+
+                    runs(function () {
+                        expect(provider.scanFile).not.toHaveBeenCalled();
+                        expect(result[0].result.errors.length).toBe(1);
+                        expect(result[0].result.errors[0].message).toMatch(/^lines: \d+$/);
+                        expect(result[0].result.errors[0].type).toBe(CodeInspection.Type.ERROR);
+                    });
+                });
+
+                it("should resolve a superseded scan of the same file with null", function () {
+                    var provider = createWorkerCodeInspector("javascript worker linter", { prefix: "lines: " }),
+                        first,
+                        second;
+                    CodeInspection.register("javascript", provider);
+
+                    runs(function () {
+                        var firstPromise = provider.scanFileAsync("a\nb", "/test/superseded.js"),
+                            secondPromise = provider.scanFileAsync("a\nb\nc", "/test/superseded.js");
+
+                        firstPromise.done(function (r) {
+                            first = r;
+                        });
+                        secondPromise.done(function (r) {
+                            second = r;
+                        });
+
+                        waitsForDone(secondPromise, "file linting", 5000);
+                    });
+
+                    runs(function () {
+                        expect(first).toBe(null);
+                        expect(second.errors[0].message).toBe("lines: 3");
+                    });
+                });
+
+                it("should reuse the cached result when the text and options didn't change", function () {
+                    var provider = createWorkerCodeInspector("javascript worker linter", { prefix: "lines: " }),
+                        InspectionWorkerPool = testWindow.brackets.getModule("language/InspectionWorkerPool").InspectionWorkerPool,
+                        results = [];
+                    CodeInspection.register("javascript", provider);
+                    spyOn(InspectionWorkerPool.prototype, "scan").andCallThrough();
+
+                    runs(function () {
+                        waitsForDone(provider.scanFileAsync("a\nb", "/test/cached.js").done(function (r) {
+                            results.push(r);
+                        }), "file linting", 5000);
+                    });
+
+                    runs(function () {
+                        waitsForDone(provider.scanFileAsync("a\nb", "/test/cached.js").done(function (r) {
+                            results.push(r);
+                        }), "file linting", 5000);
+                    });
+
+                    runs(function () {
+                        expect(InspectionWorkerPool.prototype.scan.callCount).toBe(1);
+                        expect(results[1]).toEqual(results[0]);
+                        expect(results[1].errors[0].message).toBe("lines: 2");
+                    });
+                });
+
+                it("should keep the workers of a provider that is still registered for another language", function () {
+                    var provider = createWorkerCodeInspector("shared worker linter", { prefix: "lines: " }),
+                        replacement = createWorkerCodeInspector("shared worker linter", { prefix: "lines: " }),
+                        result;
+                    CodeInspection.register("javascript", provider);
+                    CodeInspection.register("css", provider);
+                    CodeInspection.register("css", replacement);
+
+                    runs(function () {
+                        waitsForDone(provider.scanFileAsync("a\nb", "/test/shared.js").done(function (r) {
+                            result = r;
+                        }), "file linting", 5000);
+                    });
+
+                    runs(function () {
+                        expect(provider.scanFile).not.toHaveBeenCalled();
+                        expect(result.errors[0].message).toBe("lines: 2");
+                    });
+                });
+
+                it("should give a provider that is registered again new workers", function () {
+                    var provider = createWorkerCodeInspector("javascript worker linter", { prefix: "lines: " }),
+                        result;
+                    CodeInspection.register("javascript", provider);
+                    CodeInspection._unregisterAll();
+                    expect(provider.scanFileAsync).toBeUndefined();
+
+                    CodeInspection.register("javascript", provider);
+
+                    runs(function () {
+                        waitsForDone(provider.scanFileAsync("a\nb\nc", "/test/again.js").done(function (r) {
+                            result = r;
+                        }), "file linting", 5000);
+                    });
+
+                    runs(function () {
+                        expect(provider.scanFile).not.toHaveBeenCalled();
+                        expect(result.errors[0].message).toBe("lines: 3");
+                    });
+                });
+
+                it("should not share cached results between modules or texts of the same length", function () {
+                    var key = InspectionCache.getKey("linter", "/a/worker.js", null, "abc");
+
+                    expect(InspectionCache.getKey("linter", "/a/worker.js", null, "abc")).toBe(key);
+                    expect(InspectionCache.getKey("linter", "/b/worker.js", null, "abc")).not.toBe(key);
+                    expect(InspectionCache.getKey("linter", "/a/worker.js", null, "abd")).not.toBe(key);
+                });
+
+                it("should report errors thrown by the provider module", function () {
+                    var provider = createWorkerCodeInspector("javascript failing worker linter", { fail: true }),
+                        result;
+                    CodeInspection.register("javascript", provider);
+
+                    runs(function () {
+                        var promise = CodeInspection.inspectFile(simpleJavascriptFileEntry);
+                        promise.done(function (r) {
+                            result = r;
+                        });
+
+                        waitsForDone(promise, "file linting", 5000);
+                    });
+
+                    runs(function () {
+                        expect(provider.scanFile).not.toHaveBeenCalled();
+                        expect(result[0].result.errors.length).toBe(1);
+                        expect(result[0].result.errors[0].message)
+                            .toBe(StringUtils.format(Strings.LINTER_FAILED, "javascript failing worker linter", "Linter failed on purpose"));
+                    });
+                });
+            });
+
             it("should support universal providers", function () {
                 var codeInspector1 = createCodeInspector("javascript linter", successfulLintResult());
                 var codeInspector2 = createCodeInspector("css linter", successfulLintResult());
@@ -548,6 +725,108 @@ define(function (require, exports, module) {
                 return StringUtils.format(Strings.STATUSBAR_CODE_INSPECTION_TOOLTIP, title);
             }
 
+            it("should list the problems of all project files when the project is inspected", function () {
+                var codeInspector = createCodeInspector("javascript linter", failLintResult());
+                CodeInspection.register("javascript", codeInspector);
+
+                runs(function () {
+                    CodeInspection.toggleProjectInspection(true);
+                });
+
+                // errors.js and no-errors.js have one problem each, errors.css has no linter
+                waitsFor(function () {
+                    return $("#problems-panel .title").text() === StringUtils.format(Strings.PROJECT_ERRORS_PANEL_TITLE, 2, 2);
+                }, "project inspection", 5000);
+
+                runs(function () {
+                    var paths = $("#problems-panel .inspector-section").map(function () {
+                        return $(this).attr("data-path");
+                    }).get();
+
+                    expect(paths).toEqual([testFolder + "errors.js", testFolder + "no-errors.js"]);
+                    expect($("#problems-panel").is(":visible")).toBe(true);
+
+                    CodeInspection.toggleProjectInspection(false);
+                });
+            });
+
+            it("should inspect again only the project files of a provider that requests a run", function () {
+                var jsInspector = createCodeInspector("javascript linter", failLintResult()),
+                    cssInspector = createCodeInspector("css linter", successfulLintResult()),
+                    jsCalls,
+                    cssCalls;
+                CodeInspection.register("javascript", jsInspector);
+                CodeInspection.register("css", cssInspector);
+
+                runs(function () {
+                    CodeInspection.toggleProjectInspection(true);
+                });
+
+                waitsFor(function () {
+                    return jsInspector.scanFile.callCount >= 2 && cssInspector.scanFile.callCount >= 1 &&
+                        $("#problems-panel .title").text() === StringUtils.format(Strings.PROJECT_ERRORS_PANEL_TITLE, 2, 2);
+                }, "project inspection", 5000);
+
+                runs(function () {
+                    jsCalls = jsInspector.scanFile.callCount;
+                    cssCalls = cssInspector.scanFile.callCount;
+                    CodeInspection.requestRun("javascript linter");
+                });
+
+                waitsFor(function () {
+                    return jsInspector.scanFile.callCount >= jsCalls + 2;
+                }, "javascript files to be inspected again", 5000);
+
+                // give a requeued css file the time to be inspected as well
+                waits(300);
+
+                runs(function () {
+                    expect(cssInspector.scanFile.callCount).toBe(cssCalls);
+
+                    CodeInspection.toggleProjectInspection(false);
+                });
+            });
+
+            it("should inspect only the added files when files are added to or removed from a directory", function () {
+                var codeInspector = createCodeInspector("javascript linter", failLintResult()),
+                    FileSystemInWindow,
+                    calls;
+                CodeInspection.register("javascript", codeInspector);
+
+                runs(function () {
+                    FileSystemInWindow = brackets.test.FileSystem;
+                    CodeInspection.toggleProjectInspection(true);
+                });
+
+                waitsFor(function () {
+                    return $("#problems-panel .title").text() === StringUtils.format(Strings.PROJECT_ERRORS_PANEL_TITLE, 2, 2);
+                }, "project inspection", 5000);
+
+                runs(function () {
+                    var directory = FileSystemInWindow.getDirectoryForPath(testFolder);
+
+                    calls = codeInspector.scanFile.callCount;
+                    FileSystemInWindow._fireChangeEvent(directory,
+                        [FileSystemInWindow.getFileForPath(testFolder + "errors.js")],
+                        [FileSystemInWindow.getFileForPath(testFolder + "no-errors.js")]);
+                });
+
+                waitsFor(function () {
+                    return codeInspector.scanFile.callCount === calls + 1;
+                }, "the added file to be inspected", 5000);
+
+                // give a requeued project file the time to be inspected as well
+                waits(300);
+
+                runs(function () {
+                    expect(codeInspector.scanFile.callCount).toBe(calls + 1);
+                    expect(codeInspector.scanFile.mostRecentCall.args[1]).toBe(testFolder + "errors.js");
+                    expect($("#problems-panel .title").text()).toBe(StringUtils.format(Strings.PROJECT_ERRORS_PANEL_TITLE, 1, 1));
+
+                    CodeInspection.toggleProjectInspection(false);
+                });
+            });
+
             it("should run test linter when a JavaScript document opens and indicate errors in the panel", function () {
                 var codeInspector = createCodeInspector("javascript linter", failLintResult());
                 CodeInspection.register("javascript", codeInspector);
@@ -108,5 +108,21 @@ define(function (require, exports, module) {
             expect(eventTriggered).toBeTruthy();
             expect(command.getName()).toBe("newName");
         });
+
+        it("execute a placeholder by registering the real command first", function () {
+            var placeholder = CommandManager.registerPlaceholder(commandID, function () {
+                CommandManager.register("test command", commandID, testCommandFn);
+                return $.Deferred().resolve().promise();
+            });
+
+            expect(placeholder).toBeTruthy();
+            expect(CommandManager.getAll()).toEqual([]);
+
+            var promise = CommandManager.execute(commandID);
+            expect(promise.state()).toBe("resolved");
+            expect(executed).toBeTruthy();
+            expect(CommandManager.get(commandID)).not.toBe(placeholder);
+            expect(CommandManager.getAll()).toEqual([commandID]);
+        });
     });
 });
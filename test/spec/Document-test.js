@@ -32,6 +32,7 @@ define(function (require, exports, module) {
         DocumentModule,      // loaded from brackets.test
         DocumentManager,     // loaded from brackets.test
         MainViewManager,     // loaded from brackets.test
+        Document            = require("document/Document").Document,
         SpecRunnerUtils     = require("spec/SpecRunnerUtils");
 
 
@@ -231,6 +232,139 @@ define(function (require, exports, module) {
             });
 
         });
+
+        describe("getSnapshot", function () {
+            var myDocument;
+
+            afterEach(function () {
+                if (myDocument && myDocument._masterEditor) {
+                    SpecRunnerUtils.destroyMockEditor(myDocument);
+                }
+                myDocument = null;
+            });
+
+            it("should read lines and ranges without creating a master editor", function () {
+                myDocument = SpecRunnerUtils.createMockDocument("line 0\r\nline 1\r\nline 2");
+
+                // createMockDocument() throws if asked to create a master editor
+                expect(myDocument.getLine(1)).toBe("line 1");
+                expect(myDocument.getLine(3)).toBeUndefined();
+                expect(myDocument.getRange({line: 0, ch: 5}, {line: 1, ch: 4})).toBe("0\nline");
+                expect(myDocument.getRange({line: 2, ch: 0}, {line: 2, ch: 100})).toBe("line 2");
+            });
+
+            it("should convert between offsets and positions", function () {
+                myDocument = SpecRunnerUtils.createMockDocument("ab\ncde\n\nf");
+                var snapshot = myDocument.getSnapshot();
+
+                expect(snapshot.getLineCount()).toBe(4);
+                expect(snapshot.posFromIndex(0)).toEqual({line: 0, ch: 0});
+                expect(snapshot.posFromIndex(4)).toEqual({line: 1, ch: 1});
+                expect(snapshot.posFromIndex(7)).toEqual({line: 2, ch: 0});
+                expect(snapshot.posFromIndex(100)).toEqual({line: 3, ch: 1});
+                expect(snapshot.indexFromPos({line: 1, ch: 1})).toBe(4);
+                expect(snapshot.indexFromPos({line: 1, ch: 100})).toBe(6);
+            });
+
+            it("should share one snapshot until the document changes", function () {
+                var mocks = SpecRunnerUtils.createMockEditor("one\ntwo", "unknown");
+                myDocument = mocks.doc;
+
+                var snapshot = myDocument.getSnapshot();
+                expect(myDocument.getSnapshot()).toBe(snapshot);
+
+                myDocument.replaceRange("three", {line: 1, ch: 0}, {line: 1, ch: 3});
+
+                var newSnapshot = myDocument.getSnapshot();
+                expect(newSnapshot).not.toBe(snapshot);
+                expect(newSnapshot.version).toBeGreaterThan(snapshot.version);
+                expect(snapshot.getText()).toBe("one\ntwo");
+                expect(newSnapshot.getText()).toBe("one\nthree");
+            });
+
+            it("should deliver a burst of changes as one idleChange", function () {
+                var mocks = SpecRunnerUtils.createMockEditor("0\n1\n2\n3\n4\n5", "unknown"),
+                    summaries = [],
+                    changes = 0;
+                myDocument = mocks.doc;
+
+                myDocument.on("change", function () {
+                    changes++;
+                });
+                myDocument.on("idleChange", function (e, doc, summary) {
+                    summaries.push(summary);
+                });
+
+                runs(function () {
+                    // Two cursors, then an unrelated edit further down
+                    myDocument.doMultipleEdits([
+                        {edit: {text: "a\nb", start: {line: 1, ch: 0}, end: {line: 1, ch: 1}}},
+                        {edit: {text: "c", start: {line: 3, ch: 0}, end: {line: 3, ch: 1}}}
+                    ]);
+                    myDocument.replaceRange("", {line: 5, ch: 0}, {line: 6, ch: 0});
+                    expect(summaries.length).toBe(0);
+                });
+
+                waitsFor(function () {
+                    return summaries.length > 0;
+                }, 1000, "idleChange");
+
+                runs(function () {
+                    expect(changes).toBe(2);
+                    expect(summaries.length).toBe(1);
+                    expect(summaries[0]).toEqual({fromLine: 1, toLine: 5, newToLine: 5, replacesAll: false});
+                    expect(myDocument.getText()).toBe("0\na\nb\n2\nc\n5");
+                });
+            });
+
+            it("should drop a pending idleChange when the last reference is released", function () {
+                var mocks = SpecRunnerUtils.createMockEditor("one\ntwo", "unknown"),
+                    summaries = [];
+                myDocument = mocks.doc;
+
+                myDocument.on("idleChange", function (e, doc, summary) {
+                    summaries.push(summary);
+                });
+
+                runs(function () {
+                    // Mock documents stub out ref counting, use the real one
+                    Document.prototype.addRef.call(myDocument);
+                    myDocument.replaceRange("zero\n", {line: 0, ch: 0});
+                    Document.prototype.releaseRef.call(myDocument);
+                });
+
+                waits(500);
+
+                runs(function () {
+                    expect(summaries.length).toBe(0);
+                });
+            });
+
+            it("should merge change lists into one span of lines", function () {
+                var summarize = Document.summarizeChangeList;
+
+                // Insert two lines at line 2, then replace line 10 (line 8 before the insert)
+                expect(summarize([
+                    {from: {line: 2, ch: 0}, to: {line: 2, ch: 0}, text: ["x", "y", ""]},
+                    {from: {line: 10, ch: 0}, to: {line: 10, ch: 3}, text: ["z"]}
+                ])).toEqual({fromLine: 2, toLine: 8, newToLine: 10, replacesAll: false});
+
+                // Delete lines 5-6, then edit line 1
+                expect(summarize([
+                    {from: {line: 5, ch: 0}, to: {line: 7, ch: 0}, text: [""]},
+                    {from: {line: 1, ch: 0}, to: {line: 1, ch: 1}, text: ["q"]}
+                ])).toEqual({fromLine: 1, toLine: 7, newToLine: 5, replacesAll: false});
+
+                expect(summarize([{text: ["a", "b"]}]).replacesAll).toBe(true);
+            });
+
+            it("should keep original line endings of the text", function () {
+                myDocument = SpecRunnerUtils.createMockDocument("one\r\ntwo");
+
+                expect(myDocument.getText()).toBe("one\ntwo");
+                expect(myDocument.getText(true)).toBe("one\r\ntwo");
+            });
+        });
     });
 
     describe("Document Integration", function () {
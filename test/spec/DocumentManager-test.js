@@ -120,6 +120,75 @@ define(function (require, exports, module) {
                     expect(doc).toBeTruthy();
                 });
             });
+
+            it("Should find open documents by path and forget them once closed", function () {
+                var doc1 = DocumentManager.createUntitledDocument(1, ".txt"),
+                    doc2 = DocumentManager.createUntitledDocument(2, ".txt");
+
+                doc1.addRef();
+                doc2.addRef();
+                expect(DocumentManager.getOpenDocumentForPath(doc1.file.fullPath)).toBe(doc1);
+                expect(DocumentManager.getOpenDocumentForPath(doc2.file.fullPath)).toBe(doc2);
+                expect(DocumentManager.getOpenDocumentForPath(testPath + "/notOpen.js")).toBeNull();
+
+                // Modifying the returned list must not affect later calls
+                DocumentManager.getAllOpenDocuments().length = 0;
+                expect(DocumentManager.getAllOpenDocuments().length).toEqual(2);
+
+                doc1.releaseRef();
+                expect(DocumentManager.getOpenDocumentForPath(doc1.file.fullPath)).toBeNull();
+                expect(DocumentManager.getAllOpenDocuments()).toEqual([doc2]);
+
+                doc2.releaseRef();
+                expect(DocumentManager.getAllOpenDocuments().length).toEqual(0);
+            });
+        });
+
+        describe("renaming", function () {
+            var tempDir = SpecRunnerUtils.getTempDirectory();
+
+            beforeEach(function () {
+                SpecRunnerUtils.createTempDirectory();
+                SpecRunnerUtils.loadProjectInTestWindow(tempDir);
+            });
+
+            afterEach(function () {
+                SpecRunnerUtils.removeTempDirectory();
+            });
+
+            it("Should find an open document by its new path after a rename", function () {
+                var oldPath = tempDir + "/old.js",
+                    newPath = tempDir + "/new.js";
+
+                runs(function () {
+                    waitsForDone(SpecRunnerUtils.createTextFile(oldPath, "var a;", testWindow.brackets.test.FileSystem), "create file");
+                });
+
+                runs(function () {
+                    promise = CommandManager.execute(Commands.FILE_OPEN, { fullPath: oldPath });
+                    waitsForDone(promise, Commands.FILE_OPEN);
+                });
+
+                runs(function () {
+                    var deferred = new $.Deferred();
+                    testWindow.brackets.test.FileSystem.getFileForPath(oldPath).rename(newPath, function (err) {
+                        if (err) {
+                            deferred.reject(err);
+                        } else {
+                            deferred.resolve();
+                        }
+                    });
+                    waitsForDone(deferred.promise(), "rename");
+                });
+
+                runs(function () {
+                    expect(DocumentManager.getOpenDocumentForPath(oldPath)).toBeNull();
+                    expect(DocumentManager.getOpenDocumentForPath(newPath).file.fullPath).toBe(newPath);
+
+                    // Close before the temp directory goes away
+                    testWindow.brackets.test.MainViewManager._closeAll(testWindow.brackets.test.MainViewManager.ALL_PANES);
+                });
+            });
         });
 
     });
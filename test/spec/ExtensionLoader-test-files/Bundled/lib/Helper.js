@@ -0,0 +1,9 @@
+/*global define */
+
+define(function (require, exports, module) {
+    "use strict";
+
+    exports.greet = function (name) {
+        return "Hello " + name.trim();
+    };
+});
@@ -0,0 +1,10 @@
+/*global define */
+
+define(function (require, exports, module) {
+    "use strict";
+
+    var Helper      = require("lib/Helper"),
+        template    = require("text!template.html");
+
+    exports.message = Helper.greet(template);
+});
@@ -0,0 +1,11 @@
+/*global define, brackets */
+
+define(function (require, exports, module) {
+    "use strict";
+
+    var CommandManager = brackets.getModule("command/CommandManager");
+
+    CommandManager.register("Lazy Command", "test.lazyCommand", function (value) {
+        exports.executedWith = value;
+    });
+});
@@ -28,8 +28,10 @@ define(function (require, exports, module) {
     "use strict";
 
     // Load dependent modules
-    var ExtensionLoader = require("utils/ExtensionLoader"),
-        SpecRunnerUtils = require("spec/SpecRunnerUtils");
+    var CommandManager          = require("command/CommandManager"),
+        ExtensionLoader         = require("utils/ExtensionLoader"),
+        ExtensionBundleCache    = require("utils/ExtensionBundleCache"),
+        SpecRunnerUtils         = require("spec/SpecRunnerUtils");
 
     var testPath = SpecRunnerUtils.getTestPath("/spec/ExtensionLoader-test-files");
 
@@ -143,5 +145,78 @@ define(function (require, exports, module) {
             testLoadExtension("BadRequireConfig", "rejected", /\[Extension\] failed to load.*BadRequireConfig.*failed to parse requirejs-config.json/);
         });
 
+        it("should load an extension with activation events on the first of them", function () {
+            runs(function () {
+                waitsForDone(ExtensionLoader.loadExtension("LazyCommand", { baseUrl: testPath + "/LazyCommand" }, "main"), "loadExtension");
+            });
+
+            runs(function () {
+                expect(ExtensionLoader.getRequireContextForExtension("LazyCommand")).toBeUndefined();
+
+                waitsForDone(CommandManager.execute("test.lazyCommand", 42), "execute test.lazyCommand");
+            });
+
+            runs(function () {
+                expect(ExtensionLoader.getRequireContextForExtension("LazyCommand")("main").executedWith).toBe(42);
+            });
+        });
+
+        describe("Bundle cache", function () {
+
+            var baseUrl = testPath + "/Bundled";
+
+            beforeEach(function () {
+                SpecRunnerUtils.createTempDirectory();
+
+                runs(function () {
+                    ExtensionBundleCache._setCacheDirectory(SpecRunnerUtils.getTempDirectory() + "/extension-cache");
+                });
+            });
+
+            afterEach(function () {
+                runs(function () {
+                    ExtensionBundleCache._setCacheDirectory(null);
+                });
+
+                SpecRunnerUtils.removeTempDirectory();
+            });
+
+            it("should load the modules of an extension from its cached bundle", function () {
+                var bundle;
+
+                runs(function () {
+                    waitsForDone(ExtensionLoader.loadExtension("BundledFirst", { baseUrl: baseUrl }, "main"), "loadExtension");
+                });
+
+                runs(function () {
+                    waitsForDone(ExtensionBundleCache.recordBundle("BundledFirst", baseUrl), "recordBundle");
+                });
+
+                runs(function () {
+                    ExtensionBundleCache.getBundle(baseUrl).done(function (result) {
+                        bundle = result;
+                    });
+
+                    waitsFor(function () {
+                        return bundle;
+                    }, "getBundle");
+                });
+
+                runs(function () {
+                    expect(bundle.modules.sort()).toEqual(["lib/Helper", "main"]);
+
+                    waitsForDone(ExtensionLoader.loadExtension("BundledSecond", { baseUrl: baseUrl }, "main"), "loadExtension");
+                });
+
+                runs(function () {
+                    var context = brackets.libRequire.s.contexts.BundledSecond;
+
+                    // One script for the whole extension, with the same exports
+                    expect(context.urlFetched[bundle.path]).toBe(true);
+                    expect(context.urlFetched[baseUrl + "/lib/Helper.js"]).toBeFalsy();
+                    expect(ExtensionLoader.getRequireContextForExtension("BundledSecond")("main").message).toBe("Hello World");
+                });
+            });
+        });
     });
 });
@@ -0,0 +1,14 @@
+/*global define */
+
+define(function (require, exports, module) {
+    "use strict";
+
+    // Called from the spec, so that the extension's code is on the stack
+    exports.getCaller = function (ExtensionMonitor) {
+        return ExtensionMonitor.getCaller();
+    };
+
+    exports.attribute = function (ExtensionMonitor, target) {
+        ExtensionMonitor.attribute(target);
+    };
+});
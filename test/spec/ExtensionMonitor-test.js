@@ -0,0 +1,171 @@
+/*
+ * Copyright (c) 2018 - present The quadre code authors. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ *
+ */
+
+define(function (require, exports, module) {
+    "use strict";
+
+    var ExtensionMonitor = require("utils/ExtensionMonitor"),
+        EventDispatcher  = require("utils/EventDispatcher"),
+        SpecRunnerUtils  = require("spec/SpecRunnerUtils");
+
+    var testPath = SpecRunnerUtils.getTestPath("/spec/ExtensionMonitor-test-files");
+
+    describe("ExtensionMonitor", function () {
+
+        function busy(ms) {
+            var end = performance.now() + ms;
+            while (performance.now() < end) {
+                // keep the CPU busy
+            }
+        }
+
+        function getStats(name) {
+            return ExtensionMonitor.getStats().filter(function (entry) {
+                return entry.name === name;
+            })[0];
+        }
+
+        beforeEach(function () {
+            ExtensionMonitor._reset();
+            ExtensionMonitor.setEnabled(true);
+            ExtensionMonitor.setBudget(5, ExtensionMonitor.ACTION_NONE);
+        });
+
+        afterEach(function () {
+            ExtensionMonitor.setEnabled(false);
+            ExtensionMonitor.setBudget(50, ExtensionMonitor.ACTION_NONE);
+            ExtensionMonitor._reset();
+        });
+
+        it("should call callbacks that aren't attributed to an extension without measuring them", function () {
+            var fn = function (a, b) { return a + b; };
+
+            expect(ExtensionMonitor.invoke(fn, "add", fn, null, [1, 2])).toBe(3);
+            expect(ExtensionMonitor.getStats()).toEqual([]);
+        });
+
+        it("should measure the callbacks of an extension", function () {
+            var provider = {
+                hasHints: function () {
+                    return true;
+                },
+                getHints: function () {
+                    busy(3);
+                    return { hints: [] };
+                }
+            };
+            ExtensionMonitor.setOwner(provider, "ext-a");
+
+            expect(ExtensionMonitor.invoke(provider, "hasHints", provider.hasHints, provider, [])).toBe(true);
+            expect(ExtensionMonitor.invoke(provider, "getHints", provider.getHints, provider, [])).toEqual({ hints: [] });
+
+            var stats = getStats("ext-a");
+            expect(stats.calls).toBe(2);
+            expect(stats.max).not.toBeLessThan(3);
+            expect(stats.slowestCall).toBe("getHints");
+            expect(stats.state).toBe("ok");
+        });
+
+        it("should only count nested calls for the innermost extension", function () {
+            var inner = function () {
+                    busy(10);
+                },
+                outer = function () {
+                    ExtensionMonitor.invoke(inner, "inner", inner, null, []);
+                };
+            ExtensionMonitor.setOwner(inner, "ext-inner");
+            ExtensionMonitor.setOwner(outer, "ext-outer");
+
+            ExtensionMonitor.invoke(outer, "outer", outer, null, []);
+
+            expect(getStats("ext-inner").max).not.toBeLessThan(10);
+            expect(getStats("ext-outer").max).toBeLessThan(5);
+        });
+
+        it("should skip the callbacks of an extension over budget until it is resumed", function () {
+            var fn = jasmine.createSpy().andCallFake(function () {
+                    busy(6);
+                    return true;
+                }),
+                i;
+            ExtensionMonitor.setOwner(fn, "ext-slow");
+            ExtensionMonitor.setBudget(5, ExtensionMonitor.ACTION_DISABLE);
+
+            for (i = 0; i < 20; i++) {
+                ExtensionMonitor.invoke(fn, "hook", fn, null, []);
+            }
+            expect(ExtensionMonitor.isSuspended(fn)).toBe(true);
+            expect(getStats("ext-slow").state).toBe(ExtensionMonitor.ACTION_DISABLE);
+
+            expect(ExtensionMonitor.invoke(fn, "hook", fn, null, [])).toBeUndefined();
+            expect(fn.callCount).toBe(20);
+            expect(getStats("ext-slow").skipped).toBe(1);
+
+            ExtensionMonitor.resume("ext-slow");
+            expect(ExtensionMonitor.invoke(fn, "hook", fn, null, [])).toBe(true);
+            expect(fn.callCount).toBe(21);
+        });
+
+        it("should attribute calls to the extension whose require context loaded the code", function () {
+            var contextName = "ExtensionMonitorCaller",
+                callerModule,
+                target = {};
+
+            runs(function () {
+                var extensionRequire = brackets.libRequire.config({ context: contextName, baseUrl: testPath });
+                ExtensionMonitor.registerExtension(contextName);
+                extensionRequire(["Caller"], function (module) {
+                    callerModule = module;
+                });
+            });
+
+            waitsFor(function () {
+                return callerModule;
+            }, "the module to load in its own context", 5000);
+
+            runs(function () {
+                expect(document.querySelector("script[data-requirecontext='" + contextName + "']")).toBeTruthy();
+
+                expect(callerModule.getCaller(ExtensionMonitor)).toBe(contextName);
+                expect(ExtensionMonitor.getCaller()).toBe(null);
+
+                callerModule.attribute(ExtensionMonitor, target);
+                expect(ExtensionMonitor.getOwner(target)).toBe(contextName);
+            });
+        });
+
+        it("should measure event handlers attributed to an extension", function () {
+            var dispatcher = {},
+                fn = jasmine.createSpy();
+            EventDispatcher.makeEventDispatcher(dispatcher);
+
+            dispatcher.on("foo", fn);
+            ExtensionMonitor.setOwner(dispatcher._eventHandlers.foo[0], "ext-events");
+            dispatcher.trigger("foo", 42);
+
+            expect(fn).toHaveBeenCalledWith(jasmine.any(Object), 42);
+            expect(getStats("ext-events").calls).toBe(1);
+            expect(getStats("ext-events").slowestCall).toBe("foo");
+        });
+    });
+});
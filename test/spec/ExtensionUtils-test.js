@@ -26,6 +26,7 @@ define(function (require, exports, module) {
     "use strict";
 
     var ExtensionUtils,     // Load from brackets.test
+        LessCache,          // Load from brackets.test
         FileUtils           = require("file/FileUtils"),
         SpecRunnerUtils     = require("spec/SpecRunnerUtils"),
         LESS_RESULT         = require("text!spec/ExtensionUtils-test-files/less.text");
@@ -42,12 +43,14 @@ define(function (require, exports, module) {
 
                 // Load module instances from brackets.test
                 ExtensionUtils      = testWindow.brackets.test.ExtensionUtils;
+                LessCache           = testWindow.brackets.test.LessCache;
             });
         });
 
         afterLast(function () {
             testWindow      = null;
             ExtensionUtils  = null;
+            LessCache       = null;
             SpecRunnerUtils.closeTestWindow();
         });
 
@@ -163,5 +166,131 @@ define(function (require, exports, module) {
                 });
             });
         });
+
+        describe("LESS cache", function () {
+            var tempDir = SpecRunnerUtils.getTempDirectory(),
+                code    = "@import \"imported.less\";\n.cached { width: @width; }\n",
+                options;
+
+            function render() {
+                var css;
+
+                runs(function () {
+                    var promise = LessCache.render(code, options);
+                    promise.done(function (result) {
+                        css = result;
+                    });
+                    waitsForDone(promise, "LessCache.render");
+                });
+
+                runs(function () {
+                    // the entry is stored once the imports have been checked
+                    waitsFor(function () {
+                        return LessCache._isCached(code, options);
+                    }, "CSS to be cached");
+                });
+
+                return function () {
+                    return css;
+                };
+            }
+
+            function writeImport(width) {
+                runs(function () {
+                    waitsForDone(SpecRunnerUtils.createTextFile(tempDir + "/imported.less", "@width: " + width + ";\n", testWindow.brackets.test.FileSystem), "write imported.less");
+                });
+            }
+
+            beforeEach(function () {
+                SpecRunnerUtils.createTempDirectory();
+
+                runs(function () {
+                    options = { filename: tempDir + "/main.less", rootpath: tempDir + "/" };
+                    LessCache._setCacheDirectory(tempDir + "/less-cache");
+                });
+
+                writeImport("10px");
+            });
+
+            afterEach(function () {
+                runs(function () {
+                    LessCache._setCacheDirectory(null);
+                });
+
+                SpecRunnerUtils.removeTempDirectory();
+            });
+
+            it("should reuse the CSS compiled for the same code", function () {
+                var first = render(),
+                    second = render();
+
+                runs(function () {
+                    expect(first()).toMatch(/width: 10px/);
+                    expect(second()).toBe(first());
+                });
+            });
+
+            it("should compile again when an imported file changes", function () {
+                var first = render();
+
+                // make sure the modification time differs
+                waits(10);
+                writeImport("20px");
+
+                var second = render();
+
+                runs(function () {
+                    expect(first()).toMatch(/width: 10px/);
+                    expect(second()).toMatch(/width: 20px/);
+                });
+            });
+
+            it("should drop the cached CSS once it finds out the compiler changed", function () {
+                var FileSystemInWindow = testWindow.brackets.test.FileSystem,
+                    indexPath = tempDir + "/less-cache/less-cache.json",
+                    index = null,
+                    first = render(),
+                    second;
+
+                // the index is written a little after the last change
+                waitsFor(function () {
+                    FileUtils.readAsText(FileSystemInWindow.getFileForPath(indexPath)).done(function (text) {
+                        index = JSON.parse(text);
+                    });
+                    return index && index.compilerVersion && Object.keys(index.entries).length === 1;
+                }, "the index to be written", 5000);
+
+                runs(function () {
+                    index.compilerVersion = "node-0.0.0";
+                    waitsForDone(SpecRunnerUtils.createTextFile(indexPath, JSON.stringify(index), FileSystemInWindow), "write less-cache.json");
+                });
+
+                runs(function () {
+                    // load the index again
+                    LessCache._setCacheDirectory(tempDir + "/less-cache");
+                    var promise = LessCache.render(code, options);
+                    promise.done(function (css) {
+                        second = css;
+                    });
+                    waitsForDone(promise, "LessCache.render");
+                });
+
+                runs(function () {
+                    // the hit doesn't wait for the compiler version
+                    expect(second).toBe(first());
+                });
+
+                waitsFor(function () {
+                    return !LessCache._isCached(code, options);
+                }, "the entry to be dropped", 5000);
+
+                // and the next miss stores the CSS of the current compiler
+                var third = render();
+
+                runs(function () {
+                    expect(third()).toBe(first());
+                });
+            });
+        });
     });
 });
@@ -26,7 +26,8 @@
 define(function (require, exports, module) {
     "use strict";
 
-    var FileFilters        = require("search/FileFilters"),
+    var _                  = require("thirdparty/lodash"),
+        FileFilters        = require("search/FileFilters"),
         SpecRunnerUtils    = require("spec/SpecRunnerUtils"),
         Dialogs            = require("widgets/Dialogs"),
         KeyEvent           = require("utils/KeyEvent"),
@@ -380,6 +381,37 @@ define(function (require, exports, module) {
                 expectMatch(filter,    "/foo/jquery-1.6-min.js");
                 expectNotMatch(filter, "/foo/jquery-1.6/a.js");
             });
+
+            it("should match the same paths with all filtering functions", function () {
+                var filter = FileFilters.compile(["node_modules", "*.min.js", "/thirdparty/*/jquery*.js", "a?c"]),
+                    paths = [
+                        "/src/node_modules/a.js",
+                        "/src/lib.min.js",
+                        "/src/lib.min.jsx",
+                        "/thirdparty/x/jquery-2.js",
+                        "/thirdparty/a/b/jquery.js",
+                        "/abc/",
+                        "/a/c"
+                    ],
+                    matching = ["/src/node_modules/a.js", "/src/lib.min.js", "/thirdparty/x/jquery-2.js", "/abc/"],
+                    files = paths.map(function (path) {
+                        return { fullPath: path };
+                    });
+
+                paths.forEach(function (path) {
+                    expect(FileFilters.filterPath(filter, path)).toBe(matching.indexOf(path) === -1);
+                });
+                expect(FileFilters.getPathsMatchingFilter(filter, paths)).toEqual(matching);
+                expect(_.pluck(FileFilters.filterFileList(filter, files), "fullPath")).toEqual(_.difference(paths, matching));
+            });
+
+            it("should accept compiled filters from a previous session", function () {
+                // Compiled filters are plain strings, e.g. as stored by a search that is reopened
+                var filter = "^.*node_modules.*$|^.*\\.css$";
+                expectMatch(filter,    "/a/node_modules/b.js");
+                expectMatch(filter,    "/a/b.css");
+                expectNotMatch(filter, "/a/b.js");
+            });
         });
 
         describe("Automatic glob prefixes/suffixes", function () {
@@ -719,137 +719,99 @@ define(function (require, exports, module) {
             });
         });
 
-        describe("Find results paging", function () {
-            var expectedPages = [
-                {
-                    totalResults: 500,
-                    totalFiles: 2,
-                    overallFirstIndex: 1,
-                    overallLastIndex: 100,
-                    matchRanges: [{file: 0, filename: "manyhits-1.txt", first: 0, firstLine: 1, last: 99, lastLine: 100, pattern: /i'm going to\s+find this\s+now/}],
-                    firstPageEnabled: false,
-                    lastPageEnabled: true,
-                    prevPageEnabled: false,
-                    nextPageEnabled: true
-                },
-                {
-                    totalResults: 500,
-                    totalFiles: 2,
-                    overallFirstIndex: 101,
-                    overallLastIndex: 200,
-                    matchRanges: [{file: 0, filename: "manyhits-1.txt", first: 0, firstLine: 101, last: 99, lastLine: 200, pattern: /i'm going to\s+find this\s+now/}],
-                    firstPageEnabled: true,
-                    lastPageEnabled: true,
-                    prevPageEnabled: true,
-                    nextPageEnabled: true
-                },
-                {
-                    totalResults: 500,
-                    totalFiles: 2,
-                    overallFirstIndex: 201,
-                    overallLastIndex: 300,
-                    matchRanges: [
-                        {file: 0, filename: "manyhits-1.txt", first: 0, firstLine: 201, last: 49, lastLine: 250, pattern: /i'm going to\s+find this\s+now/},
-                        {file: 1, filename: "manyhits-2.txt", first: 0, firstLine: 1, last: 49, lastLine: 50, pattern: /you're going to\s+find this\s+now/}
-                    ],
-                    firstPageEnabled: true,
-                    lastPageEnabled: true,
-                    prevPageEnabled: true,
-                    nextPageEnabled: true
-                },
-                {
-                    totalResults: 500,
-                    totalFiles: 2,
-                    overallFirstIndex: 301,
-                    overallLastIndex: 400,
-                    matchRanges: [{file: 0, filename: "manyhits-2.txt", first: 0, firstLine: 51, last: 99, lastLine: 150, pattern: /you're going to\s+find this\s+now/}],
-                    firstPageEnabled: true,
-                    lastPageEnabled: true,
-                    prevPageEnabled: true,
-                    nextPageEnabled: true
-                },
-                {
-                    totalResults: 500,
-                    totalFiles: 2,
-                    overallFirstIndex: 401,
-                    overallLastIndex: 500,
-                    matchRanges: [{file: 0, filename: "manyhits-2.txt", first: 0, firstLine: 151, last: 99, lastLine: 250, pattern: /you're going to\s+find this\s+now/}],
-                    firstPageEnabled: true,
-                    lastPageEnabled: false,
-                    prevPageEnabled: true,
-                    nextPageEnabled: false
-                }
-            ];
-
-            function expectPageDisplay(options) {
-                // Check the title
-                expect($("#find-in-files-results .title").text().match("\\b" + options.totalResults + "\\b")).toBeTruthy();
-                expect($("#find-in-files-results .title").text().match("\\b" + options.totalFiles + "\\b")).toBeTruthy();
-                var paginationInfo = $("#find-in-files-results .pagination-col").text();
-                expect(paginationInfo.match("\\b" + options.overallFirstIndex + "\\b")).toBeTruthy();
-                expect(paginationInfo.match("\\b" + options.overallLastIndex + "\\b")).toBeTruthy();
-
-                // Check for presence of file and first/last item rows within each file
-                options.matchRanges.forEach(function (range) {
-                    var $fileRow = $("#find-in-files-results tr.file-section[data-file-index='" + range.file + "']");
-                    expect($fileRow.length).toBe(1);
-                    expect($fileRow.find(".dialog-filename").text()).toEqual(range.filename);
-
-                    var $firstMatchRow = $("#find-in-files-results tr[data-file-index='" + range.file + "'][data-item-index='" + range.first + "']");
-                    expect($firstMatchRow.length).toBe(1);
-                    expect($firstMatchRow.find(".line-number").text().match("\\b" + range.firstLine + "\\b")).toBeTruthy();
-                    expect($firstMatchRow.find(".line-text").text().match(range.pattern)).toBeTruthy();
-
-                    var $lastMatchRow = $("#find-in-files-results tr[data-file-index='" + range.file + "'][data-item-index='" + range.last + "']");
-                    expect($lastMatchRow.length).toBe(1);
-                    expect($lastMatchRow.find(".line-number").text().match("\\b" + range.lastLine + "\\b")).toBeTruthy();
-                    expect($lastMatchRow.find(".line-text").text().match(range.pattern)).toBeTruthy();
-                });
-
-                // Check enablement of buttons
-                expect($("#find-in-files-results .first-page").hasClass("disabled")).toBe(!options.firstPageEnabled);
-                expect($("#find-in-files-results .last-page").hasClass("disabled")).toBe(!options.lastPageEnabled);
-                expect($("#find-in-files-results .prev-page").hasClass("disabled")).toBe(!options.prevPageEnabled);
-                expect($("#find-in-files-results .next-page").hasClass("disabled")).toBe(!options.nextPageEnabled);
+        describe("Find results virtualization", function () {
+            var $container;
+
+            function getRow(fileIndex, matchIndex) {
+                return $("#find-in-files-results tr[data-file-index='" + fileIndex + "'][data-match-index='" + matchIndex + "']");
+            }
+
+            function getFileRow(fileIndex) {
+                return $("#find-in-files-results tr.file-section[data-file-index='" + fileIndex + "']");
+            }
+
+            function scrollToRow(row) {
+                var rowHeight = $container.find("tbody").height() / $container.find("tr").length;
+                $container.scrollTop(row * rowHeight).trigger("scroll");
             }
 
-            it("should page forward, then jump back to first page, displaying correct contents at each step", function () {
+            beforeEach(function () {
                 openProject(SpecRunnerUtils.getTestPath("/spec/FindReplace-test-files-manyhits"));
                 openSearchBar();
 
-                // This search will find 500 hits in 2 files. Since there are 100 hits per page, there should
-                // be five pages, and the third page should have 50 results from the first file and 50 results
-                // from the second file.
+                // This search will find 500 hits in 2 files, 250 in each
                 executeSearch("find this");
 
                 runs(function () {
-                    var i;
-                    for (i = 0; i < 5; i++) {
-                        if (i > 0) {
-                            $("#find-in-files-results .next-page").click();
-                        }
-                        expectPageDisplay(expectedPages[i]);
-                    }
+                    $container = $("#find-in-files-results .table-container");
+                });
+            });
 
-                    $("#find-in-files-results .first-page").click();
-                    expectPageDisplay(expectedPages[0]);
+            afterEach(function () {
+                $container = null;
+            });
+
+            it("should only render the rows around the visible ones", function () {
+                runs(function () {
+                    var $rows = $container.find("tr");
+
+                    expect($("#find-in-files-results .title").text().match("\\b500\\b")).toBeTruthy();
+                    expect($("#find-in-files-results .title").text().match("\\b2\\b")).toBeTruthy();
+                    expect($rows.length).toBeGreaterThan(1);
+                    expect($rows.length).toBeLessThan(100);
+
+                    expect($rows.eq(0).hasClass("file-section")).toBeTruthy();
+                    expect($rows.eq(0).find(".dialog-filename").text()).toEqual("manyhits-1.txt");
+                    expect(getRow(0, 0).find(".line-number").text()).toEqual("1");
+                    expect(getRow(0, 0).find(".line-text").text()).toMatch(/i'm going to\s+find this\s+now/);
                 });
             });
 
-            it("should jump to last page, then page backward, displaying correct contents at each step", function () {
-                openProject(SpecRunnerUtils.getTestPath("/spec/FindReplace-test-files-manyhits"));
+            it("should render the rows scrolled into view and load the remaining results", function () {
+                runs(function () {
+                    // Row 200 is the 200th match of the first file, the first row is the title of the file
+                    scrollToRow(200);
+                    expect(getRow(0, 199).length).toBe(1);
+                    expect(getRow(0, 199).find(".line-number").text()).toEqual("200");
+                    expect(getRow(0, 0).length).toBe(0);
+                });
 
-                executeSearch("find this");
+                waitsFor(function () {
+                    $container.scrollTop($container[0].scrollHeight).trigger("scroll");
+                    return getRow(1, 249).length === 1;
+                }, "last result to be rendered", 5000);
 
                 runs(function () {
-                    var i;
-                    $("#find-in-files-results .last-page").click();
-                    for (i = 4; i >= 0; i--) {
-                        if (i < 4) {
-                            $("#find-in-files-results .prev-page").click();
-                        }
-                        expectPageDisplay(expectedPages[i]);
-                    }
+                    expect(getFileRow(0).length).toBe(0);
+                    expect(getRow(1, 249).find(".line-number").text()).toEqual("250");
+                    expect(getRow(1, 249).find(".line-text").text()).toMatch(/you're going to\s+find this\s+now/);
+                    expect($container.find("tr").length).toBeLessThan(100);
+                });
+            });
+
+            it("should collapse and expand the results of a file, keeping its title row", function () {
+                var $fileRow;
+
+                runs(function () {
+                    $fileRow = getFileRow(0);
+                    $fileRow.click();
+
+                    expect($fileRow.find(".disclosure-triangle").hasClass("expanded")).toBeFalsy();
+                    expect($.contains($container[0], $fileRow[0])).toBeTruthy();
+                    expect(getRow(0, 0).length).toBe(0);
+                });
+
+                // The results of the second file move up into view, loading them if needed
+                waitsFor(function () {
+                    return getRow(1, 0).length === 1;
+                }, "results of the second file to be rendered", 5000);
+
+                runs(function () {
+                    getFileRow(0).click();
+
+                    expect(getFileRow(0).find(".disclosure-triangle").hasClass("expanded")).toBeTruthy();
+                    expect(getRow(0, 0).find(".line-number").text()).toEqual("1");
+                    expect(getRow(1, 0).length).toBe(0);
                 });
             });
         });
@@ -925,6 +887,22 @@ define(function (require, exports, module) {
                         expect(wasQuickChange).toBeFalsy();
                     });
                 });
+
+                it("should keep the results of a renamed file when the node search found more than the in-browser maximum", function () {
+                    var maximum = FindInFiles.searchModel.constructor.MAX_TOTAL_RESULTS;
+
+                    runs(function () {
+                        // The node search reports the count of all the matches, not only the loaded ones
+                        FindInFiles.searchModel.numMatches = maximum + 1;
+                        FindInFiles._fileNameChangeHandler(null, fullTestPath("foo.html"), fullTestPath("newfoo.html"));
+                    });
+                    waitsFor(function () { return gotChange; }, "model change event");
+                    runs(function () {
+                        expect(FindInFiles.searchModel.results[fullTestPath("newfoo.html")]).toEqual(oldResults[fullTestPath("foo.html")]);
+                        expect(FindInFiles.searchModel.numMatches).toBe(maximum + 1);
+                        expect(FindInFiles.searchModel.foundMaximum).toBeFalsy();
+                    });
+                });
             });
 
             describe("when in-memory document changes", function () {
@@ -2439,9 +2417,9 @@ define(function (require, exports, module) {
                         runs(function () {
                             $(".disclosure-triangle").click();
                             expect($(".disclosure-triangle").hasClass("expanded")).toBeFalsy();
-                            // Check that all results are hidden
-                            expect($(".bottom-panel-table tr[data-file-index=0][data-match-index]:hidden").length).toEqual(7);
-                            expect($(".bottom-panel-table tr[data-file-index=1][data-match-index]:hidden").length).toEqual(4);
+                            // Check that the results of collapsed files aren't rendered
+                            expect($(".bottom-panel-table tr[data-file-index=0][data-match-index]").length).toEqual(0);
+                            expect($(".bottom-panel-table tr[data-file-index=1][data-match-index]").length).toEqual(0);
                             $(".disclosure-triangle").click();
                             expect($(".disclosure-triangle").hasClass("expanded")).toBeTruthy();
                             expect($(".bottom-panel-table tr[data-file-index=0][data-match-index]:visible").length).toEqual(7);
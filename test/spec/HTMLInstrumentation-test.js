@@ -1276,6 +1276,33 @@ define(function (require, exports, module) {
                 });
             });
 
+            it("should get the same edits when reparsing from a node table built in a worker", function () {
+                var previousDOM, nodeTable;
+
+                setupEditor(WellFormedDoc);
+                runs(function () {
+                    previousDOM = HTMLSimpleDOM.build(editor.document.getText());
+                    HTMLInstrumentation._markTextFromDOM(editor, previousDOM);
+
+                    // Adding an attribute is structural, so the whole document gets reparsed
+                    editor.document.replaceRange(" class='added'", {line: 12, ch: 3});
+                    HTMLSimpleDOM.buildNodeTableAsync(editor.document.getText(), true).done(function (result) {
+                        nodeTable = result;
+                    });
+                });
+                waitsFor(function () { return nodeTable; }, "node table from worker");
+                runs(function () {
+                    var fromText = HTMLInstrumentation._updateDOM(previousDOM, editor),
+                        fromTable = HTMLInstrumentation._updateDOM(previousDOM, editor, null, nodeTable);
+
+                    expect(fromTable.edits.length).toBe(1);
+                    expect(fromTable.edits[0].type).toBe("attrAdd");
+                    expect(fromTable.edits).toEqual(fromText.edits);
+                    expect(HTMLSimpleDOM._dumpDOM(fromTable.dom)).toEqual(HTMLSimpleDOM._dumpDOM(fromText.dom));
+                    checkMarkSanity();
+                });
+            });
+
             it("should avoid updating while typing an incomplete tag, then update when it's done", function () {
                 setupEditor(WellFormedDoc);
                 runs(function () {
@@ -28,6 +28,7 @@ define(function (require, exports, module) {
     "use strict";
 
     var HTMLSimpleDOM = require("language/HTMLSimpleDOM"),
+        HTMLNodeTable = require("language/HTMLNodeTable"),
         FileUtils     = require("file/FileUtils"),
         WellFormedDoc = require("text!spec/HTMLInstrumentation-test-files/wellformed.html"),
         MurmurHash3   = require("thirdparty/murmurhash3_gc");
@@ -202,5 +203,56 @@ define(function (require, exports, module) {
                 expect(meta.childSignature).toEqual(jasmine.any(Number));
             });
         });
+
+        describe("Node tables", function () {
+            it("should build the same node table in a worker as on the main thread", function () {
+                var nodeTable;
+
+                runs(function () {
+                    HTMLSimpleDOM.buildNodeTableAsync(WellFormedDoc).done(function (result) {
+                        nodeTable = result;
+                    });
+                });
+                waitsFor(function () { return nodeTable; }, "node table from worker");
+                runs(function () {
+                    var expected = HTMLNodeTable.build(WellFormedDoc);
+                    expect(Array.prototype.slice.call(nodeTable.nodes)).toEqual(Array.prototype.slice.call(expected.nodes));
+                    expect(nodeTable.tags).toEqual(expected.tags);
+                    expect(nodeTable.attributes).toEqual(expected.attributes);
+                    expect(nodeTable.contents).toEqual(expected.contents);
+                    expect(nodeTable.root).toEqual(expected.root);
+                    expect(nodeTable.errors).toBeNull();
+                });
+            });
+
+            it("should build a SimpleDOM from a node table with the same structure and signatures", function () {
+                var fromText = build(WellFormedDoc),
+                    fromTable = HTMLSimpleDOM.buildFromNodeTable(HTMLNodeTable.build(WellFormedDoc));
+
+                function strip(node) {
+                    return {
+                        tag: node.tag,
+                        content: node.content,
+                        attributes: node.attributes,
+                        start: node.start,
+                        end: node.end,
+                        startPos: node.startPos,
+                        endPos: node.endPos,
+                        textSignature: node.textSignature,
+                        attributeSignature: node.attributeSignature,
+                        children: node.children && node.children.map(strip)
+                    };
+                }
+
+                expect(strip(fromTable)).toEqual(strip(fromText));
+            });
+
+            it("should report the errors of a failed parse in the node table", function () {
+                var nodeTable = HTMLNodeTable.build("<p>unclosed <b>tags", true);
+                expect(nodeTable.root).toBe(-1);
+                expect(HTMLSimpleDOM.buildFromNodeTable(nodeTable)).toBeNull();
+                expect(nodeTable.errors.length).toBe(1);
+            });
+        });
     });
 });
@@ -0,0 +1,11 @@
+/*
+ * This file has CRLF line endings on purpose, see .gitattributes
+ */
+
+function crlfFirst() {
+    return 1;
+}
+
+function crlfSecond() {
+    return 2;
+}
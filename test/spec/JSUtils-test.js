@@ -567,12 +567,13 @@ define(function (require, exports, module) {
 
         this.category = "integration";
 
-        var functions;  // populated by indexAndFind()
+        var functions,  // populated by indexAndFind()
+            brackets;
 
         beforeEach(function () {
             SpecRunnerUtils.createTestWindowAndRun(this, function (testWindow) {
                 // Load module instances from brackets.test
-                var brackets        = testWindow.brackets;
+                brackets            = testWindow.brackets;
                 DocumentManager     = brackets.test.DocumentManager;
                 FileViewController  = brackets.test.FileViewController;
                 ProjectManager      = brackets.test.ProjectManager;
@@ -587,6 +588,7 @@ define(function (require, exports, module) {
             FileViewController  = null;
             JSUtils             = null;
             ProjectManager      = null;
+            brackets            = null;
             SpecRunnerUtils.closeTestWindow();
         });
 
@@ -655,6 +657,59 @@ define(function (require, exports, module) {
         });
 
 
+        describe("Function index", function () {
+            it("should not read unchanged files again", function () {
+                var testFileUtils = brackets.getModule("file/FileUtils");
+
+                indexAndFind(function (fileInfos) {
+                    return JSUtils.findMatchingFunctions("edit2", fileInfos);
+                });
+                runs(function () {
+                    expect(functions.length).toBe(1);
+                    spyOn(testFileUtils, "readAsText").andCallThrough();
+                });
+
+                indexAndFind(function (fileInfos) {
+                    return JSUtils.findMatchingFunctions("edit2", fileInfos);
+                });
+                runs(function () {
+                    expect(functions.length).toBe(1);
+                    expect(functions[0].lineStart).toBe(7);
+                    expect(functions[0].lineEnd).toBe(9);
+                    expect(testFileUtils.readAsText).not.toHaveBeenCalled();
+                });
+            });
+
+            it("should find functions in files with CRLF line endings", function () {
+                indexAndFind(function (fileInfos) {
+                    return JSUtils.findMatchingFunctions("crlfSecond", fileInfos);
+                });
+                runs(function () {
+                    expect(functions.length).toBe(1);
+                    expect(functions[0].lineStart).toBe(8);
+                    expect(functions[0].lineEnd).toBe(10);
+                });
+            });
+
+            it("should not load documents that don't define the function", function () {
+                indexAndFind(function (fileInfos) {
+                    return JSUtils.findMatchingFunctions("edit2", fileInfos);
+                });
+                runs(function () {
+                    spyOn(DocumentManager, "getDocumentForPath").andCallThrough();
+                });
+
+                indexAndFind(function (fileInfos) {
+                    return JSUtils.findMatchingFunctions("edit2", fileInfos);
+                });
+                runs(function () {
+                    expect(DocumentManager.getDocumentForPath.callCount).toBe(1);
+                    expect(DocumentManager.getDocumentForPath.mostRecentCall.args[0]).toBe(testPath + "/edit.js");
+                });
+            });
+        });
+
+
         describe("Working with unsaved changes", function () {
 
             function fileChangedTest(buildCache) {
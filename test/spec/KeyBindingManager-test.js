@@ -797,6 +797,32 @@ define(function (require, exports, module) {
                 expect(fooCalled).toBe(true);
             });
 
+            it("should dispatch keyboard events to the current key bindings", function () {
+                var fooCalled = 0,
+                    event = {
+                        ctrlKey: true,
+                        shiftKey: true,
+                        keyCode: KeyEvent.DOM_VK_DASH,
+                        stopPropagation: function () {},
+                        preventDefault: function () {}
+                    };
+                CommandManager.register("Foo", "test.foo", function () {
+                    fooCalled++;
+                });
+
+                KeyBindingManager.addBinding("test.foo", "Shift-Ctrl--");
+                KeyBindingManager._handleKeyEvent(event);
+                expect(fooCalled).toBe(1);
+
+                KeyBindingManager.removeBinding("Ctrl-Shift--");
+                KeyBindingManager._handleKeyEvent(event);
+                expect(fooCalled).toBe(1);
+
+                KeyBindingManager.addBinding("test.foo", "Ctrl-Shift--");
+                KeyBindingManager._handleKeyEvent(event);
+                expect(fooCalled).toBe(2);
+            });
+
         });
 
         describe("handle AltGr key", function () {
@@ -1307,5 +1307,63 @@ define(function (require, exports, module) {
                 });
             });
         });
+
+        describe("Editor hibernation", function () {
+            var PreferencesManager;
+
+            beforeEach(function () {
+                PreferencesManager = testWindow.brackets.test.PreferencesManager;
+                PreferencesManager.set("pane.maxLiveEditors", 1);
+            });
+
+            afterEach(function () {
+                PreferencesManager.set("pane.maxLiveEditors", undefined);
+                PreferencesManager = null;
+            });
+
+            function openInWorkingSet(name) {
+                runs(function () {
+                    promise = CommandManager.execute(Commands.CMD_ADD_TO_WORKINGSET_AND_OPEN, { fullPath: testPath + "/" + name, paneId: "first-pane" });
+                    waitsForDone(promise, Commands.CMD_ADD_TO_WORKINGSET_AND_OPEN);
+                });
+            }
+
+            (isCI ? xit : it)("should hibernate the editors beyond the budget and restore them when shown again", function () {
+                var pane;
+
+                openInWorkingSet("test.js");
+                runs(function () {
+                    EditorManager.getCurrentFullEditor().setCursorPos(2, 1);
+                });
+                openInWorkingSet("test.css");
+                runs(function () {
+                    pane = MainViewManager._getPane("first-pane");
+                    expect(pane.isEditorHibernated(testPath + "/test.js")).toBe(true);
+                    expect(pane.getViewForPath(testPath + "/test.js")).toBeFalsy();
+                    expect(MainViewManager.findInWorkingSet("first-pane", testPath + "/test.js")).toBe(0);
+                });
+                openInWorkingSet("test.js");
+                runs(function () {
+                    expect(pane.isEditorHibernated(testPath + "/test.js")).toBe(false);
+                    expect(pane.isEditorHibernated(testPath + "/test.css")).toBe(true);
+                    expect(EditorManager.getCurrentFullEditor().getCursorPos()).toEqual({ line: 2, ch: 1 });
+                });
+            });
+
+            (isCI ? xit : it)("should not hibernate the editors of modified documents", function () {
+                openInWorkingSet("test.js");
+                runs(function () {
+                    EditorManager.getCurrentFullEditor().document.replaceRange("// modified\n", { line: 0, ch: 0 });
+                });
+                openInWorkingSet("test.css");
+                runs(function () {
+                    var pane = MainViewManager._getPane("first-pane");
+                    expect(pane.isEditorHibernated(testPath + "/test.js")).toBe(false);
+                    expect(pane.getViewForPath(testPath + "/test.js")).toBeTruthy();
+
+                    DocumentManager.getOpenDocumentForPath(testPath + "/test.js")._markClean(); // so we can close without a save dialog
+                });
+            });
+        });
     });
 });
@@ -37,6 +37,7 @@ define(function (require, exports, module) {
     var RESTART_SERVER_DELAY    = 5000;  // five seconds
 
     var NodeConnection  = require("utils/NodeConnection"),
+        NodeDomain      = require("utils/NodeDomain"),
         SpecRunnerUtils = require("spec/SpecRunnerUtils");
 
     var testPath = SpecRunnerUtils.getTestPath("/spec/NodeConnection-test-files");
@@ -108,6 +109,7 @@ define(function (require, exports, module) {
                 c.off("close");
                 c.disconnect();
             });
+            NodeConnection._setBinaryFraming(true);
         });
 
         it("should not crash when attempting to load malformed domains",
@@ -190,6 +192,41 @@ define(function (require, exports, module) {
             });
         });
 
+        it("should load domains whose descriptions were cached by another connection", function () {
+            var connection = createConnection(),
+                otherConnection = createConnection(),
+                loadDeferred = null,
+                result = null;
+            runConnectAndWait(connection, false);
+            runLoadDomainsAndWait(connection, ["TestCommandsOne"], false);
+            runConnectAndWait(otherConnection, false);
+            runs(function () {
+                loadDeferred = otherConnection.loadDomains(testPath + "/TestCommandsOne", false, ["test"]);
+            });
+            waitsFor(
+                function () {
+                    return loadDeferred.state() === "resolved";
+                },
+                "The load should complete",
+                CONNECTION_TIMEOUT
+            );
+            runs(function () {
+                expect(otherConnection.domainEvents.test).toBeTruthy();
+                otherConnection.domains.test.reverse("asdf").done(function (response) {
+                    result = response;
+                });
+            });
+            waitsFor(
+                function () {
+                    return result;
+                },
+                CONNECTION_TIMEOUT
+            );
+            runs(function () {
+                expect(result).toBe("fdsa");
+            });
+        });
+
         it("should receive progress events from asynchronous commands", function () {
             var connection = createConnection();
             var commandDeferred = null;
@@ -503,5 +540,122 @@ define(function (require, exports, module) {
                 expect(view.getInt8(17)).toBe(-128);
             });
         });
+
+        it("should receive large strings with and without binary framing", function () {
+            var connection = createConnection(),
+                textConnection = createConnection(),
+                input = new Array(2000).join("\"quoted\" \u00e9\n"),
+                results = [];
+
+            runConnectAndWait(connection, false);
+            runLoadDomainsAndWait(connection, ["TestCommandsOne"], false);
+            runs(function () {
+                connection.domains.test.reverse(input).done(function (response) {
+                    results.push(response);
+                });
+                NodeConnection._setBinaryFraming(false);
+            });
+            runConnectAndWait(textConnection, false);
+            runLoadDomainsAndWait(textConnection, ["TestCommandsOne"], false);
+            runs(function () {
+                NodeConnection._setBinaryFraming(true);
+                textConnection.domains.test.reverse(input).done(function (response) {
+                    results.push(response);
+                });
+            });
+            waitsFor(
+                function () {
+                    return results.length === 2;
+                },
+                CONNECTION_TIMEOUT
+            );
+            runs(function () {
+                var expected = input.split("").reverse().join("");
+                expect(connection._binaryFraming).toBe(true);
+                expect(textConnection._binaryFraming).toBe(false);
+                expect(results[0]).toBe(expected);
+                expect(results[1]).toBe(expected);
+            });
+        });
+    });
+
+    describe("Node Domain", function () {
+
+        this.category = "livepreview";
+
+        it("should keep the domains of other NodeDomains when the interface is refreshed", function () {
+            var testDomain = new NodeDomain("test", testPath + "/TestCommandsOne"),
+                binaryDomain = new NodeDomain("binaryTest", testPath + "/BinaryTestCommands"),
+                connection = testDomain.connection,
+                staleSpec,
+                result;
+
+            runs(function () {
+                waitsForDone($.when(testDomain.promise(), binaryDomain.promise()), "domains to load", CONNECTION_TIMEOUT);
+            });
+
+            runs(function () {
+                expect(binaryDomain.connection).toBe(connection);
+
+                $.getJSON("http://localhost:" + connection._port + "/api").done(function (spec) {
+                    // The API as a refresh requested before binaryTest was loaded sees it
+                    delete spec.binaryTest;
+                    staleSpec = spec;
+                });
+                waitsFor(function () {
+                    return staleSpec;
+                }, "the API spec", CONNECTION_TIMEOUT);
+            });
+
+            runs(function () {
+                spyOn($, "getJSON").andReturn($.Deferred().resolve(staleSpec).promise());
+                waitsForDone(connection._refreshInterface(), "interface refresh");
+            });
+
+            runs(function () {
+                expect(binaryDomain.ready()).toBe(true);
+                expect(connection.domains.binaryTest).toBeTruthy();
+
+                binaryDomain.exec("getBufferAsync").done(function (response) {
+                    result = response;
+                });
+                waitsFor(function () {
+                    return result;
+                }, "the command response", CONNECTION_TIMEOUT);
+            });
+
+            runs(function () {
+                expect(result instanceof ArrayBuffer).toBe(true);
+
+                testDomain.dispose();
+                binaryDomain.dispose();
+            });
+        });
+
+        it("should remove its listeners from the shared connection when disposed", function () {
+            var domain = new NodeDomain("test", testPath + "/TestCommandsOne"),
+                connection = domain.connection;
+
+            function countListeners(event) {
+                return (connection._eventHandlers[event] || []).length;
+            }
+
+            runs(function () {
+                waitsForDone(domain.promise(), "domain to load", CONNECTION_TIMEOUT);
+            });
+
+            runs(function () {
+                var closeListeners = countListeners("close"),
+                    refreshListeners = countListeners("interfaceRefresh"),
+                    eventListeners = countListeners("test:eventOne");
+
+                domain.dispose();
+
+                expect(countListeners("close")).toBe(closeListeners - 1);
+                expect(countListeners("interfaceRefresh")).toBe(refreshListeners - 1);
+                expect(countListeners("test:eventOne")).toBe(eventListeners - 1);
+                expect(domain.ready()).toBe(false);
+            });
+        });
     });
 });
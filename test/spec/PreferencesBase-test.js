@@ -1137,6 +1137,46 @@ define(function (require, exports, module) {
                 expect(fooChanges).toBe(2);
             });
 
+            it("returns current values from its resolution cache", function () {
+                var pm = new PreferencesBase.PreferencesSystem(),
+                    projectScope = new PreferencesBase.Scope(new PreferencesBase.MemoryStorage({
+                        spaceUnits: 4,
+                        path: {
+                            "lib/**.js": {
+                                spaceUnits: 2
+                            }
+                        }
+                    })),
+                    pathLayer = new PreferencesBase.PathLayer("/project/.brackets.json"),
+                    libContext = { path: "/project/lib/a.js" };
+
+                projectScope.addLayer(pathLayer);
+                pm.addScope("project", projectScope);
+                pm.definePreference("spaceUnits", "number", 8);
+
+                expect(pm.get("spaceUnits", libContext)).toBe(2);
+                expect(pm.get("spaceUnits")).toBe(4);
+
+                // Changes are visible right away, even while events are paused
+                pm.pauseChangeEvents();
+                pm.set("spaceUnits", 3, { context: libContext });
+                expect(pm.get("spaceUnits", libContext)).toBe(3);
+                expect(pm.get("spaceUnits")).toBe(4);
+                pm.resumeChangeEvents();
+
+                // Layers can change what they resolve to without a change event
+                pathLayer.setPrefFilePath("/other/.brackets.json");
+                expect(pm.get("spaceUnits", libContext)).toBe(4);
+
+                // Modifying a returned object doesn't modify the cached value
+                pm.definePreference("closeTags", "object", { whenOpening: true });
+                pm.get("closeTags").whenOpening = false;
+                expect(pm.get("closeTags").whenOpening).toBe(true);
+
+                pm.removeScope("project");
+                expect(pm.get("spaceUnits", libContext)).toBe(8);
+            });
+
             it("can dynamically modify the default scope order", function () {
                 var pm = new PreferencesBase.PreferencesSystem();
                 pm.addScope("user", new PreferencesBase.MemoryStorage({
@@ -1623,5 +1663,125 @@ define(function (require, exports, module) {
                 });
             });
         });
+
+        describe("Journaled File Storage", function () {
+            var statePath;
+
+            function readText(path) {
+                var deferred = $.Deferred();
+                FileSystem.getFileForPath(path).read({}, function (err, text) {
+                    deferred.resolve(err ? null : text);
+                });
+                return deferred.promise();
+            }
+
+            beforeFirst(function () {
+                SpecRunnerUtils.createTempDirectory();
+            });
+
+            afterLast(function () {
+                SpecRunnerUtils.removeTempDirectory();
+            });
+
+            beforeEach(function () {
+                statePath = SpecRunnerUtils.getTempDirectory() + "/state-" + Date.now() + ".json";
+            });
+
+            it("journals the values set since the previous save and replays them on load", function () {
+                var storage = new PreferencesBase.JournaledFileStorage(statePath, true),
+                    data;
+
+                runs(function () {
+                    waitsForDone(storage.load());
+                });
+                runs(function () {
+                    data = {
+                        projects: { "/a/": { scroll: 1, selection: [1, 2] } },
+                        mru: ["/a/one.js"]
+                    };
+                    storage.save(data);
+                    // Scope changes its data in place
+                    data.projects["/a/"].scroll = 5;
+                    data.projects["/b/"] = { scroll: 2 };
+                    data.mru = ["/a/two.js", "/a/one.js"];
+                    waitsForDone(storage.save(data));
+                });
+                runs(function () {
+                    waitsForDone(readText(statePath + ".journal").done(function (text) {
+                        var lines = text.split("\n").filter(Boolean);
+                        expect(lines.length).toBe(5);
+                        expect(JSON.parse(lines[2])).toEqual([["projects", "/a/", "scroll"], 5]);
+                    }));
+                });
+                runs(function () {
+                    var reloaded = new PreferencesBase.JournaledFileStorage(statePath, true);
+                    waitsForDone(reloaded.load().done(function (loaded) {
+                        expect(loaded).toEqual(data);
+                    }));
+                });
+            });
+
+            it("journals removed values", function () {
+                var storage = new PreferencesBase.JournaledFileStorage(statePath, true);
+
+                runs(function () {
+                    waitsForDone(storage.load());
+                });
+                runs(function () {
+                    waitsForDone(storage.save({ a: { b: 1, c: 2 } }));
+                });
+                runs(function () {
+                    waitsForDone(storage.save({ a: { b: 1 } }));
+                });
+                runs(function () {
+                    var reloaded = new PreferencesBase.JournaledFileStorage(statePath, true);
+                    waitsForDone(reloaded.load().done(function (loaded) {
+                        expect(loaded).toEqual({ a: { b: 1 } });
+                    }));
+                });
+            });
+
+            it("folds the journal into the file when compacting", function () {
+                var storage = new PreferencesBase.JournaledFileStorage(statePath, true);
+
+                runs(function () {
+                    waitsForDone(storage.load());
+                });
+                runs(function () {
+                    storage.save({ a: 1, b: { c: 2 } });
+                    waitsForDone(storage.flush(true));
+                });
+                runs(function () {
+                    waitsForDone(readText(statePath + ".journal").done(function (text) {
+                        expect(text).toBe("");
+                    }));
+                    waitsForDone(readText(statePath).done(function (text) {
+                        expect(JSON.parse(text)).toEqual({ a: 1, b: { c: 2 } });
+                    }));
+                });
+            });
+
+            it("ignores a truncated last line of the journal", function () {
+                var storage = new PreferencesBase.JournaledFileStorage(statePath, true);
+
+                runs(function () {
+                    waitsForDone(storage.load());
+                });
+                runs(function () {
+                    waitsForDone(storage.save({ a: 1 }));
+                });
+                runs(function () {
+                    var deferred = $.Deferred();
+                    appshell.fs.appendFile(statePath + ".journal", "[[\"a\"],", "utf8", deferred.resolve);
+                    waitsForDone(deferred.promise());
+                });
+                runs(function () {
+                    var reloaded = new PreferencesBase.JournaledFileStorage(statePath, true);
+                    waitsForDone(reloaded.load().done(function (loaded) {
+                        expect(loaded).toEqual({ a: 1 });
+                    }));
+                });
+            });
+        });
     });
 });